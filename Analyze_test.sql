@@ -0,0 +1,31 @@
+--CS457 analyze
+
+--ANALYZE collects the statistics of one table or of the whole database
+
+CREATE DATABASE Analyzed;
+USE Analyzed;
+
+create table Flights (seat int, status int);
+create table Owners (seat int, owner varchar(10));
+insert into Flights values(1, 0);
+insert into Flights values(2, 0);
+insert into Flights values(3, 1);
+insert into Flights values(4, null);
+insert into Owners values(10, 'o1');
+insert into Owners values(20, 'o2');
+
+.STATISTICS Flights
+ANALYZE Flights;
+.STATISTICS Flights
+insert into Flights values(5, 1);
+.STATISTICS Flights
+ANALYZE;
+.STATISTICS Flights
+.STATISTICS Owners
+analyze Owners;
+
+ANALYZE Missing;
+.STATISTICS Missing
+
+DROP DATABASE Analyzed;
+.EXIT
@@ -0,0 +1,1497 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file BTreeIndex.cpp
+ *
+ * @brief Implementation file for BTreeIndex and TableIndexes classes
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the secondary indexes created by CREATE INDEX. Each
+ *          index is a B+tree of 4KB pages read through the buffer pool. Page
+ *          0 is a header, every other page is a node. Leaves hold the column
+ *          value and row id of every row and are linked left to right, so a
+ *          range is found with one descent and a walk along the leaves. The
+ *          header remembers the stat of the table the index matches, an
+ *          index that no longer matches its table is rebuilt before use
+ *
+ * @Note Requires BTreeIndex.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "BTreeIndex.h"
+#include "TableScan.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef BTREEINDEX_CPP
+#define BTREEINDEX_CPP
+
+//helper functions implemented in Table.cpp
+int findAttrOccur( vector< Attribute > attributes, string attrName );
+bool caseInsCompare( const string &s1, const string &s2 );
+
+/**
+ * @brief indexFilePath
+ *
+ * @details returns the file an index of a table is stored in
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] string indexName
+ *
+ * @return string the path .<table>.<index>.idx next to the table
+ *
+ * @note None
+ */
+string indexFilePath( string tablePath, string indexName )
+{
+	size_t slash = tablePath.rfind( '/' );
+	string directory = tablePath.substr( 0, slash + 1 );
+	string tableName = tablePath.substr( slash + 1 );
+	return directory + "." + tableName + "." + indexName + INDEX_SUFFIX;
+}
+
+/**
+ * @brief listIndexFiles
+ *
+ * @details finds the index files of a database directory
+ *
+ * @param [in] string databasePath
+ *
+ * @param [out] vector< string > &tableNames table each index belongs to
+ *
+ * @param [out] vector< string > &indexNames
+ *
+ * @return None
+ *
+ * @note None
+ */
+void listIndexFiles( string databasePath, vector< string > &tableNames, vector< string > &indexNames )
+{
+	tableNames.clear();
+	indexNames.clear();
+	DIR *directory = opendir( databasePath.c_str() );
+	if( directory == NULL )
+	{
+		return;
+	}
+
+	struct dirent *entry;
+	while( ( entry = readdir( directory ) ) != NULL )
+	{
+		string fileName = entry->d_name;
+		if( fileName.size() <= INDEX_SUFFIX.size() + 3 || fileName[ 0 ] != '.' ||
+			fileName.compare( fileName.size() - INDEX_SUFFIX.size(), INDEX_SUFFIX.size(), INDEX_SUFFIX ) != 0 )
+		{
+			continue;
+		}
+		fileName = fileName.substr( 1, fileName.size() - INDEX_SUFFIX.size() - 1 );
+		size_t dot = fileName.find( '.' );
+		if( dot == string::npos || dot == 0 || dot + 1 == fileName.size() )
+		{
+			continue;
+		}
+		tableNames.push_back( fileName.substr( 0, dot ) );
+		indexNames.push_back( fileName.substr( dot + 1 ) );
+	}
+	closedir( directory );
+}
+
+/**
+ * @brief findIndexTable
+ *
+ * @details looks up the table an index name of a database belongs to
+ *
+ * @par Algorithm index names compare without regard to case like table names
+ *
+ * @param [in] string databasePath
+ *
+ * @param [in] string indexName
+ *
+ * @param [out] string &tableName
+ *
+ * @return bool false if the database has no such index
+ *
+ * @note None
+ */
+bool findIndexTable( string databasePath, string indexName, string &tableName )
+{
+	vector< string > tableNames;
+	vector< string > indexNames;
+	listIndexFiles( databasePath, tableNames, indexNames );
+	for( unsigned int index = 0; index < indexNames.size(); index++ )
+	{
+		if( caseInsCompare( indexNames[ index ], indexName ) )
+		{
+			tableName = tableNames[ index ];
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief tableIndexNames
+ *
+ * @details finds the indexes of one table
+ *
+ * @param [in] string tablePath
+ *
+ * @param [out] vector< string > &indexNames
+ *
+ * @return None
+ *
+ * @note None
+ */
+void tableIndexNames( string tablePath, vector< string > &indexNames )
+{
+	size_t slash = tablePath.rfind( '/' );
+	string tableName = tablePath.substr( slash + 1 );
+	vector< string > tableNames;
+	vector< string > allNames;
+	listIndexFiles( tablePath.substr( 0, slash ), tableNames, allNames );
+
+	indexNames.clear();
+	for( unsigned int index = 0; index < allNames.size(); index++ )
+	{
+		if( tableNames[ index ] == tableName )
+		{
+			indexNames.push_back( allNames[ index ] );
+		}
+	}
+}
+
+/**
+ * @brief removeTableIndexes
+ *
+ * @details deletes every index of a table
+ *
+ * @param [in] string tablePath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void removeTableIndexes( string tablePath )
+{
+	vector< string > indexNames;
+	tableIndexNames( tablePath, indexNames );
+	for( unsigned int index = 0; index < indexNames.size(); index++ )
+	{
+		unlink( indexFilePath( tablePath, indexNames[ index ] ).c_str() );
+	}
+}
+
+/**
+ * @brief tableSignatureOf
+ *
+ * @details reads the stat signature of a table file
+ *
+ * @param [in] string tablePath
+ *
+ * @param [out] TableSignature &signature
+ *
+ * @return bool false if the table does not exist
+ *
+ * @note None
+ */
+bool tableSignatureOf( string tablePath, TableSignature &signature )
+{
+	struct stat fileStat;
+	if( stat( tablePath.c_str(), &fileStat ) != 0 )
+	{
+		return false;
+	}
+	signature.inode = fileStat.st_ino;
+	signature.size = fileStat.st_size;
+	signature.mtimeSec = fileStat.st_mtim.tv_sec;
+	signature.mtimeNsec = fileStat.st_mtim.tv_nsec;
+	return true;
+}
+
+/**
+ * @brief indexKeyTypeOf
+ *
+ * @details returns the keys an index on a column has
+ *
+ * @param [in] Attribute &attribute
+ *
+ * @return IndexKeyType
+ *
+ * @note None
+ */
+IndexKeyType indexKeyTypeOf( const Attribute &attribute )
+{
+	if( caseInsCompare( attribute.attributeType, "float" ) )
+	{
+		return INDEX_FLOAT_KEYS;
+	}
+	if( caseInsCompare( attribute.attributeType, "int" ) )
+	{
+		return INDEX_INTEGER_KEYS;
+	}
+	return INDEX_TEXT_KEYS;
+}
+
+/**
+ * @brief indexKeyTypeOf
+ *
+ * @details returns the keys an index needs to answer a where comparison,
+ *          they have to order values the way the comparison does
+ *
+ * @param [in] WhereCondition &wCond
+ *
+ * @return IndexKeyType
+ *
+ * @note None
+ */
+IndexKeyType indexKeyTypeOf( const WhereCondition &wCond )
+{
+	if( wCond.floatValue )
+	{
+		return INDEX_FLOAT_KEYS;
+	}
+	return wCond.intValue ? INDEX_INTEGER_KEYS : INDEX_TEXT_KEYS;
+}
+
+/**
+ * @brief buildIndex
+ *
+ * @details fills an index with every row of its table
+ *
+ * @pre index is open and its attributeIndex is set
+ *
+ * @post index holds one entry per row of the table file
+ *
+ * @par Algorithm the table is read once without the changes of the open
+ *      transaction and the entries are bulk loaded
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] BTreeIndex &index
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool buildIndex( string tablePath, BTreeIndex &index )
+{
+	TableScan scan;
+	vector< string > row;
+	vector< IndexEntry > entries;
+	IndexEntry entry;
+	bool rowMatches;
+
+	if( !scan.scanOpen( tablePath ) )
+	{
+		return false;
+	}
+	scan.scanSetDelta( NULL );
+	while( scan.scanNext( row, rowMatches ) )
+	{
+		if( index.indexKey( row[ index.attributeIndex ], entry.key ) )
+		{
+			entry.rid = scan.scanRowId();
+			entries.push_back( entry );
+		}
+	}
+	scan.scanClose();
+	return index.indexBuild( entries );
+}
+
+/**
+ * @brief refreshTableIndexes
+ *
+ * @details rebuilds the indexes of a table that no longer match it
+ *
+ * @param [in] string tablePath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void refreshTableIndexes( string tablePath )
+{
+	TableIndexes indexes;
+	indexes.indexesOpen( tablePath, NULL );
+	indexes.indexesClose( true );
+}
+
+/**
+ * @brief BTreeIndex default constructor
+ *
+ * @details a new index is not attached to any file
+ *
+ * @note None
+ */
+BTreeIndex::BTreeIndex()
+{
+	attributeIndex = -1;
+	keyType = INDEX_TEXT_KEYS;
+	fileId = -1;
+	rootPage = 0;
+	pageCount = 0;
+	headerChanged = false;
+	memset( &tableState, 0, sizeof( tableState ) );
+}
+
+/**
+ * @brief BTreeIndex default destructor
+ *
+ * @details closes the index file if it is still open
+ *
+ * @note None
+ */
+BTreeIndex::~BTreeIndex()
+{
+	indexClose();
+}
+
+/**
+ * @brief indexCreate
+ *
+ * @details creates an index file holding an empty tree
+ *
+ * @param [in] string filePath
+ *
+ * @param [in] string attrName column the index is on
+ *
+ * @param [in] IndexKeyType keys how the keys compare
+ *
+ * @return bool false if the file could not be created
+ *
+ * @note None
+ */
+bool BTreeIndex::indexCreate( string filePath, string attrName, IndexKeyType keys )
+{
+	indexClose();
+	if( attrName.size() > (unsigned int)( PAGE_SIZE - INDEX_HEADER_ATTR_DATA ) )
+	{
+		return false;
+	}
+
+	int fileDesc = open( filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	close( fileDesc );
+	fileId = bufferPool.poolOpenFile( filePath );
+	if( fileId < 0 )
+	{
+		return false;
+	}
+
+	attributeName = attrName;
+	keyType = keys;
+	memset( &tableState, 0, sizeof( tableState ) );
+	vector< IndexEntry > entries;
+	return indexBuild( entries );
+}
+
+/**
+ * @brief indexOpen
+ *
+ * @details opens an index file and reads its header page
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if the file is missing or not an index
+ *
+ * @note None
+ */
+bool BTreeIndex::indexOpen( string filePath )
+{
+	indexClose();
+	fileId = bufferPool.poolOpenFile( filePath );
+	if( fileId < 0 )
+	{
+		return false;
+	}
+
+	int length;
+	char *header = bufferPool.pinPage( fileId, 0, length );
+	if( header == NULL )
+	{
+		indexClose();
+		return false;
+	}
+	bool valid = length == PAGE_SIZE && memcmp( header + INDEX_HEADER_MAGIC, INDEX_MAGIC, 4 ) == 0;
+	if( valid )
+	{
+		uint32_t numeric;
+		uint32_t attrLength;
+		memcpy( &rootPage, header + INDEX_HEADER_ROOT, sizeof( rootPage ) );
+		memcpy( &pageCount, header + INDEX_HEADER_PAGE_COUNT, sizeof( pageCount ) );
+		memcpy( &numeric, header + INDEX_HEADER_NUMERIC, sizeof( numeric ) );
+		memcpy( &tableState.inode, header + INDEX_HEADER_INODE, sizeof( tableState.inode ) );
+		memcpy( &tableState.size, header + INDEX_HEADER_SIZE, sizeof( tableState.size ) );
+		memcpy( &tableState.mtimeSec, header + INDEX_HEADER_MTIME_SEC, sizeof( tableState.mtimeSec ) );
+		memcpy( &tableState.mtimeNsec, header + INDEX_HEADER_MTIME_NSEC, sizeof( tableState.mtimeNsec ) );
+		memcpy( &attrLength, header + INDEX_HEADER_ATTR_LENGTH, sizeof( attrLength ) );
+		valid = attrLength <= (uint32_t)( PAGE_SIZE - INDEX_HEADER_ATTR_DATA ) &&
+				rootPage > 0 && rootPage < pageCount && numeric <= INDEX_INTEGER_KEYS;
+		if( valid )
+		{
+			keyType = (IndexKeyType)numeric;
+			attributeName.assign( header + INDEX_HEADER_ATTR_DATA, attrLength );
+		}
+	}
+	bufferPool.unpinPage( fileId, 0, false );
+	if( !valid )
+	{
+		indexClose();
+	}
+	return valid;
+}
+
+/**
+ * @brief indexClose
+ *
+ * @details writes the header if it changed and closes the index file
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BTreeIndex::indexClose()
+{
+	if( fileId >= 0 )
+	{
+		if( headerChanged )
+		{
+			writeHeader();
+		}
+		bufferPool.poolCloseFile( fileId );
+		fileId = -1;
+	}
+	headerChanged = false;
+}
+
+/**
+ * @brief indexKey
+ *
+ * @details converts a cell of the indexed column into its key
+ *
+ * @par Algorithm float columns are compared as doubles by the where
+ *      condition, so their keys are the double, and int columns as 64 bit
+ *      integers, so their keys are the integer. Every other column compares
+ *      as a string and its key is the cell, cut to INDEX_MAX_KEY bytes
+ *
+ * @param [in] string &cell
+ *
+ * @param [out] string &key
+ *
+ * @return bool false for a value no comparison matches, it is not indexed
+ *
+ * @note None
+ */
+bool BTreeIndex::indexKey( const string &cell, string &key )
+{
+	if( keyType == INDEX_INTEGER_KEYS )
+	{
+		long long value = strtoll( cell.c_str(), NULL, 10 );
+		key.assign( (const char *)&value, sizeof( value ) );
+		return true;
+	}
+	if( keyType == INDEX_FLOAT_KEYS )
+	{
+		double value = atof( cell.c_str() );
+		if( value != value )
+		{
+			return false;
+		}
+		key.assign( (const char *)&value, sizeof( value ) );
+		return true;
+	}
+	key.assign( cell, 0, INDEX_MAX_KEY );
+	return true;
+}
+
+/**
+ * @brief indexInsert
+ *
+ * @details adds the key of a row to the tree
+ *
+ * @par Algorithm the key goes into its leaf, a full node is split in two
+ *      and the split moves up to the parent. A split root gets a new root
+ *      above it
+ *
+ * @param [in] string &key
+ *
+ * @param [in] long rid
+ *
+ * @return bool false if a page could not be written
+ *
+ * @note None
+ */
+bool BTreeIndex::indexInsert( const string &key, long rid )
+{
+	IndexEntry entry;
+	IndexEntry promoted;
+	uint32_t newPage;
+	entry.key = key;
+	entry.rid = rid;
+
+	if( fileId < 0 )
+	{
+		return false;
+	}
+	if( !insertInto( rootPage, entry, promoted, newPage ) )
+	{
+		return true;
+	}
+
+	IndexNode root;
+	root.leaf = false;
+	root.link = 0;
+	root.entries.push_back( promoted );
+	root.children.push_back( rootPage );
+	root.children.push_back( newPage );
+	rootPage = pageCount++;
+	headerChanged = true;
+	return writeNode( rootPage, root );
+}
+
+/**
+ * @brief indexRemove
+ *
+ * @details removes the key of a row from the tree
+ *
+ * @par Algorithm the row id makes every entry unique, so one descent finds
+ *      it. Nodes are not merged, an emptied leaf stays in the leaf chain
+ *
+ * @param [in] string &key
+ *
+ * @param [in] long rid
+ *
+ * @return bool false if the entry was not found
+ *
+ * @note None
+ */
+bool BTreeIndex::indexRemove( const string &key, long rid )
+{
+	IndexEntry entry;
+	IndexNode node;
+	uint32_t pageNo = rootPage;
+	entry.key = key;
+	entry.rid = rid;
+
+	if( fileId < 0 )
+	{
+		return false;
+	}
+	while( readNode( pageNo, node ) && !node.leaf )
+	{
+		pageNo = node.children[ childFor( node, entry ) ];
+	}
+	if( !node.leaf )
+	{
+		return false;
+	}
+	for( unsigned int index = 0; index < node.entries.size(); index++ )
+	{
+		if( compareEntries( node.entries[ index ], entry ) == 0 )
+		{
+			node.entries.erase( node.entries.begin() + index );
+			return writeNode( pageNo, node );
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief indexBuild
+ *
+ * @details replaces the tree with one holding the given entries
+ *
+ * @par Algorithm the entries are sorted and packed into leaves left to
+ *      right, then every level of inner nodes is packed from the first key
+ *      of each node below it until one root is left
+ *
+ * @param [in] vector< IndexEntry > &entries sorted in place
+ *
+ * @return bool false if a page could not be written
+ *
+ * @note None
+ */
+bool BTreeIndex::indexBuild( vector< IndexEntry > &entries )
+{
+	vector< IndexEntry > levelKeys;
+	vector< uint32_t > levelPages;
+	IndexNode node;
+	bool success = true;
+	int size = NODE_ENTRIES;
+
+	if( fileId < 0 )
+	{
+		return false;
+	}
+	sort( entries.begin(), entries.end(),
+		[ this ]( const IndexEntry &entryA, const IndexEntry &entryB )
+		{
+			return compareEntries( entryA, entryB ) < 0;
+		} );
+
+	pageCount = 1;
+	node.leaf = true;
+	node.link = 0;
+	uint32_t nodePage = pageCount++;
+	levelPages.push_back( nodePage );
+	for( unsigned int index = 0; index < entries.size(); index++ )
+	{
+		int entrySize = 2 + entries[ index ].key.size() + 8;
+		if( !node.entries.empty() && size + entrySize > INDEX_FILL_BYTES )
+		{
+			node.link = pageCount++;
+			success = writeNode( nodePage, node ) && success;
+			nodePage = node.link;
+			node.link = 0;
+			node.entries.clear();
+			size = NODE_ENTRIES;
+			levelPages.push_back( nodePage );
+			levelKeys.push_back( entries[ index ] );
+		}
+		node.entries.push_back( entries[ index ] );
+		size += entrySize;
+	}
+	success = writeNode( nodePage, node ) && success;
+
+	while( levelPages.size() > 1 )
+	{
+		vector< IndexEntry > upperKeys;
+		vector< uint32_t > upperPages;
+		node.leaf = false;
+		node.link = 0;
+		node.entries.clear();
+		node.children.assign( 1, levelPages[ 0 ] );
+		nodePage = pageCount++;
+		upperPages.push_back( nodePage );
+		size = NODE_ENTRIES;
+		for( unsigned int index = 1; index < levelPages.size(); index++ )
+		{
+			const IndexEntry &separator = levelKeys[ index - 1 ];
+			int entrySize = 2 + separator.key.size() + 8 + 4;
+			if( !node.entries.empty() && size + entrySize > INDEX_FILL_BYTES )
+			{
+				success = writeNode( nodePage, node ) && success;
+				nodePage = pageCount++;
+				upperPages.push_back( nodePage );
+				upperKeys.push_back( separator );
+				node.entries.clear();
+				node.children.assign( 1, levelPages[ index ] );
+				size = NODE_ENTRIES;
+				continue;
+			}
+			node.entries.push_back( separator );
+			node.children.push_back( levelPages[ index ] );
+			size += entrySize;
+		}
+		success = writeNode( nodePage, node ) && success;
+		levelPages.swap( upperPages );
+		levelKeys.swap( upperKeys );
+	}
+
+	rootPage = levelPages[ 0 ];
+	return writeHeader() && success;
+}
+
+/**
+ * @brief indexRange
+ *
+ * @details finds the row ids whose keys lie in a range
+ *
+ * @par Algorithm descends to the leaf holding the low end of the range and
+ *      walks the leaf chain until a key passes the high end
+ *
+ * @param [in] string *low low end, NULL for no low end
+ *
+ * @param [in] bool lowInclusive
+ *
+ * @param [in] string *high high end, NULL for no high end
+ *
+ * @param [in] bool highInclusive
+ *
+ * @param [out] vector< long > &rids in key order
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BTreeIndex::indexRange( const string *low, bool lowInclusive, const string *high,
+								bool highInclusive, vector< long > &rids )
+{
+	IndexNode node;
+	IndexEntry start;
+	uint32_t pageNo = rootPage;
+	rids.clear();
+
+	if( fileId < 0 )
+	{
+		return;
+	}
+	if( low != NULL )
+	{
+		start.key = *low;
+		start.rid = lowInclusive ? LONG_MIN : LONG_MAX;
+	}
+	while( readNode( pageNo, node ) && !node.leaf )
+	{
+		pageNo = node.children[ low != NULL ? childFor( node, start ) : 0 ];
+	}
+
+	while( node.leaf )
+	{
+		for( unsigned int index = 0; index < node.entries.size(); index++ )
+		{
+			const IndexEntry &entry = node.entries[ index ];
+			int compare;
+			if( low != NULL )
+			{
+				compare = compareKeys( entry.key, *low );
+				if( compare < 0 || ( compare == 0 && !lowInclusive ) )
+				{
+					continue;
+				}
+			}
+			if( high != NULL )
+			{
+				compare = compareKeys( entry.key, *high );
+				if( compare > 0 || ( compare == 0 && !highInclusive ) )
+				{
+					return;
+				}
+			}
+			rids.push_back( entry.rid );
+		}
+		if( node.link == 0 || !readNode( node.link, node ) )
+		{
+			return;
+		}
+	}
+}
+
+/**
+ * @brief indexCurrent
+ *
+ * @details checks whether the index was last brought up to date with the
+ *          table in its current state
+ *
+ * @param [in] TableSignature &signature
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool BTreeIndex::indexCurrent( const TableSignature &signature )
+{
+	return tableState.inode == signature.inode && tableState.size == signature.size &&
+			tableState.mtimeSec == signature.mtimeSec && tableState.mtimeNsec == signature.mtimeNsec;
+}
+
+/**
+ * @brief indexSetSignature
+ *
+ * @details records the table state the index matches
+ *
+ * @param [in] TableSignature *signature NULL marks the index out of date
+ *             while it is being changed
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BTreeIndex::indexSetSignature( const TableSignature *signature )
+{
+	if( signature == NULL )
+	{
+		memset( &tableState, 0, sizeof( tableState ) );
+	}
+	else
+	{
+		tableState = *signature;
+	}
+	writeHeader();
+}
+
+/**
+ * @brief compareKeys
+ *
+ * @details orders two keys the way the where condition orders their values
+ *
+ * @param [in] string &keyA
+ *
+ * @param [in] string &keyB
+ *
+ * @return int negative, zero or positive
+ *
+ * @note None
+ */
+int BTreeIndex::compareKeys( const string &keyA, const string &keyB )
+{
+	if( keyType == INDEX_INTEGER_KEYS )
+	{
+		long long valueA = 0;
+		long long valueB = 0;
+		memcpy( &valueA, keyA.data(), min( keyA.size(), sizeof( valueA ) ) );
+		memcpy( &valueB, keyB.data(), min( keyB.size(), sizeof( valueB ) ) );
+		return valueA < valueB ? -1 : ( valueA > valueB ? 1 : 0 );
+	}
+	if( keyType == INDEX_FLOAT_KEYS )
+	{
+		double valueA = 0;
+		double valueB = 0;
+		memcpy( &valueA, keyA.data(), min( keyA.size(), sizeof( valueA ) ) );
+		memcpy( &valueB, keyB.data(), min( keyB.size(), sizeof( valueB ) ) );
+		return valueA < valueB ? -1 : ( valueA > valueB ? 1 : 0 );
+	}
+	return keyA.compare( keyB );
+}
+
+/**
+ * @brief compareEntries
+ *
+ * @details orders two entries by key, then by row id
+ *
+ * @param [in] IndexEntry &entryA
+ *
+ * @param [in] IndexEntry &entryB
+ *
+ * @return int negative, zero or positive
+ *
+ * @note None
+ */
+int BTreeIndex::compareEntries( const IndexEntry &entryA, const IndexEntry &entryB )
+{
+	int compare = compareKeys( entryA.key, entryB.key );
+	if( compare != 0 )
+	{
+		return compare;
+	}
+	return entryA.rid < entryB.rid ? -1 : ( entryA.rid > entryB.rid ? 1 : 0 );
+}
+
+/**
+ * @brief readNode
+ *
+ * @details decodes one node page
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @param [out] IndexNode &node
+ *
+ * @return bool false if the page could not be read
+ *
+ * @note None
+ */
+bool BTreeIndex::readNode( uint32_t pageNo, IndexNode &node )
+{
+	int length;
+	node.leaf = false;
+	node.entries.clear();
+	node.children.clear();
+	if( pageNo == 0 || pageNo >= pageCount )
+	{
+		return false;
+	}
+	char *page = bufferPool.pinPage( fileId, pageNo, length );
+	if( page == NULL )
+	{
+		return false;
+	}
+
+	uint16_t entryCount;
+	uint32_t link;
+	node.leaf = page[ NODE_LEAF ] != 0;
+	memcpy( &entryCount, page + NODE_ENTRY_COUNT, sizeof( entryCount ) );
+	memcpy( &link, page + NODE_LINK, sizeof( link ) );
+	node.link = node.leaf ? link : 0;
+	if( !node.leaf )
+	{
+		node.children.push_back( link );
+	}
+
+	int offset = NODE_ENTRIES;
+	bool valid = true;
+	node.entries.resize( entryCount );
+	for( int index = 0; index < entryCount && valid; index++ )
+	{
+		IndexEntry &entry = node.entries[ index ];
+		uint16_t keyLength;
+		int64_t rid;
+		memcpy( &keyLength, page + offset, sizeof( keyLength ) );
+		offset += sizeof( keyLength );
+		valid = offset + keyLength + (int)sizeof( rid ) <= PAGE_SIZE;
+		if( valid )
+		{
+			entry.key.assign( page + offset, keyLength );
+			offset += keyLength;
+			memcpy( &rid, page + offset, sizeof( rid ) );
+			offset += sizeof( rid );
+			entry.rid = rid;
+		}
+		if( valid && !node.leaf )
+		{
+			memcpy( &link, page + offset, sizeof( link ) );
+			offset += sizeof( link );
+			node.children.push_back( link );
+		}
+	}
+	bufferPool.unpinPage( fileId, pageNo, false );
+	if( !valid )
+	{
+		node.leaf = true;
+		node.link = 0;
+		node.entries.clear();
+		node.children.clear();
+	}
+	return valid;
+}
+
+/**
+ * @brief writeNode
+ *
+ * @details encodes one node into its page
+ *
+ * @pre the node fits in a page
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @param [in] IndexNode &node
+ *
+ * @return bool false if every frame of the pool is pinned
+ *
+ * @note None
+ */
+bool BTreeIndex::writeNode( uint32_t pageNo, const IndexNode &node )
+{
+	int length;
+	char *page = bufferPool.pinPage( fileId, pageNo, length );
+	if( page == NULL )
+	{
+		return false;
+	}
+
+	uint16_t entryCount = node.entries.size();
+	uint32_t link = node.leaf ? node.link : node.children[ 0 ];
+	memset( page, 0, PAGE_SIZE );
+	page[ NODE_LEAF ] = node.leaf ? 1 : 0;
+	memcpy( page + NODE_ENTRY_COUNT, &entryCount, sizeof( entryCount ) );
+	memcpy( page + NODE_LINK, &link, sizeof( link ) );
+
+	int offset = NODE_ENTRIES;
+	for( unsigned int index = 0; index < node.entries.size(); index++ )
+	{
+		const IndexEntry &entry = node.entries[ index ];
+		uint16_t keyLength = entry.key.size();
+		int64_t rid = entry.rid;
+		memcpy( page + offset, &keyLength, sizeof( keyLength ) );
+		offset += sizeof( keyLength );
+		memcpy( page + offset, entry.key.data(), keyLength );
+		offset += keyLength;
+		memcpy( page + offset, &rid, sizeof( rid ) );
+		offset += sizeof( rid );
+		if( !node.leaf )
+		{
+			link = node.children[ index + 1 ];
+			memcpy( page + offset, &link, sizeof( link ) );
+			offset += sizeof( link );
+		}
+	}
+	bufferPool.unpinPage( fileId, pageNo, true );
+	return true;
+}
+
+/**
+ * @brief nodeSize
+ *
+ * @details returns the number of bytes a node takes in its page
+ *
+ * @param [in] IndexNode &node
+ *
+ * @return int
+ *
+ * @note None
+ */
+int BTreeIndex::nodeSize( const IndexNode &node )
+{
+	int size = NODE_ENTRIES;
+	for( unsigned int index = 0; index < node.entries.size(); index++ )
+	{
+		size += 2 + node.entries[ index ].key.size() + 8 + ( node.leaf ? 0 : 4 );
+	}
+	return size;
+}
+
+/**
+ * @brief writeHeader
+ *
+ * @details writes the header page with the root, page count and the
+ *          signature of the table
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool BTreeIndex::writeHeader()
+{
+	int length;
+	char *header = bufferPool.pinPage( fileId, 0, length );
+	if( header == NULL )
+	{
+		return false;
+	}
+
+	uint32_t version = INDEX_VERSION;
+	uint32_t numeric = keyType;
+	uint32_t attrLength = attributeName.size();
+	memset( header, 0, PAGE_SIZE );
+	memcpy( header + INDEX_HEADER_MAGIC, INDEX_MAGIC, 4 );
+	memcpy( header + INDEX_HEADER_VERSION, &version, sizeof( version ) );
+	memcpy( header + INDEX_HEADER_ROOT, &rootPage, sizeof( rootPage ) );
+	memcpy( header + INDEX_HEADER_PAGE_COUNT, &pageCount, sizeof( pageCount ) );
+	memcpy( header + INDEX_HEADER_NUMERIC, &numeric, sizeof( numeric ) );
+	memcpy( header + INDEX_HEADER_INODE, &tableState.inode, sizeof( tableState.inode ) );
+	memcpy( header + INDEX_HEADER_SIZE, &tableState.size, sizeof( tableState.size ) );
+	memcpy( header + INDEX_HEADER_MTIME_SEC, &tableState.mtimeSec, sizeof( tableState.mtimeSec ) );
+	memcpy( header + INDEX_HEADER_MTIME_NSEC, &tableState.mtimeNsec, sizeof( tableState.mtimeNsec ) );
+	memcpy( header + INDEX_HEADER_ATTR_LENGTH, &attrLength, sizeof( attrLength ) );
+	memcpy( header + INDEX_HEADER_ATTR_DATA, attributeName.data(), attrLength );
+	bufferPool.unpinPage( fileId, 0, true );
+	headerChanged = false;
+	return true;
+}
+
+/**
+ * @brief childFor
+ *
+ * @details picks the child of an inner node an entry belongs under
+ *
+ * @param [in] IndexNode &node
+ *
+ * @param [in] IndexEntry &entry
+ *
+ * @return unsigned int index of the child, the number of keys not above entry
+ *
+ * @note None
+ */
+unsigned int BTreeIndex::childFor( const IndexNode &node, const IndexEntry &entry )
+{
+	unsigned int low = 0;
+	unsigned int high = node.entries.size();
+	while( low < high )
+	{
+		unsigned int middle = ( low + high ) / 2;
+		if( compareEntries( node.entries[ middle ], entry ) <= 0 )
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/**
+ * @brief insertInto
+ *
+ * @details inserts an entry below the given node
+ *
+ * @par Algorithm a node that overflows its page keeps the lower half of its
+ *      bytes and moves the rest to a new page. A leaf copies the first key of
+ *      the new page up, an inner node moves its middle key up
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @param [in] IndexEntry &entry
+ *
+ * @param [out] IndexEntry &promoted key the parent has to add on a split
+ *
+ * @param [out] uint32_t &newPage page the parent has to add on a split
+ *
+ * @return bool true if the node was split
+ *
+ * @note None
+ */
+bool BTreeIndex::insertInto( uint32_t pageNo, const IndexEntry &entry, IndexEntry &promoted,
+								uint32_t &newPage )
+{
+	IndexNode node;
+	if( !readNode( pageNo, node ) )
+	{
+		return false;
+	}
+
+	if( node.leaf )
+	{
+		unsigned int position = 0;
+		while( position < node.entries.size() && compareEntries( node.entries[ position ], entry ) < 0 )
+		{
+			position++;
+		}
+		if( position < node.entries.size() && compareEntries( node.entries[ position ], entry ) == 0 )
+		{
+			return false;
+		}
+		node.entries.insert( node.entries.begin() + position, entry );
+	}
+	else
+	{
+		unsigned int child = childFor( node, entry );
+		IndexEntry childPromoted;
+		uint32_t childPage;
+		if( !insertInto( node.children[ child ], entry, childPromoted, childPage ) )
+		{
+			return false;
+		}
+		node.entries.insert( node.entries.begin() + child, childPromoted );
+		node.children.insert( node.children.begin() + child + 1, childPage );
+	}
+
+	int size = nodeSize( node );
+	if( size <= PAGE_SIZE )
+	{
+		writeNode( pageNo, node );
+		return false;
+	}
+
+	//split at the entry that passes half of the bytes
+	unsigned int middle = 0;
+	int leftSize = NODE_ENTRIES;
+	while( middle < node.entries.size() - 1 && leftSize < size / 2 )
+	{
+		leftSize += 2 + node.entries[ middle ].key.size() + 8 + ( node.leaf ? 0 : 4 );
+		middle++;
+	}
+	if( middle == 0 )
+	{
+		middle = 1;
+	}
+
+	IndexNode right;
+	right.leaf = node.leaf;
+	right.link = 0;
+	newPage = pageCount++;
+	headerChanged = true;
+	if( node.leaf )
+	{
+		right.entries.assign( node.entries.begin() + middle, node.entries.end() );
+		right.link = node.link;
+		node.link = newPage;
+		promoted = right.entries[ 0 ];
+	}
+	else
+	{
+		promoted = node.entries[ middle ];
+		right.entries.assign( node.entries.begin() + middle + 1, node.entries.end() );
+		right.children.assign( node.children.begin() + middle + 1, node.children.end() );
+		node.children.resize( middle + 1 );
+	}
+	node.entries.resize( middle );
+	writeNode( pageNo, node );
+	writeNode( newPage, right );
+	return true;
+}
+
+/**
+ * @brief TableIndexes default constructor
+ *
+ * @details a new set has no indexes open
+ *
+ * @note None
+ */
+TableIndexes::TableIndexes()
+{
+	changed = false;
+}
+
+/**
+ * @brief TableIndexes default destructor
+ *
+ * @details closes the indexes, leaving changed ones marked out of date
+ *
+ * @note None
+ */
+TableIndexes::~TableIndexes()
+{
+	indexesClose( false );
+}
+
+/**
+ * @brief indexesOpen
+ *
+ * @details opens every index of a table
+ *
+ * @post indexes that do not match the table any more are rebuilt
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] vector< Attribute > *attributes columns of the table, NULL
+ *             to read them from the table
+ *
+ * @return bool false if the table has no index
+ *
+ * @note None
+ */
+bool TableIndexes::indexesOpen( string tablePath, const vector< Attribute > *attributes )
+{
+	if( indexedTable == tablePath )
+	{
+		return !indexes.empty();
+	}
+	indexesClose( false );
+	indexedTable = tablePath;
+
+	vector< string > indexNames;
+	tableIndexNames( tablePath, indexNames );
+	TableSignature signature;
+	if( indexNames.empty() || !tableSignatureOf( tablePath, signature ) )
+	{
+		return false;
+	}
+
+	vector< Attribute > tableAttributes;
+	if( attributes == NULL )
+	{
+		TableScan scan;
+		if( !scan.scanOpen( tablePath ) )
+		{
+			return false;
+		}
+		tableAttributes = scan.attributes;
+		attributes = &tableAttributes;
+	}
+
+	for( unsigned int index = 0; index < indexNames.size(); index++ )
+	{
+		BTreeIndex *tableIndex = new BTreeIndex;
+		tableIndex->indexName = indexNames[ index ];
+		if( tableIndex->indexOpen( indexFilePath( tablePath, indexNames[ index ] ) ) )
+		{
+			tableIndex->attributeIndex = findAttrOccur( *attributes, tableIndex->attributeName );
+		}
+		if( tableIndex->attributeIndex < 0 )
+		{
+			delete tableIndex;
+			continue;
+		}
+		//an index written before its column type got its own keys is
+		//rebuilt with them like an index that missed a change
+		IndexKeyType keys = indexKeyTypeOf( ( *attributes )[ tableIndex->attributeIndex ] );
+		if( tableIndex->keyType != keys || !tableIndex->indexCurrent( signature ) )
+		{
+			tableIndex->keyType = keys;
+			if( !buildIndex( tablePath, *tableIndex ) )
+			{
+				delete tableIndex;
+				continue;
+			}
+			tableIndex->indexSetSignature( &signature );
+		}
+		indexes.push_back( tableIndex );
+	}
+	return !indexes.empty();
+}
+
+/**
+ * @brief indexesActive
+ *
+ * @details checks whether any index of the table is open
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool TableIndexes::indexesActive()
+{
+	return !indexes.empty();
+}
+
+/**
+ * @brief indexOn
+ *
+ * @details returns the index on a column
+ *
+ * @param [in] int attributeIndex
+ *
+ * @return BTreeIndex * NULL if the column has no index
+ *
+ * @note None
+ */
+BTreeIndex *TableIndexes::indexOn( int attributeIndex )
+{
+	for( unsigned int index = 0; index < indexes.size(); index++ )
+	{
+		if( indexes[ index ]->attributeIndex == attributeIndex )
+		{
+			return indexes[ index ];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief rowInserted
+ *
+ * @details adds a new row to every index
+ *
+ * @param [in] vector< string > &row
+ *
+ * @param [in] long rid
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableIndexes::rowInserted( const vector< string > &row, long rid )
+{
+	string key;
+	startChange();
+	for( unsigned int index = 0; index < indexes.size(); index++ )
+	{
+		if( indexes[ index ]->indexKey( row[ indexes[ index ]->attributeIndex ], key ) )
+		{
+			indexes[ index ]->indexInsert( key, rid );
+		}
+	}
+}
+
+/**
+ * @brief rowDeleted
+ *
+ * @details removes a deleted row from every index
+ *
+ * @param [in] vector< string > &row the row as it was stored
+ *
+ * @param [in] long rid
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableIndexes::rowDeleted( const vector< string > &row, long rid )
+{
+	string key;
+	startChange();
+	for( unsigned int index = 0; index < indexes.size(); index++ )
+	{
+		if( indexes[ index ]->indexKey( row[ indexes[ index ]->attributeIndex ], key ) )
+		{
+			indexes[ index ]->indexRemove( key, rid );
+		}
+	}
+}
+
+/**
+ * @brief rowUpdated
+ *
+ * @details moves an updated row in every index whose key or row id changed
+ *
+ * @param [in] vector< string > &oldRow
+ *
+ * @param [in] long oldRid
+ *
+ * @param [in] vector< string > &newRow
+ *
+ * @param [in] long newRid
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableIndexes::rowUpdated( const vector< string > &oldRow, long oldRid,
+								const vector< string > &newRow, long newRid )
+{
+	string oldKey;
+	string newKey;
+	startChange();
+	for( unsigned int index = 0; index < indexes.size(); index++ )
+	{
+		BTreeIndex *tableIndex = indexes[ index ];
+		bool oldIndexed = tableIndex->indexKey( oldRow[ tableIndex->attributeIndex ], oldKey );
+		bool newIndexed = tableIndex->indexKey( newRow[ tableIndex->attributeIndex ], newKey );
+		if( oldIndexed && newIndexed && oldRid == newRid && oldKey == newKey )
+		{
+			continue;
+		}
+		if( oldIndexed )
+		{
+			tableIndex->indexRemove( oldKey, oldRid );
+		}
+		if( newIndexed )
+		{
+			tableIndex->indexInsert( newKey, newRid );
+		}
+	}
+}
+
+/**
+ * @brief indexesClose
+ *
+ * @details closes every index of the table
+ *
+ * @pre the changes to the table itself were written
+ *
+ * @param [in] bool tableCurrent true if the table holds every change the
+ *             indexes were given, otherwise changed indexes stay out of date
+ *             and are rebuilt when they are opened next
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableIndexes::indexesClose( bool tableCurrent )
+{
+	TableSignature signature;
+	bool recordSignature = changed && tableCurrent && tableSignatureOf( indexedTable, signature );
+	for( unsigned int index = 0; index < indexes.size(); index++ )
+	{
+		if( recordSignature )
+		{
+			indexes[ index ]->indexSetSignature( &signature );
+		}
+		delete indexes[ index ];
+	}
+	indexes.clear();
+	indexedTable.clear();
+	changed = false;
+}
+
+/**
+ * @brief startChange
+ *
+ * @details marks the indexes out of date before the first change, so a
+ *          statement that does not finish leaves them to be rebuilt
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableIndexes::startChange()
+{
+	if( changed )
+	{
+		return;
+	}
+	for( unsigned int index = 0; index < indexes.size(); index++ )
+	{
+		indexes[ index ]->indexSetSignature( NULL );
+	}
+	changed = true;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
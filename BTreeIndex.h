@@ -0,0 +1,155 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file BTreeIndex.h
+ *
+ * @brief Definition file for BTreeIndex and TableIndexes classes
+ *
+ * @details Specifies all member methods of the BTreeIndex class, an on-disk
+ *          B+tree over one column of a table, and of TableIndexes, the set
+ *          of indexes a statement keeps in sync with the table it changes
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <sys/types.h>
+#include "BufferPool.h"
+#include "Table.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef BTREEINDEX_H
+#define BTREEINDEX_H
+
+//index files are kept next to their table as .<table>.<index>.idx
+const string INDEX_SUFFIX = ".idx";
+const char INDEX_MAGIC[] = "BTIX";
+const uint32_t INDEX_VERSION = 1;
+
+//header page layout, the table signature is the state of the table the
+//index was last brought up to date with
+const int INDEX_HEADER_MAGIC = 0;
+const int INDEX_HEADER_VERSION = 4;
+const int INDEX_HEADER_ROOT = 8;
+const int INDEX_HEADER_PAGE_COUNT = 12;
+const int INDEX_HEADER_NUMERIC = 16;
+const int INDEX_HEADER_INODE = 24;
+const int INDEX_HEADER_SIZE = 32;
+const int INDEX_HEADER_MTIME_SEC = 40;
+const int INDEX_HEADER_MTIME_NSEC = 48;
+const int INDEX_HEADER_ATTR_LENGTH = 56;
+const int INDEX_HEADER_ATTR_DATA = 60;
+
+//node page layout, entries follow the node header back to back
+const int NODE_LEAF = 0;
+const int NODE_ENTRY_COUNT = 2;
+const int NODE_LINK = 4;
+const int NODE_ENTRIES = 8;
+
+//how the keys of an index compare, the column type decides it and the
+//header records it
+enum IndexKeyType{
+	INDEX_TEXT_KEYS,
+	INDEX_FLOAT_KEYS,
+	INDEX_INTEGER_KEYS
+};
+
+//longer text keys are indexed by their prefix
+const unsigned int INDEX_MAX_KEY = 1000;
+
+//a bulk loaded node is filled up to this many bytes
+const int INDEX_FILL_BYTES = PAGE_SIZE * 9 / 10;
+
+//one key of the tree, a row id makes equal column values unique
+struct IndexEntry{
+	string key;
+	long rid;
+};
+
+//a node decoded from its page, leaves link to the next leaf and inner
+//nodes hold one child more than they hold keys
+struct IndexNode{
+	bool leaf;
+	uint32_t link;
+	vector< IndexEntry > entries;
+	vector< uint32_t > children;
+};
+
+//stat of a table file, any change to the table changes it
+struct TableSignature{
+	uint64_t inode;
+	int64_t size;
+	int64_t mtimeSec;
+	int64_t mtimeNsec;
+};
+
+class BTreeIndex{
+	public:
+		string indexName;
+		string attributeName;
+		int attributeIndex;
+		IndexKeyType keyType;
+
+		BTreeIndex();
+		~BTreeIndex();
+
+		bool indexCreate( string filePath, string attrName, IndexKeyType keys );
+		bool indexOpen( string filePath );
+		void indexClose();
+
+		bool indexKey( const string &cell, string &key );
+		bool indexInsert( const string &key, long rid );
+		bool indexRemove( const string &key, long rid );
+		bool indexBuild( vector< IndexEntry > &entries );
+		void indexRange( const string *low, bool lowInclusive, const string *high,
+							bool highInclusive, vector< long > &rids );
+
+		bool indexCurrent( const TableSignature &signature );
+		void indexSetSignature( const TableSignature *signature );
+
+	private:
+		int fileId;
+		uint32_t rootPage;
+		uint32_t pageCount;
+		bool headerChanged;
+		TableSignature tableState;
+
+		int compareKeys( const string &keyA, const string &keyB );
+		int compareEntries( const IndexEntry &entryA, const IndexEntry &entryB );
+		bool readNode( uint32_t pageNo, IndexNode &node );
+		bool writeNode( uint32_t pageNo, const IndexNode &node );
+		int nodeSize( const IndexNode &node );
+		bool writeHeader();
+		unsigned int childFor( const IndexNode &node, const IndexEntry &entry );
+		bool insertInto( uint32_t pageNo, const IndexEntry &entry, IndexEntry &promoted,
+							uint32_t &newPage );
+};
+
+class TableIndexes{
+	public:
+		TableIndexes();
+		~TableIndexes();
+
+		bool indexesOpen( string tablePath, const vector< Attribute > *attributes );
+		bool indexesActive();
+		BTreeIndex *indexOn( int attributeIndex );
+		void rowInserted( const vector< string > &row, long rid );
+		void rowDeleted( const vector< string > &row, long rid );
+		void rowUpdated( const vector< string > &oldRow, long oldRid,
+							const vector< string > &newRow, long newRid );
+		void indexesClose( bool tableCurrent );
+
+	private:
+		string indexedTable;
+		vector< BTreeIndex * > indexes;
+		bool changed;
+
+		void startChange();
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
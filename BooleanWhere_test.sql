@@ -0,0 +1,37 @@
+--CS457 boolean where clauses
+
+--AND binds tighter than OR, NOT applies to the comparison after it, parentheses group
+
+CREATE DATABASE BoolWhere;
+USE BoolWhere;
+
+create table Product (pid int, name varchar(20), price float, stock int);
+insert into Product values(1, 'Gizmo', 19.99, 5);
+insert into Product values(2, 'PowerGizmo', 29.99, 0);
+insert into Product values(3, 'SingleTouch', 149.99, 12);
+insert into Product values(4, 'MultiTouch', 199.99, 3);
+insert into Product values(5, 'SuperGizmo', 49.99, 7);
+
+select * from Product where price > 20 and stock > 0;
+select * from Product where price < 20 or price > 150;
+select * from Product where pid = 1 or pid = 2 and stock > 0;
+select * from Product where (pid = 1 or pid = 2) and stock > 0;
+select * from Product where not stock = 0;
+select * from Product where not (price > 100 or stock = 0);
+select name from Product where price >= 29.99 and price <= 149.99 and not name = 'SingleTouch';
+SELECT * FROM Product WHERE stock > 0 AND NOT price > 100;
+select * from Product where price>=29.99;
+select name from Product where name='Gizmo';
+select * from Product where stock<5 and(price>100 or pid!=1);
+
+update Product set stock = 1 where stock = 0 or (price > 190 and stock < 5);
+delete from Product where name = 'Gizmo' or name = 'SuperGizmo';
+select * from Product;
+
+select * from Product where price > 20 and;
+select * from Product where (price > 20;
+select * from Product where price > 20 or or stock = 1;
+select * from Product where not;
+
+DROP DATABASE BoolWhere;
+.EXIT
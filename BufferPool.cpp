@@ -0,0 +1,777 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file BufferPool.cpp
+ *
+ * @brief Implementation file for BufferPool class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the process wide buffer pool. Table files are read in
+ *          PAGE_SIZE blocks that stay cached between statements, up to a
+ *          memory budget, and frames are evicted with the clock algorithm.
+ *          A cached file is dropped when its inode, size or modification
+ *          time shows that it was changed outside the pool
+ *
+ * @Note Requires BufferPool.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "BufferPool.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef BUFFERPOOL_CPP
+#define BUFFERPOOL_CPP
+
+BufferPool bufferPool;
+
+/**
+ * @brief pageKey
+ *
+ * @details combines a file id and page number into a page table key
+ *
+ * @param [in] int fileId
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @return uint64_t
+ *
+ * @note None
+ */
+inline uint64_t pageKey( int fileId, uint32_t pageNo )
+{
+	return ( (uint64_t)fileId << 32 ) | pageNo;
+}
+
+/**
+ * @brief BufferPool default constructor
+ *
+ * @details starts with no frames and the default budget, frames are
+ *          allocated as pages are first read
+ *
+ * @note None
+ */
+BufferPool::BufferPool()
+{
+	poolHits = 0;
+	poolMisses = 0;
+	poolEvictions = 0;
+	budgetBytes = DEFAULT_POOL_BYTES;
+	clockHand = 0;
+}
+
+/**
+ * @brief BufferPool default destructor
+ *
+ * @details writes back dirty frames and frees all frame memory
+ *
+ * @note None
+ */
+BufferPool::~BufferPool()
+{
+	for( unsigned int index = 0; index < frames.size(); index++ )
+	{
+		if( frames[ index ].valid && frames[ index ].dirty )
+		{
+			writeFrame( frames[ index ] );
+		}
+		delete [] frames[ index ].data;
+	}
+	for( unsigned int index = 0; index < files.size(); index++ )
+	{
+		if( files[ index ].fd >= 0 )
+		{
+			close( files[ index ].fd );
+		}
+	}
+}
+
+/**
+ * @brief poolSetBudget
+ *
+ * @details sets how much memory the pool may use for frames
+ *
+ * @post if the pool shrinks, unpinned frames past the budget are written
+ *       back and freed
+ *
+ * @param [in] long bytes
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BufferPool::poolSetBudget( long bytes )
+{
+	budgetBytes = bytes < MIN_POOL_BYTES ? MIN_POOL_BYTES : bytes;
+	unsigned int maxFrames = budgetBytes / PAGE_SIZE;
+	if( frames.size() <= maxFrames )
+	{
+		return;
+	}
+
+	vector< PoolFrame > kept;
+	for( unsigned int index = 0; index < frames.size(); index++ )
+	{
+		PoolFrame &frame = frames[ index ];
+		if( frame.pinCount > 0 || ( kept.size() < maxFrames && frame.valid ) )
+		{
+			kept.push_back( frame );
+			continue;
+		}
+		if( frame.valid && frame.dirty )
+		{
+			writeFrame( frame );
+		}
+		delete [] frame.data;
+	}
+
+	frames = kept;
+	pageTable.clear();
+	for( unsigned int index = 0; index < frames.size(); index++ )
+	{
+		pageTable[ pageKey( frames[ index ].fileId, frames[ index ].pageNo ) ] = index;
+	}
+	clockHand = 0;
+}
+
+/**
+ * @brief poolGetBudget
+ *
+ * @details returns the frame memory budget in bytes
+ *
+ * @return long
+ *
+ * @note None
+ */
+long BufferPool::poolGetBudget()
+{
+	return budgetBytes;
+}
+
+/**
+ * @brief poolOpenFile
+ *
+ * @details registers a file with the pool and checks its cached pages
+ *
+ * @pre none
+ *
+ * @post cached pages of the file are dropped if it changed on disk
+ *
+ * @par Algorithm files keep their id for the life of the process, so pages
+ *      cached by one statement are found again by the next
+ *
+ * @param [in] string filePath
+ *
+ * @return int file id, -1 if the file does not exist
+ *
+ * @note None
+ */
+int BufferPool::poolOpenFile( string filePath )
+{
+	int fileId;
+	map< string, int >::iterator found = fileIds.find( filePath );
+	if( found == fileIds.end() )
+	{
+		PoolFile file;
+		file.filePath = filePath;
+		file.fd = -1;
+		file.openCount = 0;
+		file.inode = 0;
+		file.size = -1;
+		file.mtimeSec = 0;
+		file.mtimeNsec = 0;
+		fileId = files.size();
+		files.push_back( file );
+		fileIds[ filePath ] = fileId;
+	}
+	else
+	{
+		fileId = found->second;
+	}
+
+	PoolFile &file = files[ fileId ];
+	if( file.openCount == 0 )
+	{
+		if( !signatureMatches( file ) )
+		{
+			dropFrames( fileId );
+		}
+		if( file.fd >= 0 )
+		{
+			close( file.fd );
+		}
+		file.fd = open( filePath.c_str(), O_RDWR );
+		if( file.fd < 0 )
+		{
+			file.fd = open( filePath.c_str(), O_RDONLY );
+		}
+		if( file.fd < 0 )
+		{
+			return -1;
+		}
+		recordSignature( file );
+	}
+	file.openCount++;
+	return fileId;
+}
+
+/**
+ * @brief poolCloseFile
+ *
+ * @details writes back the dirty pages of a file and releases it
+ *
+ * @post pages stay cached for the next statement
+ *
+ * @param [in] int fileId
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BufferPool::poolCloseFile( int fileId )
+{
+	if( fileId < 0 || fileId >= (int)files.size() || files[ fileId ].openCount == 0 )
+	{
+		return;
+	}
+	flushFile( fileId );
+	PoolFile &file = files[ fileId ];
+	file.openCount--;
+	if( file.openCount == 0 && file.fd >= 0 )
+	{
+		close( file.fd );
+		file.fd = -1;
+	}
+}
+
+/**
+ * @brief pinPage
+ *
+ * @details returns the frame holding a page, reading it on a miss
+ *
+ * @pre the file is open in the pool
+ *
+ * @post the frame stays in memory until unpinPage
+ *
+ * @par Algorithm pages past the end of the file come back zero filled with
+ *      length 0 so they can be formatted and written
+ *
+ * @param [in] int fileId
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @param [out] int &length number of valid bytes in the page
+ *
+ * @return char* page data, NULL if every frame is pinned
+ *
+ * @note None
+ */
+char *BufferPool::pinPage( int fileId, uint32_t pageNo, int &length )
+{
+	uint64_t key = pageKey( fileId, pageNo );
+	map< uint64_t, int >::iterator found = pageTable.find( key );
+	if( found != pageTable.end() )
+	{
+		PoolFrame &frame = frames[ found->second ];
+		poolHits++;
+		frame.pinCount++;
+		frame.referenced = true;
+		length = frame.length;
+		return frame.data;
+	}
+
+	poolMisses++;
+	int victim = findVictim();
+	if( victim < 0 )
+	{
+		return NULL;
+	}
+
+	PoolFrame &frame = frames[ victim ];
+	if( frame.valid )
+	{
+		if( frame.dirty )
+		{
+			writeFrame( frame );
+		}
+		pageTable.erase( pageKey( frame.fileId, frame.pageNo ) );
+		poolEvictions++;
+	}
+
+	ssize_t bytesRead = pread( files[ fileId ].fd, frame.data, PAGE_SIZE, (off_t)pageNo * PAGE_SIZE );
+	if( bytesRead < 0 )
+	{
+		bytesRead = 0;
+	}
+	memset( frame.data + bytesRead, 0, PAGE_SIZE - bytesRead );
+
+	frame.fileId = fileId;
+	frame.pageNo = pageNo;
+	frame.length = bytesRead;
+	frame.pinCount = 1;
+	frame.dirty = false;
+	frame.referenced = true;
+	frame.valid = true;
+	pageTable[ key ] = victim;
+
+	length = frame.length;
+	return frame.data;
+}
+
+/**
+ * @brief unpinPage
+ *
+ * @details releases a page returned by pinPage
+ *
+ * @param [in] int fileId
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @param [in] bool dirty true if the whole page was changed and must be written
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BufferPool::unpinPage( int fileId, uint32_t pageNo, bool dirty )
+{
+	map< uint64_t, int >::iterator found = pageTable.find( pageKey( fileId, pageNo ) );
+	if( found == pageTable.end() )
+	{
+		return;
+	}
+	PoolFrame &frame = frames[ found->second ];
+	if( frame.pinCount > 0 )
+	{
+		frame.pinCount--;
+	}
+	if( dirty )
+	{
+		frame.dirty = true;
+		frame.length = PAGE_SIZE;
+	}
+}
+
+/**
+ * @brief flushFile
+ *
+ * @details writes every dirty page of a file back to disk
+ *
+ * @param [in] int fileId
+ *
+ * @return bool false if a write failed
+ *
+ * @note None
+ */
+bool BufferPool::flushFile( int fileId )
+{
+	bool success = true;
+	bool written = false;
+	for( unsigned int index = 0; index < frames.size(); index++ )
+	{
+		if( frames[ index ].valid && frames[ index ].dirty && frames[ index ].fileId == fileId )
+		{
+			success = writeFrame( frames[ index ] ) && success;
+			written = true;
+		}
+	}
+	if( written )
+	{
+		recordSignature( files[ fileId ] );
+	}
+	return success;
+}
+
+/**
+ * @brief syncFile
+ *
+ * @details writes every dirty page of a file back and waits until the file
+ *          is on disk
+ *
+ * @param [in] int fileId
+ *
+ * @return bool false if a write or the sync failed
+ *
+ * @note None
+ */
+bool BufferPool::syncFile( int fileId )
+{
+	if( !flushFile( fileId ) )
+	{
+		return false;
+	}
+	return files[ fileId ].fd >= 0 && fsync( files[ fileId ].fd ) == 0;
+}
+
+/**
+ * @brief outputStatistics
+ *
+ * @details outputs the hit, miss and eviction counters of the pool
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BufferPool::outputStatistics()
+{
+	cout << "-- Buffer pool: " << poolHits << " hits, " << poolMisses << " misses, ";
+	cout << poolEvictions << " evictions, " << frames.size() << " of ";
+	cout << budgetBytes / PAGE_SIZE << " frames used." << endl;
+}
+
+/**
+ * @brief findVictim
+ *
+ * @details picks the frame the next page is read into
+ *
+ * @par Algorithm a new frame is allocated while the budget allows it,
+ *      otherwise the clock hand sweeps the frames, clearing reference bits,
+ *      until it finds an unpinned frame that was not used since the last sweep
+ *
+ * @return int frame index, -1 if every frame is pinned
+ *
+ * @note None
+ */
+int BufferPool::findVictim()
+{
+	if( (long)frames.size() < budgetBytes / PAGE_SIZE )
+	{
+		PoolFrame frame;
+		frame.fileId = -1;
+		frame.pageNo = 0;
+		frame.data = new char[ PAGE_SIZE ];
+		frame.length = 0;
+		frame.pinCount = 0;
+		frame.dirty = false;
+		frame.referenced = false;
+		frame.valid = false;
+		frames.push_back( frame );
+		return frames.size() - 1;
+	}
+
+	unsigned int numFrames = frames.size();
+	for( unsigned int sweep = 0; sweep < 2 * numFrames; sweep++ )
+	{
+		unsigned int index = clockHand;
+		clockHand = ( clockHand + 1 ) % numFrames;
+
+		PoolFrame &frame = frames[ index ];
+		if( !frame.valid )
+		{
+			return index;
+		}
+		if( frame.pinCount > 0 )
+		{
+			continue;
+		}
+		if( frame.referenced )
+		{
+			frame.referenced = false;
+			continue;
+		}
+		return index;
+	}
+	return -1;
+}
+
+/**
+ * @brief writeFrame
+ *
+ * @details writes a dirty frame to its file
+ *
+ * @param [in] PoolFrame &frame
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool BufferPool::writeFrame( PoolFrame &frame )
+{
+	PoolFile &file = files[ frame.fileId ];
+	int fd = file.fd;
+	bool ownDescriptor = false;
+	if( fd < 0 )
+	{
+		fd = open( file.filePath.c_str(), O_RDWR );
+		ownDescriptor = true;
+	}
+	bool success = fd >= 0 &&
+		pwrite( fd, frame.data, frame.length, (off_t)frame.pageNo * PAGE_SIZE ) == frame.length;
+	if( ownDescriptor && fd >= 0 )
+	{
+		close( fd );
+	}
+	frame.dirty = false;
+	return success;
+}
+
+/**
+ * @brief dropFrames
+ *
+ * @details forgets every cached page of a file
+ *
+ * @param [in] int fileId
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BufferPool::dropFrames( int fileId )
+{
+	for( unsigned int index = 0; index < frames.size(); index++ )
+	{
+		if( frames[ index ].valid && frames[ index ].fileId == fileId && frames[ index ].pinCount == 0 )
+		{
+			pageTable.erase( pageKey( fileId, frames[ index ].pageNo ) );
+			frames[ index ].valid = false;
+			frames[ index ].dirty = false;
+		}
+	}
+}
+
+/**
+ * @brief recordSignature
+ *
+ * @details remembers the inode, size and modification time of a file
+ *
+ * @param [in] PoolFile &file
+ *
+ * @return None
+ *
+ * @note None
+ */
+void BufferPool::recordSignature( PoolFile &file )
+{
+	struct stat buffer;
+	if( stat( file.filePath.c_str(), &buffer ) != 0 )
+	{
+		file.size = -1;
+		return;
+	}
+	file.inode = buffer.st_ino;
+	file.size = buffer.st_size;
+	file.mtimeSec = buffer.st_mtim.tv_sec;
+	file.mtimeNsec = buffer.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief signatureMatches
+ *
+ * @details checks that a file was not changed since its signature was taken
+ *
+ * @param [in] PoolFile &file
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool BufferPool::signatureMatches( PoolFile &file )
+{
+	struct stat buffer;
+	if( file.size < 0 || stat( file.filePath.c_str(), &buffer ) != 0 )
+	{
+		return false;
+	}
+	return file.inode == buffer.st_ino && file.size == buffer.st_size &&
+			file.mtimeSec == buffer.st_mtim.tv_sec && file.mtimeNsec == buffer.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief PoolReader default constructor
+ *
+ * @details a new reader is not attached to any file
+ *
+ * @note None
+ */
+PoolReader::PoolReader()
+{
+	fileId = -1;
+	pageNo = 0;
+	page = NULL;
+	length = 0;
+	offset = 0;
+	endOfFile = false;
+}
+
+/**
+ * @brief PoolReader default destructor
+ *
+ * @details releases the pinned page and the file
+ *
+ * @note None
+ */
+PoolReader::~PoolReader()
+{
+	readerClose();
+}
+
+/**
+ * @brief readerOpen
+ *
+ * @details opens a text table file for reading through the buffer pool
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if the file does not exist
+ *
+ * @note None
+ */
+bool PoolReader::readerOpen( string filePath )
+{
+	readerClose();
+	fileId = bufferPool.poolOpenFile( filePath );
+	pageNo = 0;
+	offset = 0;
+	endOfFile = false;
+	return fileId >= 0;
+}
+
+/**
+ * @brief readLine
+ *
+ * @details reads the next line of the file, without its newline
+ *
+ * @par Algorithm pages are pinned one at a time and lines that cross a page
+ *      boundary are joined
+ *
+ * @param [out] string &line
+ *
+ * @return bool false at the end of the file
+ *
+ * @note None
+ */
+bool PoolReader::readLine( string &line )
+{
+	bool readSomething = false;
+	line.clear();
+
+	while( fileId >= 0 && !endOfFile )
+	{
+		if( page == NULL )
+		{
+			page = bufferPool.pinPage( fileId, pageNo, length );
+			offset = 0;
+			if( page == NULL || length == 0 )
+			{
+				if( page != NULL )
+				{
+					bufferPool.unpinPage( fileId, pageNo, false );
+					page = NULL;
+				}
+				endOfFile = true;
+				break;
+			}
+		}
+
+		if( offset < length )
+		{
+			const char *start = page + offset;
+			const char *newLine = (const char *)memchr( start, '\n', length - offset );
+			if( newLine != NULL )
+			{
+				line.append( start, newLine - start );
+				offset = newLine - page + 1;
+				return true;
+			}
+			line.append( start, length - offset );
+			readSomething = true;
+		}
+
+		//page used up, move on unless it was the last one
+		bufferPool.unpinPage( fileId, pageNo, false );
+		page = NULL;
+		if( length < PAGE_SIZE )
+		{
+			endOfFile = true;
+		}
+		pageNo++;
+	}
+	return readSomething;
+}
+
+/**
+ * @brief readerTell
+ *
+ * @details returns the offset of the next byte readLine reads
+ *
+ * @return off_t
+ *
+ * @note None
+ */
+off_t PoolReader::readerTell()
+{
+	return (off_t)pageNo * PAGE_SIZE + ( page == NULL ? 0 : offset );
+}
+
+/**
+ * @brief readerSeek
+ *
+ * @details moves the reader to an offset of the file, so a row found
+ *          through an index is read without reading the rows before it
+ *
+ * @param [in] off_t position
+ *
+ * @return bool false if the position lies past the end of the file
+ *
+ * @note None
+ */
+bool PoolReader::readerSeek( off_t position )
+{
+	if( fileId < 0 || position < 0 )
+	{
+		return false;
+	}
+	if( page != NULL )
+	{
+		bufferPool.unpinPage( fileId, pageNo, false );
+		page = NULL;
+	}
+	pageNo = position / PAGE_SIZE;
+	page = bufferPool.pinPage( fileId, pageNo, length );
+	offset = position % PAGE_SIZE;
+	endOfFile = false;
+	if( page != NULL && offset < length )
+	{
+		return true;
+	}
+	if( page != NULL )
+	{
+		bufferPool.unpinPage( fileId, pageNo, false );
+		page = NULL;
+	}
+	endOfFile = true;
+	return false;
+}
+
+/**
+ * @brief readerClose
+ *
+ * @details releases the pinned page and the file
+ *
+ * @return None
+ *
+ * @note None
+ */
+void PoolReader::readerClose()
+{
+	if( page != NULL )
+	{
+		bufferPool.unpinPage( fileId, pageNo, false );
+		page = NULL;
+	}
+	if( fileId >= 0 )
+	{
+		bufferPool.poolCloseFile( fileId );
+		fileId = -1;
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,110 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file BufferPool.h
+ *
+ * @brief Definition file for BufferPool class
+ *
+ * @details Specifies all member methods of the BufferPool class, the process
+ *          wide page cache every table file is read through
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <stdint.h>
+#include <sys/types.h>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+const int PAGE_SIZE = 4096;
+const long DEFAULT_POOL_BYTES = 64L * 1024 * 1024;
+const long MIN_POOL_BYTES = 16L * PAGE_SIZE;
+
+struct PoolFrame{
+	int fileId;
+	uint32_t pageNo;
+	char *data;
+	int length;
+	int pinCount;
+	bool dirty;
+	bool referenced;
+	bool valid;
+};
+
+struct PoolFile{
+	string filePath;
+	int fd;
+	int openCount;
+	//stat signature of the file when its frames were last known to be current
+	ino_t inode;
+	off_t size;
+	long mtimeSec;
+	long mtimeNsec;
+};
+
+class BufferPool{
+	public:
+		long poolHits;
+		long poolMisses;
+		long poolEvictions;
+
+		BufferPool();
+		~BufferPool();
+
+		void poolSetBudget( long bytes );
+		long poolGetBudget();
+		int poolOpenFile( string filePath );
+		void poolCloseFile( int fileId );
+		char *pinPage( int fileId, uint32_t pageNo, int &length );
+		void unpinPage( int fileId, uint32_t pageNo, bool dirty );
+		bool flushFile( int fileId );
+		bool syncFile( int fileId );
+		void outputStatistics();
+
+	private:
+		long budgetBytes;
+		vector< PoolFrame > frames;
+		map< uint64_t, int > pageTable;
+		map< string, int > fileIds;
+		vector< PoolFile > files;
+		unsigned int clockHand;
+
+		int findVictim();
+		bool writeFrame( PoolFrame &frame );
+		void dropFrames( int fileId );
+		void recordSignature( PoolFile &file );
+		bool signatureMatches( PoolFile &file );
+};
+
+class PoolReader{
+	public:
+		PoolReader();
+		~PoolReader();
+
+		bool readerOpen( string filePath );
+		bool readLine( string &line );
+		off_t readerTell();
+		bool readerSeek( off_t position );
+		void readerClose();
+
+	private:
+		int fileId;
+		uint32_t pageNo;
+		char *page;
+		int length;
+		int offset;
+		bool endOfFile;
+};
+
+//the buffer pool shared by every table of the process
+extern BufferPool bufferPool;
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,500 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file CatalogCache.cpp
+ *
+ * @brief Implementation file for CatalogCache class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the catalog cache. The DatabaseSystem directory and
+ *          every database directory are listed once at startup. After that
+ *          inotify reports the databases and table files other processes
+ *          create, drop or rename, and only those entries of the catalog
+ *          change. When inotify is not available, or drops events, a
+ *          directory is listed again only if its modification time changed
+ *
+ * @Note Requires CatalogCache.h
+ */
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <ctime>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include "CatalogCache.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef CATALOGCACHE_CPP
+#define CATALOGCACHE_CPP
+
+//helper functions implemented in sim.cpp
+bool read_directory( const std::string& name, vector< string >& v );
+
+//changes to a directory that add or remove one of its entries
+const uint32_t CATALOG_WATCH_EVENTS = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+/**
+ * @brief isTableFile
+ *
+ * @details checks whether a file of a database directory is a table, lock
+ *          and scratch files hold _temp and indexes and logs are hidden
+ *
+ * @param [in] string &fileName
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool isTableFile( const string &fileName )
+{
+	return !fileName.empty() && fileName[ 0 ] != '.' && fileName.find( "_temp" ) == string::npos;
+}
+
+/**
+ * @brief CatalogCache default constructor
+ *
+ * @details creates a cache that has not listed any directory
+ *
+ * @note None
+ */
+CatalogCache::CatalogCache()
+{
+	notifyDescriptor = -1;
+}
+
+/**
+ * @brief CatalogCache default destructor
+ *
+ * @details stops watching the directories
+ *
+ * @note None
+ */
+CatalogCache::~CatalogCache()
+{
+	if( notifyDescriptor >= 0 )
+	{
+		close( notifyDescriptor );
+	}
+}
+
+/**
+ * @brief cacheLoad
+ *
+ * @details lists every database and table of the system directory into
+ *          the catalog and starts watching the directories
+ *
+ * @post the system directory exists
+ *
+ * @param [in] string directory the DatabaseSystem directory
+ *
+ * @return None
+ *
+ * @note None
+ */
+void CatalogCache::cacheLoad( string directory )
+{
+	struct stat buffer;
+
+	systemDirectory = directory;
+	if( stat( systemDirectory.c_str(), &buffer ) != 0 )
+	{
+		mkdir( systemDirectory.c_str(), 0777 );
+	}
+
+	notifyDescriptor = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+	watchDirectory( "" );
+	listSystem();
+	for( unsigned int index = 0; index < databases.size(); index++ )
+	{
+		listDatabase( databases[ index ] );
+	}
+}
+
+/**
+ * @brief cacheRefresh
+ *
+ * @details brings the catalog up to date with changes other processes made
+ *          to the directories since the last refresh
+ *
+ * @par Algorithm the inotify events are applied one at a time. If events
+ *      were lost, or there is no inotify, the system directory and each
+ *      database directory are listed again when their modification time
+ *      changed
+ *
+ * @return None
+ *
+ * @note None
+ */
+void CatalogCache::cacheRefresh()
+{
+	if( notifyDescriptor >= 0 && readEvents() )
+	{
+		return;
+	}
+	if( directoryChanged( "" ) )
+	{
+		listSystem();
+	}
+	for( unsigned int index = 0; index < databases.size(); index++ )
+	{
+		if( directoryChanged( databases[ index ].databaseName ) )
+		{
+			listDatabase( databases[ index ] );
+		}
+	}
+}
+
+/**
+ * @brief cacheGetDatabase
+ *
+ * @details finds a database of the catalog by its name, ignoring case
+ *
+ * @param [in] string &databaseName
+ *
+ * @return Database* NULL when there is no such database
+ *
+ * @note None
+ */
+Database* CatalogCache::cacheGetDatabase( const string &databaseName )
+{
+	NameIndex::const_iterator entry = databaseIndex.find( databaseName );
+	return entry == databaseIndex.end() ? NULL : &databases[ entry->second ];
+}
+
+/**
+ * @brief cacheAddDatabase
+ *
+ * @details adds a database without tables to the catalog
+ *
+ * @pre the catalog has no database of the name ignoring case
+ *
+ * @param [in] string &databaseName
+ *
+ * @return Database* the database added
+ *
+ * @note addresses of the other databases may change
+ */
+Database* CatalogCache::cacheAddDatabase( const string &databaseName )
+{
+	databases.push_back( Database() );
+	databases.back().databaseName = databaseName;
+	databaseIndex[ databaseName ] = databases.size() - 1;
+	return &databases.back();
+}
+
+/**
+ * @brief cacheDropDatabase
+ *
+ * @details removes a database and its tables from the catalog
+ *
+ * @par Algorithm the databases after it move down one position, so only
+ *      their entries of the index change
+ *
+ * @param [in] string &databaseName
+ *
+ * @return bool false if there is no such database
+ *
+ * @note addresses of the databases after it change
+ */
+bool CatalogCache::cacheDropDatabase( const string &databaseName )
+{
+	NameIndex::iterator entry = databaseIndex.find( databaseName );
+	if( entry == databaseIndex.end() )
+	{
+		return false;
+	}
+	unsigned int position = entry->second;
+	databaseIndex.erase( entry );
+	stamps.erase( databases[ position ].databaseName );
+	databases.erase( databases.begin() + position );
+	for( unsigned int index = position; index < databases.size(); index++ )
+	{
+		databaseIndex[ databases[ index ].databaseName ] = index;
+	}
+	return true;
+}
+
+/**
+ * @brief watchDirectory
+ *
+ * @details starts watching the system directory or a database directory,
+ *          a directory already watched keeps its watch
+ *
+ * @par Algorithm when the watch cannot be added, usually because the limit
+ *      of watches was reached, inotify is closed and every directory is
+ *      checked by its modification time from then on
+ *
+ * @param [in] string databaseName empty for the system directory
+ *
+ * @return None
+ *
+ * @note None
+ */
+void CatalogCache::watchDirectory( string databaseName )
+{
+	if( notifyDescriptor < 0 )
+	{
+		return;
+	}
+
+	string path = databaseName.empty() ? systemDirectory : systemDirectory + "/" + databaseName;
+	int watch = inotify_add_watch( notifyDescriptor, path.c_str(), CATALOG_WATCH_EVENTS );
+	if( watch >= 0 )
+	{
+		watches[ watch ] = databaseName;
+	}
+	else if( errno != ENOENT )
+	{
+		close( notifyDescriptor );
+		notifyDescriptor = -1;
+		watches.clear();
+	}
+}
+
+/**
+ * @brief readEvents
+ *
+ * @details applies the directory changes inotify reported
+ *
+ * @par Algorithm a directory created in or moved into the system directory
+ *      is a new database, which is watched and then listed so no table
+ *      added in between is missed. A table file created or moved into a
+ *      database directory is a new table. Removing or moving either away
+ *      drops it from the catalog. Changes the catalog already holds, such
+ *      as those of this process, leave it as it is
+ *
+ * @return bool false if events were lost or inotify was closed
+ *
+ * @note None
+ */
+bool CatalogCache::readEvents()
+{
+	char buffer[ CATALOG_EVENT_BYTES ] __attribute__ ( ( aligned( __alignof__( struct inotify_event ) ) ) );
+	bool complete = true;
+	ssize_t length;
+
+	while( notifyDescriptor >= 0 && ( length = read( notifyDescriptor, buffer, sizeof( buffer ) ) ) > 0 )
+	{
+		const struct inotify_event *event;
+		for( char *next = buffer; next < buffer + length; next += sizeof( struct inotify_event ) + event->len )
+		{
+			event = (const struct inotify_event *)next;
+			if( event->mask & IN_Q_OVERFLOW )
+			{
+				complete = false;
+				continue;
+			}
+			map< int, string >::iterator watch = watches.find( event->wd );
+			if( watch == watches.end() )
+			{
+				continue;
+			}
+			if( event->mask & IN_IGNORED )
+			{
+				watches.erase( watch );
+				continue;
+			}
+			if( event->len == 0 )
+			{
+				continue;
+			}
+
+			string name = event->name;
+			bool added = ( event->mask & ( IN_CREATE | IN_MOVED_TO ) ) != 0;
+			bool isDirectory = ( event->mask & IN_ISDIR ) != 0;
+			if( watch->second.empty() && isDirectory )
+			{
+				Database* database = cacheGetDatabase( name );
+				if( added )
+				{
+					if( database == NULL )
+					{
+						database = cacheAddDatabase( name );
+					}
+					watchDirectory( name );
+					listDatabase( *database );
+				}
+				else if( database != NULL )
+				{
+					cacheDropDatabase( name );
+				}
+			}
+			else if( !watch->second.empty() && !isDirectory && isTableFile( name ) )
+			{
+				Database* database = cacheGetDatabase( watch->second );
+				Table* table = database == NULL ? NULL : database->getTable( name );
+				if( database != NULL && added && table == NULL )
+				{
+					Table newTable;
+					newTable.tableName = name;
+					newTable.tableTempName = name;
+					database->addTable( newTable );
+				}
+				else if( database != NULL && !added && table != NULL )
+				{
+					database->dropTable( name );
+				}
+			}
+		}
+	}
+	return complete && notifyDescriptor >= 0;
+}
+
+/**
+ * @brief listSystem
+ *
+ * @details lists the databases of the system directory, adding the new
+ *          ones with their tables and dropping those that are gone
+ *
+ * @return None
+ *
+ * @note None
+ */
+void CatalogCache::listSystem()
+{
+	vector< string > directoryItems;
+	map< string, bool > listed;
+	struct stat buffer;
+
+	if( stat( systemDirectory.c_str(), &buffer ) == 0 )
+	{
+		stamps[ "" ].modified = buffer.st_mtim;
+		stamps[ "" ].recent = buffer.st_mtim.tv_sec >= time( NULL ) - 1;
+	}
+	if( !read_directory( systemDirectory, directoryItems ) )
+	{
+		return;
+	}
+	for( unsigned int index = 0; index < directoryItems.size(); index++ )
+	{
+		if( directoryItems[ index ] != "." && directoryItems[ index ] != ".." )
+		{
+			listed[ directoryItems[ index ] ] = true;
+		}
+	}
+
+	unsigned int kept = 0;
+	for( unsigned int index = 0; index < databases.size(); index++ )
+	{
+		if( listed.erase( databases[ index ].databaseName ) == 0 )
+		{
+			stamps.erase( databases[ index ].databaseName );
+		}
+		else
+		{
+			if( kept != index )
+			{
+				databases[ kept ] = databases[ index ];
+			}
+			kept++;
+		}
+	}
+	databases.resize( kept );
+	databaseIndex.clear();
+	for( unsigned int index = 0; index < databases.size(); index++ )
+	{
+		databaseIndex.insert( make_pair( databases[ index ].databaseName, index ) );
+	}
+	for( map< string, bool >::iterator name = listed.begin(); name != listed.end(); name++ )
+	{
+		Database* database = cacheAddDatabase( name->first );
+		watchDirectory( name->first );
+		listDatabase( *database );
+	}
+}
+
+/**
+ * @brief listDatabase
+ *
+ * @details lists the tables of a database directory, adding the new ones
+ *          and dropping those that are gone
+ *
+ * @param [in/out] Database &database
+ *
+ * @return None
+ *
+ * @note None
+ */
+void CatalogCache::listDatabase( Database &database )
+{
+	string path = systemDirectory + "/" + database.databaseName;
+	vector< string > tableItems;
+	map< string, bool > listed;
+	struct stat buffer;
+
+	if( stat( path.c_str(), &buffer ) == 0 )
+	{
+		stamps[ database.databaseName ].modified = buffer.st_mtim;
+		stamps[ database.databaseName ].recent = buffer.st_mtim.tv_sec >= time( NULL ) - 1;
+	}
+	if( !read_directory( path, tableItems ) )
+	{
+		return;
+	}
+	for( unsigned int index = 0; index < tableItems.size(); index++ )
+	{
+		if( isTableFile( tableItems[ index ] ) )
+		{
+			listed[ tableItems[ index ] ] = true;
+		}
+	}
+
+	//the tables still listed move down over those that are gone, then the
+	//index is built once for the whole directory
+	vector< Table > &tables = database.databaseTable;
+	unsigned int kept = 0;
+	for( unsigned int index = 0; index < tables.size(); index++ )
+	{
+		if( listed.erase( tables[ index ].tableName ) != 0 )
+		{
+			if( kept != index )
+			{
+				tables[ kept ] = tables[ index ];
+			}
+			kept++;
+		}
+	}
+	tables.erase( tables.begin() + kept, tables.end() );
+	for( map< string, bool >::iterator name = listed.begin(); name != listed.end(); name++ )
+	{
+		Table newTable;
+		newTable.tableName = name->first;
+		newTable.tableTempName = name->first;
+		tables.push_back( newTable );
+	}
+	database.indexTables();
+}
+
+/**
+ * @brief directoryChanged
+ *
+ * @details checks the modification time of a directory against the one
+ *          it had when it was last listed
+ *
+ * @param [in] string databaseName empty for the system directory
+ *
+ * @return bool true if the directory must be listed again
+ *
+ * @note None
+ */
+bool CatalogCache::directoryChanged( string databaseName )
+{
+	string path = databaseName.empty() ? systemDirectory : systemDirectory + "/" + databaseName;
+	map< string, DirectoryStamp >::iterator stamp = stamps.find( databaseName );
+	struct stat buffer;
+
+	if( stat( path.c_str(), &buffer ) != 0 || stamp == stamps.end() || stamp->second.recent )
+	{
+		return true;
+	}
+	return buffer.st_mtim.tv_sec != stamp->second.modified.tv_sec ||
+			buffer.st_mtim.tv_nsec != stamp->second.modified.tv_nsec;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
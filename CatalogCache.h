@@ -0,0 +1,73 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file CatalogCache.h
+ *
+ * @brief Definition file for CatalogCache class
+ *
+ * @details Specifies all member methods of the CatalogCache class, which
+ *          keeps the databases and tables of the DatabaseSystem directory
+ *          in memory and in step with other processes
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <time.h>
+#include "Database.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef CATALOGCACHE_H
+#define CATALOGCACHE_H
+
+//bytes of directory change events read at once
+const unsigned int CATALOG_EVENT_BYTES = 64 * 1024;
+
+//modification time of a directory when it was last listed. A directory
+//changed within the second it was listed may change again unnoticed, so it
+//is listed again on the next check
+struct DirectoryStamp{
+	struct timespec modified;
+	bool recent;
+};
+
+class CatalogCache{
+	public:
+		CatalogCache();
+		~CatalogCache();
+
+		//databases of the system directory, added and dropped through
+		//cacheAddDatabase and cacheDropDatabase
+		vector< Database > databases;
+
+		void cacheLoad( string directory );
+		void cacheRefresh();
+		Database* cacheGetDatabase( const string &databaseName );
+		Database* cacheAddDatabase( const string &databaseName );
+		bool cacheDropDatabase( const string &databaseName );
+
+	private:
+		string systemDirectory;
+		NameIndex databaseIndex;
+
+		//inotify descriptor, -1 when directories are checked by their
+		//modification time instead, and the database of each watch, the
+		//system directory being the empty name
+		int notifyDescriptor;
+		map< int, string > watches;
+
+		map< string, DirectoryStamp > stamps;
+
+		void watchDirectory( string databaseName );
+		bool readEvents();
+		void listSystem();
+		void listDatabase( Database &database );
+		bool directoryChanged( string databaseName );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
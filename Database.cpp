@@ -31,7 +31,7 @@ using namespace std;
 #define DATABASE_CPP
 
 //declaration of the function
-bool caseInsCompare( string s1, string s2 );
+bool caseInsCompare( const string &s1, const string &s2 );
 
 /**
  *@brief caseInsCharCompareN method
@@ -52,16 +52,58 @@ inline bool caseInsCharCompareN( char a, char b )
  *
  *@details checks size of strings and if the values of each char a are equal
  *
- *@param [in] string s1
+ *@param [in] string &s1
  *
- *@param [in] string s2
+ *@param [in] string &s2
 */
-bool caseInsCompare( string s1, string s2 )
+bool caseInsCompare( const string &s1, const string &s2 )
 {
 	return ( ( s1.size() == s2.size() ) && 
 			equal( s1.begin(), s1.end(), s2.begin(), caseInsCharCompareN ) );
 }
 
+/**
+ * @brief NameHash
+ *
+ * @details hashes a name as if it were in uppercase
+ *
+ * @par Algorithm FNV-1a over the uppercase characters, so names that
+ *      differ only in case hash the same
+ *
+ * @param [in] string &name
+ *
+ * @return size_t
+ *
+ * @note None
+ */
+size_t NameHash::operator()( const string &name ) const
+{
+	size_t hash = 2166136261u;
+	for( unsigned int index = 0; index < name.size(); index++ )
+	{
+		hash = ( hash ^ (unsigned char)toupper( name[ index ] ) ) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @brief NameEqual
+ *
+ * @details compares two names ignoring case
+ *
+ * @param [in] string &first
+ *
+ * @param [in] string &second
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool NameEqual::operator()( const string &first, const string &second ) const
+{
+	return caseInsCompare( first, second );
+}
+
 /**
  * @brief database Default constructor
  *
@@ -184,15 +226,15 @@ void Database::databaseUse()
  *
  * @post if table exists, a boolean value of true is returned
  *
- * @par Algorithm Go through the tables and check if the tableName matches a table
- * 		stored in the database
+ * @par Algorithm the name is looked up in the index of the tables, which
+ * 		ignores case
  *      
  * @exception None
  *
- * @param [in] string tblName - name of the table to see if it exists
+ * @param [in/out] string tblName - name of the table to see if it exists,
+ *        set to the name the table was created with
  *
- * @param [in] int &tblReturn, the index at which the table was found in the vector of database tables is stored
- * @param [out] 
+ * @param [out] int &tblReturn, the index at which the table was found in the vector of database tables is stored
  *
  * @return bool true if found, else false
  *
@@ -200,17 +242,14 @@ void Database::databaseUse()
  */
 bool Database::tableExists( string &tblName, int &tblReturn )
 {
-	int tblSize = databaseTable.size();
-	for( int index = 0; index < tblSize; index++ )
+	NameIndex::const_iterator entry = tableIndex.find( tblName );
+	if( entry == tableIndex.end() )
 	{
-		if( caseInsCompare( databaseTable[ index ].tableName, tblName ) )
-		{
-			tblReturn = index;
-			tblName = databaseTable[ index ].tableName;
-			return true;
-		}
+		return false;
 	}
-	return false;
+	tblReturn = entry->second;
+	tblName = databaseTable[ tblReturn ].tableName;
+	return true;
 }
 
 /**
@@ -223,26 +262,92 @@ bool Database::tableExists( string &tblName, int &tblReturn )
  * @post address of table is returned
  *
  * @par Algorithm 
- *     search through all the tables in the current database, return matching one
+ *     the name is looked up in the index of the tables, which ignores case
  * 
  * @exception 
  *
  * @param [in] tableName	provides string for table to search for
  *
- * @return Table*
+ * @return Table* NULL when the database has no such table
  *
  * @note None
  */
-Table* Database::getTable( string tableName )
+Table* Database::getTable( const string &tableName )
 {
-	for ( uint i = 0; i < databaseTable.size(); i++ )
+	NameIndex::const_iterator entry = tableIndex.find( tableName );
+	return entry == tableIndex.end() ? NULL : &databaseTable[ entry->second ];
+}
+
+/**
+ * @brief addTable
+ *
+ * @details adds a table to the database and to the index of the tables
+ *
+ * @pre no table of the database has the name ignoring case
+ *
+ * @param [in] Table &table
+ *
+ * @return Table* the table added
+ *
+ * @note addresses of the other tables may change
+ */
+Table* Database::addTable( const Table &table )
+{
+	databaseTable.push_back( table );
+	tableIndex[ table.tableName ] = databaseTable.size() - 1;
+	return &databaseTable.back();
+}
+
+/**
+ * @brief dropTable
+ *
+ * @details removes a table from the database and from the index of the
+ *          tables
+ *
+ * @par Algorithm the tables after it move down one position, so only their
+ *      entries of the index change and the tables keep their order
+ *
+ * @param [in] string &tableName
+ *
+ * @return bool false if the database has no such table
+ *
+ * @note addresses of the tables after it change
+ */
+bool Database::dropTable( const string &tableName )
+{
+	NameIndex::iterator entry = tableIndex.find( tableName );
+	if( entry == tableIndex.end() )
 	{
-		if( caseInsCompare( databaseTable[ i ].tableName, tableName ) )
-		{
-			return &databaseTable[ i ];
-		}
+		return false;
+	}
+	unsigned int position = entry->second;
+	tableIndex.erase( entry );
+	databaseTable.erase( databaseTable.begin() + position );
+	for( unsigned int index = position; index < databaseTable.size(); index++ )
+	{
+		tableIndex[ databaseTable[ index ].tableName ] = index;
+	}
+	return true;
+}
+
+/**
+ * @brief indexTables
+ *
+ * @details builds the index of the tables again after the vector of the
+ *          tables was changed directly
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Database::indexTables()
+{
+	tableIndex.clear();
+	tableIndex.reserve( databaseTable.size() );
+	for( unsigned int index = 0; index < databaseTable.size(); index++ )
+	{
+		tableIndex.insert( make_pair( databaseTable[ index ].tableName, index ) );
 	}
-	return NULL;
 }
 
 /**
@@ -255,7 +360,9 @@ Table* Database::getTable( string tableName )
  * @post true is returned if commit was processes, false if abort
  *
  * @par Algorithm 
- *     for each table in the database, unlock 
+ *     the changes of the transaction are written to the log of the database,
+ *     then its statistics to their files and every table is unlocked.
+ *     Nothing is committed if the transaction holds no lock
  * 
  * @exception 
  *
@@ -275,11 +382,92 @@ bool Database::commitTransaction( string currentWorkingDirectory )
 	
 		if( fileExists( currentWorkingDirectory + filePath ) && databaseTable[ i ].tableIsLocked )
 		{
-			databaseTable[ i ].tableUnlock( currentWorkingDirectory, databaseName );
 			commit = true;
 		}
 	}
+
+	//the log must be on disk before other processes can lock the tables
+	if( !commit )
+	{
+		writeAheadLog.walAbort();
+	}
+	else if( !writeAheadLog.walCommit() )
+	{
+		cout << "-- !Failed to write the transaction log." << endl;
+		commit = false;
+	}
+
+	//statistics changed by the transaction only count once it committed
+	if( commit )
+	{
+		statisticsCatalog.statisticsCommit();
+	}
+	else
+	{
+		statisticsCatalog.statisticsAbort();
+	}
+
+	for( uint i = 0; i < databaseTable.size(); i++ )
+	{
+		if( databaseTable[ i ].tableIsLocked )
+		{
+			databaseTable[ i ].tableUnlock( currentWorkingDirectory, databaseName );
+		}
+	}
 	return commit;
 }
+
+/**
+ * @brief databaseRecover
+ *
+ * @details brings the database to a consistent state after a crash
+ *          
+ * @pre no other statement ran in this process yet
+ *
+ * @post committed transactions are applied and locks of dead processes
+ *       are released
+ *
+ * @par Algorithm 
+ *     the log is recovered first, then every table lock whose process died
+ *     is removed along with the scratch file of a rewrite it left behind.
+ *     A line is output only when something was recovered
+ * 
+ * @exception 
+ *
+ * @param [in] currentworkingdirectory provides string for filepath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Database::databaseRecover( string currentWorkingDirectory )
+{
+	string databasePath = currentWorkingDirectory + "/" + databaseName;
+	int redone;
+	int discarded;
+	int released = 0;
+
+	writeAheadLog.walRecover( databasePath, redone, discarded );
+	for( uint i = 0; i < databaseTable.size(); i++ )
+	{
+		string tablePath = databasePath + "/" + databaseTable[ i ].tableName;
+		if( databaseTable[ i ].tableBreakLock( currentWorkingDirectory, databaseName ) )
+		{
+			released++;
+		}
+		//a rewrite holds the lock while it runs, without one its scratch file is left over
+		if( !fileExists( tablePath + "_temp" ) && fileExists( tablePath + SCAN_SUFFIX ) )
+		{
+			unlink( ( tablePath + SCAN_SUFFIX ).c_str() );
+		}
+	}
+	removeOrphanSpills( databasePath );
+
+	if( redone > 0 || discarded > 0 || released > 0 )
+	{
+		cout << "-- Database " << databaseName << " recovered: " << redone << " transactions redone, ";
+		cout << discarded << " discarded, " << released << " locks released." << endl;
+	}
+}
 // Terminating precompiler directives  ////////////////////////////////////////
 #endif
@@ -13,6 +13,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 using namespace std;
 
@@ -22,9 +23,25 @@ using namespace std;
 #ifndef DATABASE_H
 #define DATABASE_H
 
+//hash and equality of names that ignore case, so a name is found with one
+//probe and no folded copy of it
+struct NameHash{
+	size_t operator()( const string &name ) const;
+};
+
+struct NameEqual{
+	bool operator()( const string &first, const string &second ) const;
+};
+
+//position of each database or table in its vector by name
+typedef unordered_map< string, unsigned int, NameHash, NameEqual > NameIndex;
+
 class Database{
 	public: 
 		string databaseName;
+
+		//tables are added and dropped through addTable and dropTable, or
+		//indexTables is called after the vector is changed directly
 		vector <Table> databaseTable;
 
 		Database();
@@ -34,8 +51,15 @@ class Database{
 		void databaseAlter( string input );
 		void databaseUse();
 		bool tableExists( string &tblName, int &tblReturn );
-		Table* getTable( string tableName );
+		Table* getTable( const string &tableName );
+		Table* addTable( const Table &table );
+		bool dropTable( const string &tableName );
+		void indexTables();
 		bool commitTransaction( string currentWorkingDirectory );
+		void databaseRecover( string currentWorkingDirectory );
+
+	private:
+		NameIndex tableIndex;
 };
 
 // Terminating precompiler directives  ////////////////////////////////////////
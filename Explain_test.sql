@@ -0,0 +1,73 @@
+--CS457 explain
+
+--EXPLAIN prints the plan of a select and the plans it was chosen over without running it
+
+CREATE DATABASE Planned;
+USE Planned;
+
+create table Flights (seat int, status int);
+create table Owners (seat int, owner varchar(10));
+insert into Flights values(1, 0);
+insert into Flights values(2, 0);
+insert into Flights values(3, 0);
+insert into Flights values(4, 0);
+insert into Flights values(5, 0);
+insert into Flights values(6, 0);
+insert into Flights values(7, 0);
+insert into Flights values(8, 0);
+insert into Flights values(9, 0);
+insert into Flights values(10, 1);
+insert into Flights values(11, 0);
+insert into Flights values(12, 0);
+insert into Flights values(13, 0);
+insert into Flights values(14, 0);
+insert into Flights values(15, 0);
+insert into Flights values(16, 0);
+insert into Flights values(17, 0);
+insert into Flights values(18, 0);
+insert into Flights values(19, 0);
+insert into Flights values(20, 1);
+insert into Flights values(21, 0);
+insert into Flights values(22, 0);
+insert into Flights values(23, 0);
+insert into Flights values(24, 0);
+insert into Flights values(25, 0);
+insert into Flights values(26, 0);
+insert into Flights values(27, 0);
+insert into Flights values(28, 0);
+insert into Flights values(29, 0);
+insert into Flights values(30, 1);
+insert into Flights values(31, 0);
+insert into Flights values(32, 0);
+insert into Flights values(33, 0);
+insert into Flights values(34, 0);
+insert into Flights values(35, 0);
+insert into Flights values(36, 0);
+insert into Flights values(37, 0);
+insert into Flights values(38, 0);
+insert into Flights values(39, 0);
+insert into Flights values(40, 1);
+insert into Owners values(10, 'o1');
+insert into Owners values(20, 'o2');
+insert into Owners values(30, 'o3');
+CREATE INDEX FlightSeat ON Flights(seat);
+
+EXPLAIN select * from Flights where seat = 22;
+EXPLAIN select * from Flights where status = 1;
+EXPLAIN select * from Owners O inner join Flights F on O.seat = F.seat;
+ANALYZE;
+EXPLAIN select * from Flights where seat = 22;
+EXPLAIN select * from Flights where seat > 5 and status = 1;
+EXPLAIN select * from Flights where seat < 3 or status = 1;
+EXPLAIN select * from Owners O inner join Flights F on O.seat = F.seat;
+EXPLAIN select * from Owners O left outer join Flights F on O.seat = F.seat;
+select * from Owners O inner join Flights F on O.seat = F.seat;
+select * from Owners O left outer join Flights F on O.seat = F.seat;
+select * from Flights where seat > 5 and status = 1;
+
+EXPLAIN select * from Missing;
+EXPLAIN select * from Flights where seat =;
+EXPLAIN;
+
+DROP DATABASE Planned;
+.EXIT
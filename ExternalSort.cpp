@@ -0,0 +1,722 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ExternalSort.cpp
+ *
+ * @brief Implementation file for ExternalSort class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the sort behind ORDER BY. Rows are sorted in memory
+ *          while they fit in the sort budget. Past it the rows held are
+ *          sorted and written to a scratch file as a run, and the runs are
+ *          merged with a heap holding the next row of each (external merge
+ *          sort). Rows that compare equal keep the order they were added in.
+ *          A sort limited to its first rows keeps only those in a heap
+ *          (top-n sort)
+ *
+ * @Note Requires ExternalSort.h
+ */
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+#include "ExternalSort.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef EXTERNALSORT_CPP
+#define EXTERNALSORT_CPP
+
+//helper functions implemented in HashJoin.cpp, HashAggregate.cpp, Database.cpp and sim.cpp
+long rowBytes( const vector< string > &row );
+long writeSpillRow( ofstream &fout, const vector< string > &row );
+bool readSpillRow( ifstream &fin, vector< string > &row );
+void splitAggregateTerms( string list, vector< string > &terms );
+void trimAggregateTerm( string &term );
+int compareText( const string &first, const string &second );
+bool caseInsCompare( const string &s1, const string &s2 );
+void convertToLC( string &input );
+
+long sortMemoryBytes = DEFAULT_SORT_BYTES;
+
+/**
+ * @brief compareCells
+ *
+ * @details compares two cells of a sort column
+ *
+ * @par Algorithm null cells sort first, see isNullValue. Int and float
+ *      cells compare as numbers, other cells as text
+ *
+ * @param [in] string &first
+ *
+ * @param [in] string &second
+ *
+ * @param [in] SortValue valueType
+ *
+ * @return int less than, equal to or greater than 0 as first sorts before,
+ *         with or after second
+ *
+ * @note None
+ */
+int compareCells( const string &first, const string &second, SortValue valueType )
+{
+	bool firstNull = isNullValue( first );
+	bool secondNull = isNullValue( second );
+	if( firstNull || secondNull )
+	{
+		return (int)!firstNull - (int)!secondNull;
+	}
+	if( valueType == SORT_INTEGER )
+	{
+		long long firstNumber = strtoll( first.c_str(), NULL, 10 );
+		long long secondNumber = strtoll( second.c_str(), NULL, 10 );
+		return firstNumber < secondNumber ? -1 : firstNumber > secondNumber ? 1 : 0;
+	}
+	if( valueType == SORT_FLOAT )
+	{
+		double firstNumber = strtod( first.c_str(), NULL );
+		double secondNumber = strtod( second.c_str(), NULL );
+		return firstNumber < secondNumber ? -1 : firstNumber > secondNumber ? 1 : 0;
+	}
+	return compareText( first, second );
+}
+
+/**
+ * @brief normalizeSortTerm
+ *
+ * @details writes an aggregate function of an order by clause the way the
+ *          select list names it, "COUNT( * )" becomes "count(*)"
+ *
+ * @param [in/out] string &term
+ *
+ * @return None
+ *
+ * @note None
+ */
+void normalizeSortTerm( string &term )
+{
+	size_t open = term.find( '(' );
+	if( open == string::npos )
+	{
+		return;
+	}
+	string functionName = term.substr( 0, open );
+	string argument = term.substr( open + 1 );
+	trimAggregateTerm( functionName );
+	convertToLC( functionName );
+	if( !argument.empty() && argument[ argument.size() - 1 ] == ')' )
+	{
+		argument.erase( argument.size() - 1 );
+	}
+	trimAggregateTerm( argument );
+	term = functionName + "(" + argument + ")";
+}
+
+/**
+ * @brief ExternalSort default constructor
+ *
+ * @details a new sort has no rows
+ *
+ * @note None
+ */
+ExternalSort::ExternalSort()
+{
+	rowsBytes = 0;
+	rowCursor = 0;
+	rowLimit = -1;
+	rowsAdded = 0;
+	spillCount = 0;
+}
+
+/**
+ * @brief ExternalSort default destructor
+ *
+ * @details removes the runs written
+ *
+ * @note None
+ */
+ExternalSort::~ExternalSort()
+{
+	sortClose();
+}
+
+/**
+ * @brief parseSortKeys
+ *
+ * @details parses an order by clause into sort keys
+ *
+ * @par Algorithm terms are comma separated, each a column name or an
+ *      aggregate function of the select list, optionally followed by asc
+ *      or desc. Columns of type int and float sort as numbers
+ *
+ * @param [in] string orderType
+ *
+ * @param [in] vector< string > &names columns of the rows sorted
+ *
+ * @param [in] vector< string > &types type of every column
+ *
+ * @param [out] vector< SortKey > &keys
+ *
+ * @param [out] string &error why the clause cannot be used
+ *
+ * @return bool false if a term is not a column of the rows
+ *
+ * @note None
+ */
+bool ExternalSort::parseSortKeys( string orderType, const vector< string > &names,
+									const vector< string > &types, vector< SortKey > &keys,
+									string &error )
+{
+	vector< string > terms;
+
+	keys.clear();
+	splitAggregateTerms( orderType, terms );
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		string term = terms[ index ];
+		SortKey key;
+		key.descending = false;
+		size_t space = term.find_last_of( " \t" );
+		if( space != string::npos )
+		{
+			string direction = term.substr( space + 1 );
+			if( caseInsCompare( direction, "desc" ) || caseInsCompare( direction, "asc" ) )
+			{
+				key.descending = caseInsCompare( direction, "desc" );
+				term.erase( space );
+				trimAggregateTerm( term );
+			}
+		}
+		normalizeSortTerm( term );
+
+		key.column = -1;
+		for( unsigned int column = 0; column < names.size() && key.column < 0; column++ )
+		{
+			if( names[ column ] == term )
+			{
+				key.column = column;
+			}
+		}
+		if( key.column < 0 )
+		{
+			error = "column " + term + " does not exist";
+			return false;
+		}
+		key.valueType = SORT_TEXT;
+		if( caseInsCompare( types[ key.column ], "int" ) )
+		{
+			key.valueType = SORT_INTEGER;
+		}
+		else if( caseInsCompare( types[ key.column ], "float" ) )
+		{
+			key.valueType = SORT_FLOAT;
+		}
+		keys.push_back( key );
+	}
+	return true;
+}
+
+/**
+ * @brief sortSetup
+ *
+ * @details sets the keys rows are sorted on and where runs are written
+ *
+ * @param [in] vector< SortKey > &keys
+ *
+ * @param [in] string directory the database directory
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ExternalSort::sortSetup( const vector< SortKey > &keys, string directory )
+{
+	sortClose();
+	sortKeys = keys;
+	spillDirectory = directory;
+}
+
+/**
+ * @brief sortSetLimit
+ *
+ * @details limits the sort to its first rows, the others are dropped as
+ *          they are added so the sort holds at most rowCount rows
+ *
+ * @pre sortSetup was called and no row was added
+ *
+ * @param [in] long rowCount
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ExternalSort::sortSetLimit( long rowCount )
+{
+	rowLimit = rowCount;
+}
+
+/**
+ * @brief sortAdd
+ *
+ * @details adds a row to the sort
+ *
+ * @post the rows held are written out as a run once they pass the budget
+ *
+ * @par Algorithm a top-n sort holds the rows as they are added until it
+ *      has rowLimit of them, then turns them into a heap and only keeps
+ *      a new row in place of the last one. A limit too large for the
+ *      budget is dropped and the rows are sorted like any others
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool false if a run could not be written
+ *
+ * @note None
+ */
+bool ExternalSort::sortAdd( const vector< string > &row )
+{
+	if( rowLimit >= 0 && (long)rows.size() >= rowLimit )
+	{
+		topReplace( row );
+		return true;
+	}
+	rows.push_back( row );
+	rowsBytes += rowBytes( row );
+	if( rowLimit >= 0 )
+	{
+		rowNumbers.push_back( rowsAdded++ );
+	}
+	if( rowsBytes > sortMemoryBytes )
+	{
+		rowLimit = -1;
+		rowNumbers.clear();
+		return spillRun();
+	}
+	if( rowLimit >= 0 && (long)rows.size() == rowLimit )
+	{
+		for( unsigned int index = 0; index < rows.size(); index++ )
+		{
+			topHeap.push_back( index );
+		}
+		make_heap( topHeap.begin(), topHeap.end(),
+			[ this ]( int first, int second )
+		{
+			return topBefore( first, second );
+		} );
+	}
+	return true;
+}
+
+/**
+ * @brief sortFinish
+ *
+ * @details sorts the rows added so sortNext returns them in order
+ *
+ * @par Algorithm rows that never passed the budget are sorted in memory.
+ *      Otherwise the rest is written as a last run, and while there are
+ *      more than SORT_MERGE_FANIN runs the first ones are merged into one
+ *
+ * @return bool false if a run could not be written
+ *
+ * @note None
+ */
+bool ExternalSort::sortFinish()
+{
+	rowCursor = 0;
+	if( rowLimit >= 0 )
+	{
+		topSort();
+		return true;
+	}
+	if( runPaths.empty() )
+	{
+		stable_sort( rows.begin(), rows.end(),
+			[ this ]( const vector< string > &first, const vector< string > &second )
+		{
+			return rowLess( first, second );
+		} );
+		return true;
+	}
+
+	if( !rows.empty() && !spillRun() )
+	{
+		return false;
+	}
+	while( runPaths.size() > SORT_MERGE_FANIN )
+	{
+		if( !mergePass() )
+		{
+			return false;
+		}
+	}
+	return openRuns( 0, runPaths.size() );
+}
+
+/**
+ * @brief sortNext
+ *
+ * @details returns the next row in sorted order
+ *
+ * @pre sortFinish was called
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false once every row was returned
+ *
+ * @note None
+ */
+bool ExternalSort::sortNext( vector< string > &row )
+{
+	if( !mergeRuns.empty() )
+	{
+		return nextMerged( row );
+	}
+	if( rowCursor < rows.size() )
+	{
+		row.swap( rows[ rowCursor++ ] );
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief sortClose
+ *
+ * @details releases the rows and removes the runs
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ExternalSort::sortClose()
+{
+	closeRuns();
+	for( unsigned int index = 0; index < runPaths.size(); index++ )
+	{
+		unlink( runPaths[ index ].c_str() );
+	}
+	runPaths.clear();
+	rows.clear();
+	rowsBytes = 0;
+	rowCursor = 0;
+	rowLimit = -1;
+	rowsAdded = 0;
+	rowNumbers.clear();
+	topHeap.clear();
+}
+
+/**
+ * @brief rowLess
+ *
+ * @details checks whether a row sorts before another
+ *
+ * @param [in] vector< string > &first
+ *
+ * @param [in] vector< string > &second
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool ExternalSort::rowLess( const vector< string > &first, const vector< string > &second ) const
+{
+	for( unsigned int index = 0; index < sortKeys.size(); index++ )
+	{
+		const SortKey &key = sortKeys[ index ];
+		int order = compareCells( first[ key.column ], second[ key.column ], key.valueType );
+		if( order != 0 )
+		{
+			return key.descending ? order > 0 : order < 0;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief heapAfter
+ *
+ * @details orders the merge heap, the next row of a run comes after the
+ *          next row of another if it sorts after it, or is equal and from
+ *          a later run
+ *
+ * @param [in] int first
+ *
+ * @param [in] int second
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool ExternalSort::heapAfter( int first, int second ) const
+{
+	if( rowLess( mergeRows[ second ], mergeRows[ first ] ) )
+	{
+		return true;
+	}
+	return !rowLess( mergeRows[ first ], mergeRows[ second ] ) && first > second;
+}
+
+/**
+ * @brief topBefore
+ *
+ * @details orders the rows of a top-n sort, a row comes before another if
+ *          it sorts before it, or is equal and was added first
+ *
+ * @param [in] int first index of a row held
+ *
+ * @param [in] int second
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool ExternalSort::topBefore( int first, int second ) const
+{
+	if( rowLess( rows[ first ], rows[ second ] ) )
+	{
+		return true;
+	}
+	return !rowLess( rows[ second ], rows[ first ] ) && rowNumbers[ first ] < rowNumbers[ second ];
+}
+
+/**
+ * @brief topReplace
+ *
+ * @details offers a row to a full top-n sort
+ *
+ * @par Algorithm the row was added after every row held, so it only
+ *      replaces the last row on top of the heap if it sorts strictly
+ *      before it
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ExternalSort::topReplace( const vector< string > &row )
+{
+	auto heapOrder = [ this ]( int first, int second )
+	{
+		return topBefore( first, second );
+	};
+	long rowNumber = rowsAdded++;
+
+	if( topHeap.empty() || !rowLess( row, rows[ topHeap.front() ] ) )
+	{
+		return;
+	}
+	pop_heap( topHeap.begin(), topHeap.end(), heapOrder );
+	int last = topHeap.back();
+	rowsBytes += rowBytes( row ) - rowBytes( rows[ last ] );
+	rows[ last ] = row;
+	rowNumbers[ last ] = rowNumber;
+	push_heap( topHeap.begin(), topHeap.end(), heapOrder );
+}
+
+/**
+ * @brief topSort
+ *
+ * @details puts the rows of a top-n sort in order for sortNext
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ExternalSort::topSort()
+{
+	vector< int > order;
+	vector< vector< string > > sorted( rows.size() );
+
+	for( unsigned int index = 0; index < rows.size(); index++ )
+	{
+		order.push_back( index );
+	}
+	sort( order.begin(), order.end(),
+		[ this ]( int first, int second )
+	{
+		return topBefore( first, second );
+	} );
+	for( unsigned int index = 0; index < order.size(); index++ )
+	{
+		sorted[ index ].swap( rows[ order[ index ] ] );
+	}
+	rows.swap( sorted );
+	rowNumbers.clear();
+	topHeap.clear();
+}
+
+/**
+ * @brief spillRun
+ *
+ * @details sorts the rows held and writes them out as a run
+ *
+ * @return bool false if the run could not be written
+ *
+ * @note None
+ */
+bool ExternalSort::spillRun()
+{
+	stable_sort( rows.begin(), rows.end(),
+		[ this ]( const vector< string > &first, const vector< string > &second )
+	{
+		return rowLess( first, second );
+	} );
+
+	string runPath = spillPath();
+	ofstream fout( runPath.c_str(), ios::binary | ios::trunc );
+	runPaths.push_back( runPath );
+	for( unsigned int index = 0; index < rows.size(); index++ )
+	{
+		writeSpillRow( fout, rows[ index ] );
+	}
+	fout.close();
+	rows.clear();
+	rowsBytes = 0;
+	return !fout.fail();
+}
+
+/**
+ * @brief openRuns
+ *
+ * @details starts merging a range of the runs
+ *
+ * @param [in] unsigned int first
+ *
+ * @param [in] unsigned int last one past the last run merged
+ *
+ * @return bool false if a run could not be opened
+ *
+ * @note None
+ */
+bool ExternalSort::openRuns( unsigned int first, unsigned int last )
+{
+	closeRuns();
+	mergeRows.resize( last - first );
+	for( unsigned int index = first; index < last; index++ )
+	{
+		ifstream *run = new ifstream( runPaths[ index ].c_str(), ios::binary );
+		mergeRuns.push_back( run );
+		if( !run->is_open() )
+		{
+			return false;
+		}
+		if( readSpillRow( *run, mergeRows[ index - first ] ) )
+		{
+			mergeHeap.push_back( index - first );
+		}
+	}
+	make_heap( mergeHeap.begin(), mergeHeap.end(),
+		[ this ]( int firstRun, int secondRun ) { return heapAfter( firstRun, secondRun ); } );
+	return true;
+}
+
+/**
+ * @brief nextMerged
+ *
+ * @details returns the first of the next rows of the runs being merged and
+ *          reads the row after it from its run
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false once every run is used up
+ *
+ * @note None
+ */
+bool ExternalSort::nextMerged( vector< string > &row )
+{
+	if( mergeHeap.empty() )
+	{
+		return false;
+	}
+	auto after = [ this ]( int firstRun, int secondRun ) { return heapAfter( firstRun, secondRun ); };
+	pop_heap( mergeHeap.begin(), mergeHeap.end(), after );
+	int run = mergeHeap.back();
+	row.swap( mergeRows[ run ] );
+	if( readSpillRow( *mergeRuns[ run ], mergeRows[ run ] ) )
+	{
+		push_heap( mergeHeap.begin(), mergeHeap.end(), after );
+	}
+	else
+	{
+		mergeHeap.pop_back();
+	}
+	return true;
+}
+
+/**
+ * @brief closeRuns
+ *
+ * @details closes the runs being merged
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ExternalSort::closeRuns()
+{
+	for( unsigned int index = 0; index < mergeRuns.size(); index++ )
+	{
+		delete mergeRuns[ index ];
+	}
+	mergeRuns.clear();
+	mergeRows.clear();
+	mergeHeap.clear();
+}
+
+/**
+ * @brief mergePass
+ *
+ * @details merges the first SORT_MERGE_FANIN runs into one
+ *
+ * @par Algorithm the merged run takes the place of the runs it was made
+ *      from, so rows that compare equal stay in the order they were added
+ *
+ * @return bool false if a run could not be read or written
+ *
+ * @note None
+ */
+bool ExternalSort::mergePass()
+{
+	vector< string > row;
+	string runPath = spillPath();
+	ofstream fout( runPath.c_str(), ios::binary | ios::trunc );
+	bool success = openRuns( 0, SORT_MERGE_FANIN );
+	while( success && nextMerged( row ) )
+	{
+		writeSpillRow( fout, row );
+	}
+	closeRuns();
+	fout.close();
+
+	for( unsigned int index = 0; index < SORT_MERGE_FANIN; index++ )
+	{
+		unlink( runPaths[ index ].c_str() );
+	}
+	runPaths.erase( runPaths.begin(), runPaths.begin() + SORT_MERGE_FANIN );
+	runPaths.insert( runPaths.begin(), runPath );
+	return success && !fout.fail();
+}
+
+/**
+ * @brief spillPath
+ *
+ * @details returns the name of a new run, .spill_<pid>_sort<number> in the
+ *          database directory so startup removes it if the process dies
+ *
+ * @return string
+ *
+ * @note None
+ */
+string ExternalSort::spillPath()
+{
+	return spillDirectory + "/" + SPILL_PREFIX + to_string( (long)getpid() ) + "_sort" +
+			to_string( spillCount++ );
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,104 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ExternalSort.h
+ *
+ * @brief Definition file for ExternalSort class
+ *
+ * @details Specifies all member methods of the ExternalSort class, the
+ *          operator behind ORDER BY
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include "HashJoin.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+
+//memory a sort may hold before it writes its rows out as a sorted run
+const long DEFAULT_SORT_BYTES = 64L * 1024 * 1024;
+const long MIN_SORT_BYTES = 64L * 1024;
+
+//runs merged together, more runs are first merged into longer ones
+const unsigned int SORT_MERGE_FANIN = 64;
+
+//how the cells of a sort column are compared
+enum SortValue{
+	SORT_INTEGER,
+	SORT_FLOAT,
+	SORT_TEXT
+};
+
+//one column of an order by clause, an index into the rows sorted
+struct SortKey{
+	int column;
+	SortValue valueType;
+	bool descending;
+};
+
+class ExternalSort{
+	public:
+		ExternalSort();
+		~ExternalSort();
+
+		static bool parseSortKeys( string orderType, const vector< string > &names,
+									const vector< string > &types, vector< SortKey > &keys,
+									string &error );
+		void sortSetup( const vector< SortKey > &keys, string directory );
+		void sortSetLimit( long rowCount );
+		bool sortAdd( const vector< string > &row );
+		bool sortFinish();
+		bool sortNext( vector< string > &row );
+		void sortClose();
+
+	private:
+		vector< SortKey > sortKeys;
+
+		//rows held in memory and the bytes they take, once sorted they are
+		//returned from rowCursor on
+		vector< vector< string > > rows;
+		long rowsBytes;
+		unsigned int rowCursor;
+
+		//a top-n sort keeps only its first rowLimit rows, -1 for all. Once
+		//full they are a heap of row indexes with the last row on top, and
+		//the number each row was added as breaks ties
+		long rowLimit;
+		long rowsAdded;
+		vector< long > rowNumbers;
+		vector< int > topHeap;
+
+		//sorted runs written to the spill directory, and the runs being merged
+		//with the next row of each in a heap
+		string spillDirectory;
+		int spillCount;
+		vector< string > runPaths;
+		vector< ifstream * > mergeRuns;
+		vector< vector< string > > mergeRows;
+		vector< int > mergeHeap;
+
+		bool rowLess( const vector< string > &first, const vector< string > &second ) const;
+		bool heapAfter( int first, int second ) const;
+		bool topBefore( int first, int second ) const;
+		void topReplace( const vector< string > &row );
+		void topSort();
+		bool spillRun();
+		bool openRuns( unsigned int first, unsigned int last );
+		bool nextMerged( vector< string > &row );
+		void closeRuns();
+		bool mergePass();
+		string spillPath();
+};
+
+//memory budget of every sort of the process
+extern long sortMemoryBytes;
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
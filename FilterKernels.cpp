@@ -0,0 +1,618 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file FilterKernels.cpp
+ *
+ * @brief Implementation file for the batch filter kernels
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the comparison kernels behind float and int column
+ *          predicates, on doubles and on 64 bit integers. The AVX2 kernels
+ *          compare four values per instruction and the SSE4.2 kernels two,
+ *          they are compiled for their instruction set with a target
+ *          attribute so the program still runs on a CPU without it, where
+ *          the scalar kernel is used. Every kernel treats NaN the way the
+ *          C++ operators do
+ *
+ * @Note Requires FilterKernels.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+#include "FilterKernels.h"
+
+#ifdef FILTER_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef FILTERKERNELS_CPP
+#define FILTERKERNELS_CPP
+
+/**
+ * @brief selectionWords
+ *
+ * @details returns the number of bitmap words that hold count rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @return unsigned int
+ *
+ * @note None
+ */
+unsigned int selectionWords( unsigned int count )
+{
+	return ( count + SELECTION_WORD_BITS - 1 ) / SELECTION_WORD_BITS;
+}
+
+/**
+ * @brief selectAll
+ *
+ * @details selects the first count rows, the bits past them stay clear
+ *
+ * @param [out] vector< uint64_t > &selection
+ *
+ * @param [in] unsigned int count
+ *
+ * @return None
+ *
+ * @note None
+ */
+void selectAll( vector< uint64_t > &selection, unsigned int count )
+{
+	unsigned int words = selectionWords( count );
+	selection.assign( words, ~(uint64_t)0 );
+	if( count % SELECTION_WORD_BITS != 0 )
+	{
+		selection[ words - 1 ] = ( (uint64_t)1 << ( count % SELECTION_WORD_BITS ) ) - 1;
+	}
+}
+
+/**
+ * @brief anySelected
+ *
+ * @details checks whether any of count rows is selected
+ *
+ * @param [in] const uint64_t *selection
+ *
+ * @param [in] unsigned int count
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool anySelected( const uint64_t *selection, unsigned int count )
+{
+	for( unsigned int word = 0; word < selectionWords( count ); word++ )
+	{
+		if( selection[ word ] != 0 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief rowSelected
+ *
+ * @details checks the bit of one row
+ *
+ * @param [in] const uint64_t *selection
+ *
+ * @param [in] unsigned int rowIndex
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool rowSelected( const uint64_t *selection, unsigned int rowIndex )
+{
+	return ( selection[ rowIndex / SELECTION_WORD_BITS ] >> ( rowIndex % SELECTION_WORD_BITS ) ) & 1;
+}
+
+/**
+ * @brief compareScalar
+ *
+ * @details compares one value with the constant
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] ValueType value
+ *
+ * @param [in] ValueType constant
+ *
+ * @return bool
+ *
+ * @note None
+ */
+template< typename ValueType >
+inline bool compareScalar( CompareOp op, ValueType value, ValueType constant )
+{
+	switch( op )
+	{
+		case COMPARE_EQUAL:
+			return value == constant;
+		case COMPARE_NOT_EQUAL:
+			return value != constant;
+		case COMPARE_LESS:
+			return value < constant;
+		case COMPARE_LESS_EQUAL:
+			return value <= constant;
+		case COMPARE_GREATER:
+			return value > constant;
+		case COMPARE_GREATER_EQUAL:
+			return value >= constant;
+		default:
+			return false;
+	}
+}
+
+/**
+ * @brief filterScalar
+ *
+ * @details sets the match bit of every value from start on one at a time,
+ *          the vector kernels finish their batch with it
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const ValueType *values
+ *
+ * @param [in] unsigned int start
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] ValueType constant
+ *
+ * @param [out] uint64_t *matches cleared by the caller
+ *
+ * @return None
+ *
+ * @note None
+ */
+template< typename ValueType >
+void filterScalar( CompareOp op, const ValueType *values, unsigned int start, unsigned int count,
+					ValueType constant, uint64_t *matches )
+{
+	for( unsigned int index = start; index < count; index++ )
+	{
+		if( compareScalar( op, values[ index ], constant ) )
+		{
+			matches[ index / SELECTION_WORD_BITS ] |= (uint64_t)1 << ( index % SELECTION_WORD_BITS );
+		}
+	}
+}
+
+#ifdef FILTER_X86
+
+/**
+ * @brief compareSse
+ *
+ * @details compares two values with the constant
+ *
+ * @return int one bit per value
+ *
+ * @note None
+ */
+__attribute__(( target( "sse4.2" ) ))
+inline int compareSse( CompareOp op, __m128d values, __m128d constant )
+{
+	switch( op )
+	{
+		case COMPARE_EQUAL:
+			return _mm_movemask_pd( _mm_cmpeq_pd( values, constant ) );
+		case COMPARE_NOT_EQUAL:
+			return _mm_movemask_pd( _mm_cmpneq_pd( values, constant ) );
+		case COMPARE_LESS:
+			return _mm_movemask_pd( _mm_cmplt_pd( values, constant ) );
+		case COMPARE_LESS_EQUAL:
+			return _mm_movemask_pd( _mm_cmple_pd( values, constant ) );
+		case COMPARE_GREATER:
+			return _mm_movemask_pd( _mm_cmpgt_pd( values, constant ) );
+		case COMPARE_GREATER_EQUAL:
+			return _mm_movemask_pd( _mm_cmpge_pd( values, constant ) );
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief filterSse
+ *
+ * @details sets the match bits two values per comparison
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const double *values
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] double constant
+ *
+ * @param [out] uint64_t *matches cleared by the caller
+ *
+ * @return None
+ *
+ * @note None
+ */
+__attribute__(( target( "sse4.2" ) ))
+void filterSse( CompareOp op, const double *values, unsigned int count, double constant,
+				uint64_t *matches )
+{
+	__m128d constants = _mm_set1_pd( constant );
+	unsigned int index = 0;
+	for( ; index + 2 <= count; index += 2 )
+	{
+		uint64_t bits = compareSse( op, _mm_loadu_pd( values + index ), constants );
+		matches[ index / SELECTION_WORD_BITS ] |= bits << ( index % SELECTION_WORD_BITS );
+	}
+	filterScalar( op, values, index, count, constant, matches );
+}
+
+/**
+ * @brief compareSse
+ *
+ * @details compares two 64 bit integers with the constant, SSE4.2 only has
+ *          = and >, the other operators are built from them
+ *
+ * @return int one bit per value
+ *
+ * @note None
+ */
+__attribute__(( target( "sse4.2" ) ))
+inline int compareSse( CompareOp op, __m128i values, __m128i constant )
+{
+	switch( op )
+	{
+		case COMPARE_EQUAL:
+			return _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpeq_epi64( values, constant ) ) );
+		case COMPARE_NOT_EQUAL:
+			return _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpeq_epi64( values, constant ) ) ) ^ 0x3;
+		case COMPARE_LESS:
+			return _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpgt_epi64( constant, values ) ) );
+		case COMPARE_LESS_EQUAL:
+			return _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpgt_epi64( values, constant ) ) ) ^ 0x3;
+		case COMPARE_GREATER:
+			return _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpgt_epi64( values, constant ) ) );
+		case COMPARE_GREATER_EQUAL:
+			return _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpgt_epi64( constant, values ) ) ) ^ 0x3;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief filterSse
+ *
+ * @details sets the match bits two 64 bit integers per comparison
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const long long *values
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] long long constant
+ *
+ * @param [out] uint64_t *matches cleared by the caller
+ *
+ * @return None
+ *
+ * @note None
+ */
+__attribute__(( target( "sse4.2" ) ))
+void filterSse( CompareOp op, const long long *values, unsigned int count, long long constant,
+				uint64_t *matches )
+{
+	__m128i constants = _mm_set1_epi64x( constant );
+	unsigned int index = 0;
+	for( ; index + 2 <= count; index += 2 )
+	{
+		__m128i loaded = _mm_loadu_si128( (const __m128i *)( values + index ) );
+		uint64_t bits = compareSse( op, loaded, constants );
+		matches[ index / SELECTION_WORD_BITS ] |= bits << ( index % SELECTION_WORD_BITS );
+	}
+	filterScalar( op, values, index, count, constant, matches );
+}
+
+/**
+ * @brief compareAvx
+ *
+ * @details compares four values with the constant, ordered comparisons
+ *          fail on NaN and the unordered != holds on it
+ *
+ * @return int one bit per value
+ *
+ * @note None
+ */
+__attribute__(( target( "avx2" ) ))
+inline int compareAvx( CompareOp op, __m256d values, __m256d constant )
+{
+	switch( op )
+	{
+		case COMPARE_EQUAL:
+			return _mm256_movemask_pd( _mm256_cmp_pd( values, constant, _CMP_EQ_OQ ) );
+		case COMPARE_NOT_EQUAL:
+			return _mm256_movemask_pd( _mm256_cmp_pd( values, constant, _CMP_NEQ_UQ ) );
+		case COMPARE_LESS:
+			return _mm256_movemask_pd( _mm256_cmp_pd( values, constant, _CMP_LT_OQ ) );
+		case COMPARE_LESS_EQUAL:
+			return _mm256_movemask_pd( _mm256_cmp_pd( values, constant, _CMP_LE_OQ ) );
+		case COMPARE_GREATER:
+			return _mm256_movemask_pd( _mm256_cmp_pd( values, constant, _CMP_GT_OQ ) );
+		case COMPARE_GREATER_EQUAL:
+			return _mm256_movemask_pd( _mm256_cmp_pd( values, constant, _CMP_GE_OQ ) );
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief filterAvx
+ *
+ * @details sets the match bits four values per comparison
+ *
+ * @par Algorithm sixteen values, four comparisons, fill 16 bits of the
+ *      bitmap at a time
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const double *values
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] double constant
+ *
+ * @param [out] uint64_t *matches cleared by the caller
+ *
+ * @return None
+ *
+ * @note None
+ */
+__attribute__(( target( "avx2" ) ))
+void filterAvx( CompareOp op, const double *values, unsigned int count, double constant,
+				uint64_t *matches )
+{
+	__m256d constants = _mm256_set1_pd( constant );
+	unsigned int index = 0;
+	for( ; index + 16 <= count; index += 16 )
+	{
+		uint64_t bits = compareAvx( op, _mm256_loadu_pd( values + index ), constants );
+		bits |= (uint64_t)compareAvx( op, _mm256_loadu_pd( values + index + 4 ), constants ) << 4;
+		bits |= (uint64_t)compareAvx( op, _mm256_loadu_pd( values + index + 8 ), constants ) << 8;
+		bits |= (uint64_t)compareAvx( op, _mm256_loadu_pd( values + index + 12 ), constants ) << 12;
+		matches[ index / SELECTION_WORD_BITS ] |= bits << ( index % SELECTION_WORD_BITS );
+	}
+	filterScalar( op, values, index, count, constant, matches );
+}
+
+/**
+ * @brief compareAvx
+ *
+ * @details compares four 64 bit integers with the constant, AVX2 only has
+ *          = and >, the other operators are built from them
+ *
+ * @return int one bit per value
+ *
+ * @note None
+ */
+__attribute__(( target( "avx2" ) ))
+inline int compareAvx( CompareOp op, __m256i values, __m256i constant )
+{
+	switch( op )
+	{
+		case COMPARE_EQUAL:
+			return _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpeq_epi64( values, constant ) ) );
+		case COMPARE_NOT_EQUAL:
+			return _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpeq_epi64( values, constant ) ) ) ^ 0xf;
+		case COMPARE_LESS:
+			return _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpgt_epi64( constant, values ) ) );
+		case COMPARE_LESS_EQUAL:
+			return _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpgt_epi64( values, constant ) ) ) ^ 0xf;
+		case COMPARE_GREATER:
+			return _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpgt_epi64( values, constant ) ) );
+		case COMPARE_GREATER_EQUAL:
+			return _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpgt_epi64( constant, values ) ) ) ^ 0xf;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief filterAvx
+ *
+ * @details sets the match bits four 64 bit integers per comparison
+ *
+ * @par Algorithm sixteen values, four comparisons, fill 16 bits of the
+ *      bitmap at a time
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const long long *values
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] long long constant
+ *
+ * @param [out] uint64_t *matches cleared by the caller
+ *
+ * @return None
+ *
+ * @note None
+ */
+__attribute__(( target( "avx2" ) ))
+void filterAvx( CompareOp op, const long long *values, unsigned int count, long long constant,
+				uint64_t *matches )
+{
+	__m256i constants = _mm256_set1_epi64x( constant );
+	unsigned int index = 0;
+	for( ; index + 16 <= count; index += 16 )
+	{
+		const __m256i *loaded = (const __m256i *)( values + index );
+		uint64_t bits = compareAvx( op, _mm256_loadu_si256( loaded ), constants );
+		bits |= (uint64_t)compareAvx( op, _mm256_loadu_si256( loaded + 1 ), constants ) << 4;
+		bits |= (uint64_t)compareAvx( op, _mm256_loadu_si256( loaded + 2 ), constants ) << 8;
+		bits |= (uint64_t)compareAvx( op, _mm256_loadu_si256( loaded + 3 ), constants ) << 12;
+		matches[ index / SELECTION_WORD_BITS ] |= bits << ( index % SELECTION_WORD_BITS );
+	}
+	filterScalar( op, values, index, count, constant, matches );
+}
+
+#endif
+
+/**
+ * @brief detectInstructions
+ *
+ * @details picks the widest instruction set the CPU runs
+ *
+ * @return FilterInstructions
+ *
+ * @note None
+ */
+FilterInstructions detectInstructions()
+{
+#ifdef FILTER_X86
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx2" ) )
+	{
+		return FILTER_AVX2;
+	}
+	if( __builtin_cpu_supports( "sse4.2" ) )
+	{
+		return FILTER_SSE42;
+	}
+#endif
+	return FILTER_SCALAR;
+}
+
+//widest instruction set of this CPU, the kernels switch on it
+FilterInstructions cpuInstructions = detectInstructions();
+
+/**
+ * @brief filterInstructions
+ *
+ * @details returns the instruction set the kernels use
+ *
+ * @return FilterInstructions
+ *
+ * @note None
+ */
+FilterInstructions filterInstructions()
+{
+	return cpuInstructions;
+}
+
+/**
+ * @brief filterValues
+ *
+ * @details clears the selection bit of every value that fails the
+ *          comparison with the constant, with the widest kernel of the CPU
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const ValueType *values one per row, unselected rows are
+ *             ignored
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] ValueType constant
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+template< typename ValueType >
+void filterValues( CompareOp op, const ValueType *values, unsigned int count, ValueType constant,
+					uint64_t *selection )
+{
+	uint64_t matches[ FILTER_BATCH_ROWS / SELECTION_WORD_BITS ];
+	unsigned int done = 0;
+
+	while( done < count )
+	{
+		unsigned int batch = min( count - done, FILTER_BATCH_ROWS );
+		uint64_t *batchSelection = selection + done / SELECTION_WORD_BITS;
+		memset( matches, 0, sizeof( matches ) );
+#ifdef FILTER_X86
+		if( cpuInstructions == FILTER_AVX2 )
+		{
+			filterAvx( op, values + done, batch, constant, matches );
+		}
+		else if( cpuInstructions == FILTER_SSE42 )
+		{
+			filterSse( op, values + done, batch, constant, matches );
+		}
+		else
+#endif
+		{
+			filterScalar( op, values + done, 0, batch, constant, matches );
+		}
+		for( unsigned int word = 0; word < selectionWords( batch ); word++ )
+		{
+			batchSelection[ word ] &= matches[ word ];
+		}
+		done += batch;
+	}
+}
+
+/**
+ * @brief filterDoubles
+ *
+ * @details clears the selection bit of every double that fails the
+ *          comparison with the constant
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const double *values one per row, unselected rows are ignored
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] double constant
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+void filterDoubles( CompareOp op, const double *values, unsigned int count, double constant,
+					uint64_t *selection )
+{
+	filterValues( op, values, count, constant, selection );
+}
+
+/**
+ * @brief filterIntegers
+ *
+ * @details clears the selection bit of every 64 bit integer that fails the
+ *          comparison with the constant
+ *
+ * @param [in] CompareOp op
+ *
+ * @param [in] const long long *values one per row, unselected rows are
+ *             ignored
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] long long constant
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+void filterIntegers( CompareOp op, const long long *values, unsigned int count, long long constant,
+						uint64_t *selection )
+{
+	filterValues( op, values, count, constant, selection );
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,53 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file FilterKernels.h
+ *
+ * @brief Definition file for the batch filter kernels
+ *
+ * @details Specifies the kernels that compare a batch of decoded column
+ *          values with a constant and clear the selection bits of the rows
+ *          that fail, several values per instruction where the CPU allows
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "WherePredicate.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef FILTERKERNELS_H
+#define FILTERKERNELS_H
+
+//the vector kernels are built for x86 processors, others use the scalar ones
+#if defined( __x86_64__ ) || defined( __i386__ )
+#define FILTER_X86
+#endif
+
+//rows filtered together, a selection bitmap holds one bit per row
+const unsigned int FILTER_BATCH_ROWS = 1024;
+const unsigned int SELECTION_WORD_BITS = 64;
+
+//instruction sets a kernel may use, picked once at startup
+enum FilterInstructions{
+	FILTER_SCALAR,
+	FILTER_SSE42,
+	FILTER_AVX2
+};
+
+unsigned int selectionWords( unsigned int count );
+void selectAll( vector< uint64_t > &selection, unsigned int count );
+bool anySelected( const uint64_t *selection, unsigned int count );
+bool rowSelected( const uint64_t *selection, unsigned int rowIndex );
+void filterDoubles( CompareOp op, const double *values, unsigned int count, double constant,
+					uint64_t *selection );
+void filterIntegers( CompareOp op, const long long *values, unsigned int count, long long constant,
+						uint64_t *selection );
+FilterInstructions filterInstructions();
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
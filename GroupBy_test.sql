@@ -0,0 +1,28 @@
+--CS457 group by
+
+--Aggregates over the whole table and per group, with the errors of the select list
+
+CREATE DATABASE GroupBy;
+USE GroupBy;
+
+create table Sales (region varchar(10), qty int, price float);
+insert into Sales values('east', 3, 2.5);
+insert into Sales values('west', 10, 1.0);
+insert into Sales values('east', 7, 4.0);
+insert into Sales values('north', 1, 9.5);
+insert into Sales values('west', 2, 3.0);
+insert into Sales values('east', 0, 8.0);
+
+select count(*) from Sales;
+select count(*), sum(qty), avg(price), min(qty), max(price) from Sales where qty > 1;
+select region, count(*), sum(qty), avg(price), min(qty), max(price) from Sales group by region;
+select region, sum(qty) from Sales where qty > 0 group by region;
+SELECT region, COUNT(*) FROM Sales GROUP BY region;
+
+select region, sum(qty) from Sales group by;
+select region, sum(qty) from Sales group by city;
+select region, qty from Sales group by region;
+select avg(cost) from Sales;
+
+DROP DATABASE GroupBy;
+.EXIT
@@ -0,0 +1,1011 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file HashAggregate.cpp
+ *
+ * @brief Implementation file for HashAggregate class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements count, sum, avg, min and max with an optional GROUP BY.
+ *          Every row that passes the where condition is folded into the
+ *          running results of its group, found in an open addressing hash
+ *          table, so only one line per group is output and the table is
+ *          never held in memory. On the worker threads every worker adds
+ *          rows to a table of its own, and the tables are merged one hash
+ *          partition per worker once the scan is done, so no lock is taken
+ *          for a row
+ *
+ * @Note Requires HashAggregate.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+#include "HashAggregate.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef HASHAGGREGATE_CPP
+#define HASHAGGREGATE_CPP
+
+//helper functions implemented in Table.cpp, TableScan.cpp, Database.cpp and sim.cpp
+void removeLeadingWS( string &input );
+int getCommaCount( string str );
+int findAttrOccur( vector< Attribute > attributes, string attrName );
+bool caseInsCompare( const string &s1, const string &s2 );
+void convertToUC( string &input );
+void convertToLC( string &input );
+void outputRow( const vector< string > &row );
+
+//numbers every parallel aggregate, so a worker knows when its own table
+//belongs to an aggregate that has finished
+atomic< unsigned long > aggregateGeneration( 0 );
+
+/**
+ * @brief trimAggregateTerm
+ *
+ * @details removes the white space around a term of the select list
+ *
+ * @param [in/out] string &term
+ *
+ * @return None
+ *
+ * @note None
+ */
+void trimAggregateTerm( string &term )
+{
+	removeLeadingWS( term );
+	while( !term.empty() && isspace( (unsigned char)term[ term.size() - 1 ] ) )
+	{
+		term.erase( term.size() - 1 );
+	}
+}
+
+/**
+ * @brief splitAggregateTerms
+ *
+ * @details splits a comma separated list into its trimmed terms
+ *
+ * @param [in] string list
+ *
+ * @param [out] vector< string > &terms
+ *
+ * @return None
+ *
+ * @note None
+ */
+void splitAggregateTerms( string list, vector< string > &terms )
+{
+	int commaCount = getCommaCount( list );
+	terms.clear();
+	for( int index = 0; index < commaCount + 1; index++ )
+	{
+		string term = list.substr( 0, list.find( "," ) );
+		list.erase( 0, list.find( "," ) + 1 );
+		trimAggregateTerm( term );
+		terms.push_back( term );
+	}
+}
+
+/**
+ * @brief compareText
+ *
+ * @details compares two text cells without their quotes
+ *
+ * @param [in] string &first
+ *
+ * @param [in] string &second
+ *
+ * @return int less than, equal to or greater than 0 as first sorts before,
+ *         with or after second
+ *
+ * @note None
+ */
+int compareText( const string &first, const string &second )
+{
+	const char *firstText = first.data();
+	const char *secondText = second.data();
+	size_t firstLength = first.size();
+	size_t secondLength = second.size();
+	if( firstLength >= 2 && first[ 0 ] == '\'' && first[ firstLength - 1 ] == '\'' )
+	{
+		firstText++;
+		firstLength -= 2;
+	}
+	if( secondLength >= 2 && second[ 0 ] == '\'' && second[ secondLength - 1 ] == '\'' )
+	{
+		secondText++;
+		secondLength -= 2;
+	}
+	int result = memcmp( firstText, secondText, min( firstLength, secondLength ) );
+	if( result != 0 )
+	{
+		return result;
+	}
+	return firstLength < secondLength ? -1 : firstLength > secondLength ? 1 : 0;
+}
+
+/**
+ * @brief formatNumber
+ *
+ * @details formats a float result with up to 15 significant digits
+ *
+ * @param [in] double value
+ *
+ * @return string
+ *
+ * @note None
+ */
+string formatNumber( double value )
+{
+	char text[ 32 ];
+	snprintf( text, sizeof( text ), "%.15g", value );
+	return text;
+}
+
+/**
+ * @brief HashAggregate default constructor
+ *
+ * @details a new aggregate has no groups
+ *
+ * @note None
+ */
+HashAggregate::HashAggregate()
+{
+	groupCount = 0;
+	rowsAdded = 0;
+	slots.assign( AGGREGATE_INITIAL_SLOTS, -1 );
+	slotMask = AGGREGATE_INITIAL_SLOTS - 1;
+}
+
+/**
+ * @brief HashAggregate default destructor
+ *
+ * @details releases the groups
+ *
+ * @note None
+ */
+HashAggregate::~HashAggregate()
+{
+}
+
+/**
+ * @brief isAggregateQuery
+ *
+ * @details checks whether a select groups its rows
+ *
+ * @param [in] string queryType the select list
+ *
+ * @param [in] string groupType the columns of the group by clause
+ *
+ * @return bool true if there is a group by clause or a function in the
+ *         select list
+ *
+ * @note None
+ */
+bool HashAggregate::isAggregateQuery( string queryType, string groupType )
+{
+	removeLeadingWS( groupType );
+	return !groupType.empty() || queryType.find( '(' ) != string::npos;
+}
+
+/**
+ * @brief aggregateSetup
+ *
+ * @details parses the select list and the group by columns
+ *
+ * @pre attributes are the columns of the table read
+ *
+ * @post every row passed to aggregateRow is added to its group
+ *
+ * @par Algorithm terms of the select list are either a grouped column or
+ *      a function of one column, count also takes *. Sum and avg need an
+ *      int or float column, min and max compare int and float columns as
+ *      numbers and other columns as text
+ *
+ * @param [in] string queryType
+ *
+ * @param [in] string groupType
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @param [out] string &error why the query cannot run
+ *
+ * @return bool false if the query cannot run
+ *
+ * @note None
+ */
+bool HashAggregate::aggregateSetup( string queryType, string groupType,
+									const vector< Attribute > &attributes, string &error )
+{
+	vector< string > terms;
+
+	groupColumns.clear();
+	functions.clear();
+	outputs.clear();
+	trimAggregateTerm( groupType );
+	if( !groupType.empty() )
+	{
+		splitAggregateTerms( groupType, terms );
+		for( unsigned int index = 0; index < terms.size(); index++ )
+		{
+			int column = findAttrOccur( attributes, terms[ index ] );
+			if( column < 0 )
+			{
+				error = "column " + terms[ index ] + " does not exist";
+				return false;
+			}
+			groupColumns.push_back( column );
+		}
+	}
+
+	splitAggregateTerms( queryType, terms );
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		string term = terms[ index ];
+		size_t open = term.find( '(' );
+		size_t close = term.rfind( ')' );
+		AggregateOutput output;
+		if( open == string::npos )
+		{
+			int column = findAttrOccur( attributes, term );
+			output.isFunction = false;
+			output.index = -1;
+			for( unsigned int group = 0; group < groupColumns.size(); group++ )
+			{
+				if( column >= 0 && groupColumns[ group ] == column )
+				{
+					output.index = group;
+				}
+			}
+			if( output.index < 0 )
+			{
+				error = term + " is not a grouped column";
+				return false;
+			}
+			outputs.push_back( output );
+			continue;
+		}
+
+		AggregateFunction function;
+		string functionName = term.substr( 0, open );
+		string argument = close == string::npos || close < open ? "" : term.substr( open + 1, close - open - 1 );
+		trimAggregateTerm( functionName );
+		trimAggregateTerm( argument );
+		convertToUC( functionName );
+		if( functionName == "COUNT" )
+		{
+			function.type = AGGREGATE_COUNT;
+		}
+		else if( functionName == "SUM" )
+		{
+			function.type = AGGREGATE_SUM;
+		}
+		else if( functionName == "AVG" )
+		{
+			function.type = AGGREGATE_AVG;
+		}
+		else if( functionName == "MIN" )
+		{
+			function.type = AGGREGATE_MIN;
+		}
+		else if( functionName == "MAX" )
+		{
+			function.type = AGGREGATE_MAX;
+		}
+		else
+		{
+			error = term + " is not an aggregate function";
+			return false;
+		}
+
+		function.column = -1;
+		function.valueType = VALUE_INTEGER;
+		function.outputType = "int";
+		if( argument != "*" || function.type != AGGREGATE_COUNT )
+		{
+			function.column = findAttrOccur( attributes, argument );
+			if( function.column < 0 )
+			{
+				error = "column " + argument + " does not exist";
+				return false;
+			}
+			string columnType = attributes[ function.column ].attributeType;
+			if( caseInsCompare( columnType, "float" ) )
+			{
+				function.valueType = VALUE_FLOAT;
+			}
+			else if( !caseInsCompare( columnType, "int" ) )
+			{
+				function.valueType = VALUE_TEXT;
+			}
+			if( function.valueType == VALUE_TEXT &&
+				( function.type == AGGREGATE_SUM || function.type == AGGREGATE_AVG ) )
+			{
+				error = term + " needs an int or float column";
+				return false;
+			}
+			if( function.type == AGGREGATE_AVG )
+			{
+				function.outputType = "float";
+			}
+			else if( function.type != AGGREGATE_COUNT )
+			{
+				function.outputType = columnType;
+			}
+		}
+		convertToLC( functionName );
+		function.name = functionName + "(" + argument + ")";
+
+		output.isFunction = true;
+		output.index = functions.size();
+		outputs.push_back( output );
+		functions.push_back( function );
+	}
+	return true;
+}
+
+/**
+ * @brief copySetup
+ *
+ * @details takes the select list and group by columns of another aggregate
+ *
+ * @param [in] HashAggregate &other
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::copySetup( const HashAggregate &other )
+{
+	groupColumns = other.groupColumns;
+	functions = other.functions;
+	outputs = other.outputs;
+}
+
+/**
+ * @brief aggregateRow
+ *
+ * @details adds the next row of the scan to the results of its group
+ *
+ * @param [in] vector< string > &row every column of the table
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::aggregateRow( const vector< string > &row )
+{
+	addRow( row, rowsAdded++ );
+}
+
+/**
+ * @brief addRow
+ *
+ * @details adds one row to the results of its group
+ *
+ * @param [in] vector< string > &row every column of the table
+ *
+ * @param [in] long position of the row in the order of the scan
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::addRow( const vector< string > &row, long position )
+{
+	const string *cells = row.empty() ? NULL : &row[ 0 ];
+	const int *columns = groupColumns.empty() ? NULL : &groupColumns[ 0 ];
+	int group = findGroup( cells, columns, hashGroup( row ), position );
+	AggregateState *states = &groupStates[ group * functions.size() ];
+	for( unsigned int index = 0; index < functions.size(); index++ )
+	{
+		updateState( states[ index ], functions[ index ], row );
+	}
+}
+
+/**
+ * @brief aggregateParallel
+ *
+ * @details adds the selected rows of a scan to their groups using every
+ *          worker
+ *
+ * @pre scan was opened on filePath, its where condition is set and every
+ *      column is projected
+ *
+ * @post the groups are the same, and output in the same order, as when the
+ *       rows are added one at a time
+ *
+ * @par Algorithm every worker adds the rows of its morsels to a table of
+ *      its own, taking a lock only when it creates that table. The tables
+ *      are then merged by hash partition, one partition per worker, and
+ *      the partitions are joined without comparing any keys since no
+ *      group is in two of them
+ *
+ * @param [in] TableScan &scan
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if the scan has to be read on this thread
+ *
+ * @note None
+ */
+bool HashAggregate::aggregateParallel( TableScan &scan, string filePath )
+{
+	ParallelScan parallelScan;
+	vector< HashAggregate * > partials;
+	mutex partialsLock;
+	unsigned long generation = ++aggregateGeneration;
+
+	bool scanned = parallelScan.scanRows( scan, filePath,
+		[ this, &scan, &partials, &partialsLock, generation ]( const vector< vector< string > > &rows,
+															unsigned int count, long firstRow, string & )
+	{
+		thread_local HashAggregate *localPartial = NULL;
+		thread_local unsigned long localGeneration = 0;
+		if( localGeneration != generation )
+		{
+			localPartial = new HashAggregate();
+			localPartial->copySetup( *this );
+			localGeneration = generation;
+			lock_guard< mutex > guard( partialsLock );
+			partials.push_back( localPartial );
+		}
+
+		vector< uint64_t > selection;
+		selectAll( selection, count );
+		scan.filterBatch( rows, count, &selection[ 0 ] );
+		for( unsigned int rowIndex = 0; rowIndex < count; rowIndex++ )
+		{
+			if( rowSelected( &selection[ 0 ], rowIndex ) )
+			{
+				localPartial->addRow( rows[ rowIndex ], firstRow + rowIndex );
+			}
+		}
+	} );
+
+	if( scanned )
+	{
+		mergePartials( partials );
+	}
+	for( unsigned int index = 0; index < partials.size(); index++ )
+	{
+		delete partials[ index ];
+	}
+	return scanned;
+}
+
+/**
+ * @brief hashGroup
+ *
+ * @details hashes the grouped columns of a row
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return uint64_t
+ *
+ * @note None
+ */
+uint64_t HashAggregate::hashGroup( const vector< string > &row ) const
+{
+	hash< string > hashKey;
+	uint64_t mixed = 0xcbf29ce484222325ULL;
+	for( unsigned int index = 0; index < groupColumns.size(); index++ )
+	{
+		mixed = ( mixed ^ hashKey( row[ groupColumns[ index ] ] ) ) * 0x100000001b3ULL;
+	}
+	return mixed ^ ( mixed >> 32 );
+}
+
+/**
+ * @brief findGroup
+ *
+ * @details finds the group of a set of keys, adding it if it is new
+ *
+ * @par Algorithm linear probing from the slot of the hash, the stored hash
+ *      is compared before the keys. The table is doubled once it is half
+ *      full so probes stay short
+ *
+ * @param [in] const string *keys the cells of a row, or the keys of a group
+ *
+ * @param [in] const int *columns where each key is in the cells, NULL if
+ *             the keys come one after the other
+ *
+ * @param [in] uint64_t hash
+ *
+ * @param [in] long position of the row in the order of the scan, a group
+ *             keeps the first
+ *
+ * @return int the number of the group
+ *
+ * @note None
+ */
+int HashAggregate::findGroup( const string *keys, const int *columns, uint64_t hash, long position )
+{
+	unsigned int keyCount = groupColumns.size();
+	unsigned int slot = hash & slotMask;
+	while( slots[ slot ] >= 0 )
+	{
+		int group = slots[ slot ];
+		if( groupHashes[ group ] == hash )
+		{
+			const string *groupKey = keyCount == 0 ? NULL : &groupKeys[ group * keyCount ];
+			unsigned int index = 0;
+			while( index < keyCount && groupKey[ index ] == keys[ columns == NULL ? index : columns[ index ] ] )
+			{
+				index++;
+			}
+			if( index == keyCount )
+			{
+				if( position < groupFirstRows[ group ] )
+				{
+					groupFirstRows[ group ] = position;
+				}
+				return group;
+			}
+		}
+		slot = ( slot + 1 ) & slotMask;
+	}
+
+	int group = groupCount++;
+	for( unsigned int index = 0; index < keyCount; index++ )
+	{
+		groupKeys.push_back( keys[ columns == NULL ? index : columns[ index ] ] );
+	}
+	AggregateState emptyState;
+	emptyState.count = 0;
+	emptyState.integerSum = 0;
+	emptyState.floatSum = 0;
+	emptyState.minNumber = 0;
+	emptyState.maxNumber = 0;
+	groupStates.resize( groupStates.size() + functions.size(), emptyState );
+	groupHashes.push_back( hash );
+	groupFirstRows.push_back( position );
+	slots[ slot ] = group;
+	if( groupCount * 2 > slots.size() )
+	{
+		resizeSlots( slots.size() * 2 );
+	}
+	return group;
+}
+
+/**
+ * @brief resizeSlots
+ *
+ * @details gives the group table a new number of slots and places every
+ *          group again
+ *
+ * @param [in] unsigned int slotCount a power of two, more than twice the
+ *             number of groups
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::resizeSlots( unsigned int slotCount )
+{
+	slots.assign( slotCount, -1 );
+	slotMask = slots.size() - 1;
+	for( unsigned int group = 0; group < groupCount; group++ )
+	{
+		unsigned int slot = groupHashes[ group ] & slotMask;
+		while( slots[ slot ] >= 0 )
+		{
+			slot = ( slot + 1 ) & slotMask;
+		}
+		slots[ slot ] = group;
+	}
+}
+
+/**
+ * @brief updateState
+ *
+ * @details adds the cell of a row to the running result of a function
+ *
+ * @par Algorithm null cells are not counted, see isNullValue
+ *
+ * @param [in/out] AggregateState &state
+ *
+ * @param [in] AggregateFunction &function
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::updateState( AggregateState &state, const AggregateFunction &function,
+									const vector< string > &row ) const
+{
+	if( function.column < 0 )
+	{
+		state.count++;
+		return;
+	}
+	const string &cell = row[ function.column ];
+	if( isNullValue( cell ) )
+	{
+		return;
+	}
+	state.count++;
+
+	if( function.type == AGGREGATE_SUM || function.type == AGGREGATE_AVG )
+	{
+		if( function.valueType == VALUE_INTEGER )
+		{
+			state.integerSum += strtoll( cell.c_str(), NULL, 10 );
+		}
+		else
+		{
+			state.floatSum += strtod( cell.c_str(), NULL );
+		}
+	}
+	else if( function.type == AGGREGATE_MIN || function.type == AGGREGATE_MAX )
+	{
+		bool isMin = function.type == AGGREGATE_MIN;
+		string &value = isMin ? state.minValue : state.maxValue;
+		bool replace = state.count == 1;
+		if( !replace && function.valueType == VALUE_TEXT )
+		{
+			int order = compareText( cell, value );
+			replace = isMin ? order < 0 : order > 0;
+		}
+		else if( function.valueType != VALUE_TEXT )
+		{
+			double number = strtod( cell.c_str(), NULL );
+			double &bound = isMin ? state.minNumber : state.maxNumber;
+			replace = replace || ( isMin ? number < bound : number > bound );
+			if( replace )
+			{
+				bound = number;
+			}
+		}
+		if( replace )
+		{
+			value = cell;
+		}
+	}
+}
+
+/**
+ * @brief mergeState
+ *
+ * @details adds the result of a function over some rows to its result over
+ *          others
+ *
+ * @param [in/out] AggregateState &state
+ *
+ * @param [in] AggregateState &partial
+ *
+ * @param [in] AggregateFunction &function
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::mergeState( AggregateState &state, const AggregateState &partial,
+								const AggregateFunction &function ) const
+{
+	if( partial.count == 0 )
+	{
+		return;
+	}
+	bool first = state.count == 0;
+	state.count += partial.count;
+	state.integerSum += partial.integerSum;
+	state.floatSum += partial.floatSum;
+	if( function.type != AGGREGATE_MIN && function.type != AGGREGATE_MAX )
+	{
+		return;
+	}
+
+	bool isMin = function.type == AGGREGATE_MIN;
+	const string &partialValue = isMin ? partial.minValue : partial.maxValue;
+	double partialNumber = isMin ? partial.minNumber : partial.maxNumber;
+	string &value = isMin ? state.minValue : state.maxValue;
+	double &number = isMin ? state.minNumber : state.maxNumber;
+	bool replace = first;
+	if( !replace && function.valueType == VALUE_TEXT )
+	{
+		int order = compareText( partialValue, value );
+		replace = isMin ? order < 0 : order > 0;
+	}
+	else if( !replace )
+	{
+		replace = isMin ? partialNumber < number : partialNumber > number;
+	}
+	if( replace )
+	{
+		value = partialValue;
+		number = partialNumber;
+	}
+}
+
+/**
+ * @brief mergePartition
+ *
+ * @details merges the groups of one hash partition of every worker table
+ *
+ * @par Algorithm the high bits of the hash pick the partition, the low
+ *      ones pick the slot
+ *
+ * @param [in] vector< HashAggregate * > &partials
+ *
+ * @param [in] unsigned int partition
+ *
+ * @param [in] unsigned int partitionCount
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::mergePartition( const vector< HashAggregate * > &partials, unsigned int partition,
+									unsigned int partitionCount )
+{
+	unsigned int keyCount = groupColumns.size();
+	unsigned int functionCount = functions.size();
+	for( unsigned int index = 0; index < partials.size(); index++ )
+	{
+		const HashAggregate &partial = *partials[ index ];
+		for( unsigned int group = 0; group < partial.groupCount; group++ )
+		{
+			uint64_t hash = partial.groupHashes[ group ];
+			if( ( hash >> 32 ) % partitionCount != partition )
+			{
+				continue;
+			}
+			const string *keys = keyCount == 0 ? NULL : &partial.groupKeys[ group * keyCount ];
+			int merged = findGroup( keys, NULL, hash, partial.groupFirstRows[ group ] );
+			for( unsigned int function = 0; function < functionCount; function++ )
+			{
+				mergeState( groupStates[ merged * functionCount + function ],
+							partial.groupStates[ group * functionCount + function ], functions[ function ] );
+			}
+		}
+	}
+}
+
+/**
+ * @brief mergePartials
+ *
+ * @details merges the tables the workers filled into this one
+ *
+ * @pre this aggregate has no groups
+ *
+ * @par Algorithm every worker merges one hash partition into a table of
+ *      its own. The partitions hold different groups, so they are appended
+ *      to this table one after the other
+ *
+ * @param [in] vector< HashAggregate * > &partials
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::mergePartials( const vector< HashAggregate * > &partials )
+{
+	unsigned int partitionCount = workerPool.poolGetThreads();
+	vector< HashAggregate > partitions( partitionCount );
+	mutex doneLock;
+	condition_variable partitionDone;
+	unsigned int doneCount = 0;
+
+	for( unsigned int partition = 0; partition < partitionCount; partition++ )
+	{
+		partitions[ partition ].copySetup( *this );
+		workerPool.poolSubmit( [ this, &partials, &partitions, &doneLock, &partitionDone, &doneCount,
+								 partition, partitionCount ]()
+		{
+			partitions[ partition ].mergePartition( partials, partition, partitionCount );
+			lock_guard< mutex > guard( doneLock );
+			doneCount++;
+			partitionDone.notify_all();
+		} );
+	}
+	{
+		unique_lock< mutex > guard( doneLock );
+		while( doneCount < partitionCount )
+		{
+			partitionDone.wait( guard );
+		}
+	}
+
+	for( unsigned int partition = 0; partition < partitionCount; partition++ )
+	{
+		const HashAggregate &merged = partitions[ partition ];
+		groupKeys.insert( groupKeys.end(), merged.groupKeys.begin(), merged.groupKeys.end() );
+		groupStates.insert( groupStates.end(), merged.groupStates.begin(), merged.groupStates.end() );
+		groupHashes.insert( groupHashes.end(), merged.groupHashes.begin(), merged.groupHashes.end() );
+		groupFirstRows.insert( groupFirstRows.end(), merged.groupFirstRows.begin(),
+								merged.groupFirstRows.end() );
+		groupCount += merged.groupCount;
+	}
+	unsigned int slotCount = AGGREGATE_INITIAL_SLOTS;
+	while( slotCount < groupCount * 2 + 1 )
+	{
+		slotCount *= 2;
+	}
+	resizeSlots( slotCount );
+}
+
+/**
+ * @brief stateResult
+ *
+ * @details formats the result of a function for one group
+ *
+ * @param [in] AggregateState &state
+ *
+ * @param [in] AggregateFunction &function
+ *
+ * @return string empty when a function other than count saw no value
+ *
+ * @note None
+ */
+string HashAggregate::stateResult( const AggregateState &state, const AggregateFunction &function ) const
+{
+	if( function.type == AGGREGATE_COUNT )
+	{
+		return to_string( state.count );
+	}
+	if( state.count == 0 )
+	{
+		return "";
+	}
+	switch( function.type )
+	{
+		case AGGREGATE_SUM:
+			if( function.valueType == VALUE_INTEGER )
+			{
+				return to_string( state.integerSum );
+			}
+			return formatNumber( state.floatSum );
+		case AGGREGATE_AVG:
+			if( function.valueType == VALUE_INTEGER )
+			{
+				return formatNumber( (double)state.integerSum / state.count );
+			}
+			return formatNumber( state.floatSum / state.count );
+		case AGGREGATE_MIN:
+			return state.minValue;
+		default:
+			return state.maxValue;
+	}
+}
+
+/**
+ * @brief outputColumns
+ *
+ * @details returns the name and type of every column of the result
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @param [out] vector< string > &names
+ *
+ * @param [out] vector< string > &types
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::outputColumns( const vector< Attribute > &attributes, vector< string > &names,
+									vector< string > &types ) const
+{
+	names.clear();
+	types.clear();
+	for( unsigned int index = 0; index < outputs.size(); index++ )
+	{
+		if( outputs[ index ].isFunction )
+		{
+			const AggregateFunction &function = functions[ outputs[ index ].index ];
+			names.push_back( function.name );
+			types.push_back( function.outputType );
+		}
+		else
+		{
+			const Attribute &attribute = attributes[ groupColumns[ outputs[ index ].index ] ];
+			names.push_back( attribute.attributeName );
+			types.push_back( attribute.attributeType );
+		}
+	}
+}
+
+/**
+ * @brief outputHeader
+ *
+ * @details outputs the select list as "-- a int|count(*) int"
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashAggregate::outputHeader( const vector< Attribute > &attributes )
+{
+	vector< string > names;
+	vector< string > types;
+	outputColumns( attributes, names, types );
+	cout << "-- ";
+	for( unsigned int index = 0; index < names.size(); index++ )
+	{
+		if( index != 0 )
+		{
+			cout << "|";
+		}
+		cout << names[ index ] << " " << types[ index ];
+	}
+	cout << endl;
+}
+
+/**
+ * @brief outputGroups
+ *
+ * @details outputs one row per group in the order the groups were first
+ *          seen, or adds the rows to a sort
+ *
+ * @par Algorithm without group by columns there is exactly one group, also
+ *      when no row matched. Groups are sorted by their first row, the
+ *      order they were added in unless workers added them
+ *
+ * @param [in/out] ExternalSort *sorter receives the rows instead of the
+ *                 output, NULL for none
+ *
+ * @return bool false if the sort could not take a row
+ *
+ * @note None
+ */
+bool HashAggregate::outputGroups( ExternalSort *sorter )
+{
+	vector< string > row( outputs.size() );
+	vector< string > noRow;
+	vector< pair< long, unsigned int > > order;
+
+	if( groupCount == 0 && groupColumns.empty() )
+	{
+		findGroup( NULL, NULL, hashGroup( noRow ), 0 );
+	}
+	for( unsigned int group = 0; group < groupCount; group++ )
+	{
+		order.push_back( make_pair( groupFirstRows[ group ], group ) );
+	}
+	sort( order.begin(), order.end() );
+	for( unsigned int orderIndex = 0; orderIndex < groupCount; orderIndex++ )
+	{
+		unsigned int group = order[ orderIndex ].second;
+		for( unsigned int index = 0; index < outputs.size(); index++ )
+		{
+			int outputIndex = outputs[ index ].index;
+			if( outputs[ index ].isFunction )
+			{
+				row[ index ] = stateResult( groupStates[ group * functions.size() + outputIndex ],
+											functions[ outputIndex ] );
+			}
+			else
+			{
+				row[ index ] = groupKeys[ group * groupColumns.size() + outputIndex ];
+			}
+		}
+		if( sorter == NULL )
+		{
+			outputRow( row );
+		}
+		else if( !sorter->sortAdd( row ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,122 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file HashAggregate.h
+ *
+ * @brief Definition file for HashAggregate class
+ *
+ * @details Specifies all member methods of the HashAggregate class, the
+ *          operator behind aggregate functions and GROUP BY in selects
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "Table.h"
+#include "TableScan.h"
+#include "ParallelScan.h"
+#include "ExternalSort.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef HASHAGGREGATE_H
+#define HASHAGGREGATE_H
+
+//slots of a new group table, a power of two
+const unsigned int AGGREGATE_INITIAL_SLOTS = 64;
+
+enum AggregateType{
+	AGGREGATE_COUNT,
+	AGGREGATE_SUM,
+	AGGREGATE_AVG,
+	AGGREGATE_MIN,
+	AGGREGATE_MAX
+};
+
+//how the cells an aggregate reads are compared and added
+enum AggregateValue{
+	VALUE_INTEGER,
+	VALUE_FLOAT,
+	VALUE_TEXT
+};
+
+//one aggregate function of the select list, column is -1 for count(*)
+struct AggregateFunction{
+	AggregateType type;
+	int column;
+	AggregateValue valueType;
+	string name;
+	string outputType;
+};
+
+//running result of one aggregate function for one group
+struct AggregateState{
+	long long count;
+	long long integerSum;
+	double floatSum;
+	string minValue;
+	string maxValue;
+	double minNumber;
+	double maxNumber;
+};
+
+//entry of the select list, a grouped column or an aggregate function
+struct AggregateOutput{
+	bool isFunction;
+	int index;
+};
+
+class HashAggregate{
+	public:
+		HashAggregate();
+		~HashAggregate();
+
+		static bool isAggregateQuery( string queryType, string groupType );
+		bool aggregateSetup( string queryType, string groupType,
+								const vector< Attribute > &attributes, string &error );
+		void aggregateRow( const vector< string > &row );
+		bool aggregateParallel( TableScan &scan, string filePath );
+		void outputColumns( const vector< Attribute > &attributes, vector< string > &names,
+							vector< string > &types ) const;
+		void outputHeader( const vector< Attribute > &attributes );
+		bool outputGroups( ExternalSort *sorter );
+
+	private:
+		vector< int > groupColumns;
+		vector< AggregateFunction > functions;
+		vector< AggregateOutput > outputs;
+
+		//groups in the order they were added, group n owns the keys and
+		//states from n times the number of group columns and functions.
+		//The position of the first row of a group orders the output
+		vector< string > groupKeys;
+		vector< AggregateState > groupStates;
+		vector< uint64_t > groupHashes;
+		vector< long > groupFirstRows;
+		unsigned int groupCount;
+		long rowsAdded;
+
+		//open addressing table of group numbers, -1 marks an empty slot
+		vector< int > slots;
+		unsigned int slotMask;
+
+		void copySetup( const HashAggregate &other );
+		void addRow( const vector< string > &row, long position );
+		uint64_t hashGroup( const vector< string > &row ) const;
+		int findGroup( const string *keys, const int *columns, uint64_t hash, long position );
+		void resizeSlots( unsigned int slotCount );
+		void updateState( AggregateState &state, const AggregateFunction &function,
+							const vector< string > &row ) const;
+		void mergeState( AggregateState &state, const AggregateState &partial,
+							const AggregateFunction &function ) const;
+		void mergePartition( const vector< HashAggregate * > &partials, unsigned int partition,
+								unsigned int partitionCount );
+		void mergePartials( const vector< HashAggregate * > &partials );
+		string stateResult( const AggregateState &state, const AggregateFunction &function ) const;
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
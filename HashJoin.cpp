@@ -0,0 +1,1424 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file HashJoin.cpp
+ *
+ * @brief Implementation file for HashJoin class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the hash join used by inner join and left outer join.
+ *          The smaller table is read into a hash table keyed on its join
+ *          column and the larger one is streamed past it, so a join costs
+ *          one pass over each table instead of comparing every pair of rows.
+ *          When the smaller table does not fit in the memory budget both
+ *          tables are partitioned by the hash of their join column into
+ *          scratch files and each pair of partitions is joined on its own
+ *          (Grace hash join). A partition still too large is partitioned
+ *          again, and one that hashing cannot split, a single very common
+ *          key, is joined a budget sized chunk at a time. The query planner
+ *          may run a join as a nested loop, an index nested loop or a merge
+ *          join instead, which are implemented here as well
+ *
+ * @Note Requires HashJoin.h
+ */
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdlib>
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "HashJoin.h"
+#include "ExternalSort.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef HASHJOIN_CPP
+#define HASHJOIN_CPP
+
+//helper functions implemented in Table.cpp and TableScan.cpp
+int findAttrOccur( vector< Attribute > attributes, string attrName );
+string stripQuotes( string content );
+
+//helper function implemented in ExternalSort.cpp
+int compareCells( const string &first, const string &second, SortValue valueType );
+
+long joinMemoryBytes = DEFAULT_JOIN_BYTES;
+
+/**
+ * @brief tableFileSize
+ *
+ * @details returns the size of a table file, used to pick the build input
+ *
+ * @param [in] string tablePath
+ *
+ * @return long 0 if the table does not exist
+ *
+ * @note None
+ */
+long tableFileSize( string tablePath )
+{
+	struct stat fileStat;
+	if( stat( tablePath.c_str(), &fileStat ) != 0 )
+	{
+		return 0;
+	}
+	return fileStat.st_size;
+}
+
+/**
+ * @brief rowBytes
+ *
+ * @details estimates the memory a row held in a vector takes
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return long
+ *
+ * @note None
+ */
+long rowBytes( const vector< string > &row )
+{
+	long bytes = sizeof( row );
+	for( unsigned int index = 0; index < row.size(); index++ )
+	{
+		bytes += sizeof( row[ index ] ) + row[ index ].capacity();
+	}
+	return bytes;
+}
+
+/**
+ * @brief writeSpillRow
+ *
+ * @details appends a row to a spill file
+ *
+ * @par Algorithm the cell count, then each cell as its length and bytes, so
+ *      cells may hold any character
+ *
+ * @param [in] ofstream &fout
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return long bytes written
+ *
+ * @note None
+ */
+long writeSpillRow( ofstream &fout, const vector< string > &row )
+{
+	uint32_t cellCount = row.size();
+	long bytes = sizeof( cellCount );
+	fout.write( (const char *)&cellCount, sizeof( cellCount ) );
+	for( unsigned int index = 0; index < row.size(); index++ )
+	{
+		uint32_t length = row[ index ].size();
+		fout.write( (const char *)&length, sizeof( length ) );
+		fout.write( row[ index ].data(), length );
+		bytes += sizeof( length ) + length;
+	}
+	return bytes;
+}
+
+/**
+ * @brief readSpillRow
+ *
+ * @details reads the next row of a spill file written by writeSpillRow
+ *
+ * @param [in] ifstream &fin
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false at the end of the file
+ *
+ * @note None
+ */
+bool readSpillRow( ifstream &fin, vector< string > &row )
+{
+	uint32_t cellCount;
+	if( !fin.read( (char *)&cellCount, sizeof( cellCount ) ) )
+	{
+		return false;
+	}
+	row.resize( cellCount );
+	for( unsigned int index = 0; index < cellCount; index++ )
+	{
+		uint32_t length;
+		if( !fin.read( (char *)&length, sizeof( length ) ) )
+		{
+			return false;
+		}
+		row[ index ].resize( length );
+		if( length > 0 && !fin.read( &row[ index ][ 0 ], length ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief partitionOf
+ *
+ * @details picks the partition of a join key at a partitioning depth
+ *
+ * @par Algorithm the string hash is mixed with the depth, so every depth
+ *      splits a partition differently and none uses the low bits the
+ *      in-memory hash table uses
+ *
+ * @param [in] string &key
+ *
+ * @param [in] int depth
+ *
+ * @return int
+ *
+ * @note None
+ */
+int partitionOf( const string &key, int depth )
+{
+	hash< string > hashKey;
+	uint64_t mixed = hashKey( key );
+	mixed ^= ( depth + 1 ) * 0x9E3779B97F4A7C15ULL;
+	mixed *= 0xFF51AFD7ED558CCDULL;
+	mixed ^= mixed >> 33;
+	return mixed % JOIN_PARTITIONS;
+}
+
+/**
+ * @brief removeOrphanSpills
+ *
+ * @details deletes the scratch files of processes that are no longer running
+ *
+ * @param [in] string databasePath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void removeOrphanSpills( string databasePath )
+{
+	DIR *directory = opendir( databasePath.c_str() );
+	if( directory == NULL )
+	{
+		return;
+	}
+
+	struct dirent *entry;
+	while( ( entry = readdir( directory ) ) != NULL )
+	{
+		string fileName = entry->d_name;
+		if( fileName.compare( 0, SPILL_PREFIX.size(), SPILL_PREFIX ) != 0 )
+		{
+			continue;
+		}
+		pid_t owner = atol( fileName.c_str() + SPILL_PREFIX.size() );
+		if( owner == getpid() || ( kill( owner, 0 ) != 0 && errno == ESRCH ) )
+		{
+			unlink( ( databasePath + "/" + fileName ).c_str() );
+		}
+	}
+	closedir( directory );
+}
+
+/**
+ * @brief JoinInput default constructor
+ *
+ * @details a new input has no rows
+ *
+ * @note None
+ */
+JoinInput::JoinInput()
+{
+	scan = NULL;
+}
+
+/**
+ * @brief JoinInput default destructor
+ *
+ * @details closes a spill file that is still open
+ *
+ * @note None
+ */
+JoinInput::~JoinInput()
+{
+	inputClose();
+}
+
+/**
+ * @brief inputScan
+ *
+ * @details reads the input from an open table scan
+ *
+ * @param [in] TableScan *tableScan
+ *
+ * @return None
+ *
+ * @note None
+ */
+void JoinInput::inputScan( TableScan *tableScan )
+{
+	inputClose();
+	scan = tableScan;
+}
+
+/**
+ * @brief inputSpill
+ *
+ * @details reads the input from a spill file
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if the file could not be opened
+ *
+ * @note None
+ */
+bool JoinInput::inputSpill( string filePath )
+{
+	inputClose();
+	spill.open( filePath.c_str(), ios::binary );
+	return spill.is_open();
+}
+
+/**
+ * @brief inputNext
+ *
+ * @details reads the next row of the input
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false at the end of the input
+ *
+ * @note None
+ */
+bool JoinInput::inputNext( vector< string > &row )
+{
+	if( scan != NULL )
+	{
+		bool rowMatches;
+		return scan->scanNext( row, rowMatches );
+	}
+	if( !spill.is_open() )
+	{
+		return false;
+	}
+	return readSpillRow( spill, row );
+}
+
+/**
+ * @brief inputClose
+ *
+ * @details detaches the input from its scan or spill file
+ *
+ * @return None
+ *
+ * @note None
+ */
+void JoinInput::inputClose()
+{
+	scan = NULL;
+	if( spill.is_open() )
+	{
+		spill.close();
+	}
+	spill.clear();
+}
+
+/**
+ * @brief HashJoin default constructor
+ *
+ * @details a new join holds no rows
+ *
+ * @note None
+ */
+HashJoin::HashJoin()
+{
+	bucketMask = 0;
+	buildKey = -1;
+	buildBytes = 0;
+	numTbl1Attr = 0;
+	numTbl2Attr = 0;
+	spillCount = 0;
+}
+
+/**
+ * @brief HashJoin default destructor
+ *
+ * @details releases the hash table
+ *
+ * @note None
+ */
+HashJoin::~HashJoin()
+{
+}
+
+/**
+ * @brief joinTables
+ *
+ * @details outputs every pair of rows of table1 and table2 whose join
+ *          columns are equal, and for an outer join every row of table1
+ *          without a match padded with NULLs
+ *
+ * @pre table1 and table2 must exist
+ *
+ * @post a join that fits in memory outputs its rows in the order of table1,
+ *       the matches of one row in the order of table2. A spilled hash join
+ *       outputs them one partition at a time and a merge join in the order
+ *       of the join column
+ *
+ * @par Algorithm planJoin picks the cheapest method, see QueryPlanner. A
+ *      hash join building on table2 streams table1 and outputs every row as
+ *      soon as it is probed. Building on table1 it streams table2 and keeps
+ *      the rows that match on a list per table1 row, which is output in
+ *      table1 order once table2 is read. A build input that passes
+ *      joinMemoryBytes turns the join into a Grace hash join
+ *
+ * @param [in] string table1Path
+ *
+ * @param [in] string table1Attr join column of table1
+ *
+ * @param [in] string table2Path
+ *
+ * @param [in] string table2Attr join column of table2
+ *
+ * @param [in] bool outer true for a left outer join
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::joinTables( string table1Path, string table1Attr, string table2Path,
+							string table2Attr, bool outer )
+{
+	TableScan scan1;
+	TableScan scan2;
+	JoinInput build;
+	JoinInput probe;
+	JoinPlan plan;
+	vector< string > row;
+	bool rowMatches = false;
+
+	scan1.scanOpen( table1Path );
+	scan2.scanOpen( table2Path );
+	numTbl1Attr = scan1.attributes.size();
+	numTbl2Attr = scan2.attributes.size();
+	int tbl1AttrOccur = findAttrOccur( scan1.attributes, table1Attr );
+	int tbl2AttrOccur = findAttrOccur( scan2.attributes, table2Attr );
+	outputJoinHeader( scan1.attributes, scan2.attributes );
+	spillDirectory = table1Path.substr( 0, table1Path.rfind( '/' ) );
+
+	if( tbl1AttrOccur < 0 || tbl2AttrOccur < 0 )
+	{
+		//nothing matches an unknown attribute
+		while( outer && scan1.scanNext( row, rowMatches ) )
+		{
+			outputJoinRow( row, NULL );
+		}
+		scan1.scanClose();
+		scan2.scanClose();
+		return;
+	}
+
+	planJoin( scan1, table1Path, tbl1AttrOccur, scan2, table2Path, tbl2AttrOccur, outer, plan );
+	const JoinCandidate &chosen = plan.candidates[ 0 ];
+	if( chosen.method == JOIN_NESTED_LOOP )
+	{
+		nestedLoopJoin( scan1, tbl1AttrOccur, scan2, tbl2AttrOccur, outer );
+	}
+	else if( chosen.method == JOIN_INDEX_NESTED_LOOP )
+	{
+		indexNestedLoopJoin( scan1, tbl1AttrOccur, scan2, tbl2AttrOccur, outer );
+	}
+	else if( chosen.method == JOIN_MERGE )
+	{
+		if( !mergeJoin( scan1, tbl1AttrOccur, scan2, tbl2AttrOccur, outer ) )
+		{
+			cout << "-- !Failed to join the tables because the sort could not write its runs." << endl;
+		}
+	}
+	else if( !chosen.buildLeft )
+	{
+		//build on table2, probe with table1 in its own order
+		build.inputScan( &scan2 );
+		probe.inputScan( &scan1 );
+		if( buildTable( build, tbl2AttrOccur, joinMemoryBytes ) )
+		{
+			indexBuildRows();
+			if( !probeParallel( scan1, table1Path, tbl1AttrOccur, outer ) )
+			{
+				probeStreaming( probe, tbl1AttrOccur, false, outer, NULL );
+			}
+		}
+		else
+		{
+			graceJoin( build, tbl2AttrOccur, probe, tbl1AttrOccur, false, outer, 0 );
+		}
+	}
+	else
+	{
+		//build on table1, its rows are output in order after the probe
+		build.inputScan( &scan1 );
+		probe.inputScan( &scan2 );
+		if( buildTable( build, tbl1AttrOccur, joinMemoryBytes ) )
+		{
+			indexBuildRows();
+			probeOrdered( probe, tbl2AttrOccur, outer );
+		}
+		else
+		{
+			graceJoin( build, tbl1AttrOccur, probe, tbl2AttrOccur, true, outer, 0 );
+		}
+	}
+
+	build.inputClose();
+	probe.inputClose();
+	scan1.scanClose();
+	scan2.scanClose();
+	clearBuild();
+}
+
+/**
+ * @brief joinExplain
+ *
+ * @details outputs how joinTables would join two tables and the methods
+ *          it was chosen over, without reading the tables
+ *
+ * @pre table1 and table2 must exist
+ *
+ * @param [in] string table1Path
+ *
+ * @param [in] string table1Attr join column of table1
+ *
+ * @param [in] string table2Path
+ *
+ * @param [in] string table2Attr join column of table2
+ *
+ * @param [in] bool outer true for a left outer join
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::joinExplain( string table1Path, string table1Attr, string table2Path,
+							string table2Attr, bool outer )
+{
+	TableScan scan1;
+	TableScan scan2;
+	JoinPlan plan;
+	string table1Name = table1Path.substr( table1Path.rfind( '/' ) + 1 );
+	string table2Name = table2Path.substr( table2Path.rfind( '/' ) + 1 );
+
+	scan1.scanOpen( table1Path );
+	scan2.scanOpen( table2Path );
+	int tbl1AttrOccur = findAttrOccur( scan1.attributes, table1Attr );
+	int tbl2AttrOccur = findAttrOccur( scan2.attributes, table2Attr );
+	if( tbl1AttrOccur < 0 || tbl2AttrOccur < 0 )
+	{
+		cout << "-- Plan: " << ( outer ? "full scan of " + table1Name : "no scan" )
+			<< ", nothing matches an unknown attribute." << endl;
+	}
+	else
+	{
+		planJoin( scan1, table1Path, tbl1AttrOccur, scan2, table2Path, tbl2AttrOccur, outer, plan );
+		outputJoinPlan( table1Name, table2Name, plan );
+	}
+	scan1.scanClose();
+	scan2.scanClose();
+}
+
+/**
+ * @brief nestedLoopJoin
+ *
+ * @details joins two small tables by comparing every pair of rows
+ *
+ * @pre table2 fits in joinMemoryBytes
+ *
+ * @post rows are output in the order of table1, the matches of one row in
+ *       the order of table2
+ *
+ * @par Algorithm table2 is read into memory once and every row of table1
+ *      is compared with all of its rows, which for a handful of rows is
+ *      cheaper than hashing them
+ *
+ * @param [in] TableScan &scan1
+ *
+ * @param [in] int key1 join column of table1
+ *
+ * @param [in] TableScan &scan2
+ *
+ * @param [in] int key2 join column of table2
+ *
+ * @param [in] bool outer true for a left outer join
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::nestedLoopJoin( TableScan &scan1, int key1, TableScan &scan2, int key2, bool outer )
+{
+	vector< vector< string > > innerRows;
+	vector< string > row;
+	bool rowMatches = false;
+
+	while( scan2.scanNext( row, rowMatches ) )
+	{
+		innerRows.push_back( row );
+	}
+	while( scan1.scanNext( row, rowMatches ) )
+	{
+		bool matched = false;
+		for( unsigned int index = 0; index < innerRows.size(); index++ )
+		{
+			if( innerRows[ index ][ key2 ] == row[ key1 ] )
+			{
+				outputJoinRow( row, &innerRows[ index ] );
+				matched = true;
+			}
+		}
+		if( !matched && outer )
+		{
+			outputJoinRow( row, NULL );
+		}
+	}
+}
+
+/**
+ * @brief indexNestedLoopJoin
+ *
+ * @details joins by looking every row of table1 up in the index on the
+ *          join column of table2
+ *
+ * @pre the open transaction did not change table2
+ *
+ * @post rows are output in the order of table1, the matches of one row in
+ *       the order of table2
+ *
+ * @par Algorithm the index finds the rows of table2 with the key of the
+ *      value, which are compared again since keys only approximate values.
+ *      A value the index has no key for, a float that is not a number, is
+ *      kept out of the index and equals no row, so it matches nothing and
+ *      table2 is never read in full
+ *
+ * @param [in] TableScan &scan1
+ *
+ * @param [in] int key1 join column of table1
+ *
+ * @param [in] TableScan &scan2
+ *
+ * @param [in] int key2 join column of table2
+ *
+ * @param [in] bool outer true for a left outer join
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::indexNestedLoopJoin( TableScan &scan1, int key1, TableScan &scan2, int key2, bool outer )
+{
+	vector< string > row;
+	vector< string > innerRow;
+	bool rowMatches = false;
+
+	while( scan1.scanNext( row, rowMatches ) )
+	{
+		bool matched = false;
+		if( scan2.scanLookup( key2, row[ key1 ] ) )
+		{
+			while( scan2.scanNext( innerRow, rowMatches ) )
+			{
+				if( innerRow[ key2 ] == row[ key1 ] )
+				{
+					outputJoinRow( row, &innerRow );
+					matched = true;
+				}
+			}
+		}
+		if( !matched && outer )
+		{
+			outputJoinRow( row, NULL );
+		}
+	}
+}
+
+/**
+ * @brief mergeJoin
+ *
+ * @details joins by sorting both tables on their join columns and reading
+ *          them side by side
+ *
+ * @post rows are output in the order of the join column
+ *
+ * @par Algorithm both tables go through an ExternalSort on the join column
+ *      as text, so neither has to fit in memory. The rows of table2 with the
+ *      key of the current row of table1 are gathered once and matched with
+ *      every row of table1 with that key. The tables are walked in the order
+ *      compareCells sorted them, where text is compared with its quotes left
+ *      out and every way of writing null is equal, so the values of a group
+ *      are compared again
+ *
+ * @param [in] TableScan &scan1
+ *
+ * @param [in] int key1 join column of table1
+ *
+ * @param [in] TableScan &scan2
+ *
+ * @param [in] int key2 join column of table2
+ *
+ * @param [in] bool outer true for a left outer join
+ *
+ * @return bool false if a sort could not write its runs
+ *
+ * @note None
+ */
+bool HashJoin::mergeJoin( TableScan &scan1, int key1, TableScan &scan2, int key2, bool outer )
+{
+	ExternalSort sort1;
+	ExternalSort sort2;
+	vector< SortKey > keys( 1 );
+	vector< vector< string > > group;
+	vector< string > row1;
+	vector< string > row2;
+	bool rowMatches = false;
+	bool success = true;
+
+	keys[ 0 ].valueType = SORT_TEXT;
+	keys[ 0 ].descending = false;
+	keys[ 0 ].column = key1;
+	sort1.sortSetup( keys, spillDirectory );
+	while( success && scan1.scanNext( row1, rowMatches ) )
+	{
+		success = sort1.sortAdd( row1 );
+	}
+	keys[ 0 ].column = key2;
+	sort2.sortSetup( keys, spillDirectory );
+	while( success && scan2.scanNext( row2, rowMatches ) )
+	{
+		success = sort2.sortAdd( row2 );
+	}
+	success = success && sort1.sortFinish() && sort2.sortFinish();
+
+	bool more1 = success && sort1.sortNext( row1 );
+	bool more2 = success && sort2.sortNext( row2 );
+	while( more1 )
+	{
+		//rows of table2 below the key match nothing
+		while( more2 && compareCells( row2[ key2 ], row1[ key1 ], SORT_TEXT ) < 0 )
+		{
+			more2 = sort2.sortNext( row2 );
+		}
+		group.clear();
+		while( more2 && compareCells( row2[ key2 ], row1[ key1 ], SORT_TEXT ) == 0 )
+		{
+			group.push_back( row2 );
+			more2 = sort2.sortNext( row2 );
+		}
+
+		string groupKey = row1[ key1 ];
+		do
+		{
+			bool matched = false;
+			for( unsigned int index = 0; index < group.size(); index++ )
+			{
+				if( group[ index ][ key2 ] == row1[ key1 ] )
+				{
+					outputJoinRow( row1, &group[ index ] );
+					matched = true;
+				}
+			}
+			if( !matched && outer )
+			{
+				outputJoinRow( row1, NULL );
+			}
+			more1 = sort1.sortNext( row1 );
+		} while( more1 && compareCells( row1[ key1 ], groupKey, SORT_TEXT ) == 0 );
+	}
+	sort1.sortClose();
+	sort2.sortClose();
+	return success;
+}
+
+/**
+ * @brief buildTable
+ *
+ * @details reads build rows until the input ends or the budget is passed
+ *
+ * @pre clearBuild was called
+ *
+ * @post buildRows holds the rows read, indexBuildRows hashes them
+ *
+ * @param [in] JoinInput &input
+ *
+ * @param [in] int keyIndex join column of the build input
+ *
+ * @param [in] long budget bytes the rows may take
+ *
+ * @return bool true if the whole input was read
+ *
+ * @note None
+ */
+bool HashJoin::buildTable( JoinInput &input, int keyIndex, long budget )
+{
+	vector< string > row;
+	buildKey = keyIndex;
+	while( input.inputNext( row ) )
+	{
+		buildBytes += rowBytes( row );
+		buildRows.push_back( row );
+		if( buildBytes > budget )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief indexBuildRows
+ *
+ * @details hashes the build rows on their join column
+ *
+ * @post each bucket chains its rows in the order they were read
+ *
+ * @par Algorithm the bucket count is the power of two above twice the row
+ *      count. Rows are linked in from the last to the first so every chain
+ *      ends up in read order
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::indexBuildRows()
+{
+	hash< string > hashKey;
+	unsigned int bucketCount = 16;
+	while( bucketCount < buildRows.size() * 2 )
+	{
+		bucketCount *= 2;
+	}
+	bucketMask = bucketCount - 1;
+	bucketHeads.assign( bucketCount, -1 );
+	chainNext.assign( buildRows.size(), -1 );
+	for( int index = buildRows.size() - 1; index >= 0; index-- )
+	{
+		unsigned int bucket = hashKey( buildRows[ index ][ buildKey ] ) & bucketMask;
+		chainNext[ index ] = bucketHeads[ bucket ];
+		bucketHeads[ bucket ] = index;
+	}
+}
+
+/**
+ * @brief clearBuild
+ *
+ * @details releases the build rows and the hash table
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::clearBuild()
+{
+	vector< vector< string > >().swap( buildRows );
+	vector< int >().swap( bucketHeads );
+	vector< int >().swap( chainNext );
+	buildBytes = 0;
+}
+
+/**
+ * @brief firstMatch
+ *
+ * @details finds the first build row whose join column equals key
+ *
+ * @param [in] string &key
+ *
+ * @return int index of the build row, -1 if there is none
+ *
+ * @note None
+ */
+int HashJoin::firstMatch( const string &key ) const
+{
+	hash< string > hashKey;
+	if( bucketHeads.empty() )
+	{
+		return -1;
+	}
+	int rowIndex = bucketHeads[ hashKey( key ) & bucketMask ];
+	while( rowIndex >= 0 && buildRows[ rowIndex ][ buildKey ] != key )
+	{
+		rowIndex = chainNext[ rowIndex ];
+	}
+	return rowIndex;
+}
+
+/**
+ * @brief nextMatch
+ *
+ * @details finds the next build row after rowIndex whose join column equals key
+ *
+ * @param [in] int rowIndex a match returned before
+ *
+ * @param [in] string &key
+ *
+ * @return int index of the build row, -1 if there is none
+ *
+ * @note None
+ */
+int HashJoin::nextMatch( int rowIndex, const string &key ) const
+{
+	rowIndex = chainNext[ rowIndex ];
+	while( rowIndex >= 0 && buildRows[ rowIndex ][ buildKey ] != key )
+	{
+		rowIndex = chainNext[ rowIndex ];
+	}
+	return rowIndex;
+}
+
+/**
+ * @brief probeOrdered
+ *
+ * @details probes the table1 build rows with table2 and outputs the
+ *          result in table1 order
+ *
+ * @pre the build input is table1 and is hashed
+ *
+ * @par Algorithm each table2 row that matches is kept once and linked onto
+ *      the match list of every table1 row it matches
+ *
+ * @param [in] JoinInput &probe
+ *
+ * @param [in] int probeKey join column of table2
+ *
+ * @param [in] bool outer
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::probeOrdered( JoinInput &probe, int probeKey, bool outer )
+{
+	vector< string > row;
+	vector< vector< string > > probeRows;
+	vector< int > matchHead( buildRows.size(), -1 );
+	vector< int > matchTail( buildRows.size(), -1 );
+	vector< int > matchNext;
+	vector< int > matchProbe;
+
+	while( probe.inputNext( row ) )
+	{
+		int match = firstMatch( row[ probeKey ] );
+		if( match >= 0 )
+		{
+			probeRows.push_back( row );
+		}
+		while( match >= 0 )
+		{
+			int entry = matchNext.size();
+			matchNext.push_back( -1 );
+			matchProbe.push_back( probeRows.size() - 1 );
+			if( matchTail[ match ] < 0 )
+			{
+				matchHead[ match ] = entry;
+			}
+			else
+			{
+				matchNext[ matchTail[ match ] ] = entry;
+			}
+			matchTail[ match ] = entry;
+			match = nextMatch( match, row[ probeKey ] );
+		}
+	}
+
+	int buildSize = buildRows.size();
+	for( int index = 0; index < buildSize; index++ )
+	{
+		if( matchHead[ index ] < 0 && outer )
+		{
+			outputJoinRow( buildRows[ index ], NULL );
+		}
+		for( int entry = matchHead[ index ]; entry >= 0; entry = matchNext[ entry ] )
+		{
+			outputJoinRow( buildRows[ index ], &probeRows[ matchProbe[ entry ] ] );
+		}
+	}
+}
+
+/**
+ * @brief probeStreaming
+ *
+ * @details probes the build rows with every row of the probe input and
+ *          outputs each match as it is found
+ *
+ * @pre the build rows are hashed
+ *
+ * @post an outer join also outputs the unmatched rows of table1, the build
+ *       rows after the probe or the probe rows as they are read
+ *
+ * @param [in] JoinInput &probe
+ *
+ * @param [in] int probeKey
+ *
+ * @param [in] bool buildIsLeft true if the build rows are from table1
+ *
+ * @param [in] bool outer
+ *
+ * @param [in] vector< bool > *probeMatched when the build input is probed a
+ *             chunk at a time, records which probe rows matched instead of
+ *             padding them, NULL otherwise
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::probeStreaming( JoinInput &probe, int probeKey, bool buildIsLeft, bool outer,
+								vector< bool > *probeMatched )
+{
+	vector< string > row;
+	vector< bool > buildMatched;
+	unsigned int probeIndex = 0;
+
+	if( buildIsLeft && outer )
+	{
+		buildMatched.assign( buildRows.size(), false );
+	}
+	while( probe.inputNext( row ) )
+	{
+		int match = firstMatch( row[ probeKey ] );
+		if( probeMatched != NULL && probeMatched->size() <= probeIndex )
+		{
+			probeMatched->push_back( false );
+		}
+		if( match < 0 && outer && !buildIsLeft && probeMatched == NULL )
+		{
+			outputJoinRow( row, NULL );
+		}
+		while( match >= 0 )
+		{
+			outputPair( buildRows[ match ], &row, buildIsLeft );
+			if( !buildMatched.empty() )
+			{
+				buildMatched[ match ] = true;
+			}
+			if( probeMatched != NULL )
+			{
+				( *probeMatched )[ probeIndex ] = true;
+			}
+			match = nextMatch( match, row[ probeKey ] );
+		}
+		probeIndex++;
+	}
+
+	for( unsigned int index = 0; index < buildMatched.size(); index++ )
+	{
+		if( !buildMatched[ index ] )
+		{
+			outputJoinRow( buildRows[ index ], NULL );
+		}
+	}
+}
+
+/**
+ * @brief probeParallel
+ *
+ * @details probes the table2 build rows with table1 on the worker threads
+ *
+ * @pre the build input is table2 and is hashed, no row of table1 was read
+ *
+ * @post the output is the same as probeStreaming gives, in table1 order
+ *
+ * @par Algorithm every morsel of table1 probes the hash table, which no
+ *      worker changes, and formats its joined rows on its own
+ *
+ * @param [in] TableScan &probeScan scan of table1
+ *
+ * @param [in] string probePath
+ *
+ * @param [in] int probeKey join column of table1
+ *
+ * @param [in] bool outer
+ *
+ * @return bool false if table1 has to be probed on this thread
+ *
+ * @note None
+ */
+bool HashJoin::probeParallel( TableScan &probeScan, string probePath, int probeKey, bool outer )
+{
+	ParallelScan parallelScan;
+	return parallelScan.scanRows( probeScan, probePath,
+		[ this, probeKey, outer ]( const vector< vector< string > > &rows, unsigned int count,
+									long, string &output )
+	{
+		for( unsigned int rowIndex = 0; rowIndex < count; rowIndex++ )
+		{
+			const vector< string > &row = rows[ rowIndex ];
+			int match = firstMatch( row[ probeKey ] );
+			if( match < 0 && outer )
+			{
+				formatJoinRow( row, NULL, output );
+			}
+			while( match >= 0 )
+			{
+				formatJoinRow( row, &buildRows[ match ], output );
+				match = nextMatch( match, row[ probeKey ] );
+			}
+		}
+	} );
+}
+
+/**
+ * @brief graceJoin
+ *
+ * @details joins two inputs whose build side does not fit in memory
+ *
+ * @pre buildRows holds the build rows read before the budget was passed
+ *
+ * @par Algorithm both inputs are written to JOIN_PARTITIONS spill files by
+ *      the hash of their join column, so matching rows land in partitions
+ *      with the same number. Each build partition that fits is hashed and
+ *      probed with its probe partition. One that does not is partitioned
+ *      again with a different hash, unless it holds nearly all of its
+ *      parent, a key too common to split, or JOIN_MAX_DEPTH was reached;
+ *      then it is joined in chunks
+ *
+ * @param [in] JoinInput &build
+ *
+ * @param [in] int buildKeyIndex
+ *
+ * @param [in] JoinInput &probe
+ *
+ * @param [in] int probeKey
+ *
+ * @param [in] bool buildIsLeft true if the build rows are from table1
+ *
+ * @param [in] bool outer
+ *
+ * @param [in] int depth partitioning passes made before this one
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::graceJoin( JoinInput &build, int buildKeyIndex, JoinInput &probe, int probeKey,
+							bool buildIsLeft, bool outer, int depth )
+{
+	vector< string > buildPaths;
+	vector< string > probePaths;
+	vector< long > buildSizes;
+	vector< long > probeSizes;
+
+	partitionInput( build, &buildRows, buildKeyIndex, depth, buildPaths, buildSizes );
+	clearBuild();
+	partitionInput( probe, NULL, probeKey, depth, probePaths, probeSizes );
+
+	long totalBytes = 0;
+	for( int partition = 0; partition < JOIN_PARTITIONS; partition++ )
+	{
+		totalBytes += buildSizes[ partition ];
+	}
+
+	for( int partition = 0; partition < JOIN_PARTITIONS; partition++ )
+	{
+		JoinInput partitionBuild;
+		JoinInput partitionProbe;
+		bool buildEmpty = buildSizes[ partition ] == 0;
+		bool probeEmpty = probeSizes[ partition ] == 0;
+
+		//an outer join still pads the table1 rows of a one sided partition
+		if( ( !buildEmpty && !probeEmpty ) ||
+			( outer && ( buildIsLeft ? !buildEmpty : !probeEmpty ) ) )
+		{
+			partitionBuild.inputSpill( buildPaths[ partition ] );
+			partitionProbe.inputSpill( probePaths[ partition ] );
+			if( buildTable( partitionBuild, buildKeyIndex, joinMemoryBytes ) )
+			{
+				indexBuildRows();
+				probeStreaming( partitionProbe, probeKey, buildIsLeft, outer, NULL );
+				clearBuild();
+			}
+			else if( depth + 1 < JOIN_MAX_DEPTH && buildSizes[ partition ] < totalBytes / 10 * 9 )
+			{
+				graceJoin( partitionBuild, buildKeyIndex, partitionProbe, probeKey,
+							buildIsLeft, outer, depth + 1 );
+			}
+			else
+			{
+				clearBuild();
+				partitionBuild.inputClose();
+				partitionProbe.inputClose();
+				chunkedJoin( buildPaths[ partition ], buildKeyIndex, probePaths[ partition ],
+								probeKey, buildIsLeft, outer );
+			}
+		}
+		partitionBuild.inputClose();
+		partitionProbe.inputClose();
+		unlink( buildPaths[ partition ].c_str() );
+		unlink( probePaths[ partition ].c_str() );
+	}
+}
+
+/**
+ * @brief chunkedJoin
+ *
+ * @details joins a build partition that cannot be split any further
+ *
+ * @par Algorithm the build partition is read a budget sized chunk at a
+ *      time and the probe partition is read once per chunk. When the probe
+ *      rows are table1 rows of an outer join, the rows that never matched
+ *      are output after the last chunk
+ *
+ * @param [in] string buildPath
+ *
+ * @param [in] int buildKeyIndex
+ *
+ * @param [in] string probePath
+ *
+ * @param [in] int probeKey
+ *
+ * @param [in] bool buildIsLeft
+ *
+ * @param [in] bool outer
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::chunkedJoin( string buildPath, int buildKeyIndex, string probePath, int probeKey,
+							bool buildIsLeft, bool outer )
+{
+	JoinInput buildInput;
+	vector< bool > probeMatched;
+	vector< bool > *matched = ( outer && !buildIsLeft ) ? &probeMatched : NULL;
+	bool moreRows = true;
+
+	buildInput.inputSpill( buildPath );
+	while( moreRows )
+	{
+		clearBuild();
+		moreRows = !buildTable( buildInput, buildKeyIndex, joinMemoryBytes );
+		if( buildRows.empty() )
+		{
+			break;
+		}
+		indexBuildRows();
+		JoinInput probeInput;
+		probeInput.inputSpill( probePath );
+		probeStreaming( probeInput, probeKey, buildIsLeft, outer, matched );
+	}
+	clearBuild();
+
+	if( matched != NULL )
+	{
+		JoinInput probeInput;
+		vector< string > row;
+		unsigned int probeIndex = 0;
+		probeInput.inputSpill( probePath );
+		while( probeInput.inputNext( row ) )
+		{
+			if( probeIndex >= probeMatched.size() || !probeMatched[ probeIndex ] )
+			{
+				outputJoinRow( row, NULL );
+			}
+			probeIndex++;
+		}
+	}
+}
+
+/**
+ * @brief partitionInput
+ *
+ * @details writes the rows of an input to one spill file per partition
+ *
+ * @param [in] JoinInput &input
+ *
+ * @param [in] vector< vector< string > > *firstRows rows already taken from
+ *             the input, written first, NULL for none
+ *
+ * @param [in] int keyIndex join column of the input
+ *
+ * @param [in] int depth partitioning passes made before this one
+ *
+ * @param [out] vector< string > &paths spill file of every partition
+ *
+ * @param [out] vector< long > &sizes bytes written to every partition
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::partitionInput( JoinInput &input, const vector< vector< string > > *firstRows,
+								int keyIndex, int depth, vector< string > &paths,
+								vector< long > &sizes )
+{
+	vector< ofstream > outputs( JOIN_PARTITIONS );
+	vector< string > row;
+
+	paths.clear();
+	sizes.assign( JOIN_PARTITIONS, 0 );
+	for( int partition = 0; partition < JOIN_PARTITIONS; partition++ )
+	{
+		paths.push_back( spillPath() );
+		outputs[ partition ].open( paths[ partition ].c_str(), ios::binary | ios::trunc );
+	}
+
+	if( firstRows != NULL )
+	{
+		for( unsigned int index = 0; index < firstRows->size(); index++ )
+		{
+			const vector< string > &firstRow = ( *firstRows )[ index ];
+			int partition = partitionOf( firstRow[ keyIndex ], depth );
+			sizes[ partition ] += writeSpillRow( outputs[ partition ], firstRow );
+		}
+	}
+	while( input.inputNext( row ) )
+	{
+		int partition = partitionOf( row[ keyIndex ], depth );
+		sizes[ partition ] += writeSpillRow( outputs[ partition ], row );
+	}
+
+	for( int partition = 0; partition < JOIN_PARTITIONS; partition++ )
+	{
+		outputs[ partition ].close();
+	}
+}
+
+/**
+ * @brief spillPath
+ *
+ * @details returns the path of a new scratch file of this process
+ *
+ * @return string
+ *
+ * @note None
+ */
+string HashJoin::spillPath()
+{
+	return spillDirectory + "/" + SPILL_PREFIX + to_string( (long)getpid() ) + "_" +
+			to_string( spillCount++ );
+}
+
+/**
+ * @brief outputJoinHeader
+ *
+ * @details outputs the attributes of both tables as "-- a int|b int"
+ *
+ * @param [in] vector< Attribute > &attributes1
+ *
+ * @param [in] vector< Attribute > &attributes2
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::outputJoinHeader( const vector< Attribute > &attributes1,
+									const vector< Attribute > &attributes2 )
+{
+	int attrSize1 = attributes1.size();
+	int attrSize2 = attributes2.size();
+
+	cout << "-- ";
+	for( int index = 0; index < attrSize1; index++ )
+	{
+		cout << attributes1[ index ].attributeName << " ";
+		cout << attributes1[ index ].attributeType << "|";
+	}
+	for( int index = 0; index < attrSize2; index++ )
+	{
+		cout << attributes2[ index ].attributeName << " ";
+		cout << attributes2[ index ].attributeType;
+		if( index != attrSize2 - 1 )
+		{
+			cout << "|";
+		}
+	}
+	cout << endl;
+}
+
+/**
+ * @brief outputJoinRow
+ *
+ * @details outputs one joined row as "-- a|b|c|d"
+ *
+ * @param [in] vector< string > &row1
+ *
+ * @param [in] vector< string > *row2 NULL to pad the table2 columns with NULLs
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::outputJoinRow( const vector< string > &row1, const vector< string > *row2 )
+{
+	string output;
+	formatJoinRow( row1, row2, output );
+	cout << output << flush;
+}
+
+/**
+ * @brief formatJoinRow
+ *
+ * @details appends one joined row as "-- a|b|c|d" and a newline to output
+ *
+ * @param [in] vector< string > &row1
+ *
+ * @param [in] vector< string > *row2 NULL to pad the table2 columns with NULLs
+ *
+ * @param [out] string &output
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::formatJoinRow( const vector< string > &row1, const vector< string > *row2,
+								string &output ) const
+{
+	output += "-- ";
+	for( int attr1 = 0; attr1 < numTbl1Attr; attr1++ )
+	{
+		output += stripQuotes( row1[ attr1 ] );
+		output += "|";
+	}
+	for( int attr2 = 0; attr2 < numTbl2Attr; attr2++ )
+	{
+		if( row2 != NULL )
+		{
+			output += stripQuotes( ( *row2 )[ attr2 ] );
+		}
+		if( attr2 != numTbl2Attr - 1 )
+		{
+			output += "|";
+		}
+	}
+	output += "\n";
+}
+
+/**
+ * @brief outputPair
+ *
+ * @details outputs a build row and a probe row with the table1 row first
+ *
+ * @param [in] vector< string > &buildRow
+ *
+ * @param [in] vector< string > *probeRow
+ *
+ * @param [in] bool buildIsLeft
+ *
+ * @return None
+ *
+ * @note None
+ */
+void HashJoin::outputPair( const vector< string > &buildRow, const vector< string > *probeRow,
+							bool buildIsLeft )
+{
+	if( buildIsLeft )
+	{
+		outputJoinRow( buildRow, probeRow );
+	}
+	else
+	{
+		outputJoinRow( *probeRow, &buildRow );
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,117 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file HashJoin.h
+ *
+ * @brief Definition file for HashJoin class
+ *
+ * @details Specifies all member methods of the HashJoin class, the equi join
+ *          operators behind inner join and left outer join
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include "Table.h"
+#include "TableScan.h"
+#include "ParallelScan.h"
+#include "QueryPlanner.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef HASHJOIN_H
+#define HASHJOIN_H
+
+//memory a join may hold before it partitions its inputs to disk
+const long DEFAULT_JOIN_BYTES = 64L * 1024 * 1024;
+const long MIN_JOIN_BYTES = 64L * 1024;
+
+//scratch files of operators that spill are .spill_<pid>_<number> in the
+//database directory
+const string SPILL_PREFIX = ".spill_";
+
+//partitions made per pass, and passes before a partition that is still
+//too large is joined in chunks
+const int JOIN_PARTITIONS = 16;
+const int JOIN_MAX_DEPTH = 3;
+
+//rows of a join input, from a table or from a spilled partition
+class JoinInput{
+	public:
+		JoinInput();
+		~JoinInput();
+
+		void inputScan( TableScan *tableScan );
+		bool inputSpill( string filePath );
+		bool inputNext( vector< string > &row );
+		void inputClose();
+
+	private:
+		TableScan *scan;
+		ifstream spill;
+};
+
+class HashJoin{
+	public:
+		HashJoin();
+		~HashJoin();
+
+		void joinTables( string table1Path, string table1Attr, string table2Path,
+							string table2Attr, bool outer );
+		void joinExplain( string table1Path, string table1Attr, string table2Path,
+							string table2Attr, bool outer );
+
+	private:
+		//rows of the build input, chained by bucket in the order they were read
+		vector< vector< string > > buildRows;
+		vector< int > bucketHeads;
+		vector< int > chainNext;
+		unsigned int bucketMask;
+		int buildKey;
+		long buildBytes;
+
+		//columns of each input, needed for the NULL padding of outer rows
+		int numTbl1Attr;
+		int numTbl2Attr;
+
+		//where partitions are spilled
+		string spillDirectory;
+		int spillCount;
+
+		void nestedLoopJoin( TableScan &scan1, int key1, TableScan &scan2, int key2, bool outer );
+		void indexNestedLoopJoin( TableScan &scan1, int key1, TableScan &scan2, int key2, bool outer );
+		bool mergeJoin( TableScan &scan1, int key1, TableScan &scan2, int key2, bool outer );
+		bool buildTable( JoinInput &input, int keyIndex, long budget );
+		void indexBuildRows();
+		void clearBuild();
+		int firstMatch( const string &key ) const;
+		int nextMatch( int rowIndex, const string &key ) const;
+		void probeOrdered( JoinInput &probe, int probeKey, bool outer );
+		void probeStreaming( JoinInput &probe, int probeKey, bool buildIsLeft, bool outer,
+								vector< bool > *probeMatched );
+		bool probeParallel( TableScan &probeScan, string probePath, int probeKey, bool outer );
+		void graceJoin( JoinInput &build, int buildKeyIndex, JoinInput &probe, int probeKey,
+						bool buildIsLeft, bool outer, int depth );
+		void chunkedJoin( string buildPath, int buildKeyIndex, string probePath, int probeKey,
+							bool buildIsLeft, bool outer );
+		void partitionInput( JoinInput &input, const vector< vector< string > > *firstRows,
+								int keyIndex, int depth, vector< string > &paths,
+								vector< long > &sizes );
+		string spillPath();
+		void outputJoinHeader( const vector< Attribute > &attributes1,
+								const vector< Attribute > &attributes2 );
+		void outputJoinRow( const vector< string > &row1, const vector< string > *row2 );
+		void formatJoinRow( const vector< string > &row1, const vector< string > *row2,
+							string &output ) const;
+		void outputPair( const vector< string > &buildRow, const vector< string > *probeRow,
+							bool buildIsLeft );
+};
+
+//memory budget of every join of the process
+extern long joinMemoryBytes;
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,41 @@
+--CS457 int comparisons
+
+--Int columns compare as numbers in where clauses and through indexes
+
+CREATE DATABASE IntCompare;
+USE IntCompare;
+
+create table Lines (id int, name varchar(10));
+create table Pages (id int, name varchar(10)) STORAGE PAGE;
+
+insert into Lines values(1, 'one');
+insert into Lines values(2, 'two');
+insert into Lines values(10, 'ten');
+insert into Lines values(-3, 'minus');
+insert into Lines values(100, 'hundred');
+insert into Pages values(1, 'one');
+insert into Pages values(2, 'two');
+insert into Pages values(10, 'ten');
+insert into Pages values(-3, 'minus');
+insert into Pages values(100, 'hundred');
+
+select * from Lines where id >= 2;
+select * from Lines where id < 10;
+select * from Lines where id > -5 and id != 10;
+select * from Pages where id >= 2;
+select * from Pages where id <= 2 or name = 'ten';
+
+create index LinesId on Lines (id);
+create index PagesId on Pages (id);
+select * from Lines where id >= 2;
+select * from Lines where id = 10;
+select * from Pages where id > 2;
+select * from Pages where id < 10;
+
+update Lines set name = 'big' where id > 9;
+delete from Pages where id >= 10;
+select * from Lines;
+select * from Pages;
+
+DROP DATABASE IntCompare;
+.EXIT
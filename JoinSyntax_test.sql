@@ -0,0 +1,32 @@
+--CS457 join syntax
+
+--Comma joins, inner joins and left outer joins match rows on one column of each table
+
+CREATE DATABASE JoinSyntax;
+USE JoinSyntax;
+
+create table Employee (id int, name varchar(10));
+create table Sales (employeeID int, productID int);
+insert into Employee values(1, 'Joe');
+insert into Employee values(2, 'Jack');
+insert into Employee values(3, 'Gill');
+insert into Sales values(1, 344);
+insert into Sales values(1, 355);
+insert into Sales values(2, 544);
+
+select * from Employee E, Sales S where E.id = S.employeeID;
+select * from Employee E inner join Sales S on E.id = S.employeeID;
+select * from Employee E left outer join Sales S on E.id = S.employeeID;
+SELECT * FROM Employee e INNER JOIN Sales s ON s.employeeID = e.id;
+select * from Sales S left outer join Employee E on S.employeeID = E.id;
+
+select * from Employee E inner join Sales S on E.id = S.missing;
+select * from Employee E inner join Missing M on E.id = M.id;
+select * from Employee E left outer join Sales S;
+select count(*) from Employee E inner join Sales S on E.id = S.employeeID;
+select E.name from Employee E, Sales S where E.id = S.employeeID;
+select * from Employee E inner join Sales S on E.id = S.employeeID group by name;
+select * from Employee E left outer join Sales S on E.id = S.employeeID limit 1;
+
+DROP DATABASE JoinSyntax;
+.EXIT
@@ -0,0 +1,28 @@
+--CS457 limit and offset
+
+--Limit keeps the first rows after offset skips some, sorted or in table order
+
+CREATE DATABASE Limited;
+USE Limited;
+
+create table Sales (region varchar(10), qty int, price float);
+insert into Sales values('east', 3, 2.5);
+insert into Sales values('west', 10, 1.0);
+insert into Sales values('east', 7, 4.0);
+insert into Sales values('north', 1, 9.5);
+insert into Sales values('west', 2, 3.0);
+insert into Sales values('east', 0, 8.0);
+
+select * from Sales order by price desc limit 2;
+select * from Sales order by price desc limit 2 offset 1;
+select * from Sales limit 3;
+select * from Sales where qty > 1 limit 2 offset 1;
+select * from Sales limit 2 offset 5;
+select * from Sales limit 0;
+
+select * from Sales limit;
+select * from Sales limit -1;
+select * from Sales limit two;
+
+DROP DATABASE Limited;
+.EXIT
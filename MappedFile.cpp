@@ -0,0 +1,238 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file MappedFile.cpp
+ *
+ * @brief Implementation file for MappedFile class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the memory mapped read path of text tables. A mapping
+ *          shows the file as it was when it was mapped, so a file this
+ *          process is appending rows to is read through the buffer pool
+ *          instead. Text tables are never truncated in place, a rewrite
+ *          renames a new file over them, so a mapping stays valid until it
+ *          is closed
+ *
+ * @Note Requires MappedFile.h
+ */
+#include <iostream>
+#include <string>
+#include <set>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MappedFile.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef MAPPEDFILE_CPP
+#define MAPPEDFILE_CPP
+
+//text tables a writer of this process has open for appending, the applier
+//thread of the log writes tables too
+mutex appendingLock;
+multiset< string > appendingFiles;
+
+/**
+ * @brief MappedFile default constructor
+ *
+ * @details starts without a mapping
+ *
+ * @note None
+ */
+MappedFile::MappedFile()
+{
+	data = NULL;
+	size = 0;
+}
+
+/**
+ * @brief MappedFile default destructor
+ *
+ * @details unmaps the file
+ *
+ * @note None
+ */
+MappedFile::~MappedFile()
+{
+	mapClose();
+}
+
+/**
+ * @brief mapOpen
+ *
+ * @details maps a whole file for reading, to be read from start to end
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if the file is empty, being appended to or could not
+ *         be mapped, it is then read through the buffer pool
+ *
+ * @note None
+ */
+bool MappedFile::mapOpen( string filePath )
+{
+	struct stat fileStat;
+
+	mapClose();
+	if( isAppending( filePath ) )
+	{
+		return false;
+	}
+	int fileDescriptor = open( filePath.c_str(), O_RDONLY );
+	if( fileDescriptor < 0 )
+	{
+		return false;
+	}
+	if( fstat( fileDescriptor, &fileStat ) != 0 || fileStat.st_size == 0 )
+	{
+		close( fileDescriptor );
+		return false;
+	}
+
+	void *mapping = mmap( NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+	close( fileDescriptor );
+	if( mapping == MAP_FAILED )
+	{
+		return false;
+	}
+	data = (char *)mapping;
+	size = fileStat.st_size;
+	mapAdvise( MAP_SEQUENTIAL );
+	return true;
+}
+
+/**
+ * @brief mapAdvise
+ *
+ * @details tells the kernel how the mapping is read, a sequential scan is
+ *          read ahead and an index lookup is not
+ *
+ * @param [in] MapAccess access
+ *
+ * @return None
+ *
+ * @note None
+ */
+void MappedFile::mapAdvise( MapAccess access )
+{
+	if( data != NULL )
+	{
+		madvise( data, size, access == MAP_SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM );
+	}
+}
+
+/**
+ * @brief mapClose
+ *
+ * @details unmaps the file if it is mapped
+ *
+ * @return None
+ *
+ * @note None
+ */
+void MappedFile::mapClose()
+{
+	if( data != NULL )
+	{
+		munmap( data, size );
+		data = NULL;
+		size = 0;
+	}
+}
+
+/**
+ * @brief mapIsOpen
+ *
+ * @details checks whether a file is mapped
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool MappedFile::mapIsOpen() const
+{
+	return data != NULL;
+}
+
+/**
+ * @brief mapData
+ *
+ * @details returns the first byte of the mapped file
+ *
+ * @return const char *
+ *
+ * @note None
+ */
+const char *MappedFile::mapData() const
+{
+	return data;
+}
+
+/**
+ * @brief mapSize
+ *
+ * @details returns the length of the mapped file
+ *
+ * @return size_t
+ *
+ * @note None
+ */
+size_t MappedFile::mapSize() const
+{
+	return size;
+}
+
+/**
+ * @brief markAppending
+ *
+ * @details records that a writer of this process starts or stops appending
+ *          to a text table
+ *
+ * @param [in] string filePath
+ *
+ * @param [in] bool appending
+ *
+ * @return None
+ *
+ * @note None
+ */
+void markAppending( string filePath, bool appending )
+{
+	lock_guard< mutex > guard( appendingLock );
+	if( appending )
+	{
+		appendingFiles.insert( filePath );
+	}
+	else
+	{
+		multiset< string >::iterator found = appendingFiles.find( filePath );
+		if( found != appendingFiles.end() )
+		{
+			appendingFiles.erase( found );
+		}
+	}
+}
+
+/**
+ * @brief isAppending
+ *
+ * @details checks whether a writer of this process is appending to a table
+ *
+ * @param [in] string filePath
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool isAppending( string filePath )
+{
+	lock_guard< mutex > guard( appendingLock );
+	return appendingFiles.count( filePath ) > 0;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
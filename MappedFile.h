@@ -0,0 +1,51 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file MappedFile.h
+ *
+ * @brief Definition file for MappedFile class
+ *
+ * @details Specifies all member methods of the MappedFile class, a read only
+ *          memory mapping of a text table file that scans split rows from
+ *          without reading them into a buffer first
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+//how a mapping is going to be read
+enum MapAccess{
+	MAP_SEQUENTIAL,
+	MAP_RANDOM
+};
+
+class MappedFile{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		bool mapOpen( string filePath );
+		void mapAdvise( MapAccess access );
+		void mapClose();
+		bool mapIsOpen() const;
+		const char *mapData() const;
+		size_t mapSize() const;
+
+	private:
+		char *data;
+		size_t size;
+};
+
+void markAppending( string filePath, bool appending );
+bool isAppending( string filePath );
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,25 @@
+--CS457 null cells
+
+--Aggregates skip and order by sorts first every way of writing null
+
+CREATE DATABASE NullValues;
+USE NullValues;
+
+create table Items (id int, price float, name varchar(10));
+insert into Items values(1, 2.5, 'pen');
+insert into Items values(2, 4.0, 'ink');
+ALTER TABLE Items ADD qty int;
+insert into Items values(3, NULL, 'cap', 5);
+insert into Items values(4, 1.5, 'nib', 3);
+insert into Items values(5, 6.0, NULL, null);
+
+select * from Items;
+select count(*), count(qty), sum(qty), avg(qty), min(qty), max(qty) from Items;
+select count(price), sum(price), min(price), max(price) from Items;
+select count(name), min(name), max(name) from Items;
+select id, qty from Items order by qty;
+select id, qty from Items order by qty desc;
+select id, price from Items order by price;
+
+DROP DATABASE NullValues;
+.EXIT
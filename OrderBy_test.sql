@@ -0,0 +1,25 @@
+--CS457 order by
+
+--Rows come out sorted on one or more columns, each ascending or descending
+
+CREATE DATABASE OrderBy;
+USE OrderBy;
+
+create table Sales (region varchar(10), qty int, price float);
+insert into Sales values('east', 3, 2.5);
+insert into Sales values('west', 10, 1.0);
+insert into Sales values('east', 7, 4.0);
+insert into Sales values('north', 1, 9.5);
+insert into Sales values('west', 2, 3.0);
+insert into Sales values('east', 0, 8.0);
+
+select * from Sales order by qty;
+select * from Sales order by region, price desc;
+select region, qty from Sales where price < 5 order by qty desc;
+SELECT * FROM Sales ORDER BY price ASC;
+
+select * from Sales order by;
+select * from Sales order by city;
+
+DROP DATABASE OrderBy;
+.EXIT
@@ -0,0 +1,981 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file PageFile.cpp
+ *
+ * @brief Implementation file for PageFile class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the binary slotted-page table format. Page 0 holds the
+ *          attribute line, every other page holds a slot directory that grows
+ *          up from the page header and typed tuples that grow down from the
+ *          end of the page. Rows are addressed by (page, slot) row ids, so
+ *          deletes and most updates happen in place
+ *
+ * @Note Requires PageFile.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include "PageFile.h"
+#include "BufferPool.cpp"
+#include "SchemaCatalog.cpp"
+#include "Table.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PAGEFILE_CPP
+#define PAGEFILE_CPP
+
+/**
+ * @brief fieldTypeOf
+ *
+ * @details maps an attribute type to the tag its values are stored with
+ *
+ * @param [in] string attributeType
+ *
+ * @return unsigned char FIELD_INT, FIELD_FLOAT or FIELD_TEXT
+ *
+ * @note None
+ */
+unsigned char fieldTypeOf( string attributeType )
+{
+	for( unsigned int index = 0; index < attributeType.size(); index++ )
+	{
+		attributeType[ index ] = tolower( attributeType[ index ] );
+	}
+	if( attributeType.compare( 0, 3, "int" ) == 0 )
+	{
+		return FIELD_INT;
+	}
+	if( attributeType.compare( 0, 5, "float" ) == 0 || attributeType.compare( 0, 6, "double" ) == 0 )
+	{
+		return FIELD_FLOAT;
+	}
+	return FIELD_TEXT;
+}
+
+/**
+ * @brief formatDouble
+ *
+ * @details formats a double with the fewest digits that read back exactly
+ *
+ * @param [in] double value
+ *
+ * @return string
+ *
+ * @note None
+ */
+string formatDouble( double value )
+{
+	char buffer[ 64 ];
+	int precision = 1;
+	for( ; precision < 17; precision++ )
+	{
+		snprintf( buffer, sizeof( buffer ), "%.*g", precision, value );
+		if( strtod( buffer, NULL ) == value )
+		{
+			break;
+		}
+	}
+	//prefer plain notation for ordinary magnitudes
+	while( strchr( buffer, 'e' ) != NULL && precision < 17 &&
+			fabs( value ) >= 1e-4 && fabs( value ) < 1e15 )
+	{
+		precision++;
+		snprintf( buffer, sizeof( buffer ), "%.*g", precision, value );
+	}
+	return buffer;
+}
+
+/**
+ * @brief readUint16
+ *
+ * @details reads an unsigned 16 bit value out of a page
+ *
+ * @param [in] const char *page
+ *
+ * @param [in] int offset
+ *
+ * @return uint16_t
+ *
+ * @note None
+ */
+inline uint16_t readUint16( const char *page, int offset )
+{
+	uint16_t value;
+	memcpy( &value, page + offset, sizeof( value ) );
+	return value;
+}
+
+/**
+ * @brief writeUint16
+ *
+ * @details writes an unsigned 16 bit value into a page
+ *
+ * @param [in] char *page
+ *
+ * @param [in] int offset
+ *
+ * @param [in] uint16_t value
+ *
+ * @return None
+ *
+ * @note None
+ */
+inline void writeUint16( char *page, int offset, uint16_t value )
+{
+	memcpy( page + offset, &value, sizeof( value ) );
+}
+
+/**
+ * @brief initDataPage
+ *
+ * @details formats an empty data page
+ *
+ * @param [out] char *page
+ *
+ * @return None
+ *
+ * @note None
+ */
+void initDataPage( char *page )
+{
+	memset( page, 0, PAGE_SIZE );
+	writeUint16( page, PAGE_SLOT_COUNT, 0 );
+	writeUint16( page, PAGE_FREE_END, PAGE_SIZE );
+}
+
+/**
+ * @brief compactPage
+ *
+ * @details moves every live tuple to the end of the page so that the space
+ *          of deleted and shrunk tuples becomes free again
+ *
+ * @par Algorithm slot numbers are kept, so row ids stay valid
+ *
+ * @param [in/out] char *page
+ *
+ * @return None
+ *
+ * @note None
+ */
+void compactPage( char *page )
+{
+	char compacted[ PAGE_SIZE ];
+	int slotCount = readUint16( page, PAGE_SLOT_COUNT );
+	int freeEnd = PAGE_SIZE;
+
+	memcpy( compacted, page, PAGE_SLOTS + slotCount * SLOT_SIZE );
+	for( int slot = 0; slot < slotCount; slot++ )
+	{
+		int slotOffset = PAGE_SLOTS + slot * SLOT_SIZE;
+		int length = readUint16( page, slotOffset + 2 );
+		if( length > 0 )
+		{
+			freeEnd -= length;
+			memcpy( compacted + freeEnd, page + readUint16( page, slotOffset ), length );
+			writeUint16( compacted, slotOffset, freeEnd );
+		}
+	}
+	writeUint16( compacted, PAGE_FREE_END, freeEnd );
+	memcpy( page, compacted, PAGE_SIZE );
+}
+
+/**
+ * @brief PageFile default constructor
+ *
+ * @details a new page file object is not attached to any file
+ *
+ * @note None
+ */
+PageFile::PageFile()
+{
+	fileId = -1;
+	pageCount = 0;
+	scanPage = 1;
+	scanSlot = 0;
+	scanBufferValid = false;
+	stagedPages = NULL;
+}
+
+/**
+ * @brief PageFile default destructor
+ *
+ * @details closes the file if it is still open
+ *
+ * @note None
+ */
+PageFile::~PageFile()
+{
+	pageFileClose();
+}
+
+/**
+ * @brief isPageFile
+ *
+ * @details checks whether a table file uses the page format
+ *
+ * @par Algorithm compares the first bytes of the file with the magic number,
+ *      a text table starts with its attribute line instead
+ *
+ * @param [in] string filePath
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool PageFile::isPageFile( string filePath )
+{
+	char magic[ 4 ];
+	int fileDesc = open( filePath.c_str(), O_RDONLY );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	bool pageFormat = ( pread( fileDesc, magic, 4, HEADER_MAGIC ) == 4 ) &&
+						memcmp( magic, PAGE_FILE_MAGIC, 4 ) == 0;
+	close( fileDesc );
+	return pageFormat;
+}
+
+/**
+ * @brief pageFileCreate
+ *
+ * @details creates an empty page file with the given attribute line
+ *
+ * @pre none
+ *
+ * @post file holds only its header page and stays open
+ *
+ * @param [in] string filePath
+ *
+ * @param [in] string attrData
+ *
+ * @return bool false if the file could not be created
+ *
+ * @note None
+ */
+bool PageFile::pageFileCreate( string filePath, string attrData )
+{
+	pageFileClose();
+	if( attrData.size() > (unsigned int)( PAGE_SIZE - HEADER_ATTR_DATA ) )
+	{
+		return false;
+	}
+
+	int fileDesc = open( filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	close( fileDesc );
+	fileId = bufferPool.poolOpenFile( filePath );
+	if( fileId < 0 )
+	{
+		return false;
+	}
+
+	attributeData = attrData;
+	pageCount = 1;
+
+	const vector< Attribute > &attributes =
+		schemaCatalog.catalogSchema( filePath, attributeData.data(), attributeData.size(), true ).attributes;
+	fieldTypes.clear();
+	for( unsigned int index = 0; index < attributes.size(); index++ )
+	{
+		fieldTypes.push_back( fieldTypeOf( attributes[ index ].attributeType ) );
+	}
+	return writeHeader();
+}
+
+/**
+ * @brief pageFileOpen
+ *
+ * @details opens an existing page file and reads its header page
+ *
+ * @par Algorithm the column types come from the schema catalog, the
+ *      attribute line of the header is only parsed when it changed
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if the file is missing or not a page file
+ *
+ * @note None
+ */
+bool PageFile::pageFileOpen( string filePath )
+{
+	char header[ PAGE_SIZE ];
+	uint32_t version;
+	uint32_t attrLength;
+
+	pageFileClose();
+	fileId = bufferPool.poolOpenFile( filePath );
+	if( fileId < 0 || !readPage( 0, header ) || memcmp( header, PAGE_FILE_MAGIC, 4 ) != 0 )
+	{
+		pageFileClose();
+		return false;
+	}
+
+	memcpy( &version, header + HEADER_VERSION, sizeof( version ) );
+	memcpy( &pageCount, header + HEADER_PAGE_COUNT, sizeof( pageCount ) );
+	memcpy( &attrLength, header + HEADER_ATTR_LENGTH, sizeof( attrLength ) );
+	if( version != PAGE_FILE_VERSION || attrLength > (uint32_t)( PAGE_SIZE - HEADER_ATTR_DATA ) )
+	{
+		pageFileClose();
+		return false;
+	}
+	attributeData.assign( header + HEADER_ATTR_DATA, attrLength );
+
+	const vector< Attribute > &attributes =
+		schemaCatalog.catalogSchema( filePath, attributeData.data(), attributeData.size(), true ).attributes;
+	fieldTypes.clear();
+	for( unsigned int index = 0; index < attributes.size(); index++ )
+	{
+		fieldTypes.push_back( fieldTypeOf( attributes[ index ].attributeType ) );
+	}
+	scanStart();
+	return true;
+}
+
+/**
+ * @brief pageFileClose
+ *
+ * @details releases the file, its dirty pages are written back by the pool
+ *
+ * @return None
+ *
+ * @note None
+ */
+void PageFile::pageFileClose()
+{
+	if( fileId >= 0 )
+	{
+		bufferPool.poolCloseFile( fileId );
+		fileId = -1;
+	}
+}
+
+/**
+ * @brief pageFileStage
+ *
+ * @details collects the pages the following changes write in a map instead of
+ *          writing them to the file
+ *
+ * @pre the file is open
+ *
+ * @post staged pages are read back from the map, the file is not changed
+ *
+ * @param [in] map< uint32_t, string > *pages page images by page number,
+ *             NULL to write to the file again
+ *
+ * @return None
+ *
+ * @note None
+ */
+void PageFile::pageFileStage( map< uint32_t, string > *pages )
+{
+	stagedPages = pages;
+}
+
+/**
+ * @brief pageFileInstall
+ *
+ * @details writes whole page images to the file and waits until they are on
+ *          disk
+ *
+ * @pre the file is open and not staging
+ *
+ * @par Algorithm writing an image again leaves the same page, so an install
+ *      that was cut short can simply be repeated
+ *
+ * @param [in] map< uint32_t, string > &pages page images by page number
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool PageFile::pageFileInstall( const map< uint32_t, string > &pages )
+{
+	bool success = true;
+	map< uint32_t, string >::const_iterator page;
+	for( page = pages.begin(); page != pages.end(); ++page )
+	{
+		if( page->second.size() != (unsigned int)PAGE_SIZE )
+		{
+			return false;
+		}
+		success = writePage( page->first, page->second.data() ) && success;
+		if( page->first >= pageCount )
+		{
+			pageCount = page->first + 1;
+		}
+	}
+	return bufferPool.syncFile( fileId ) && success;
+}
+
+/**
+ * @brief readPage
+ *
+ * @details copies one page of the file out of the buffer pool, or out of the
+ *          staged pages
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @param [out] char *page
+ *
+ * @return bool false if the page is past the end of the file
+ *
+ * @note None
+ */
+bool PageFile::readPage( uint32_t pageNo, char *page )
+{
+	if( stagedPages != NULL )
+	{
+		map< uint32_t, string >::iterator staged = stagedPages->find( pageNo );
+		if( staged != stagedPages->end() )
+		{
+			memcpy( page, staged->second.data(), PAGE_SIZE );
+			return true;
+		}
+	}
+
+	int length;
+	char *frame = bufferPool.pinPage( fileId, pageNo, length );
+	if( frame == NULL )
+	{
+		return false;
+	}
+	memcpy( page, frame, PAGE_SIZE );
+	bufferPool.unpinPage( fileId, pageNo, false );
+	return length == PAGE_SIZE;
+}
+
+/**
+ * @brief writePage
+ *
+ * @details copies one page into the buffer pool and marks it dirty, it
+ *          reaches the file when it is evicted or the file is closed. While
+ *          staging the page is only kept in the staged pages
+ *
+ * @param [in] uint32_t pageNo
+ *
+ * @param [in] const char *page
+ *
+ * @return bool false if every frame of the pool is pinned
+ *
+ * @note None
+ */
+bool PageFile::writePage( uint32_t pageNo, const char *page )
+{
+	if( stagedPages != NULL )
+	{
+		( *stagedPages )[ pageNo ].assign( page, PAGE_SIZE );
+		return true;
+	}
+
+	int length;
+	char *frame = bufferPool.pinPage( fileId, pageNo, length );
+	if( frame == NULL )
+	{
+		return false;
+	}
+	memcpy( frame, page, PAGE_SIZE );
+	bufferPool.unpinPage( fileId, pageNo, true );
+	return true;
+}
+
+/**
+ * @brief writeHeader
+ *
+ * @details writes the header page with the current page count
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool PageFile::writeHeader()
+{
+	char header[ PAGE_SIZE ];
+	uint32_t version = PAGE_FILE_VERSION;
+	uint32_t attrLength = attributeData.size();
+
+	memset( header, 0, PAGE_SIZE );
+	memcpy( header + HEADER_MAGIC, PAGE_FILE_MAGIC, 4 );
+	memcpy( header + HEADER_VERSION, &version, sizeof( version ) );
+	memcpy( header + HEADER_PAGE_COUNT, &pageCount, sizeof( pageCount ) );
+	memcpy( header + HEADER_ATTR_LENGTH, &attrLength, sizeof( attrLength ) );
+	memcpy( header + HEADER_ATTR_DATA, attributeData.data(), attrLength );
+	return writePage( 0, header );
+}
+
+/**
+ * @brief encodeRow
+ *
+ * @details encodes a row into a typed tuple
+ *
+ * @par Algorithm every field is a tag byte followed by an 8 byte integer, an
+ *      8 byte double or a 16 bit length and the text. A value is only stored
+ *      as a number when the number prints back as the same text, so "1.0" or
+ *      "007" are kept as text and read back exactly as they were written.
+ *      Only "null" itself is stored as a bare tag, other spellings of null
+ *      are kept as text. Decoding a tuple therefore gives back the row that
+ *      was encoded, which is the row the log overlay shows before the
+ *      background apply writes it
+ *
+ * @param [in] vector< string > &row
+ *
+ * @param [out] string &tuple
+ *
+ * @return bool false if the tuple does not fit in a page
+ *
+ * @note None
+ */
+bool PageFile::encodeRow( const vector< string > &row, string &tuple )
+{
+	tuple.clear();
+	int numFields = fieldTypes.size();
+	for( int index = 0; index < numFields; index++ )
+	{
+		string value = index < (int)row.size() ? row[ index ] : "null";
+		const char *start = value.c_str();
+		char *end = NULL;
+
+		if( value == "null" )
+		{
+			tuple += (char)FIELD_NULL;
+			continue;
+		}
+		if( fieldTypes[ index ] == FIELD_INT )
+		{
+			long long intValue = strtoll( start, &end, 10 );
+			char buffer[ 32 ];
+			snprintf( buffer, sizeof( buffer ), "%lld", intValue );
+			if( *end == '\0' && value == buffer )
+			{
+				tuple += (char)FIELD_INT;
+				tuple.append( (const char *)&intValue, sizeof( intValue ) );
+				continue;
+			}
+		}
+		else if( fieldTypes[ index ] == FIELD_FLOAT )
+		{
+			double floatValue = strtod( start, &end );
+			if( *end == '\0' && formatDouble( floatValue ) == value )
+			{
+				tuple += (char)FIELD_FLOAT;
+				tuple.append( (const char *)&floatValue, sizeof( floatValue ) );
+				continue;
+			}
+		}
+
+		uint16_t length = value.size();
+		if( value.size() > 0xffff )
+		{
+			return false;
+		}
+		tuple += (char)FIELD_TEXT;
+		tuple.append( (const char *)&length, sizeof( length ) );
+		tuple += value;
+	}
+	return (int)tuple.size() <= PAGE_SIZE - PAGE_SLOTS - SLOT_SIZE;
+}
+
+/**
+ * @brief decodeRow
+ *
+ * @details decodes a typed tuple back into its text values
+ *
+ * @param [in] const char *tuple
+ *
+ * @param [in] int length
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void PageFile::decodeRow( const char *tuple, int length, vector< string > &row ) const
+{
+	int numFields = fieldTypes.size();
+	int offset = 0;
+	row.resize( numFields );
+	for( int index = 0; index < numFields; index++ )
+	{
+		if( offset >= length )
+		{
+			row[ index ] = "null";
+			continue;
+		}
+		unsigned char tag = tuple[ offset++ ];
+		if( tag == FIELD_INT )
+		{
+			long long intValue;
+			char buffer[ 32 ];
+			memcpy( &intValue, tuple + offset, sizeof( intValue ) );
+			offset += sizeof( intValue );
+			snprintf( buffer, sizeof( buffer ), "%lld", intValue );
+			row[ index ] = buffer;
+		}
+		else if( tag == FIELD_FLOAT )
+		{
+			double floatValue;
+			memcpy( &floatValue, tuple + offset, sizeof( floatValue ) );
+			offset += sizeof( floatValue );
+			row[ index ] = formatDouble( floatValue );
+		}
+		else if( tag == FIELD_TEXT )
+		{
+			uint16_t textLength;
+			memcpy( &textLength, tuple + offset, sizeof( textLength ) );
+			offset += sizeof( textLength );
+			row[ index ].assign( tuple + offset, textLength );
+			offset += textLength;
+		}
+		else
+		{
+			row[ index ] = "null";
+		}
+	}
+}
+
+/**
+ * @brief placeTuple
+ *
+ * @details stores a tuple in a page, compacting the page if needed
+ *
+ * @pre slot is -1 to take any free slot, or a dead slot to reuse
+ *
+ * @post slot holds the slot the tuple was stored in
+ *
+ * @param [in/out] char *page
+ *
+ * @param [in] string &tuple
+ *
+ * @param [in/out] int &slot
+ *
+ * @return bool false if the page has no room
+ *
+ * @note None
+ */
+bool PageFile::placeTuple( char *page, const string &tuple, int &slot )
+{
+	int slotCount = readUint16( page, PAGE_SLOT_COUNT );
+	int liveBytes = 0;
+	int length = tuple.size();
+
+	if( slot < 0 )
+	{
+		for( int index = 0; index < slotCount; index++ )
+		{
+			if( readUint16( page, PAGE_SLOTS + index * SLOT_SIZE + 2 ) == 0 )
+			{
+				slot = index;
+				break;
+			}
+		}
+	}
+	for( int index = 0; index < slotCount; index++ )
+	{
+		liveBytes += readUint16( page, PAGE_SLOTS + index * SLOT_SIZE + 2 );
+	}
+
+	int newSlotCount = slot < 0 ? slotCount + 1 : slotCount;
+	int directoryEnd = PAGE_SLOTS + newSlotCount * SLOT_SIZE;
+	if( directoryEnd + liveBytes + length > PAGE_SIZE )
+	{
+		return false;
+	}
+	if( readUint16( page, PAGE_FREE_END ) - directoryEnd < length )
+	{
+		compactPage( page );
+	}
+
+	if( slot < 0 )
+	{
+		slot = slotCount;
+	}
+	int freeEnd = readUint16( page, PAGE_FREE_END ) - length;
+	memcpy( page + freeEnd, tuple.data(), length );
+	writeUint16( page, PAGE_FREE_END, freeEnd );
+	writeUint16( page, PAGE_SLOT_COUNT, newSlotCount );
+	writeUint16( page, PAGE_SLOTS + slot * SLOT_SIZE, freeEnd );
+	writeUint16( page, PAGE_SLOTS + slot * SLOT_SIZE + 2, length );
+	return true;
+}
+
+/**
+ * @brief insertRow
+ *
+ * @details stores a new row in the last page, or in a new page if it is full
+ *
+ * @param [in] vector< string > &row
+ *
+ * @param [out] long &rid
+ *
+ * @return bool false if the row could not be stored
+ *
+ * @note None
+ */
+bool PageFile::insertRow( const vector< string > &row, long &rid )
+{
+	char page[ PAGE_SIZE ];
+	string tuple;
+	int slot = -1;
+
+	if( fileId < 0 || !encodeRow( row, tuple ) )
+	{
+		return false;
+	}
+
+	uint32_t pageNo = pageCount - 1;
+	if( pageNo == 0 || !readPage( pageNo, page ) || !placeTuple( page, tuple, slot ) )
+	{
+		pageNo = pageCount;
+		slot = -1;
+		initDataPage( page );
+		placeTuple( page, tuple, slot );
+		pageCount++;
+		if( !writeHeader() )
+		{
+			return false;
+		}
+	}
+
+	rid = ( (long)pageNo << RID_SLOT_BITS ) | slot;
+	return writePage( pageNo, page );
+}
+
+/**
+ * @brief deleteRow
+ *
+ * @details frees the slot of a row
+ *
+ * @param [in] long rid
+ *
+ * @return bool false if the row does not exist
+ *
+ * @note None
+ */
+bool PageFile::deleteRow( long rid )
+{
+	char page[ PAGE_SIZE ];
+	uint32_t pageNo = rid >> RID_SLOT_BITS;
+	int slot = rid & ( ( 1 << RID_SLOT_BITS ) - 1 );
+
+	if( pageNo == 0 || pageNo >= pageCount || !readPage( pageNo, page ) )
+	{
+		return false;
+	}
+	int slotCount = readUint16( page, PAGE_SLOT_COUNT );
+	if( slot >= slotCount || readUint16( page, PAGE_SLOTS + slot * SLOT_SIZE + 2 ) == 0 )
+	{
+		return false;
+	}
+
+	writeUint16( page, PAGE_SLOTS + slot * SLOT_SIZE, 0 );
+	writeUint16( page, PAGE_SLOTS + slot * SLOT_SIZE + 2, 0 );
+
+	//give trailing dead slots back to the free space
+	while( slotCount > 0 && readUint16( page, PAGE_SLOTS + ( slotCount - 1 ) * SLOT_SIZE + 2 ) == 0 )
+	{
+		slotCount--;
+	}
+	writeUint16( page, PAGE_SLOT_COUNT, slotCount );
+	return writePage( pageNo, page );
+}
+
+/**
+ * @brief updateRow
+ *
+ * @details replaces a row, in place whenever it still fits in its page
+ *
+ * @post rid changes only if the row had to move to another page
+ *
+ * @param [in/out] long &rid
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool false if the row does not exist or could not be stored
+ *
+ * @note None
+ */
+bool PageFile::updateRow( long &rid, const vector< string > &row )
+{
+	char page[ PAGE_SIZE ];
+	string tuple;
+	uint32_t pageNo = rid >> RID_SLOT_BITS;
+	int slot = rid & ( ( 1 << RID_SLOT_BITS ) - 1 );
+
+	if( !encodeRow( row, tuple ) || pageNo == 0 || pageNo >= pageCount || !readPage( pageNo, page ) )
+	{
+		return false;
+	}
+	int slotOffset = PAGE_SLOTS + slot * SLOT_SIZE;
+	int oldLength = readUint16( page, slotOffset + 2 );
+	if( slot >= readUint16( page, PAGE_SLOT_COUNT ) || oldLength == 0 )
+	{
+		return false;
+	}
+
+	//overwrite in place if the new tuple is not longer
+	if( (int)tuple.size() <= oldLength )
+	{
+		memcpy( page + readUint16( page, slotOffset ), tuple.data(), tuple.size() );
+		writeUint16( page, slotOffset + 2, tuple.size() );
+		return writePage( pageNo, page );
+	}
+
+	//otherwise free the old tuple and try to keep the row in its page
+	writeUint16( page, slotOffset, 0 );
+	writeUint16( page, slotOffset + 2, 0 );
+	if( placeTuple( page, tuple, slot ) )
+	{
+		return writePage( pageNo, page );
+	}
+	return deleteRow( rid ) && insertRow( row, rid );
+}
+
+/**
+ * @brief readRow
+ *
+ * @details reads a single row by its row id
+ *
+ * @param [in] long rid
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false if the row does not exist
+ *
+ * @note None
+ */
+bool PageFile::readRow( long rid, vector< string > &row )
+{
+	char page[ PAGE_SIZE ];
+	uint32_t pageNo = rid >> RID_SLOT_BITS;
+	int slot = rid & ( ( 1 << RID_SLOT_BITS ) - 1 );
+
+	if( pageNo == 0 || pageNo >= pageCount || !readPage( pageNo, page ) ||
+		slot >= readUint16( page, PAGE_SLOT_COUNT ) )
+	{
+		return false;
+	}
+	int length = readUint16( page, PAGE_SLOTS + slot * SLOT_SIZE + 2 );
+	if( length == 0 )
+	{
+		return false;
+	}
+	decodeRow( page + readUint16( page, PAGE_SLOTS + slot * SLOT_SIZE ), length, row );
+	return true;
+}
+
+/**
+ * @brief scanStart
+ *
+ * @details positions the scan on the first row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void PageFile::scanStart()
+{
+	scanPage = 1;
+	scanSlot = 0;
+	scanBufferValid = false;
+}
+
+/**
+ * @brief scanNextRow
+ *
+ * @details returns the next live row in page and slot order
+ *
+ * @par Algorithm each page is read once into the scan buffer, dead slots
+ *      are skipped
+ *
+ * @param [out] vector< string > &row
+ *
+ * @param [out] long &rid
+ *
+ * @return bool false once every page has been read
+ *
+ * @note None
+ */
+bool PageFile::scanNextRow( vector< string > &row, long &rid )
+{
+	while( scanPage < pageCount )
+	{
+		if( !scanBufferValid )
+		{
+			if( !readPage( scanPage, scanBuffer ) )
+			{
+				return false;
+			}
+			scanBufferValid = true;
+			scanSlot = 0;
+		}
+
+		int slotCount = readUint16( scanBuffer, PAGE_SLOT_COUNT );
+		while( scanSlot < slotCount )
+		{
+			int slotOffset = PAGE_SLOTS + scanSlot * SLOT_SIZE;
+			int length = readUint16( scanBuffer, slotOffset + 2 );
+			if( length > 0 )
+			{
+				decodeRow( scanBuffer + readUint16( scanBuffer, slotOffset ), length, row );
+				rid = ( (long)scanPage << RID_SLOT_BITS ) | scanSlot;
+				scanSlot++;
+				return true;
+			}
+			scanSlot++;
+		}
+
+		scanPage++;
+		scanBufferValid = false;
+	}
+	return false;
+}
+
+/**
+ * @brief pageRow
+ *
+ * @details decodes one slot of a data page read outside the buffer pool
+ *
+ * @pre the file was opened so fieldTypes are known
+ *
+ * @param [in] const char *page
+ *
+ * @param [in] int slot
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false if the slot is dead or past the slot directory
+ *
+ * @note None
+ */
+bool PageFile::pageRow( const char *page, int slot, vector< string > &row ) const
+{
+	if( slot >= readUint16( page, PAGE_SLOT_COUNT ) )
+	{
+		return false;
+	}
+	int slotOffset = PAGE_SLOTS + slot * SLOT_SIZE;
+	int length = readUint16( page, slotOffset + 2 );
+	if( length == 0 )
+	{
+		return false;
+	}
+	decodeRow( page + readUint16( page, slotOffset ), length, row );
+	return true;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,94 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file PageFile.h
+ *
+ * @brief Definition file for PageFile class
+ *
+ * @details Specifies all member methods of the PageFile class, the binary
+ *          slotted-page table format
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <stdint.h>
+#include "BufferPool.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PAGEFILE_H
+#define PAGEFILE_H
+
+const char PAGE_FILE_MAGIC[] = "PGTB";
+const uint32_t PAGE_FILE_VERSION = 1;
+
+//header page layout
+const int HEADER_MAGIC = 0;
+const int HEADER_VERSION = 4;
+const int HEADER_PAGE_COUNT = 8;
+const int HEADER_ATTR_LENGTH = 12;
+const int HEADER_ATTR_DATA = 16;
+
+//data page layout, slots grow up from the header, tuples grow down from the end
+const int PAGE_SLOT_COUNT = 0;
+const int PAGE_FREE_END = 2;
+const int PAGE_SLOTS = 4;
+const int SLOT_SIZE = 4;
+
+//field tags of an encoded tuple
+const unsigned char FIELD_NULL = 0;
+const unsigned char FIELD_INT = 1;
+const unsigned char FIELD_FLOAT = 2;
+const unsigned char FIELD_TEXT = 3;
+
+//a row id is the page number in the high bits and the slot in the low 16 bits
+const int RID_SLOT_BITS = 16;
+
+class PageFile{
+	public:
+		string attributeData;
+		vector< unsigned char > fieldTypes;
+
+		PageFile();
+		~PageFile();
+
+		static bool isPageFile( string filePath );
+		bool pageFileCreate( string filePath, string attrData );
+		bool pageFileOpen( string filePath );
+		void pageFileClose();
+		void pageFileStage( map< uint32_t, string > *pages );
+		bool pageFileInstall( const map< uint32_t, string > &pages );
+
+		bool insertRow( const vector< string > &row, long &rid );
+		bool deleteRow( long rid );
+		bool updateRow( long &rid, const vector< string > &row );
+		bool readRow( long rid, vector< string > &row );
+
+		void scanStart();
+		bool scanNextRow( vector< string > &row, long &rid );
+		bool pageRow( const char *page, int slot, vector< string > &row ) const;
+
+	private:
+		int fileId;
+		uint32_t pageCount;
+		uint32_t scanPage;
+		int scanSlot;
+		char scanBuffer[ PAGE_SIZE ];
+		bool scanBufferValid;
+		//pages written while staging, in place of the file
+		map< uint32_t, string > *stagedPages;
+
+		bool readPage( uint32_t pageNo, char *page );
+		bool writePage( uint32_t pageNo, const char *page );
+		bool writeHeader();
+		bool encodeRow( const vector< string > &row, string &tuple );
+		void decodeRow( const char *tuple, int length, vector< string > &row ) const;
+		bool placeTuple( char *page, const string &tuple, int &slot );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,35 @@
+--CS457 page format round trip
+
+--A page table and a text table hold the same values and must print the same rows
+
+CREATE DATABASE RoundTrip;
+USE RoundTrip;
+
+create table Pages (id int, price float, name varchar(10)) STORAGE PAGE;
+create table Lines (id int, price float, name varchar(10));
+
+insert into Pages values(1, 1.0, 'one');
+insert into Pages values(2, 7.250, 'two');
+insert into Pages values(3, 2, 'three');
+insert into Pages values(007, 0.1, 'four');
+insert into Pages values(-5, 1e3, 'five');
+insert into Pages values(6, -0.50, 'six');
+
+insert into Lines values(1, 1.0, 'one');
+insert into Lines values(2, 7.250, 'two');
+insert into Lines values(3, 2, 'three');
+insert into Lines values(007, 0.1, 'four');
+insert into Lines values(-5, 1e3, 'five');
+insert into Lines values(6, -0.50, 'six');
+
+select * from Pages;
+select * from Lines;
+
+update Pages set price = 3.10 where name = 'two';
+update Lines set price = 3.10 where name = 'two';
+
+select * from Pages;
+select * from Lines;
+
+DROP DATABASE RoundTrip;
+.EXIT
@@ -0,0 +1,763 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ParallelScan.cpp
+ *
+ * @brief Implementation file for WorkerPool and ParallelScan classes
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the work stealing worker pool and the parallel scan.
+ *          The table file is cut into morsels at row boundaries, a text row
+ *          belongs to the morsel its first byte is in and a page row to the
+ *          morsel of its page. Workers read their morsel straight from the
+ *          file and run its rows through the operator of the statement,
+ *          select filtering or a join probe, into output text, in batches
+ *          of FILTER_BATCH_ROWS so a where condition filters a whole batch
+ *          with the vector kernels. The statement
+ *          thread writes the morsels out in file order
+ *
+ * @Note Requires ParallelScan.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "ParallelScan.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PARALLELSCAN_CPP
+#define PARALLELSCAN_CPP
+
+//helper functions implemented in TableScan.cpp
+string stripQuotes( string content );
+
+WorkerPool workerPool;
+
+//index of the worker running on this thread, -1 off the pool
+thread_local int currentWorker = -1;
+
+/**
+ * @brief readRange
+ *
+ * @details appends bytes of a file to a buffer without moving its offset
+ *
+ * @param [in] int fd
+ *
+ * @param [in] off_t position
+ *
+ * @param [in] off_t count
+ *
+ * @param [out] string &buffer
+ *
+ * @return off_t bytes read, less than count at the end of the file
+ *
+ * @note None
+ */
+off_t readRange( int fd, off_t position, off_t count, string &buffer )
+{
+	size_t oldSize = buffer.size();
+	off_t total = 0;
+	buffer.resize( oldSize + count );
+	while( total < count )
+	{
+		ssize_t bytes = pread( fd, &buffer[ oldSize + total ], count - total, position + total );
+		if( bytes <= 0 )
+		{
+			break;
+		}
+		total += bytes;
+	}
+	buffer.resize( oldSize + total );
+	return total;
+}
+
+/**
+ * @brief WorkerPool default constructor
+ *
+ * @details one thread per core, started when the first task is submitted
+ *
+ * @note None
+ */
+WorkerPool::WorkerPool()
+{
+	threadCount = thread::hardware_concurrency();
+	if( threadCount < 1 )
+	{
+		threadCount = 1;
+	}
+	nextQueue = 0;
+	queuedTasks = 0;
+	stopping = false;
+}
+
+/**
+ * @brief WorkerPool default destructor
+ *
+ * @details lets the workers finish their tasks and joins them
+ *
+ * @note None
+ */
+WorkerPool::~WorkerPool()
+{
+	stopWorkers();
+}
+
+/**
+ * @brief poolSetThreads
+ *
+ * @details changes the number of worker threads
+ *
+ * @pre no task is running
+ *
+ * @param [in] int threads 1 runs every statement on its own thread
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WorkerPool::poolSetThreads( int threads )
+{
+	stopWorkers();
+	threadCount = threads < 1 ? 1 : threads;
+}
+
+/**
+ * @brief poolGetThreads
+ *
+ * @details returns the number of worker threads
+ *
+ * @return int
+ *
+ * @note None
+ */
+int WorkerPool::poolGetThreads()
+{
+	return threadCount;
+}
+
+/**
+ * @brief poolSubmit
+ *
+ * @details queues a task for the workers
+ *
+ * @par Algorithm a task submitted by a worker goes on that worker's own
+ *      queue, so the morsels an operator splits off stay on its core until
+ *      another core runs dry and steals them. Tasks of the statement thread
+ *      are dealt to the queues in turn
+ *
+ * @param [in] function< void() > task
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WorkerPool::poolSubmit( function< void() > task )
+{
+	startWorkers();
+	int queueIndex = currentWorker >= 0 ? currentWorker : nextQueue++ % queues.size();
+	{
+		lock_guard< mutex > guard( queues[ queueIndex ]->queueLock );
+		queues[ queueIndex ]->tasks.push_back( task );
+	}
+	{
+		lock_guard< mutex > guard( idleLock );
+		queuedTasks++;
+	}
+	tasksReady.notify_one();
+}
+
+/**
+ * @brief startWorkers
+ *
+ * @details starts the worker threads unless they are running
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WorkerPool::startWorkers()
+{
+	if( !workers.empty() )
+	{
+		return;
+	}
+	stopping = false;
+	for( int index = 0; index < threadCount; index++ )
+	{
+		queues.push_back( new WorkerQueue );
+	}
+	for( int index = 0; index < threadCount; index++ )
+	{
+		workers.push_back( thread( &WorkerPool::workerLoop, this, index ) );
+	}
+}
+
+/**
+ * @brief stopWorkers
+ *
+ * @details joins the worker threads once every queue is empty
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WorkerPool::stopWorkers()
+{
+	{
+		lock_guard< mutex > guard( idleLock );
+		stopping = true;
+	}
+	tasksReady.notify_all();
+	for( unsigned int index = 0; index < workers.size(); index++ )
+	{
+		workers[ index ].join();
+	}
+	workers.clear();
+	for( unsigned int index = 0; index < queues.size(); index++ )
+	{
+		delete queues[ index ];
+	}
+	queues.clear();
+}
+
+/**
+ * @brief workerLoop
+ *
+ * @details runs tasks until the pool stops, sleeping while there are none
+ *
+ * @param [in] int workerIndex
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WorkerPool::workerLoop( int workerIndex )
+{
+	currentWorker = workerIndex;
+	while( true )
+	{
+		function< void() > task;
+		if( takeTask( workerIndex, task ) )
+		{
+			{
+				lock_guard< mutex > guard( idleLock );
+				queuedTasks--;
+			}
+			task();
+			continue;
+		}
+
+		unique_lock< mutex > guard( idleLock );
+		while( queuedTasks == 0 && !stopping )
+		{
+			tasksReady.wait( guard );
+		}
+		if( queuedTasks == 0 )
+		{
+			return;
+		}
+	}
+}
+
+/**
+ * @brief takeTask
+ *
+ * @details finds the next task for a worker
+ *
+ * @par Algorithm the newest task of the worker's own queue comes first, its
+ *      data is the most likely to still be in cache. Otherwise the oldest
+ *      task of the next worker that has any is stolen
+ *
+ * @param [in] int workerIndex
+ *
+ * @param [out] function< void() > &task
+ *
+ * @return bool false if every queue is empty
+ *
+ * @note None
+ */
+bool WorkerPool::takeTask( int workerIndex, function< void() > &task )
+{
+	int queueCount = queues.size();
+	for( int offset = 0; offset < queueCount; offset++ )
+	{
+		WorkerQueue *queue = queues[ ( workerIndex + offset ) % queueCount ];
+		lock_guard< mutex > guard( queue->queueLock );
+		if( queue->tasks.empty() )
+		{
+			continue;
+		}
+		if( offset == 0 )
+		{
+			task = queue->tasks.back();
+			queue->tasks.pop_back();
+		}
+		else
+		{
+			task = queue->tasks.front();
+			queue->tasks.pop_front();
+		}
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief ParallelScan default constructor
+ *
+ * @details a new scan has no table
+ *
+ * @note None
+ */
+ParallelScan::ParallelScan()
+{
+	source = NULL;
+	fileDescriptor = -1;
+}
+
+/**
+ * @brief ParallelScan default destructor
+ *
+ * @details closes the table file
+ *
+ * @note None
+ */
+ParallelScan::~ParallelScan()
+{
+	if( fileDescriptor >= 0 )
+	{
+		close( fileDescriptor );
+	}
+	pageFile.pageFileClose();
+}
+
+/**
+ * @brief scanSelect
+ *
+ * @details outputs the selected rows of a scan using every worker
+ *
+ * @pre scan was opened on filePath and its where condition and projection
+ *      are set, its header was output
+ *
+ * @post the rows are output in the same order a sequential scan outputs them
+ *
+ * @param [in] TableScan &scan
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if nothing was output, the caller then reads the scan
+ *         itself
+ *
+ * @note None
+ */
+bool ParallelScan::scanSelect( TableScan &scan, string filePath )
+{
+	return scanRows( scan, filePath,
+		[ this ]( const vector< vector< string > > &rows, unsigned int count, long, string &output )
+	{
+		vector< uint64_t > selection;
+		selectAll( selection, count );
+		source->filterBatch( rows, count, &selection[ 0 ] );
+		for( unsigned int rowIndex = 0; rowIndex < count; rowIndex++ )
+		{
+			if( rowSelected( &selection[ 0 ], rowIndex ) )
+			{
+				outputSelected( rows[ rowIndex ], output );
+			}
+		}
+	} );
+}
+
+/**
+ * @brief scanRows
+ *
+ * @details runs every row of a scan through an operator on the workers and
+ *          outputs what the operator produces
+ *
+ * @pre scan was opened on filePath and no row has been read from it
+ *
+ * @post the output of each row comes out in the order of the table file
+ *
+ * @par Algorithm the table is cut into morsels that are handed to the
+ *      workers a window ahead of the morsel being output, so memory stays
+ *      bounded by the window and not by the table. A morsel that takes
+ *      longer, more matches or longer rows, only holds up its own worker
+ *      while the others steal the morsels queued behind it
+ *
+ * @param [in] TableScan &scan
+ *
+ * @param [in] string filePath
+ *
+ * @param [in] BatchOperator batchOperator appends the output of a batch of
+ *             rows, it is called from several threads at once
+ *
+ * @return bool false if nothing was output because the table is too small,
+ *         uses an index or overlays uncommitted changes
+ *
+ * @note None
+ */
+bool ParallelScan::scanRows( TableScan &scan, string filePath, BatchOperator batchOperator )
+{
+	struct stat fileStat;
+	if( workerPool.poolGetThreads() < 2 || !scan.scanPartitionable() ||
+		stat( filePath.c_str(), &fileStat ) != 0 || fileStat.st_size < PARALLEL_MIN_BYTES )
+	{
+		return false;
+	}
+	if( scan.pageFormat && !pageFile.pageFileOpen( filePath ) )
+	{
+		return false;
+	}
+	fileDescriptor = open( filePath.c_str(), O_RDONLY );
+	if( fileDescriptor < 0 )
+	{
+		return false;
+	}
+	source = &scan;
+	scanPath = filePath;
+	morselBatch = batchOperator;
+	if( !scan.pageFormat && mapping.mapOpen( filePath ) )
+	{
+		fileStat.st_size = mapping.mapSize();
+	}
+	if( !splitChunks( fileStat.st_size ) )
+	{
+		return false;
+	}
+
+	int chunkCount = chunks.size();
+	int window = workerPool.poolGetThreads() * PARALLEL_WINDOW;
+	int submitted = 0;
+	for( int next = 0; next < chunkCount; next++ )
+	{
+		while( submitted < chunkCount && submitted < next + window )
+		{
+			int chunkIndex = submitted++;
+			workerPool.poolSubmit( [ this, chunkIndex ]() { scanChunk( chunkIndex ); } );
+		}
+
+		string output;
+		{
+			unique_lock< mutex > guard( chunksLock );
+			while( !chunks[ next ].done )
+			{
+				chunkDone.wait( guard );
+			}
+			output.swap( chunks[ next ].output );
+		}
+		cout << output;
+	}
+	cout.flush();
+	return true;
+}
+
+/**
+ * @brief splitChunks
+ *
+ * @details cuts the rows of the table file into chunks
+ *
+ * @par Algorithm text rows start after the attribute line, page rows after
+ *      the header page and end at the page count it records
+ *
+ * @param [in] off_t fileSize
+ *
+ * @return bool false if the file could not be read
+ *
+ * @note None
+ */
+bool ParallelScan::splitChunks( off_t fileSize )
+{
+	off_t dataStart;
+	off_t dataEnd = fileSize;
+	string buffer;
+
+	if( source->pageFormat )
+	{
+		uint32_t pageCount;
+		if( readRange( fileDescriptor, 0, PAGE_SIZE, buffer ) != PAGE_SIZE )
+		{
+			return false;
+		}
+		memcpy( &pageCount, buffer.data() + HEADER_PAGE_COUNT, sizeof( pageCount ) );
+		dataStart = PAGE_SIZE;
+		dataEnd = min( dataEnd, (off_t)pageCount * PAGE_SIZE );
+	}
+	else if( mapping.mapIsOpen() )
+	{
+		const char *newLine = (const char *)memchr( mapping.mapData(), '\n', mapping.mapSize() );
+		if( newLine == NULL )
+		{
+			return false;
+		}
+		dataStart = newLine - mapping.mapData() + 1;
+	}
+	else
+	{
+		size_t newLine = string::npos;
+		while( newLine == string::npos )
+		{
+			off_t searched = buffer.size();
+			if( readRange( fileDescriptor, searched, PAGE_SIZE, buffer ) == 0 )
+			{
+				return false;
+			}
+			newLine = buffer.find( '\n', searched );
+		}
+		dataStart = newLine + 1;
+	}
+
+	for( off_t start = dataStart; start < dataEnd; start += PARALLEL_CHUNK_BYTES )
+	{
+		ScanChunk chunk;
+		chunk.start = start;
+		chunk.end = min( start + PARALLEL_CHUNK_BYTES, dataEnd );
+		chunk.done = false;
+		chunk.index = chunks.size();
+		chunk.rowsBatched = 0;
+		chunks.push_back( chunk );
+	}
+	return true;
+}
+
+/**
+ * @brief scanChunk
+ *
+ * @details runs the rows of one morsel through the operator on a worker
+ *
+ * @post the scan is not touched once the morsel is marked done
+ *
+ * @param [in] int chunkIndex
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ParallelScan::scanChunk( int chunkIndex )
+{
+	ScanChunk &chunk = chunks[ chunkIndex ];
+	if( source->pageFormat )
+	{
+		scanPageChunk( chunk );
+	}
+	else
+	{
+		scanTextChunk( chunk );
+	}
+
+	//notify under the lock, once the statement thread sees the last morsel
+	//done it may destroy the scan, the worker must not touch it after
+	lock_guard< mutex > guard( chunksLock );
+	chunk.done = true;
+	chunkDone.notify_all();
+}
+
+/**
+ * @brief scanTextChunk
+ *
+ * @details reads the text rows that start inside a morsel
+ *
+ * @par Algorithm a mapped table is split where it lies in the mapping.
+ *      Otherwise the morsel is read into a buffer, together with the byte
+ *      before it and the rest of its last row
+ *
+ * @param [in] ScanChunk &chunk
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ParallelScan::scanTextChunk( ScanChunk &chunk )
+{
+	if( mapping.mapIsOpen() )
+	{
+		const char *data = mapping.mapData();
+		splitChunkRows( data + chunk.start - 1, data + chunk.end, data + mapping.mapSize(), chunk );
+		return;
+	}
+
+	string buffer;
+	off_t readFrom = chunk.start - 1;
+
+	readRange( fileDescriptor, readFrom, chunk.end - readFrom, buffer );
+	size_t chunkLength = buffer.size();
+	size_t searched = chunkLength == 0 ? 0 : chunkLength - 1;
+	while( buffer.find( '\n', searched ) == string::npos )
+	{
+		searched = buffer.size();
+		if( readRange( fileDescriptor, readFrom + searched, PARALLEL_CHUNK_BYTES, buffer ) == 0 )
+		{
+			break;
+		}
+	}
+
+	splitChunkRows( buffer.data(), buffer.data() + chunkLength, buffer.data() + buffer.size(), chunk );
+}
+
+/**
+ * @brief splitChunkRows
+ *
+ * @details runs the text rows that start inside a morsel through the operator
+ *
+ * @par Algorithm the byte before the chunk is passed too, when it is not a
+ *      newline the first partial row belongs to the chunk before. The last
+ *      row runs past the end of the chunk up to its newline. Blank lines
+ *      are skipped as in a sequential scan. Rows are split where they lie,
+ *      without copying each line first
+ *
+ * @param [in] const char *readFrom the byte before the chunk
+ *
+ * @param [in] const char *chunkEnd
+ *
+ * @param [in] const char *bufferEnd holds the newline of the last row
+ *
+ * @param [in/out] ScanChunk &chunk
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ParallelScan::splitChunkRows( const char *readFrom, const char *chunkEnd, const char *bufferEnd,
+								   ScanChunk &chunk )
+{
+	vector< vector< string > > rows( FILTER_BATCH_ROWS );
+	unsigned int count = 0;
+	int numCells = source->attributes.size();
+
+	const char *rowStart = (const char *)memchr( readFrom, '\n', bufferEnd - readFrom );
+	rowStart = rowStart == NULL ? bufferEnd : rowStart + 1;
+	while( rowStart < chunkEnd )
+	{
+		if( *rowStart == '\n' )
+		{
+			rowStart++;
+			continue;
+		}
+		rowStart = splitRow( rowStart, bufferEnd, numCells, rows[ count ] );
+		batchRow( rows, count, chunk );
+	}
+	if( count > 0 )
+	{
+		runBatch( rows, count, chunk );
+	}
+}
+
+/**
+ * @brief scanPageChunk
+ *
+ * @details reads the live rows of the pages of a morsel
+ *
+ * @param [in] ScanChunk &chunk
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ParallelScan::scanPageChunk( ScanChunk &chunk )
+{
+	string page;
+	vector< vector< string > > rows( FILTER_BATCH_ROWS );
+	unsigned int count = 0;
+	for( off_t start = chunk.start; start < chunk.end; start += PAGE_SIZE )
+	{
+		page.clear();
+		if( readRange( fileDescriptor, start, PAGE_SIZE, page ) != PAGE_SIZE )
+		{
+			break;
+		}
+		int slotCount = readUint16( page.data(), PAGE_SLOT_COUNT );
+		for( int slot = 0; slot < slotCount; slot++ )
+		{
+			if( pageFile.pageRow( page.data(), slot, rows[ count ] ) )
+			{
+				batchRow( rows, count, chunk );
+			}
+		}
+	}
+	if( count > 0 )
+	{
+		runBatch( rows, count, chunk );
+	}
+}
+
+/**
+ * @brief batchRow
+ *
+ * @details adds the row just read into rows[ count ] to the batch, a full
+ *          batch is run through the operator
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in/out] unsigned int &count rows of the batch in use
+ *
+ * @param [in/out] ScanChunk &chunk
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ParallelScan::batchRow( vector< vector< string > > &rows, unsigned int &count, ScanChunk &chunk )
+{
+	if( ++count == FILTER_BATCH_ROWS )
+	{
+		runBatch( rows, count, chunk );
+		count = 0;
+	}
+}
+
+/**
+ * @brief runBatch
+ *
+ * @details runs a batch of the rows of a morsel through the operator
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in/out] ScanChunk &chunk
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ParallelScan::runBatch( const vector< vector< string > > &rows, unsigned int count, ScanChunk &chunk )
+{
+	long firstRow = ( (long)chunk.index << MORSEL_POSITION_BITS ) + chunk.rowsBatched;
+	morselBatch( rows, count, firstRow, chunk.output );
+	chunk.rowsBatched += count;
+}
+
+/**
+ * @brief outputSelected
+ *
+ * @details appends the projection of a row as "-- a|b|c" to the chunk output
+ *
+ * @param [in] vector< string > &row
+ *
+ * @param [out] string &output
+ *
+ * @return None
+ *
+ * @note None
+ */
+void ParallelScan::outputSelected( const vector< string > &row, string &output )
+{
+	int projectionSize = source->projection.size();
+	output += "-- ";
+	for( int index = 0; index < projectionSize; index++ )
+	{
+		if( index != 0 )
+		{
+			output += "|";
+		}
+		output += stripQuotes( row[ source->projection[ index ] ] );
+	}
+	output += "\n";
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,130 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file ParallelScan.h
+ *
+ * @brief Definition file for WorkerPool and ParallelScan classes
+ *
+ * @details Specifies all member methods of the WorkerPool class, the fixed
+ *          set of threads statements hand morsels of work to, and of
+ *          ParallelScan, which runs the rows of a large table through an
+ *          operator on all of them
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <sys/types.h>
+#include "Table.h"
+#include "TableScan.h"
+#include "PageFile.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef PARALLELSCAN_H
+#define PARALLELSCAN_H
+
+//tables smaller than this are scanned on the statement thread
+const off_t PARALLEL_MIN_BYTES = 1024 * 1024;
+
+//bytes of the table file in one morsel, a whole number of pages
+const off_t PARALLEL_CHUNK_BYTES = 256 * PAGE_SIZE;
+
+//morsels handed out ahead of the one being output, per thread
+const int PARALLEL_WINDOW = 4;
+
+//operator a morsel runs its rows through a batch at a time, it appends its
+//output for the first count rows. The position of the first row orders the
+//batches the way a sequential scan reads them
+typedef function< void( const vector< vector< string > > &, unsigned int, long, string & ) > BatchOperator;
+
+//rows of one morsel are numbered from its index shifted by this
+const int MORSEL_POSITION_BITS = 32;
+
+//tasks queued on one worker, the worker takes the newest and idle workers
+//steal the oldest
+struct WorkerQueue{
+	mutex queueLock;
+	deque< function< void() > > tasks;
+};
+
+class WorkerPool{
+	public:
+		WorkerPool();
+		~WorkerPool();
+
+		void poolSetThreads( int threads );
+		int poolGetThreads();
+		void poolSubmit( function< void() > task );
+
+	private:
+		int threadCount;
+		vector< thread > workers;
+		vector< WorkerQueue * > queues;
+		unsigned int nextQueue;
+
+		//tasks queued on every worker, idle workers sleep while it is 0
+		mutex idleLock;
+		condition_variable tasksReady;
+		int queuedTasks;
+		bool stopping;
+
+		void startWorkers();
+		void stopWorkers();
+		void workerLoop( int workerIndex );
+		bool takeTask( int workerIndex, function< void() > &task );
+};
+
+//one morsel of a table and its result, output once every morsel before it was
+struct ScanChunk{
+	off_t start;
+	off_t end;
+	string output;
+	bool done;
+	int index;
+	long rowsBatched;
+};
+
+class ParallelScan{
+	public:
+		ParallelScan();
+		~ParallelScan();
+
+		bool scanSelect( TableScan &scan, string filePath );
+		bool scanRows( TableScan &scan, string filePath, BatchOperator batchOperator );
+
+	private:
+		TableScan *source;
+		BatchOperator morselBatch;
+		string scanPath;
+		int fileDescriptor;
+		MappedFile mapping;
+		PageFile pageFile;
+		vector< ScanChunk > chunks;
+		mutex chunksLock;
+		condition_variable chunkDone;
+
+		bool splitChunks( off_t fileSize );
+		void scanChunk( int chunkIndex );
+		void scanTextChunk( ScanChunk &chunk );
+		void splitChunkRows( const char *readFrom, const char *chunkEnd, const char *bufferEnd,
+							 ScanChunk &chunk );
+		void scanPageChunk( ScanChunk &chunk );
+		void batchRow( vector< vector< string > > &rows, unsigned int &count, ScanChunk &chunk );
+		void runBatch( const vector< vector< string > > &rows, unsigned int count, ScanChunk &chunk );
+		void outputSelected( const vector< string > &row, string &output );
+};
+
+//the workers of the process, one per core by default
+extern WorkerPool workerPool;
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,690 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file QueryPlanner.cpp
+ *
+ * @brief Implementation file for the query planner
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the cost based choice of how a select reads its table
+ *          and how a join matches its tables. The size of each table and the
+ *          share of its rows a comparison keeps are estimated from the table
+ *          statistics, or from the catalog row count and fixed selectivities
+ *          when the table was never analyzed. Every plan is costed in page
+ *          reads and the cheapest one runs. EXPLAIN prints the plan chosen
+ *          and the ones it was chosen over
+ *
+ * @Note Requires QueryPlanner.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <climits>
+#include "QueryPlanner.h"
+#include "TableStatistics.h"
+#include "TableScan.h"
+#include "HashJoin.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef QUERYPLANNER_CPP
+#define QUERYPLANNER_CPP
+
+//helper functions implemented in HashJoin.cpp, ExternalSort.cpp and Table.cpp
+long tableFileSize( string tablePath );
+int compareCells( const string &first, const string &second, SortValue valueType );
+bool caseInsCompare( const string &s1, const string &s2 );
+
+//helper functions implemented in TableStatistics.cpp
+unsigned int findHistogramBucket( const ColumnStatistics &column, const string &value );
+double statisticsDistinct( const ColumnStatistics &column, int64_t rowCount );
+
+/**
+ * @brief estimateTable
+ *
+ * @details estimates the rows and pages of a table
+ *
+ * @par Algorithm the row count of the statistics, else the one of the
+ *      catalog, else the size of the file over DEFAULT_ROW_BYTES. The
+ *      statistics are left out when ANALYZE built no histogram from the
+ *      table yet or when they count other rows than the catalog
+ *
+ * @param [in] string &tablePath
+ *
+ * @param [out] TableEstimate &table
+ *
+ * @return None
+ *
+ * @note None
+ */
+void estimateTable( const string &tablePath, TableEstimate &table )
+{
+	table.tablePath = tablePath;
+	table.bytes = tableFileSize( tablePath );
+	table.pages = max( ceil( table.bytes / PAGE_SIZE ), 1.0 );
+	table.statistics = statisticsCatalog.statisticsOf( tablePath );
+
+	int64_t rowCount = schemaCatalog.catalogRowCount( tablePath );
+	if( table.statistics != NULL )
+	{
+		bool analyzed = false;
+		for( unsigned int column = 0; column < table.statistics->columns.size(); column++ )
+		{
+			analyzed = analyzed || !table.statistics->columns[ column ].histogram.empty();
+		}
+		if( !analyzed || ( rowCount >= 0 && rowCount != table.statistics->rowCount ) )
+		{
+			table.statistics = NULL;
+		}
+	}
+	if( table.statistics != NULL )
+	{
+		rowCount = table.statistics->rowCount;
+	}
+	table.rows = rowCount >= 0 ? rowCount : table.bytes / DEFAULT_ROW_BYTES;
+}
+
+/**
+ * @brief columnStatistics
+ *
+ * @details finds the statistics of a column of a table
+ *
+ * @param [in] TableEstimate &table
+ *
+ * @param [in] int columnIndex
+ *
+ * @param [in] string &columnName
+ *
+ * @return ColumnStatistics* NULL if the table was not analyzed or its
+ *         statistics are of other columns
+ *
+ * @note None
+ */
+const ColumnStatistics *columnStatistics( const TableEstimate &table, int columnIndex,
+											const string &columnName )
+{
+	if( table.statistics == NULL || columnIndex < 0 ||
+		columnIndex >= (int)table.statistics->columns.size() ||
+		!caseInsCompare( table.statistics->columns[ columnIndex ].columnName, columnName ) )
+	{
+		return NULL;
+	}
+	return &table.statistics->columns[ columnIndex ];
+}
+
+/**
+ * @brief equalRows
+ *
+ * @details estimates the rows of a table that hold one value of a column
+ *
+ * @par Algorithm the values that are not null spread evenly over the
+ *      distinct values. Without statistics EQUAL_SELECTIVITY of the rows
+ *
+ * @param [in] TableEstimate &table
+ *
+ * @param [in] ColumnStatistics *column NULL without statistics
+ *
+ * @return double
+ *
+ * @note None
+ */
+double equalRows( const TableEstimate &table, const ColumnStatistics *column )
+{
+	if( column == NULL )
+	{
+		return table.rows * EQUAL_SELECTIVITY;
+	}
+	int64_t rowCount = table.statistics->rowCount;
+	double values = max( rowCount - column->nullCount, (int64_t)0 );
+	return values / max( statisticsDistinct( *column, rowCount ), 1.0 );
+}
+
+/**
+ * @brief histogramBelow
+ *
+ * @details estimates the values of a column below a comparison value
+ *
+ * @par Algorithm the buckets below the one of the value count in full. A
+ *      value inside a bucket takes the part of it below the value, measured
+ *      over the range of the bucket for float columns and half of it
+ *      otherwise
+ *
+ * @param [in] ColumnStatistics &column
+ *
+ * @param [in] WhereCondition &wCond
+ *
+ * @param [in] bool inclusive true to count the copies of the value too
+ *
+ * @param [in] double valueRows values of the column equal to the value
+ *
+ * @return double
+ *
+ * @note None
+ */
+double histogramBelow( const ColumnStatistics &column, const WhereCondition &wCond, bool inclusive,
+						double valueRows )
+{
+	unsigned int bucket = findHistogramBucket( column, wCond.comparisonValue );
+	double rows = 0;
+	for( unsigned int index = 0; index < bucket && index < column.histogram.size(); index++ )
+	{
+		rows += column.histogram[ index ].rowCount;
+	}
+	if( bucket == column.histogram.size() )
+	{
+		return rows;
+	}
+
+	const HistogramBucket &entry = column.histogram[ bucket ];
+	if( compareCells( entry.upperBound, wCond.comparisonValue, column.valueType ) == 0 )
+	{
+		return rows + max( entry.rowCount - ( inclusive ? 0 : valueRows ), 0.0 );
+	}
+
+	double fraction = 0.5;
+	if( column.valueType == SORT_FLOAT )
+	{
+		const string &lowBound = bucket == 0 ? column.minValue : column.histogram[ bucket - 1 ].upperBound;
+		double low = atof( lowBound.c_str() );
+		double high = atof( entry.upperBound.c_str() );
+		if( high > low )
+		{
+			fraction = min( max( ( wCond.comparisonValueFloat - low ) / ( high - low ), 0.0 ), 1.0 );
+		}
+	}
+	return rows + entry.rowCount * fraction;
+}
+
+/**
+ * @brief guessSelectivity
+ *
+ * @details the share of rows a comparison keeps without statistics
+ *
+ * @param [in] string &op
+ *
+ * @return double EQUAL_SELECTIVITY for =, the rest of the rows for != and
+ *         RANGE_SELECTIVITY for a range
+ *
+ * @note None
+ */
+double guessSelectivity( const string &op )
+{
+	if( op == "=" )
+	{
+		return EQUAL_SELECTIVITY;
+	}
+	return op == "!=" ? 1 - EQUAL_SELECTIVITY : RANGE_SELECTIVITY;
+}
+
+/**
+ * @brief estimateSelectivity
+ *
+ * @details estimates the share of the rows of a table a comparison keeps
+ *
+ * @par Algorithm = keeps the rows of one distinct value, none when the value
+ *      is outside the range of the column, and != the others. A range reads
+ *      the histogram. Statistics are ordered like the comparison when int
+ *      and float columns are compared as numbers and other columns as text,
+ *      otherwise ranges fall back to RANGE_SELECTIVITY as every comparison
+ *      does without statistics
+ *
+ * @param [in] TableEstimate &table
+ *
+ * @param [in] WhereCondition &wCond
+ *
+ * @return double between 0 and 1
+ *
+ * @note None
+ */
+double estimateSelectivity( const TableEstimate &table, const WhereCondition &wCond )
+{
+	const string &op = wCond.operatorValue;
+	const ColumnStatistics *column = columnStatistics( table, wCond.attributeIndex, wCond.attributeName );
+	if( column == NULL || table.statistics->rowCount <= 0 )
+	{
+		return guessSelectivity( op );
+	}
+
+	double rowCount = table.statistics->rowCount;
+	double values = max( rowCount - column->nullCount, 0.0 );
+	double valueRows = equalRows( table, column );
+	bool ordered = column->valueType == SORT_FLOAT ? wCond.floatValue :
+					column->valueType == SORT_INTEGER ? wCond.intValue :
+					column->valueType == SORT_TEXT && !wCond.floatValue && !wCond.intValue;
+	double matched = 0;
+	if( op == "=" || op == "!=" )
+	{
+		if( ordered && column->hasRange &&
+			( compareCells( wCond.comparisonValue, column->minValue, column->valueType ) < 0 ||
+				compareCells( wCond.comparisonValue, column->maxValue, column->valueType ) > 0 ) )
+		{
+			valueRows = 0;
+		}
+		matched = op == "=" ? valueRows : values - valueRows;
+	}
+	else if( !ordered || column->histogram.empty() )
+	{
+		return RANGE_SELECTIVITY;
+	}
+	else if( op == "<" || op == "<=" )
+	{
+		matched = histogramBelow( *column, wCond, op == "<=", valueRows );
+	}
+	else
+	{
+		matched = values - histogramBelow( *column, wCond, op == ">", valueRows );
+	}
+	return min( max( matched / rowCount, 0.0 ), 1.0 );
+}
+
+/**
+ * @brief readCost
+ *
+ * @details returns the cost of reading a whole table in file order
+ *
+ * @param [in] TableEstimate &table
+ *
+ * @return double
+ *
+ * @note None
+ */
+double readCost( const TableEstimate &table )
+{
+	return table.pages * SEQUENTIAL_PAGE_COST + table.rows * ROW_COST;
+}
+
+/**
+ * @brief spillPasses
+ *
+ * @details returns the passes an operator makes over its spilled input
+ *
+ * @par Algorithm every pass divides the input by the fanout, until it fits
+ *      in memory or maxPasses were made
+ *
+ * @param [in] double bytes of the input
+ *
+ * @param [in] double memory the operator may hold
+ *
+ * @param [in] double fanout partitions or runs handled per pass
+ *
+ * @param [in] int maxPasses
+ *
+ * @return int 0 if the input fits in memory
+ *
+ * @note None
+ */
+int spillPasses( double bytes, double memory, double fanout, int maxPasses )
+{
+	int passes = 0;
+	while( bytes > memory && passes < maxPasses )
+	{
+		bytes /= fanout;
+		passes++;
+	}
+	return passes;
+}
+
+/**
+ * @brief sortCost
+ *
+ * @details returns the cost of sorting a table that was read already
+ *
+ * @par Algorithm every row is copied in and out of the sort and compared
+ *      log2 of the row count times. A table above sortMemoryBytes is written
+ *      to runs and read back, once more for every time there are more runs
+ *      than are merged at once
+ *
+ * @param [in] TableEstimate &table
+ *
+ * @return double
+ *
+ * @note None
+ */
+double sortCost( const TableEstimate &table )
+{
+	double cost = table.rows * ( 2 * ROW_COST + log2( max( table.rows, 2.0 ) ) * COMPARE_COST );
+	if( table.bytes > sortMemoryBytes )
+	{
+		int passes = 1 + spillPasses( table.bytes / sortMemoryBytes, SORT_MERGE_FANIN, SORT_MERGE_FANIN, INT_MAX );
+		cost += 2 * passes * table.pages * SEQUENTIAL_PAGE_COST;
+	}
+	return cost;
+}
+
+/**
+ * @brief planAccessPath
+ *
+ * @details chooses how a select reads its table
+ *
+ * @pre plan.candidates holds the comparisons an index can look up
+ *
+ * @post plan.chosen is the cheapest candidate, -1 when reading the whole
+ *       table is cheaper. plan.scanRows are the rows the where condition
+ *       keeps
+ *
+ * @par Algorithm a full scan reads every page in order. An index lookup
+ *      reads the pages of the rows it finds out of order, but never more
+ *      pages than the table has, and every row it finds. The guess the
+ *      predicate made for each comparison every matching row satisfies is
+ *      replaced by the estimate of the statistics
+ *
+ * @param [in] string &tablePath
+ *
+ * @param [in/out] AccessPlan &plan
+ *
+ * @return None
+ *
+ * @note None
+ */
+void planAccessPath( const string &tablePath, AccessPlan &plan )
+{
+	TableEstimate table;
+	estimateTable( tablePath, table );
+	plan.tableRows = table.rows;
+	plan.scanCost = readCost( table );
+
+	double selectivity = plan.whereSelectivity;
+	for( unsigned int index = 0; index < plan.conjuncts.size(); index++ )
+	{
+		const WhereCondition &wCond = plan.conjuncts[ index ];
+		selectivity *= estimateSelectivity( table, wCond ) / guessSelectivity( wCond.operatorValue );
+	}
+	plan.scanRows = table.rows * min( max( selectivity, 0.0 ), 1.0 );
+	plan.candidateRows.clear();
+	plan.candidateCosts.clear();
+	plan.chosen = -1;
+
+	double cheapest = plan.scanCost;
+	for( unsigned int index = 0; index < plan.candidates.size(); index++ )
+	{
+		double rows = table.rows * estimateSelectivity( table, plan.candidates[ index ] );
+		double cost = INDEX_LOOKUP_COST + min( rows, table.pages ) * RANDOM_PAGE_COST + rows * ROW_COST;
+		plan.candidateRows.push_back( rows );
+		plan.candidateCosts.push_back( cost );
+		if( cost < cheapest )
+		{
+			cheapest = cost;
+			plan.chosen = index;
+		}
+	}
+}
+
+/**
+ * @brief planJoin
+ *
+ * @details costs every way to run an equi join of two open tables
+ *
+ * @post plan.candidates holds the methods that can run, cheapest first
+ *
+ * @par Algorithm table1 stays the outer input so rows keep its order. A
+ *      nested loop holds table2 in memory and compares it with every row of
+ *      table1. An index nested loop looks every row of table1 up in an index
+ *      on the join column of table2, which the open transaction must not
+ *      have changed. A hash join stores the rows of its build input and
+ *      probes them with the other. Once the build input passes
+ *      joinMemoryBytes both tables are partitioned to disk, again for every
+ *      partition still too large. A merge join sorts both tables on the join
+ *      column and matches them in one pass. The rows out are the product of
+ *      the tables over the distinct values of the join column with the most
+ *      of them
+ *
+ * @param [in] TableScan &scan1
+ *
+ * @param [in] string &table1Path
+ *
+ * @param [in] int key1 join column of table1
+ *
+ * @param [in] TableScan &scan2
+ *
+ * @param [in] string &table2Path
+ *
+ * @param [in] int key2 join column of table2
+ *
+ * @param [in] bool outer true for a left outer join
+ *
+ * @param [out] JoinPlan &plan
+ *
+ * @return None
+ *
+ * @note None
+ */
+void planJoin( TableScan &scan1, const string &table1Path, int key1, TableScan &scan2,
+				const string &table2Path, int key2, bool outer, JoinPlan &plan )
+{
+	TableEstimate table1;
+	TableEstimate table2;
+	estimateTable( table1Path, table1 );
+	estimateTable( table2Path, table2 );
+	const ColumnStatistics *column1 = key1 < 0 ? NULL :
+		columnStatistics( table1, key1, scan1.attributes[ key1 ].attributeName );
+	const ColumnStatistics *column2 = key2 < 0 ? NULL :
+		columnStatistics( table2, key2, scan2.attributes[ key2 ].attributeName );
+
+	double distinct = 0;
+	if( column1 != NULL )
+	{
+		distinct = statisticsDistinct( *column1, table1.statistics->rowCount );
+	}
+	if( column2 != NULL )
+	{
+		distinct = max( distinct, statisticsDistinct( *column2, table2.statistics->rowCount ) );
+	}
+	plan.outputRows = distinct >= 1 ? table1.rows * table2.rows / distinct : max( table1.rows, table2.rows );
+	if( outer )
+	{
+		plan.outputRows = max( plan.outputRows, table1.rows );
+	}
+
+	plan.candidates.clear();
+	JoinCandidate candidate;
+	double readBoth = readCost( table1 ) + readCost( table2 );
+	double spillBoth = 2 * ( table1.pages + table2.pages ) * SEQUENTIAL_PAGE_COST;
+
+	//hash join, building on table2 first so it wins a tie
+	candidate.method = JOIN_HASH;
+	candidate.buildLeft = false;
+	candidate.cost = readBoth + table2.rows * HASH_ROW_COST + table1.rows * ROW_COST +
+		spillPasses( table2.bytes, joinMemoryBytes, JOIN_PARTITIONS, JOIN_MAX_DEPTH ) * spillBoth;
+	plan.candidates.push_back( candidate );
+	candidate.buildLeft = true;
+	candidate.cost = readBoth + table1.rows * HASH_ROW_COST + table2.rows * ROW_COST +
+		spillPasses( table1.bytes, joinMemoryBytes, JOIN_PARTITIONS, JOIN_MAX_DEPTH ) * spillBoth;
+	plan.candidates.push_back( candidate );
+
+	candidate.buildLeft = false;
+	if( table2.bytes <= joinMemoryBytes )
+	{
+		candidate.method = JOIN_NESTED_LOOP;
+		candidate.cost = readBoth + table1.rows * table2.rows * COMPARE_COST;
+		plan.candidates.push_back( candidate );
+	}
+
+	BTreeIndex *index = NULL;
+	if( key2 >= 0 && writeAheadLog.walGetDelta( table2Path ) == NULL )
+	{
+		index = scan2.scanIndexOn( key2 );
+	}
+	plan.indexName = index == NULL ? "" : index->indexName;
+	if( index != NULL )
+	{
+		double fetched = table1.rows * equalRows( table2, column2 );
+		candidate.method = JOIN_INDEX_NESTED_LOOP;
+		candidate.cost = readCost( table1 ) + table1.rows * INDEX_LOOKUP_COST +
+							min( fetched, table2.pages ) * RANDOM_PAGE_COST + fetched * ROW_COST;
+		plan.candidates.push_back( candidate );
+	}
+
+	candidate.method = JOIN_MERGE;
+	candidate.cost = readBoth + sortCost( table1 ) + sortCost( table2 ) +
+						( table1.rows + table2.rows ) * COMPARE_COST;
+	plan.candidates.push_back( candidate );
+
+	stable_sort( plan.candidates.begin(), plan.candidates.end(),
+		[]( const JoinCandidate &first, const JoinCandidate &second )
+		{
+			return first.cost < second.cost;
+		} );
+}
+
+/**
+ * @brief formatEstimate
+ *
+ * @details formats an estimate with a fixed number of decimals
+ *
+ * @param [in] double value
+ *
+ * @param [in] int decimals
+ *
+ * @return string
+ *
+ * @note None
+ */
+string formatEstimate( double value, int decimals )
+{
+	char buffer[ 64 ];
+	snprintf( buffer, sizeof( buffer ), "%.*f", decimals, value );
+	return buffer;
+}
+
+/**
+ * @brief describeAccess
+ *
+ * @details describes one access path of a select
+ *
+ * @param [in] string &tableName
+ *
+ * @param [in] AccessPlan &plan
+ *
+ * @param [in] int candidate index of the candidate, -1 for the full scan
+ *
+ * @return string
+ *
+ * @note None
+ */
+string describeAccess( const string &tableName, const AccessPlan &plan, int candidate )
+{
+	if( candidate < 0 )
+	{
+		return "full scan of " + tableName;
+	}
+	const WhereCondition &wCond = plan.candidates[ candidate ];
+	return "index scan of " + tableName + " on " + wCond.attributeName + " " + wCond.operatorValue +
+			" " + wCond.comparisonValue + " with index " + plan.candidateIndexes[ candidate ];
+}
+
+/**
+ * @brief outputAccessPlan
+ *
+ * @details prints the access path of a select and the ones it was chosen over
+ *
+ * @param [in] string &tableName
+ *
+ * @param [in] AccessPlan &plan planned by planAccessPath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void outputAccessPlan( const string &tableName, const AccessPlan &plan )
+{
+	//an index scan reads the rows it finds, a full scan all of them and
+	//keeps the ones the where condition matches
+	string rows = formatEstimate( plan.tableRows, 0 );
+	double cost = plan.scanCost;
+	if( plan.chosen >= 0 )
+	{
+		rows = formatEstimate( plan.candidateRows[ plan.chosen ], 0 ) + " of " + rows;
+		cost = plan.candidateCosts[ plan.chosen ];
+	}
+	else if( plan.scanRows < plan.tableRows )
+	{
+		rows = formatEstimate( plan.scanRows, 0 ) + " of " + rows;
+	}
+	cout << "-- Plan: " << describeAccess( tableName, plan, plan.chosen ) << ", about " << rows
+		<< " rows, cost " << formatEstimate( cost, 1 ) << "." << endl;
+
+	for( int index = -1; index < (int)plan.candidates.size(); index++ )
+	{
+		if( index != plan.chosen )
+		{
+			cost = index < 0 ? plan.scanCost : plan.candidateCosts[ index ];
+			cout << "-- Considered: " << describeAccess( tableName, plan, index ) << ", cost "
+				<< formatEstimate( cost, 1 ) << "." << endl;
+		}
+	}
+}
+
+/**
+ * @brief describeJoin
+ *
+ * @details describes one way to run a join
+ *
+ * @param [in] JoinCandidate &candidate
+ *
+ * @param [in] string &table1Name
+ *
+ * @param [in] string &table2Name
+ *
+ * @param [in] string &indexName index on the join column of table2
+ *
+ * @return string
+ *
+ * @note None
+ */
+string describeJoin( const JoinCandidate &candidate, const string &table1Name, const string &table2Name,
+						const string &indexName )
+{
+	if( candidate.method == JOIN_NESTED_LOOP )
+	{
+		return "nested loop join with " + table1Name + " outer";
+	}
+	if( candidate.method == JOIN_INDEX_NESTED_LOOP )
+	{
+		return "index nested loop join with " + table1Name + " outer and index " + indexName +
+				" of " + table2Name;
+	}
+	if( candidate.method == JOIN_HASH )
+	{
+		return candidate.buildLeft ? "hash join building on left table " + table1Name :
+										"hash join building on right table " + table2Name;
+	}
+	return "merge join sorting " + table1Name + " and " + table2Name;
+}
+
+/**
+ * @brief outputJoinPlan
+ *
+ * @details prints the method of a join and the ones it was chosen over
+ *
+ * @param [in] string &table1Name
+ *
+ * @param [in] string &table2Name
+ *
+ * @param [in] JoinPlan &plan planned by planJoin
+ *
+ * @return None
+ *
+ * @note None
+ */
+void outputJoinPlan( const string &table1Name, const string &table2Name, const JoinPlan &plan )
+{
+	for( unsigned int index = 0; index < plan.candidates.size(); index++ )
+	{
+		const JoinCandidate &candidate = plan.candidates[ index ];
+		cout << ( index == 0 ? "-- Plan: " : "-- Considered: " )
+			<< describeJoin( candidate, table1Name, table2Name, plan.indexName );
+		if( index == 0 )
+		{
+			cout << ", about " << formatEstimate( plan.outputRows, 0 ) << " rows";
+		}
+		cout << ", cost " << formatEstimate( candidate.cost, 1 ) << "." << endl;
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
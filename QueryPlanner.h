@@ -0,0 +1,101 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file QueryPlanner.h
+ *
+ * @brief Definition file for the query planner
+ *
+ * @details Specifies the cost model, the estimates it is fed from table
+ *          statistics and the plans it chooses between, the access path of
+ *          a select and the method and order of a join
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include "Table.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef QUERYPLANNER_H
+#define QUERYPLANNER_H
+
+//costs in units of one page read in file order. A page read out of order
+//costs more, and work done per row, per hashed row, per comparison and per
+//index lookup is a share of a page read
+const double SEQUENTIAL_PAGE_COST = 1.0;
+const double RANDOM_PAGE_COST = 4.0;
+const double ROW_COST = 0.01;
+const double HASH_ROW_COST = 0.02;
+const double COMPARE_COST = 0.0025;
+const double INDEX_LOOKUP_COST = 0.3;
+
+//bytes of a row when a table has no row count to divide its size by
+const double DEFAULT_ROW_BYTES = 64;
+
+struct TableStatistics;
+class TableScan;
+
+//estimated size of a table, from its statistics when it has them
+struct TableEstimate{
+	string tablePath;
+	double rows;
+	double bytes;
+	double pages;
+	TableStatistics *statistics;
+};
+
+//access paths of a select, a full scan or an index on one of the
+//comparisons every matching row satisfies. The where condition keeps
+//whereSelectivity of the rows by the guesses of its compiled predicate,
+//conjuncts are the comparisons of it every matching row satisfies
+struct AccessPlan{
+	double whereSelectivity;
+	vector< WhereCondition > conjuncts;
+	double tableRows;
+	double scanRows;
+	double scanCost;
+	vector< WhereCondition > candidates;
+	vector< string > candidateIndexes;
+	vector< double > candidateRows;
+	vector< double > candidateCosts;
+
+	//the candidate chosen, -1 for a full scan
+	int chosen;
+};
+
+enum JoinMethod{
+	JOIN_NESTED_LOOP,
+	JOIN_INDEX_NESTED_LOOP,
+	JOIN_HASH,
+	JOIN_MERGE
+};
+
+//one way to run a join. Table1 is always the outer input of a nested loop,
+//so rows come out in its order, buildLeft picks the table a hash join keeps
+//in memory
+struct JoinCandidate{
+	JoinMethod method;
+	bool buildLeft;
+	double cost;
+};
+
+//the join methods considered, cheapest first, and the estimated rows out
+struct JoinPlan{
+	vector< JoinCandidate > candidates;
+	double outputRows;
+	string indexName;
+};
+
+void estimateTable( const string &tablePath, TableEstimate &table );
+double estimateSelectivity( const TableEstimate &table, const WhereCondition &wCond );
+void planAccessPath( const string &tablePath, AccessPlan &plan );
+void planJoin( TableScan &scan1, const string &table1Path, int key1, TableScan &scan2,
+				const string &table2Path, int key2, bool outer, JoinPlan &plan );
+void outputAccessPlan( const string &tableName, const AccessPlan &plan );
+void outputJoinPlan( const string &table1Name, const string &table2Name, const JoinPlan &plan );
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,626 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file SchemaCatalog.cpp
+ *
+ * @brief Implementation file for SchemaCatalog class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the schema catalog. Every database directory holds a
+ *          catalog file of records with the parsed attributes, the storage
+ *          format and the row count of its tables. The file is read once per
+ *          process, and opening a table then only checks that the attribute
+ *          line of the file is still the one the catalog holds instead of
+ *          parsing it. Changes are appended as new records, the catalog is
+ *          compacted when it is read and mostly holds old records
+ *
+ * @Note Requires SchemaCatalog.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "SchemaCatalog.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SCHEMACATALOG_CPP
+#define SCHEMACATALOG_CPP
+
+//helper function implemented in TableScan.cpp
+void parseAttributes( string attrLine, vector< Attribute > &attributes );
+
+//helper function implemented in BTreeIndex.cpp
+bool tableSignatureOf( string tablePath, TableSignature &signature );
+
+//helper functions implemented in WriteAheadLog.cpp
+void appendUint32( string &buffer, uint32_t value );
+void appendUint64( string &buffer, uint64_t value );
+void appendString( string &buffer, const string &value );
+bool takeUint32( const char *data, size_t length, size_t &position, uint32_t &value );
+bool takeUint64( const char *data, size_t length, size_t &position, uint64_t &value );
+bool takeString( const char *data, size_t length, size_t &position, string &value );
+uint32_t walChecksum( const char *data, size_t length );
+bool writeAll( int fileDesc, const string &buffer );
+
+SchemaCatalog schemaCatalog;
+
+/**
+ * @brief encodeCatalogRecord
+ *
+ * @details appends the record of one table to a catalog buffer
+ *
+ * @par Algorithm a record is its payload length, the checksum of the
+ *      payload and the payload, the same framing as the log, so a record cut
+ *      off by a crash is detected. A drop record holds only the name
+ *
+ * @param [in] char recordType
+ *
+ * @param [in] string &tableName
+ *
+ * @param [in] SchemaEntry &entry
+ *
+ * @param [out] string &buffer
+ *
+ * @return None
+ *
+ * @note None
+ */
+void encodeCatalogRecord( char recordType, const string &tableName, const SchemaEntry &entry, string &buffer )
+{
+	string payload;
+	payload += recordType;
+	appendString( payload, tableName );
+	if( recordType == CATALOG_TABLE )
+	{
+		payload += (char)entry.pageFormat;
+		appendUint64( payload, (uint64_t)entry.rowCount );
+		appendUint64( payload, entry.signature.inode );
+		appendUint64( payload, (uint64_t)entry.signature.size );
+		appendUint64( payload, (uint64_t)entry.signature.mtimeSec );
+		appendUint64( payload, (uint64_t)entry.signature.mtimeNsec );
+		appendString( payload, entry.attributeData );
+		appendUint32( payload, entry.attributes.size() );
+		for( unsigned int index = 0; index < entry.attributes.size(); index++ )
+		{
+			appendString( payload, entry.attributes[ index ].attributeName );
+			appendString( payload, entry.attributes[ index ].attributeType );
+		}
+	}
+
+	appendUint32( buffer, payload.size() );
+	appendUint32( buffer, walChecksum( payload.data(), payload.size() ) );
+	buffer.append( payload );
+}
+
+/**
+ * @brief decodeCatalogRecord
+ *
+ * @details reads one record of a catalog file
+ *
+ * @param [in] const char *data
+ *
+ * @param [in] size_t available bytes left in the file
+ *
+ * @param [out] char &recordType
+ *
+ * @param [out] string &tableName
+ *
+ * @param [out] SchemaEntry &entry
+ *
+ * @param [out] size_t &used bytes the record takes up
+ *
+ * @return bool false if the record is incomplete or damaged
+ *
+ * @note None
+ */
+bool decodeCatalogRecord( const char *data, size_t available, char &recordType, string &tableName,
+							SchemaEntry &entry, size_t &used )
+{
+	uint32_t length;
+	uint32_t checksum;
+	size_t position = 0;
+	if( !takeUint32( data, available, position, length ) ||
+		!takeUint32( data, available, position, checksum ) ||
+		available - position < length || length < 1 ||
+		walChecksum( data + position, length ) != checksum )
+	{
+		return false;
+	}
+
+	const char *payload = data + position;
+	size_t offset = 1;
+	recordType = payload[ 0 ];
+	used = position + length;
+	if( !takeString( payload, length, offset, tableName ) )
+	{
+		return false;
+	}
+	if( recordType != CATALOG_TABLE )
+	{
+		return recordType == CATALOG_DROP;
+	}
+
+	uint64_t rowCount;
+	uint64_t size;
+	uint64_t mtimeSec;
+	uint64_t mtimeNsec;
+	uint32_t columnCount;
+	if( offset >= length )
+	{
+		return false;
+	}
+	entry.pageFormat = payload[ offset++ ] != 0;
+	if( !takeUint64( payload, length, offset, rowCount ) ||
+		!takeUint64( payload, length, offset, entry.signature.inode ) ||
+		!takeUint64( payload, length, offset, size ) ||
+		!takeUint64( payload, length, offset, mtimeSec ) ||
+		!takeUint64( payload, length, offset, mtimeNsec ) ||
+		!takeString( payload, length, offset, entry.attributeData ) ||
+		!takeUint32( payload, length, offset, columnCount ) ||
+		columnCount > length )
+	{
+		return false;
+	}
+	entry.rowCount = (int64_t)rowCount;
+	entry.signature.size = (int64_t)size;
+	entry.signature.mtimeSec = (int64_t)mtimeSec;
+	entry.signature.mtimeNsec = (int64_t)mtimeNsec;
+	entry.attributes.resize( columnCount );
+	for( unsigned int index = 0; index < columnCount; index++ )
+	{
+		if( !takeString( payload, length, offset, entry.attributes[ index ].attributeName ) ||
+			!takeString( payload, length, offset, entry.attributes[ index ].attributeType ) )
+		{
+			return false;
+		}
+	}
+	entry.countChanged = false;
+	return true;
+}
+
+/**
+ * @brief SchemaCatalog default constructor
+ *
+ * @details creates a catalog that has not read any database directory
+ *
+ * @note None
+ */
+SchemaCatalog::SchemaCatalog()
+{
+	scratchEntry.pageFormat = false;
+	scratchEntry.rowCount = -1;
+	scratchEntry.countChanged = false;
+}
+
+/**
+ * @brief SchemaCatalog default destructor
+ *
+ * @details writes the row counts that changed to the catalog files
+ *
+ * @note None
+ */
+SchemaCatalog::~SchemaCatalog()
+{
+	catalogFlush();
+}
+
+/**
+ * @brief catalogSchema
+ *
+ * @details returns the schema of a table given the attribute line its file
+ *          starts with
+ *
+ * @par Algorithm when the catalog holds the same attribute line for the
+ *      table its attributes are returned as they are. Otherwise the line is
+ *      parsed and the new schema is appended to the catalog file, along with
+ *      the row counts of the database that changed. Scratch files are parsed
+ *      every time
+ *
+ * @param [in] string &filePath
+ *
+ * @param [in] const char *header the attribute line, without its newline
+ *
+ * @param [in] size_t length
+ *
+ * @param [in] bool pageFormat
+ *
+ * @return SchemaEntry& valid until the next call
+ *
+ * @note None
+ */
+const SchemaEntry &SchemaCatalog::catalogSchema( const string &filePath, const char *header, size_t length,
+													bool pageFormat )
+{
+	string directoryPath;
+	string tableName;
+	SchemaDirectory *directory = findDirectory( filePath, directoryPath, tableName );
+	if( directory == NULL )
+	{
+		scratchEntry.attributeData.assign( header, length );
+		scratchEntry.pageFormat = pageFormat;
+		parseAttributes( scratchEntry.attributeData, scratchEntry.attributes );
+		return scratchEntry;
+	}
+
+	map< string, SchemaEntry >::iterator found = directory->tables.find( tableName );
+	if( found != directory->tables.end() && found->second.pageFormat == pageFormat &&
+		found->second.attributeData.size() == length &&
+		memcmp( found->second.attributeData.data(), header, length ) == 0 )
+	{
+		return found->second;
+	}
+
+	SchemaEntry &entry = directory->tables[ tableName ];
+	entry.attributeData.assign( header, length );
+	entry.pageFormat = pageFormat;
+	parseAttributes( entry.attributeData, entry.attributes );
+	entry.rowCount = -1;
+	memset( &entry.signature, 0, sizeof( entry.signature ) );
+	entry.countChanged = true;
+	directory->countChanged = true;
+	catalogFlush();
+	return entry;
+}
+
+/**
+ * @brief catalogRowCount
+ *
+ * @details returns the number of rows of a table file
+ *
+ * @param [in] string &filePath
+ *
+ * @return int64_t -1 when the rows were not counted since the file last
+ *         changed
+ *
+ * @note None
+ */
+int64_t SchemaCatalog::catalogRowCount( const string &filePath )
+{
+	string directoryPath;
+	string tableName;
+	TableSignature signature;
+	SchemaDirectory *directory = findDirectory( filePath, directoryPath, tableName );
+	if( directory == NULL || !tableSignatureOf( filePath, signature ) )
+	{
+		return -1;
+	}
+	map< string, SchemaEntry >::iterator found = directory->tables.find( tableName );
+	if( found == directory->tables.end() ||
+		memcmp( &found->second.signature, &signature, sizeof( signature ) ) != 0 )
+	{
+		return -1;
+	}
+	return found->second.rowCount;
+}
+
+/**
+ * @brief catalogSetRowCount
+ *
+ * @details records the number of rows of a table file
+ *
+ * @pre the schema of the table was looked up with catalogSchema
+ *
+ * @post the count is written to the catalog file by catalogFlush
+ *
+ * @param [in] string &filePath
+ *
+ * @param [in] int64_t rowCount
+ *
+ * @param [in] TableSignature &signature of the file the rows were counted in
+ *
+ * @return None
+ *
+ * @note None
+ */
+void SchemaCatalog::catalogSetRowCount( const string &filePath, int64_t rowCount, const TableSignature &signature )
+{
+	string directoryPath;
+	string tableName;
+	SchemaDirectory *directory = findDirectory( filePath, directoryPath, tableName );
+	if( directory == NULL )
+	{
+		return;
+	}
+	map< string, SchemaEntry >::iterator found = directory->tables.find( tableName );
+	if( found == directory->tables.end() )
+	{
+		return;
+	}
+	SchemaEntry &entry = found->second;
+	if( entry.rowCount != rowCount || memcmp( &entry.signature, &signature, sizeof( signature ) ) != 0 )
+	{
+		entry.rowCount = rowCount;
+		entry.signature = signature;
+		entry.countChanged = true;
+		directory->countChanged = true;
+	}
+}
+
+/**
+ * @brief catalogDrop
+ *
+ * @details removes a dropped table from the catalog
+ *
+ * @param [in] string &filePath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void SchemaCatalog::catalogDrop( const string &filePath )
+{
+	string directoryPath;
+	string tableName;
+	SchemaDirectory *directory = findDirectory( filePath, directoryPath, tableName );
+	if( directory == NULL || directory->tables.erase( tableName ) == 0 )
+	{
+		return;
+	}
+
+	string records;
+	encodeCatalogRecord( CATALOG_DROP, tableName, scratchEntry, records );
+	appendRecords( directoryPath, records );
+}
+
+/**
+ * @brief catalogFlush
+ *
+ * @details appends the tables whose schema or row count changed to the
+ *          catalog files
+ *
+ * @par Algorithm a row count changes with most statements, so counts are
+ *      written along with the next schema and when the process ends rather
+ *      than every time. A count lost in a crash is only counted again
+ *
+ * @return None
+ *
+ * @note None
+ */
+void SchemaCatalog::catalogFlush()
+{
+	for( map< string, SchemaDirectory >::iterator directory = directories.begin();
+			directory != directories.end(); directory++ )
+	{
+		if( !directory->second.countChanged )
+		{
+			continue;
+		}
+		string records;
+		map< string, SchemaEntry > &tables = directory->second.tables;
+		for( map< string, SchemaEntry >::iterator table = tables.begin(); table != tables.end(); table++ )
+		{
+			if( table->second.countChanged )
+			{
+				encodeCatalogRecord( CATALOG_TABLE, table->first, table->second, records );
+				table->second.countChanged = false;
+			}
+		}
+		directory->second.countChanged = false;
+		appendRecords( directory->first, records );
+	}
+}
+
+/**
+ * @brief findDirectory
+ *
+ * @details returns the catalog of the database directory a table file is in,
+ *          reading its catalog file the first time
+ *
+ * @param [in] string &filePath
+ *
+ * @param [out] string &directoryPath
+ *
+ * @param [out] string &tableName
+ *
+ * @return SchemaDirectory* NULL for scratch and hidden files
+ *
+ * @note None
+ */
+SchemaDirectory *SchemaCatalog::findDirectory( const string &filePath, string &directoryPath, string &tableName )
+{
+	size_t slash = filePath.rfind( '/' );
+	if( slash == string::npos || slash + 1 >= filePath.size() || filePath[ slash + 1 ] == '.' ||
+		filePath.find( "_temp", slash ) != string::npos )
+	{
+		return NULL;
+	}
+	directoryPath.assign( filePath, 0, slash );
+	tableName.assign( filePath, slash + 1, string::npos );
+
+	map< string, SchemaDirectory >::iterator found = directories.find( directoryPath );
+	if( found == directories.end() )
+	{
+		found = directories.insert( make_pair( directoryPath, SchemaDirectory() ) ).first;
+		loadDirectory( directoryPath, found->second );
+	}
+	return &found->second;
+}
+
+/**
+ * @brief loadDirectory
+ *
+ * @details reads the catalog file of a database directory
+ *
+ * @par Algorithm the records are applied in order, a later record of a
+ *      table replaces the earlier one. Reading stops at a damaged record.
+ *      A damaged catalog, or one that mostly holds replaced records, is
+ *      written again with one record per table that still exists
+ *
+ * @param [in] string &directoryPath
+ *
+ * @param [out] SchemaDirectory &directory
+ *
+ * @return None
+ *
+ * @note None
+ */
+void SchemaCatalog::loadDirectory( const string &directoryPath, SchemaDirectory &directory )
+{
+	string catalogPath = directoryPath + "/" + CATALOG_FILE;
+	struct stat buffer;
+	string data;
+
+	directory.tables.clear();
+	directory.countChanged = false;
+	int fileDesc = open( catalogPath.c_str(), O_RDONLY );
+	if( fileDesc < 0 )
+	{
+		return;
+	}
+	if( fstat( fileDesc, &buffer ) == 0 && buffer.st_size > 0 )
+	{
+		data.resize( buffer.st_size );
+		if( pread( fileDesc, &data[ 0 ], data.size(), 0 ) != (ssize_t)data.size() )
+		{
+			data.clear();
+		}
+	}
+	close( fileDesc );
+
+	uint32_t version = 0;
+	if( data.size() >= (size_t)CATALOG_HEADER_SIZE )
+	{
+		memcpy( &version, data.data() + 4, sizeof( version ) );
+	}
+	if( data.size() < (size_t)CATALOG_HEADER_SIZE || memcmp( data.data(), CATALOG_MAGIC, 4 ) != 0 ||
+		version != CATALOG_VERSION )
+	{
+		compactDirectory( directoryPath, directory );
+		return;
+	}
+
+	size_t position = CATALOG_HEADER_SIZE;
+	unsigned int records = 0;
+	char recordType;
+	string tableName;
+	SchemaEntry entry;
+	size_t used;
+	while( position < data.size() &&
+			decodeCatalogRecord( data.data() + position, data.size() - position, recordType,
+									tableName, entry, used ) )
+	{
+		if( recordType == CATALOG_TABLE )
+		{
+			directory.tables[ tableName ] = entry;
+		}
+		else
+		{
+			directory.tables.erase( tableName );
+		}
+		position += used;
+		records++;
+	}
+
+	if( position < data.size() || records > 2 * directory.tables.size() + CATALOG_COMPACT_SLACK )
+	{
+		compactDirectory( directoryPath, directory );
+	}
+}
+
+/**
+ * @brief compactDirectory
+ *
+ * @details writes the catalog file of a database directory again with one
+ *          record per table
+ *
+ * @par Algorithm tables whose file is gone are left out. The new catalog is
+ *      written to a scratch file that then replaces the catalog, so the
+ *      catalog is never seen half written
+ *
+ * @param [in] string &directoryPath
+ *
+ * @param [in/out] SchemaDirectory &directory
+ *
+ * @return bool false if the catalog could not be written
+ *
+ * @note None
+ */
+bool SchemaCatalog::compactDirectory( const string &directoryPath, SchemaDirectory &directory )
+{
+	string compactPath = directoryPath + "/" + CATALOG_COMPACT_FILE;
+	string buffer( CATALOG_MAGIC, 4 );
+	struct stat fileStat;
+
+	if( stat( directoryPath.c_str(), &fileStat ) != 0 )
+	{
+		return false;
+	}
+	appendUint32( buffer, CATALOG_VERSION );
+	map< string, SchemaEntry >::iterator table = directory.tables.begin();
+	while( table != directory.tables.end() )
+	{
+		if( stat( ( directoryPath + "/" + table->first ).c_str(), &fileStat ) != 0 )
+		{
+			directory.tables.erase( table++ );
+			continue;
+		}
+		encodeCatalogRecord( CATALOG_TABLE, table->first, table->second, buffer );
+		table->second.countChanged = false;
+		table++;
+	}
+
+	int fileDesc = open( compactPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	bool success = writeAll( fileDesc, buffer );
+	close( fileDesc );
+	if( !success || rename( compactPath.c_str(), ( directoryPath + "/" + CATALOG_FILE ).c_str() ) != 0 )
+	{
+		unlink( compactPath.c_str() );
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief appendRecords
+ *
+ * @details appends records to the catalog file of a database directory
+ *
+ * @par Algorithm the file is opened for every append so records always go
+ *      to the catalog another process may have just compacted, and each
+ *      batch is one write so the records of processes do not interleave
+ *
+ * @param [in] string &directoryPath
+ *
+ * @param [in] string &records
+ *
+ * @return bool false if the records could not be written
+ *
+ * @note None
+ */
+bool SchemaCatalog::appendRecords( const string &directoryPath, const string &records )
+{
+	string catalogPath = directoryPath + "/" + CATALOG_FILE;
+	struct stat fileStat;
+
+	if( records.empty() )
+	{
+		return true;
+	}
+	if( stat( catalogPath.c_str(), &fileStat ) != 0 )
+	{
+		SchemaDirectory &directory = directories[ directoryPath ];
+		return compactDirectory( directoryPath, directory );
+	}
+	int fileDesc = open( catalogPath.c_str(), O_WRONLY | O_APPEND );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	bool success = write( fileDesc, records.data(), records.size() ) == (ssize_t)records.size();
+	close( fileDesc );
+	return success;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,92 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file SchemaCatalog.h
+ *
+ * @brief Definition file for SchemaCatalog class
+ *
+ * @details Specifies all member methods of the SchemaCatalog class, the
+ *          process wide catalog of table schemas, storage formats and row
+ *          counts that is kept in a binary file in every database directory
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <stdint.h>
+#include <sys/types.h>
+#include "Table.h"
+#include "BTreeIndex.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SCHEMACATALOG_H
+#define SCHEMACATALOG_H
+
+//catalog file kept in every database directory and the file it is compacted
+//into before it replaces the catalog
+const string CATALOG_FILE = ".catalog";
+const string CATALOG_COMPACT_FILE = ".catalog_compact";
+const char CATALOG_MAGIC[] = "SCAT";
+const uint32_t CATALOG_VERSION = 1;
+const int CATALOG_HEADER_SIZE = 8;
+
+//record types, the schema and row count of a table or a table dropped
+const char CATALOG_TABLE = 'T';
+const char CATALOG_DROP = 'D';
+
+//the catalog is compacted when it holds this many records more than twice
+//the number of tables
+const unsigned int CATALOG_COMPACT_SLACK = 64;
+
+//schema of one table, the attribute line it was parsed from and the number
+//of rows, -1 when it is not known. A row count holds only while the table
+//file still has the signature it was counted with
+struct SchemaEntry{
+	string attributeData;
+	vector< Attribute > attributes;
+	bool pageFormat;
+	int64_t rowCount;
+	TableSignature signature;
+	bool countChanged;
+};
+
+//tables of one database directory and whether a row count changed since
+//the catalog file was last written
+struct SchemaDirectory{
+	map< string, SchemaEntry > tables;
+	bool countChanged;
+};
+
+class SchemaCatalog{
+	public:
+		SchemaCatalog();
+		~SchemaCatalog();
+
+		const SchemaEntry &catalogSchema( const string &filePath, const char *header, size_t length,
+											bool pageFormat );
+		int64_t catalogRowCount( const string &filePath );
+		void catalogSetRowCount( const string &filePath, int64_t rowCount, const TableSignature &signature );
+		void catalogDrop( const string &filePath );
+		void catalogFlush();
+
+	private:
+		map< string, SchemaDirectory > directories;
+
+		//schema of a scratch file, which the catalog does not keep
+		SchemaEntry scratchEntry;
+
+		SchemaDirectory *findDirectory( const string &filePath, string &directoryPath, string &tableName );
+		void loadDirectory( const string &directoryPath, SchemaDirectory &directory );
+		bool compactDirectory( const string &directoryPath, SchemaDirectory &directory );
+		bool appendRecords( const string &directoryPath, const string &records );
+};
+
+//the catalog of the process
+extern SchemaCatalog schemaCatalog;
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,900 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file SqlParser.cpp
+ *
+ * @brief Implementation file for SqlParser class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the statement parser. The statement is split into
+ *          tokens in a single pass, and a recursive descent parser walks
+ *          the tokens once to build the SqlStatement the simulation runs,
+ *          so parsing takes time linear in the statement. Keywords match
+ *          in any case and never inside quotes
+ *
+ * @Note Requires SqlParser.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cctype>
+#include "SqlParser.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SQLPARSER_CPP
+#define SQLPARSER_CPP
+
+//helper functions implemented in sim.cpp
+void convertToUC( string &input );
+
+//characters that are tokens of their own, <=, >=, != and <> are one token
+const char SQL_SYMBOLS[] = "(),;.=<>!*+-/";
+
+//words that end a table of a from clause instead of naming its alias
+const char *const TABLE_FOLLOWERS[] = { "where", "inner", "join", "left", "on", "group",
+										"order", "limit", NULL };
+
+//clauses that may follow each clause of a select, in the order they are written
+const char *const WHERE_FOLLOWERS[] = { "group by", "order by", "limit", NULL };
+const char *const GROUP_FOLLOWERS[] = { "order by", "limit", NULL };
+const char *const ORDER_FOLLOWERS[] = { "limit", NULL };
+const char *const SET_FOLLOWERS[] = { "where", NULL };
+const char *const NO_FOLLOWERS[] = { NULL };
+
+/**
+ * @brief isSqlSymbol
+ *
+ * @details checks whether a character is a token of its own
+ *
+ * @param [in] char character
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool isSqlSymbol( char character )
+{
+	return character != '\0' && strchr( SQL_SYMBOLS, character ) != NULL;
+}
+
+/**
+ * @brief SqlParser default constructor
+ *
+ * @details creates a parser with no statement
+ *
+ * @note None
+ */
+SqlParser::SqlParser()
+{
+	position = 0;
+}
+
+/**
+ * @brief SqlParser default destructor
+ *
+ * @details releases the tokens
+ *
+ * @note None
+ */
+SqlParser::~SqlParser()
+{
+	tokens.clear();
+}
+
+/**
+ * @brief parseStatement
+ *
+ * @details parses one statement, without its semicolon
+ *
+ * @par Algorithm tokenizes the statement, then picks the rule of the
+ *      statement from its first word. A dot command is a dot followed by
+ *      the command name, the rest of it is the argument of the command
+ *
+ * @param [in] string &input
+ *
+ * @param [out] SqlStatement &statement
+ *
+ * @return bool false if the statement is not valid
+ *
+ * @note None
+ */
+bool SqlParser::parseStatement( const string &input, SqlStatement &statement )
+{
+	text = input;
+	position = 0;
+	tokenize();
+	statement = SqlStatement();
+	statement.joinType = JOIN_NONE;
+	statement.explain = false;
+
+	const SqlToken &first = peekToken( 0 );
+	const SqlToken &second = peekToken( 1 );
+	if( first.type == TOKEN_SYMBOL && text[ first.start ] == '.' && second.type == TOKEN_WORD &&
+		second.start == first.end )
+	{
+		statement.type = STATEMENT_COMMAND;
+		statement.action = "." + tokenText( second );
+		convertToUC( statement.action );
+		position = 2;
+		statement.argument = sourceText( position, tokens.size() - 1 );
+		return true;
+	}
+	if( first.type != TOKEN_WORD )
+	{
+		return false;
+	}
+	statement.action = tokenText( first );
+	convertToUC( statement.action );
+	position++;
+
+	if( tokenIs( first, "select" ) )
+	{
+		statement.type = STATEMENT_SELECT;
+		return parseSelect( statement );
+	}
+	else if( tokenIs( first, "explain" ) )
+	{
+		statement.type = STATEMENT_SELECT;
+		statement.explain = true;
+		return acceptKeyword( "select" ) && parseSelect( statement );
+	}
+	else if( tokenIs( first, "insert" ) )
+	{
+		statement.type = STATEMENT_INSERT;
+		return parseInsert( statement );
+	}
+	else if( tokenIs( first, "update" ) )
+	{
+		statement.type = STATEMENT_UPDATE;
+		return parseUpdate( statement );
+	}
+	else if( tokenIs( first, "delete" ) )
+	{
+		statement.type = STATEMENT_DELETE;
+		return parseDelete( statement );
+	}
+	else if( tokenIs( first, "create" ) )
+	{
+		return parseCreate( statement );
+	}
+	else if( tokenIs( first, "drop" ) )
+	{
+		return parseDrop( statement );
+	}
+	else if( tokenIs( first, "alter" ) )
+	{
+		return parseAlter( statement );
+	}
+	else if( tokenIs( first, "use" ) )
+	{
+		statement.type = STATEMENT_USE;
+		return parseName( statement.name ) && atEnd();
+	}
+	else if( tokenIs( first, "begin" ) )
+	{
+		statement.type = STATEMENT_BEGIN;
+		return acceptKeyword( "transaction" ) && atEnd();
+	}
+	else if( tokenIs( first, "commit" ) )
+	{
+		statement.type = STATEMENT_COMMIT;
+		return atEnd();
+	}
+	else if( tokenIs( first, "analyze" ) )
+	{
+		statement.type = STATEMENT_ANALYZE;
+		return atEnd() || ( parseName( statement.name ) && atEnd() );
+	}
+	return false;
+}
+
+/**
+ * @brief tokenize
+ *
+ * @details splits the statement into tokens, ending with an end token
+ *
+ * @par Algorithm a quote starts a string that runs to the next quote, a
+ *      digit starts a number, a symbol character is a token of its own
+ *      and any other run of characters up to white space is a word
+ *
+ * @return None
+ *
+ * @note None
+ */
+void SqlParser::tokenize()
+{
+	unsigned int index = 0;
+	unsigned int size = text.size();
+	SqlToken token;
+
+	tokens.clear();
+	while( true )
+	{
+		while( index < size && isspace( (unsigned char)text[ index ] ) )
+		{
+			index++;
+		}
+		if( index >= size )
+		{
+			break;
+		}
+
+		char character = text[ index ];
+		token.start = index;
+		if( character == '\'' )
+		{
+			token.type = TOKEN_STRING;
+			index++;
+			while( index < size && text[ index ] != '\'' )
+			{
+				index++;
+			}
+			if( index < size )
+			{
+				index++;
+			}
+		}
+		else if( isdigit( (unsigned char)character ) )
+		{
+			token.type = TOKEN_NUMBER;
+			while( index < size && ( isalnum( (unsigned char)text[ index ] ) || text[ index ] == '.' ||
+				text[ index ] == '_' ) )
+			{
+				index++;
+			}
+		}
+		else if( isSqlSymbol( character ) )
+		{
+			token.type = TOKEN_SYMBOL;
+			index++;
+			if( index < size && ( ( text[ index ] == '=' && strchr( "<>!", character ) != NULL ) ||
+				( character == '<' && text[ index ] == '>' ) ) )
+			{
+				index++;
+			}
+		}
+		else
+		{
+			token.type = TOKEN_WORD;
+			while( index < size && !isspace( (unsigned char)text[ index ] ) && text[ index ] != '\'' &&
+				!isSqlSymbol( text[ index ] ) )
+			{
+				index++;
+			}
+		}
+		token.end = index;
+		tokens.push_back( token );
+	}
+
+	token.type = TOKEN_END;
+	token.start = size;
+	token.end = size;
+	tokens.push_back( token );
+}
+
+/**
+ * @brief peekToken
+ *
+ * @details returns a token after the next one without parsing it
+ *
+ * @param [in] unsigned int ahead 0 for the next token
+ *
+ * @return SqlToken, the end token past the last one
+ *
+ * @note None
+ */
+const SqlToken &SqlParser::peekToken( unsigned int ahead ) const
+{
+	if( position + ahead >= tokens.size() )
+	{
+		return tokens.back();
+	}
+	return tokens[ position + ahead ];
+}
+
+/**
+ * @brief tokenIs
+ *
+ * @details checks whether a token is a keyword, in any case
+ *
+ * @param [in] SqlToken &token
+ *
+ * @param [in] const char *keyword in lowercase
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::tokenIs( const SqlToken &token, const char *keyword ) const
+{
+	unsigned int length = strlen( keyword );
+	if( token.type != TOKEN_WORD || token.end - token.start != length )
+	{
+		return false;
+	}
+	for( unsigned int index = 0; index < length; index++ )
+	{
+		if( tolower( (unsigned char)text[ token.start + index ] ) != keyword[ index ] )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief acceptKeyword
+ *
+ * @details parses the next token if it is the keyword, or the words of a
+ *          keyword made of several words such as "group by"
+ *
+ * @param [in] const char *keyword in lowercase
+ *
+ * @return bool false if the next tokens are not the keyword
+ *
+ * @note None
+ */
+bool SqlParser::acceptKeyword( const char *keyword )
+{
+	unsigned int ahead = 0;
+	const char *word = keyword;
+
+	while( *word != '\0' )
+	{
+		const char *wordEnd = strchr( word, ' ' );
+		string part = wordEnd == NULL ? string( word ) : string( word, wordEnd - word );
+		if( !tokenIs( peekToken( ahead ), part.c_str() ) )
+		{
+			return false;
+		}
+		ahead++;
+		word = wordEnd == NULL ? word + part.size() : wordEnd + 1;
+	}
+	position += ahead;
+	return true;
+}
+
+/**
+ * @brief acceptSymbol
+ *
+ * @details parses the next token if it is the symbol
+ *
+ * @param [in] const char *symbol
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::acceptSymbol( const char *symbol )
+{
+	const SqlToken &token = peekToken( 0 );
+	unsigned int length = strlen( symbol );
+	if( token.type != TOKEN_SYMBOL || token.end - token.start != length ||
+		text.compare( token.start, length, symbol ) != 0 )
+	{
+		return false;
+	}
+	position++;
+	return true;
+}
+
+/**
+ * @brief atEnd
+ *
+ * @details checks whether every token was parsed
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::atEnd() const
+{
+	return peekToken( 0 ).type == TOKEN_END;
+}
+
+/**
+ * @brief tokenText
+ *
+ * @details returns the characters of a token
+ *
+ * @param [in] SqlToken &token
+ *
+ * @return string
+ *
+ * @note None
+ */
+string SqlParser::tokenText( const SqlToken &token ) const
+{
+	return text.substr( token.start, token.end - token.start );
+}
+
+/**
+ * @brief sourceText
+ *
+ * @details returns the statement from the start of a token to the end of
+ *          the token before another, as it was written
+ *
+ * @param [in] unsigned int first index of the first token
+ *
+ * @param [in] unsigned int last index of the token after the text
+ *
+ * @return string, empty if there are no tokens between them
+ *
+ * @note None
+ */
+string SqlParser::sourceText( unsigned int first, unsigned int last ) const
+{
+	if( first >= last )
+	{
+		return "";
+	}
+	return text.substr( tokens[ first ].start, tokens[ last - 1 ].end - tokens[ first ].start );
+}
+
+/**
+ * @brief parseName
+ *
+ * @details parses the name of a database, table, column or index
+ *
+ * @param [out] string &name
+ *
+ * @return bool false if the next token is not a name
+ *
+ * @note None
+ */
+bool SqlParser::parseName( string &name )
+{
+	const SqlToken &token = peekToken( 0 );
+	if( token.type != TOKEN_WORD && token.type != TOKEN_NUMBER )
+	{
+		return false;
+	}
+	name = tokenText( token );
+	position++;
+	return true;
+}
+
+/**
+ * @brief findClauseEnd
+ *
+ * @details finds the token a clause ends at, the first keyword that may
+ *          follow the clause outside parentheses, or the end token
+ *
+ * @param [in] const char *const *keywords NULL terminated
+ *
+ * @return unsigned int index of the token
+ *
+ * @note None
+ */
+unsigned int SqlParser::findClauseEnd( const char *const *keywords ) const
+{
+	int depth = 0;
+	unsigned int index;
+
+	for( index = position; tokens[ index ].type != TOKEN_END; index++ )
+	{
+		const SqlToken &token = tokens[ index ];
+		if( token.type == TOKEN_SYMBOL && text[ token.start ] == '(' )
+		{
+			depth++;
+		}
+		else if( token.type == TOKEN_SYMBOL && text[ token.start ] == ')' )
+		{
+			depth--;
+		}
+		else if( depth <= 0 && token.type == TOKEN_WORD )
+		{
+			for( unsigned int keyword = 0; keywords[ keyword ] != NULL; keyword++ )
+			{
+				const char *by = strchr( keywords[ keyword ], ' ' );
+				string word = by == NULL ? string( keywords[ keyword ] ) :
+											string( keywords[ keyword ], by - keywords[ keyword ] );
+				if( tokenIs( token, word.c_str() ) && ( by == NULL || tokenIs( tokens[ index + 1 ], by + 1 ) ) )
+				{
+					return index;
+				}
+			}
+		}
+	}
+	return index;
+}
+
+/**
+ * @brief parseClause
+ *
+ * @details parses the text of a clause up to the keyword after it
+ *
+ * @param [in] const char *const *keywords that may follow the clause
+ *
+ * @return string, empty if the clause has no tokens
+ *
+ * @note None
+ */
+string SqlParser::parseClause( const char *const *keywords )
+{
+	unsigned int end = findClauseEnd( keywords );
+	string clause = sourceText( position, end );
+	position = end;
+	return clause;
+}
+
+/**
+ * @brief parseSelect
+ *
+ * @details parses select list from table [join] [clauses]
+ *
+ * @par Algorithm the select list runs to from. A second table is joined
+ *      after a comma, with its condition in the where clause, or after
+ *      inner join or left outer join with its condition after on. A join
+ *      condition compares two columns for equality. A join outputs every
+ *      column of both tables, so it takes only * as its select list and no
+ *      clause after its condition
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseSelect( SqlStatement &statement )
+{
+	const char *const fromKeyword[] = { "from", NULL };
+	TableReference table;
+
+	statement.selectList = parseClause( fromKeyword );
+	if( statement.selectList.empty() || !acceptKeyword( "from" ) || !parseTableReference( table ) )
+	{
+		return false;
+	}
+	statement.tables.push_back( table );
+
+	if( acceptSymbol( "," ) )
+	{
+		statement.joinType = JOIN_INNER;
+		if( statement.selectList != "*" || !parseTableReference( table ) || !acceptKeyword( "where" ) )
+		{
+			return false;
+		}
+		statement.tables.push_back( table );
+		return parseJoinCondition( statement ) && atEnd();
+	}
+	if( acceptKeyword( "inner join" ) || acceptKeyword( "join" ) )
+	{
+		statement.joinType = JOIN_INNER;
+	}
+	else if( acceptKeyword( "left outer join" ) || acceptKeyword( "left join" ) )
+	{
+		statement.joinType = JOIN_LEFT_OUTER;
+	}
+	if( statement.joinType != JOIN_NONE )
+	{
+		if( statement.selectList != "*" || !parseTableReference( table ) || !acceptKeyword( "on" ) )
+		{
+			return false;
+		}
+		statement.tables.push_back( table );
+		return parseJoinCondition( statement ) && atEnd();
+	}
+	return parseSelectClauses( statement );
+}
+
+/**
+ * @brief parseTableReference
+ *
+ * @details parses a table of a from clause and its optional alias
+ *
+ * @param [out] TableReference &table
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseTableReference( TableReference &table )
+{
+	if( !parseName( table.name ) )
+	{
+		return false;
+	}
+	table.alias = table.name;
+	acceptKeyword( "as" );
+
+	const SqlToken &token = peekToken( 0 );
+	if( token.type == TOKEN_WORD )
+	{
+		for( unsigned int keyword = 0; TABLE_FOLLOWERS[ keyword ] != NULL; keyword++ )
+		{
+			if( tokenIs( token, TABLE_FOLLOWERS[ keyword ] ) )
+			{
+				return true;
+			}
+		}
+		table.alias = tokenText( token );
+		position++;
+	}
+	return true;
+}
+
+/**
+ * @brief parseColumnReference
+ *
+ * @details parses a column, optionally after its table alias and a dot
+ *
+ * @param [out] ColumnReference &column
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseColumnReference( ColumnReference &column )
+{
+	if( !parseName( column.column ) )
+	{
+		return false;
+	}
+	column.qualifier.clear();
+	if( acceptSymbol( "." ) )
+	{
+		column.qualifier = column.column;
+		return parseName( column.column );
+	}
+	return true;
+}
+
+/**
+ * @brief parseJoinCondition
+ *
+ * @details parses the condition of a join, column = column
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseJoinCondition( SqlStatement &statement )
+{
+	return parseColumnReference( statement.joinLeft ) && acceptSymbol( "=" ) &&
+			parseColumnReference( statement.joinRight );
+}
+
+/**
+ * @brief parseSelectClauses
+ *
+ * @details parses the where, group by, order by and limit clauses of a
+ *          select from one table, each optional and in that order
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool false if a clause is empty or tokens are left over
+ *
+ * @note None
+ */
+bool SqlParser::parseSelectClauses( SqlStatement &statement )
+{
+	if( acceptKeyword( "where" ) )
+	{
+		statement.whereClause = parseClause( WHERE_FOLLOWERS );
+		if( statement.whereClause.empty() )
+		{
+			return false;
+		}
+	}
+	if( acceptKeyword( "group by" ) )
+	{
+		statement.groupClause = parseClause( GROUP_FOLLOWERS );
+		if( statement.groupClause.empty() )
+		{
+			return false;
+		}
+	}
+	if( acceptKeyword( "order by" ) )
+	{
+		statement.orderClause = parseClause( ORDER_FOLLOWERS );
+		if( statement.orderClause.empty() )
+		{
+			return false;
+		}
+	}
+	if( acceptKeyword( "limit" ) )
+	{
+		statement.limitClause = parseClause( NO_FOLLOWERS );
+		if( statement.limitClause.empty() )
+		{
+			return false;
+		}
+	}
+	return atEnd();
+}
+
+/**
+ * @brief parseInsert
+ *
+ * @details parses into table values( values )
+ *
+ * @par Algorithm the values are the text between the parenthesis after
+ *      values and the last token, which closes it
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseInsert( SqlStatement &statement )
+{
+	if( !acceptKeyword( "into" ) || !parseName( statement.name ) || !acceptKeyword( "values" ) ||
+		!acceptSymbol( "(" ) )
+	{
+		return false;
+	}
+
+	unsigned int last = tokens.size() - 2;
+	const SqlToken &close = tokens[ last ];
+	if( last < position || close.type != TOKEN_SYMBOL || text[ close.start ] != ')' )
+	{
+		return false;
+	}
+	unsigned int valuesStart = tokens[ position - 1 ].end;
+	statement.valueList = text.substr( valuesStart, close.start - valuesStart );
+	position = last + 1;
+	return true;
+}
+
+/**
+ * @brief parseUpdate
+ *
+ * @details parses table set column = value [where condition]
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseUpdate( SqlStatement &statement )
+{
+	if( !parseName( statement.name ) || !acceptKeyword( "set" ) )
+	{
+		return false;
+	}
+	statement.setClause = parseClause( SET_FOLLOWERS );
+	if( statement.setClause.empty() )
+	{
+		return false;
+	}
+	if( acceptKeyword( "where" ) )
+	{
+		statement.whereClause = parseClause( NO_FOLLOWERS );
+		if( statement.whereClause.empty() )
+		{
+			return false;
+		}
+	}
+	return atEnd();
+}
+
+/**
+ * @brief parseDelete
+ *
+ * @details parses from table [where condition]
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseDelete( SqlStatement &statement )
+{
+	if( !acceptKeyword( "from" ) || !parseName( statement.name ) )
+	{
+		return false;
+	}
+	if( acceptKeyword( "where" ) )
+	{
+		statement.whereClause = parseClause( NO_FOLLOWERS );
+		if( statement.whereClause.empty() )
+		{
+			return false;
+		}
+	}
+	return atEnd();
+}
+
+/**
+ * @brief parseCreate
+ *
+ * @details parses database name, table name( columns ) [storage clause] or
+ *          index name on table( column )
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseCreate( SqlStatement &statement )
+{
+	if( acceptKeyword( "database" ) )
+	{
+		statement.type = STATEMENT_CREATE_DATABASE;
+		return parseName( statement.name ) && atEnd();
+	}
+	if( acceptKeyword( "table" ) )
+	{
+		statement.type = STATEMENT_CREATE_TABLE;
+		if( !parseName( statement.name ) || peekToken( 0 ).type != TOKEN_SYMBOL ||
+			text[ peekToken( 0 ).start ] != '(' )
+		{
+			return false;
+		}
+		statement.definition = sourceText( position, tokens.size() - 1 );
+		position = tokens.size() - 1;
+		return true;
+	}
+	if( acceptKeyword( "index" ) )
+	{
+		statement.type = STATEMENT_CREATE_INDEX;
+		return parseName( statement.name ) && acceptKeyword( "on" ) &&
+				parseName( statement.indexTable ) && acceptSymbol( "(" ) &&
+				parseName( statement.indexColumn ) && acceptSymbol( ")" ) && atEnd();
+	}
+	return false;
+}
+
+/**
+ * @brief parseDrop
+ *
+ * @details parses database name or table name
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseDrop( SqlStatement &statement )
+{
+	if( acceptKeyword( "database" ) )
+	{
+		statement.type = STATEMENT_DROP_DATABASE;
+	}
+	else if( acceptKeyword( "table" ) )
+	{
+		statement.type = STATEMENT_DROP_TABLE;
+	}
+	else
+	{
+		return false;
+	}
+	return parseName( statement.name ) && atEnd();
+}
+
+/**
+ * @brief parseAlter
+ *
+ * @details parses table name and the alteration after it
+ *
+ * @param [in/out] SqlStatement &statement
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool SqlParser::parseAlter( SqlStatement &statement )
+{
+	statement.type = STATEMENT_ALTER_TABLE;
+	if( !acceptKeyword( "table" ) || !parseName( statement.name ) || atEnd() )
+	{
+		return false;
+	}
+	statement.definition = sourceText( position, tokens.size() - 1 );
+	position = tokens.size() - 1;
+	return true;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,159 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file SqlParser.h
+ *
+ * @brief Definition file for SqlParser class
+ *
+ * @details Specifies all member methods of the SqlParser class, which turns
+ *          a statement into the tree of a parsed statement in one pass
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef SQLPARSER_H
+#define SQLPARSER_H
+
+enum TokenType{
+	TOKEN_WORD,
+	TOKEN_NUMBER,
+	TOKEN_STRING,
+	TOKEN_SYMBOL,
+	TOKEN_END
+};
+
+//one token of a statement, the characters from start up to end
+struct SqlToken{
+	TokenType type;
+	unsigned int start;
+	unsigned int end;
+};
+
+enum StatementType{
+	STATEMENT_SELECT,
+	STATEMENT_INSERT,
+	STATEMENT_UPDATE,
+	STATEMENT_DELETE,
+	STATEMENT_CREATE_DATABASE,
+	STATEMENT_CREATE_TABLE,
+	STATEMENT_CREATE_INDEX,
+	STATEMENT_DROP_DATABASE,
+	STATEMENT_DROP_TABLE,
+	STATEMENT_ALTER_TABLE,
+	STATEMENT_USE,
+	STATEMENT_BEGIN,
+	STATEMENT_COMMIT,
+	STATEMENT_ANALYZE,
+	STATEMENT_COMMAND
+};
+
+enum JoinType{
+	JOIN_NONE,
+	JOIN_INNER,
+	JOIN_LEFT_OUTER
+};
+
+//table of a from clause, the alias is the name when there is none
+struct TableReference{
+	string name;
+	string alias;
+};
+
+//column of a join condition, the qualifier is the table alias before the dot
+struct ColumnReference{
+	string qualifier;
+	string column;
+};
+
+//tree of a parsed statement. Clauses the table operators parse themselves,
+//the select list, conditions, definitions and values, are kept as the text
+//of the statement they cover
+struct SqlStatement{
+	StatementType type;
+
+	//first word in uppercase, names the statement in errors
+	string action;
+
+	//database, table or index the statement names, analyze names no table
+	//when it reads every table of the database
+	string name;
+
+	//select, the tables of the from clause and how the second is joined,
+	//explain when the plan is output instead of the rows
+	vector< TableReference > tables;
+	JoinType joinType;
+	ColumnReference joinLeft;
+	ColumnReference joinRight;
+	string selectList;
+	string groupClause;
+	string orderClause;
+	string limitClause;
+	bool explain;
+
+	//select, update and delete
+	string whereClause;
+
+	//update, set column = value
+	string setClause;
+
+	//insert, the values between the parentheses
+	string valueList;
+
+	//create table, the column list and storage clause, alter table, the
+	//action and its columns
+	string definition;
+
+	//create index, the table and column indexed
+	string indexTable;
+	string indexColumn;
+
+	//dot commands, the text after the command
+	string argument;
+};
+
+class SqlParser{
+	public:
+		SqlParser();
+		~SqlParser();
+
+		bool parseStatement( const string &input, SqlStatement &statement );
+
+	private:
+		//statement being parsed, its tokens and the next token to parse
+		string text;
+		vector< SqlToken > tokens;
+		unsigned int position;
+
+		void tokenize();
+		const SqlToken &peekToken( unsigned int ahead ) const;
+		bool tokenIs( const SqlToken &token, const char *keyword ) const;
+		bool acceptKeyword( const char *keyword );
+		bool acceptSymbol( const char *symbol );
+		bool atEnd() const;
+		string tokenText( const SqlToken &token ) const;
+		string sourceText( unsigned int first, unsigned int last ) const;
+		bool parseName( string &name );
+		unsigned int findClauseEnd( const char *const *keywords ) const;
+		string parseClause( const char *const *keywords );
+
+		bool parseSelect( SqlStatement &statement );
+		bool parseTableReference( TableReference &table );
+		bool parseColumnReference( ColumnReference &column );
+		bool parseJoinCondition( SqlStatement &statement );
+		bool parseSelectClauses( SqlStatement &statement );
+		bool parseInsert( SqlStatement &statement );
+		bool parseUpdate( SqlStatement &statement );
+		bool parseDelete( SqlStatement &statement );
+		bool parseCreate( SqlStatement &statement );
+		bool parseDrop( SqlStatement &statement );
+		bool parseAlter( SqlStatement &statement );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -15,11 +15,26 @@
 #include <string>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <fstream>
 #include <stdlib.h>
 #include <unistd.h>
+#include <cstdio>
+#include <fcntl.h>
+#include <signal.h>
+#include <cerrno>
+#include <climits>
+#include <sys/file.h>
 #include <sys/stat.h>
 #include "Table.h"
+#include "TableScan.cpp"
+#include "HashJoin.cpp"
+#include "HashAggregate.cpp"
+#include "ExternalSort.cpp"
+#include "ParallelScan.cpp"
+#include "WriteAheadLog.cpp"
+#include "TableStatistics.cpp"
+#include "QueryPlanner.cpp"
 
 using namespace std;
 
@@ -28,18 +43,14 @@ using namespace std;
 #define TABLE_CPP
 
 const string ALL = "*";
-//struct containing attribute name and index values 
-struct AttributeSubset{
-	string attributeName;
-	int attributeIndex;
-};
-
 int findAttrOccur( vector< Attribute > attributes, string attrName );
-void getWhereCondition( WhereCondition &wCond, string whereType, vector< Attribute > attributes );
+bool isAttrFloat( vector< Attribute > attributes, string attrName );
+bool isAttrInt( vector< Attribute > attributes, string attrName );
 void getSetCondition( SetCondition &sCond, string setType, vector< Attribute > attributes );
-bool currIndexIsSubset( vector< AttributeSubset > attrSubsets, int indexVal );
-bool indexExists( int i, vector< int > indexCounter );
 bool fileExists( string filename );
+bool caseInsCompare( const string &s1, const string &s2 );
+bool createLockFile( string lockPath );
+bool lockOwnerAlive( string lockPath );
 /**
  * @brief getCommaCount
  *
@@ -120,51 +131,6 @@ string getNextWord( string &input )
 	}
 }
 
-/**
- * @brief getUntilTabg
- *
- * @details Used to find the action word (command) if tab is present prior
- *          
- * @pre assumes there is more to the string and erases
- *
- * @post action word is found and returned
- *
- * @par Algorithm parses through the string and erases till next space
- *
- * @param [in] string &input
- *      
- * @return string (the word)
- *
- * @note None
- */
-string getUntilTab( string &input )
-{
-	string attribute;
-	bool tabExists = false;
-	int inputSize = input.size();
-
-	for ( int index = 0; index < inputSize; index++ )
-	{
-		if( input[ index ] == '\t' )
-		{
-			tabExists = true;
-		}
-	}
-	if ( !tabExists )
-	{
-		attribute = input;
-		input.clear();
-		return attribute;
-	}
-	else
-	{
-		attribute = input.substr( 0, input.find("\t") );
-		input.erase( 0, input.find( "\t" ) + 1 );
-		return attribute;	
-	}
-
-}
-
 /**
  * @brief removeLeadingWS
  *
@@ -185,7 +151,8 @@ string getUntilTab( string &input )
 void removeLeadingWS( string &input )
 {
 	int index = 0;
-	while( input[ index ] == ' ' || input[ index ] == '\t' )
+	int inputSize = input.size();
+	while( index < inputSize && ( input[ index ] == ' ' || input[ index ] == '\t' ) )
 	{ 
 		index++;
 	}
@@ -193,11 +160,11 @@ void removeLeadingWS( string &input )
 	input.erase( 0, index );
 
 	index = input.size() - 1;
-	while( input[ index ] == ' ' || input[ index ] == '\t' )
+	while( index >= 0 && ( input[ index ] == ' ' || input[ index ] == '\t' ) )
 	{
 		index--;
 	}
-	input.erase( index + 1, input.size() - 1 );
+	input.erase( index + 1 );
 }
 
 
@@ -276,7 +243,8 @@ Table::Table( const Table& tbl )
  *
  * @post action word is found and returned
  *
- * @par Algorithm checks if table already exists in current directory, if not, then creates table in current database & directory
+ * @par Algorithm checks if table already exists in current directory, if not, then creates table in current database & directory.
+ *		An optional "STORAGE PAGE" or "STORAGE TEXT" clause after the attribute list picks the file format, text is the default
  *
  * @param [in] string currentWorkingDirectory
  *
@@ -296,14 +264,39 @@ void Table::tableCreate( string currentWorkingDirectory, string currentDatabase,
 {
 	vector< Attribute> tblAttributes;
 	Attribute attr;
+	TableWriter writer;
 	string temp;
+	string attributeData;
 	int commaCount;
+	bool pageFormat = false;
 
 	//get filepath, Database name + table name
 	string filePath = "/" + currentDatabase + "/" + tblName;
 
-	//output to file using ofstream operator
-	ofstream fout( ( currentWorkingDirectory + filePath ).c_str() );
+	//get storage clause after the closing paren
+	string storageClause = input.substr( input.find_last_of( ")" ) + 1 );
+	removeLeadingWS( storageClause );
+	if( !storageClause.empty() )
+	{
+		string keyword = getNextWord( storageClause );
+		removeLeadingWS( storageClause );
+		if( !storageClause.empty() && storageClause[ 0 ] == '=' )
+		{
+			storageClause.erase( 0, 1 );
+			removeLeadingWS( storageClause );
+		}
+		if( caseInsCompare( keyword, "storage" ) && caseInsCompare( storageClause, "page" ) )
+		{
+			pageFormat = true;
+		}
+		else if( !caseInsCompare( keyword, "storage" ) || !caseInsCompare( storageClause, "text" ) )
+		{
+			errorCode = true;
+			cout << "-- !Failed to create table " << tblName << " because storage ";
+			cout << storageClause << " is not supported." << endl;
+			return;
+		}
+	}
 
 	//parse input str
 		//remove beginning and end ()'s
@@ -330,17 +323,14 @@ void Table::tableCreate( string currentWorkingDirectory, string currentDatabase,
 			errorCode = true;
 			cout << "-- !Failed to create table " << tblName << " because there are multiple ";
 			cout << attr.attributeName << " variables." << endl;
-			system( ( "rm " +  filePath ).c_str() ) ;
-			fout.close();
 			return;
 		}
 
 		//push attribute onto file
 		tblAttributes.push_back( attr );
 
-		//output to file
-		fout << attr.attributeName << " ";
-		fout << attr.attributeType << "\t";
+		//output to attribute line
+		attributeData += attr.attributeName + " " + attr.attributeType + "\t";
 	}
 	
 	//remove leading WS from input
@@ -354,8 +344,6 @@ void Table::tableCreate( string currentWorkingDirectory, string currentDatabase,
 		errorCode = true;
 		cout << "-- !Failed to create table " << tblName << " because there are multiple ";
 		cout << attr.attributeName << " variables." << endl;
-		system( ( "rm " +  currentDatabase + "/" + tblName ).c_str() ) ;
-		fout.close();
 		return;
 	}
 
@@ -363,9 +351,15 @@ void Table::tableCreate( string currentWorkingDirectory, string currentDatabase,
 	tblAttributes.push_back( attr );
 	
 	//output to file
-	fout << attr.attributeName << " ";
-	fout << attr.attributeType;
-	fout.close();
+	attributeData += attr.attributeName + " " + attr.attributeType;
+	if( !writer.writerCreate( currentWorkingDirectory + filePath, attributeData, pageFormat ) )
+	{
+		errorCode = true;
+		cout << "-- !Failed to create table " << tblName << "." << endl;
+		return;
+	}
+	writer.writerClose();
+	statisticsCatalog.statisticsCreate( currentWorkingDirectory + filePath, tblAttributes );
 
 	cout << "-- Table " << tblName << " created." << endl;
 }
@@ -392,9 +386,105 @@ void Table::tableCreate( string currentWorkingDirectory, string currentDatabase,
 void Table::tableDrop( string currentWorkingDirectory, string dbName )
 {
 	system( ( "rm " + currentWorkingDirectory + "/" + dbName + "/" + tableName ).c_str() ) ;
+	removeTableIndexes( currentWorkingDirectory + "/" + dbName + "/" + tableName );
+	schemaCatalog.catalogDrop( currentWorkingDirectory + "/" + dbName + "/" + tableName );
+	statisticsCatalog.statisticsDrop( currentWorkingDirectory + "/" + dbName + "/" + tableName );
 	cout << "-- Table " << tableName << " deleted." << endl;
 }
 
+/**
+ * @brief tableCreateIndex
+ *
+ * @details creates a B+tree index on one column of the table
+ *
+ * @pre assumes table exists in current database
+ *
+ * @post the index holds every row of the table and is kept in sync by
+ *       insert, update and delete
+ *
+ * @par Algorithm index names are unique within the database. The table is
+ *      locked while it is read into the index, a transaction keeps the lock
+ *      until it commits
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string currentDatabase
+ *
+ * @param [in] string indexName
+ *
+ * @param [in] string attrName
+ *
+ * @param [in] bool &errorCode
+ *
+ * @param [in] bool beginTransaction
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Table::tableCreateIndex( string currentWorkingDirectory, string currentDatabase, string indexName,
+								string attrName, bool &errorCode, bool beginTransaction )
+{
+	string databasePath = currentWorkingDirectory + "/" + currentDatabase;
+	string filePath = databasePath + "/" + tableName;
+	string indexTable;
+	TableScan scan;
+	BTreeIndex index;
+
+	if( findIndexTable( databasePath, indexName, indexTable ) )
+	{
+		errorCode = true;
+		cout << "-- !Failed to create index " << indexName << " because it already exists." << endl;
+		return;
+	}
+	if( !tableLock( currentWorkingDirectory, currentDatabase ) )
+	{
+		//output error if another process has control of the table
+		cout << "-- Error: Table " << tableName << " is locked!" << endl;
+		return;
+	}
+
+	bool success = scan.scanOpen( filePath );
+	vector< Attribute > attributes = scan.attributes;
+	scan.scanClose();
+	index.attributeIndex = findAttrOccur( attributes, attrName );
+	if( success && index.attributeIndex < 0 )
+	{
+		if( !beginTransaction )
+		{
+			tableUnlock( currentWorkingDirectory, currentDatabase );
+		}
+		errorCode = true;
+		cout << "-- !Failed to create index " << indexName << " because " << attrName;
+		cout << " is not an attribute of " << tableName << "." << endl;
+		return;
+	}
+
+	string indexPath = indexFilePath( filePath, indexName );
+	TableSignature signature;
+	success = success && tableSignatureOf( filePath, signature ) &&
+				index.indexCreate( indexPath, attrName, indexKeyTypeOf( attributes[ index.attributeIndex ] ) ) &&
+				buildIndex( filePath, index );
+	if( success )
+	{
+		index.indexSetSignature( &signature );
+	}
+	index.indexClose();
+	if( !beginTransaction )
+	{
+		tableUnlock( currentWorkingDirectory, currentDatabase );
+	}
+	if( !success )
+	{
+		unlink( indexPath.c_str() );
+		errorCode = true;
+		cout << "-- !Failed to create index " << indexName << "." << endl;
+		return;
+	}
+
+	cout << "-- Index " << indexName << " created." << endl;
+}
+
 
 /**
  * @brief tableAlter method 
@@ -405,7 +495,8 @@ void Table::tableDrop( string currentWorkingDirectory, string dbName )
  *
  * @post attribute(s) are added to the table
  *
- * @par Algorithm checks if table exists in current directory, and if so, adds the parsed attribute name & type
+ * @par Algorithm checks if table exists in current directory, and if so, adds the parsed attribute name & type.
+ *		The table is streamed into a new file of the same format with null in every new column
  *
  * @param [in] string currentWorkingDirectory
  *
@@ -422,51 +513,25 @@ void Table::tableDrop( string currentWorkingDirectory, string dbName )
 void Table::tableAlter( string currentWorkingDirectory, string currentDatabase, string input, bool &errorCode )
 {
 	vector < Attribute > tableAttributes;
-	vector < string > fileContents;
-	string attrLine;
+	vector < string > row;
+	TableScan scan;
+	TableWriter writer;
 	Attribute attr;
-	Attribute tempAttr;
 	int commaCount = 0;
+	bool rowMatches = false;
 	string temp;
-	int originalNumOfAttr = 0;
-	int newNumOfAttr = 0;
 	//create filepath  to read from file
-	string filePath = "/" + currentDatabase + "/" + tableName;
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
 
 	string action = getNextWord( input );
 
-	if( action == "ADD" )
+	if( caseInsCompare( action, "ADD" ) && scan.scanOpen( filePath ) )
 	{
-		while( !fin.eof() )
-		{
-			//get attribute line
-			getline( fin, attrLine );
-
-			while( !attrLine.empty() )
-			{
-				string attribute = getUntilTab( attrLine );
-				//parse attribute further
-				tempAttr.attributeName = getNextWord( attribute );
-				tempAttr.attributeType = attribute;
-
-				tableAttributes.push_back( tempAttr );
-			}
-			//check again that it is not end of file
-			if( !fin.eof() )
-			{
-				getline( fin, temp );
-				fileContents.push_back( temp );
-			}	
-		}
+		tableAttributes = scan.attributes;
 
 		//get comma count to get num of attributes
 		commaCount = getCommaCount( input );
 
-		//get number of attributes
-		originalNumOfAttr = tableAttributes.size();
-
-		ofstream fout( ( currentWorkingDirectory + filePath ).c_str() );
 		//get additional attributes
 		for( int index = 0; index < commaCount; index++ )
 		{
@@ -485,7 +550,6 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
 				errorCode = true;
 				cout << "-- !Failed to modify table " << tableName << " because there are multiple ";
 				cout << attr.attributeName << " variables." << endl;
-				system( ( "rm " +  filePath ).c_str() ) ;
 				return;
 			}
 
@@ -509,36 +573,36 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
 		//push onto vecotr
 		tableAttributes.push_back( attr );
 
+		string attributeData;
 		int tableSize = tableAttributes.size();
-		newNumOfAttr = tableSize - originalNumOfAttr;
 		for( int index = 0; index < tableSize; index++ )
 		{
-			if( index != tableSize - 1 )
-			{
-				//if its the last table then do not add tab
-				fout << tableAttributes[ index ].attributeName << " ";		
-				fout << tableAttributes[ index ].attributeType << "\t";	
-			}
-			else
+			if( index != 0 )
 			{
-				fout << tableAttributes[ index ].attributeName << " ";		
-				fout << tableAttributes[ index ].attributeType;	
+				attributeData += "\t";
 			}
-
+			attributeData += tableAttributes[ index ].attributeName + " " + tableAttributes[ index ].attributeType;
 		}
 
 		//initalize all records so that attribtue is null
-		int contentSize = fileContents.size();
-		for( int index = 0; index < contentSize; index++ )
+		writer.writerCreate( filePath + SCAN_SUFFIX, attributeData, scan.pageFormat );
+		while( scan.scanNext( row, rowMatches ) )
 		{
-			fout << endl << fileContents[ index ];
-			for( int newAttr = 0; newAttr < newNumOfAttr; newAttr++ )
-			{
-				fout << "\tnull";
-			}
+			row.resize( tableSize, "null" );
+			writer.writeRow( row );
+		}
+		scan.scanClose();
+		writer.writerClose();
+		rename( ( filePath + SCAN_SUFFIX ).c_str(), filePath.c_str() );
+
+		//the new columns are null in every row
+		TableStatistics *statistics = statisticsCatalog.statisticsOf( filePath );
+		if( statistics != NULL )
+		{
+			statisticsAddColumns( *statistics, tableAttributes );
+			statisticsCatalog.statisticsSave( filePath );
 		}
-		fin.close();
-		fout.close();
+
 		cout << "-- Table " << tableName << " modified." << endl;
 	}
 	else
@@ -548,6 +612,125 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
 }
 
 
+/**
+ * @brief parseRowCount
+ *
+ * @details parses a number of rows of a limit clause, a count larger than
+ *          any table is capped so it can be added to another
+ *
+ * @param [in] string word
+ *
+ * @param [out] long &rowCount
+ *
+ * @return bool false if the word is not a number of rows
+ *
+ * @note None
+ */
+bool parseRowCount( string word, long &rowCount )
+{
+	char *end = NULL;
+
+	if( word.empty() || !isdigit( word[ 0 ] ) )
+	{
+		return false;
+	}
+	errno = 0;
+	rowCount = strtol( word.c_str(), &end, 10 );
+	if( *end != '\0' )
+	{
+		return false;
+	}
+	if( errno == ERANGE || rowCount > LONG_MAX / 2 )
+	{
+		rowCount = LONG_MAX / 2;
+	}
+	return true;
+}
+
+/**
+ * @brief parseLimit
+ *
+ * @details parses a limit clause, a number of rows optionally followed by
+ *          offset and the number of rows skipped first
+ *
+ * @param [in] string limitType
+ *
+ * @param [out] long &rowLimit -1 for an empty clause
+ *
+ * @param [out] long &rowOffset
+ *
+ * @param [out] string &error why the clause cannot be used
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool parseLimit( string limitType, long &rowLimit, long &rowOffset, string &error )
+{
+	vector< string > words;
+	size_t start = limitType.find_first_not_of( " \t\r\n" );
+
+	while( start != string::npos )
+	{
+		size_t end = limitType.find_first_of( " \t\r\n", start );
+		words.push_back( limitType.substr( start, end - start ) );
+		start = limitType.find_first_not_of( " \t\r\n", end );
+	}
+	rowLimit = -1;
+	rowOffset = 0;
+	if( words.empty() )
+	{
+		return true;
+	}
+	if( !parseRowCount( words[ 0 ], rowLimit ) || ( words.size() != 1 &&
+		( words.size() != 3 || !caseInsCompare( words[ 1 ], "offset" ) ||
+		!parseRowCount( words[ 2 ], rowOffset ) ) ) )
+	{
+		removeLeadingWS( limitType );
+		error = "limit " + limitType + " is not a number of rows";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief outputSorted
+ *
+ * @details sorts the rows added to a sort and displays them
+ *
+ * @param [in/out] ExternalSort &sorter
+ *
+ * @param [in] unsigned int columnCount leading columns of each row that are
+ *             displayed, the others were only sorted on
+ *
+ * @param [in] long rowOffset sorted rows skipped
+ *
+ * @param [in] long rowLimit rows displayed after them, -1 for all
+ *
+ * @return bool false if the sort could not write its runs
+ *
+ * @note None
+ */
+bool outputSorted( ExternalSort &sorter, unsigned int columnCount, long rowOffset, long rowLimit )
+{
+	vector< string > row;
+	long position = 0;
+
+	if( !sorter.sortFinish() )
+	{
+		return false;
+	}
+	while( ( rowLimit < 0 || position < rowOffset + rowLimit ) && sorter.sortNext( row ) )
+	{
+		if( position++ >= rowOffset )
+		{
+			row.resize( columnCount );
+			outputRow( row );
+		}
+	}
+	return true;
+}
+
 /**
  * @brief tableSelect method
  *
@@ -557,7 +740,17 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
  *
  * @post attributes stored in the directory are displayed 
  *
- * @par Algorithm goes to the filepath, and displays info from the file
+ * @par Algorithm streams the table through a TableScan, every row that
+ *      satisfies the where condition is projected and displayed. A large
+ *      table is filtered by the worker threads when the scan allows it.
+ *      A select with aggregate functions or a group by clause adds the
+ *      rows to their groups instead, on the worker threads for a large
+ *      table, and displays one row per group. With an order by clause the
+ *      rows go through a sort first, a table column that is not selected
+ *      is carried after the selected ones until the rows are displayed.
+ *      With a limit clause a sort only keeps the rows it displays, and a
+ *      select without an order by stops reading the table once it has
+ *      displayed them
  *
  * @param [in] string currentWorkingDirectory
  *
@@ -567,473 +760,233 @@ void Table::tableAlter( string currentWorkingDirectory, string currentDatabase,
  *
  * @param [in] string queryType
  *
+ * @param [in] string groupType columns of the group by clause, empty for none
+ *
+ * @param [in] string orderType terms of the order by clause, empty for none
+ *
+ * @param [in] string limitType row count and offset of the limit clause,
+ *             empty for none
+ *
  * @return None
  *
  * @note None
  */
-void Table::tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType )
+void Table::tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType,
+							string groupType, string orderType, string limitType )
 {
-	vector< Attribute > attributes;
-	vector< AttributeSubset > attrSubsets;
-	WhereCondition wCond;
+	TableScan scan;
+	ParallelScan parallelScan;
+	ExternalSort sorter;
+	vector< SortKey > sortKeys;
+	vector< string > names;
+	vector< string > types;
+	vector< string > row;
 	string filePath = "/" + currentDatabase + "/" + tableName;
-	string temp;
-	int commaCount;
-	int contentLineCount = 0;
-	double tempDouble;
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-
-	//get attributes
-		//get until end of line
-	//check type of query
-	getline( fin, temp);
-
-	//automatically get all the attributes
-	while( !temp.empty() )
+	string error;
+	bool success = true;
+	long rowLimit;
+	long rowOffset;
+
+	removeLeadingWS( orderType );
+	bool ordered = !orderType.empty();
+	if( !parseLimit( limitType, rowLimit, rowOffset, error ) )
 	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes.push_back( tempAttribute );
+		cout << "-- !Failed to query table " << tableName << " because " << error << "." << endl;
+		return;
 	}
-
-	//if query all attributes
-	if( queryType == ALL )
+	if( !scan.scanOpen( currentWorkingDirectory + filePath ) )
 	{
-		cout << "-- ";
-		int size = attributes.size();
-
-		//output all attributes
-		for( int index = 0; index < size; index++ )
+		return;
+	}
+	if( HashAggregate::isAggregateQuery( queryType, groupType ) )
+	{
+		HashAggregate aggregate;
+		if( !aggregate.aggregateSetup( queryType, groupType, scan.attributes, error ) )
 		{
-			cout << attributes[ index ].attributeName << " ";
-			cout << attributes[ index ].attributeType;
-			if( index != size - 1 )
-			{
-				cout << "|";
-			}
+			cout << "-- !Failed to query table " << tableName << " because " << error << "." << endl;
+			scan.scanClose();
+			return;
 		}
-		cout << endl;
-
-		//if there is a where condition then output with where cond
-		if( !whereType.empty() )
+		aggregate.outputColumns( scan.attributes, names, types );
+		if( ordered && !ExternalSort::parseSortKeys( orderType, names, types, sortKeys, error ) )
 		{
-			getWhereCondition( wCond, whereType, attributes);
-		
-					//get size of file content
-			while( !fin.eof() )
-			{
-				getline( fin, temp );
-				contentLineCount++;
-			}
-			fin.close();
-			ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-			//get attribute and store into temp, not used
-			getline( fin, temp );
-			//create 2d array
-			string twoDArr[ contentLineCount ][ attributes.size() ];
-			int attributesSize = attributes.size();
-			for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
-			{
-				getline( fin, temp );
-				for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-				{
-					twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
-				}
-			}
-
-			//output specific data
-			//for each row
-			for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
-			{
-				bool printResult = false;
-				cout << "-- ";
-				//for each col
-				for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-				{
-						if( wCond.operatorValue == "=" )
-						{
-							
-							//if we are not comparing floats, then do not convert to double
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble == wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == "!=" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble != wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						if( wCond.operatorValue == "<" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble < wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == "<=" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble <= wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == ">" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble > wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						else if( wCond.operatorValue == ">=" )
-						{
-							if( !wCond.floatValue ) 
-							{
-								if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-								{
-									printResult = true;
-								}
-							}
-							else if( wCond.floatValue )
-							{
-								tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-								if( tempDouble >= wCond.comparisonValueFloat )
-								{
-									printResult = true;
-								}
-							}
-						}
-						if( printResult )
-						{
-							string content = twoDArr[ iIndex ][ jIndex ];
-							if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-							{
-								content.erase( 0, content.find( "'" ) + 1 );
-								content.erase( content.find_last_of( "'" ), content.length()-1 );
-							}
-							cout << content << "|";
-						}	
-				}
-				if( printResult )
-				{
-					cout << "\b \b";
-					cout << endl;
-				}
-				else
-				{
-					cout << "\b \b\b\b";	
-				}
-			}
+			cout << "-- !Failed to query table " << tableName << " because " << error << "." << endl;
+			scan.scanClose();
+			return;
+		}
+		//groups of a limited select go through a sort, which keeps them in
+		//order when there are no keys
+		bool sorted = ordered || rowLimit >= 0;
+		sorter.sortSetup( sortKeys, currentWorkingDirectory + "/" + currentDatabase );
+		if( rowLimit >= 0 )
+		{
+			sorter.sortSetLimit( rowOffset + rowLimit );
+		}
 
+		//the aggregate reads its columns from the whole row
+		scan.scanSetProjection( "*" );
+		if( !scan.scanSetWhere( whereType, error ) )
+		{
+			cout << "-- !Failed to query table " << tableName << " because " << error << "." << endl;
+			scan.scanClose();
+			return;
 		}
-		else //output everything otherwise
+		aggregate.outputHeader( scan.attributes );
+		if( !aggregate.aggregateParallel( scan, currentWorkingDirectory + filePath ) )
 		{
-			while( !fin.eof() )
+			while( scan.scanNextSelected( row ) )
 			{
-				getline( fin, temp);
-				cout << "-- ";
-				while( !temp.empty() )
-				{
-					string content = getUntilTab( temp );
-					//check that if start of string is "'" and end is "'"
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content << "|";
-				}
-				cout << "\b \b";
-				cout << endl;
+				aggregate.aggregateRow( row );
 			}
-			fin.close();
+		}
+		if( !aggregate.outputGroups( sorted ? &sorter : NULL ) )
+		{
+			success = false;
+			error = "the sort could not write the runs of its groups";
+		}
+		else if( sorted && !outputSorted( sorter, names.size(), rowOffset, rowLimit ) )
+		{
+			success = false;
+			error = "the sort could not write its runs";
 		}
 	}
 	else
 	{
-		//get attributes in query subset 
-		commaCount = getCommaCount( queryType );
-		
-		//get subset to query
-		for ( int index = 0; index < commaCount+1; index++ )
+		scan.scanSetProjection( queryType );
+		for( unsigned int index = 0; index < scan.attributes.size(); index++ )
 		{
-			AttributeSubset tempAttr;
-
-			//remove beginning parameter
-			temp = queryType.substr( 0, queryType.find( "," ));
-			queryType.erase( 0, queryType.find(",") + 1 );
-
-			//remove leading white space
-			removeLeadingWS( temp );
-
-			tempAttr.attributeName = temp;
-			tempAttr.attributeIndex = findAttrOccur( attributes, tempAttr.attributeName );
-			attrSubsets.push_back( tempAttr );
+			names.push_back( scan.attributes[ index ].attributeName );
+			types.push_back( scan.attributes[ index ].attributeType );
 		}
-
-		//check that there is where condition
-		if( !whereType.empty() )
+		if( ordered && !ExternalSort::parseSortKeys( orderType, names, types, sortKeys, error ) )
 		{
-			getWhereCondition( wCond, whereType, attributes);
+			cout << "-- !Failed to query table " << tableName << " because " << error << "." << endl;
+			scan.scanClose();
+			return;
 		}
-
-		//get size of file content
-		while( !fin.eof() )
+		if( !scan.scanSetWhere( whereType, error ) )
 		{
-			getline( fin, temp );
-			contentLineCount++;
+			cout << "-- !Failed to query table " << tableName << " because " << error << "." << endl;
+			scan.scanClose();
+			return;
 		}
+		scan.outputHeader();
 
-		fin.close();
-		ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-		//get attribute and store into temp, not used
-		getline( fin, temp );
-		//create 2d array
-		string twoDArr[ contentLineCount ][ attributes.size() ];
-		
-		//store data in 2d array
-		int attributesSize = attributes.size();
-		for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+		if( ordered )
 		{
-			getline( fin, temp );
-			for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+			//sort columns that are not selected are read after the selected ones
+			unsigned int columnCount = scan.projection.size();
+			for( unsigned int index = 0; index < sortKeys.size(); index++ )
 			{
-				twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
+				int position = find( scan.projection.begin(), scan.projection.end(), sortKeys[ index ].column ) -
+								scan.projection.begin();
+				if( position == (int)scan.projection.size() )
+				{
+					scan.projection.push_back( sortKeys[ index ].column );
+				}
+				sortKeys[ index ].column = position;
 			}
-		}
-
-		//output attribute subset
-		cout << "-- ";
-		for( int index = 0; index < attributesSize; index++ )
-		{
-			if( currIndexIsSubset( attrSubsets, index ) )
+			sorter.sortSetup( sortKeys, currentWorkingDirectory + "/" + currentDatabase );
+			if( rowLimit >= 0 )
+			{
+				sorter.sortSetLimit( rowOffset + rowLimit );
+			}
+			while( success && scan.scanNextSelected( row ) )
 			{
-				cout << attributes[ index ].attributeName;
-				cout << " " << attributes[ index ].attributeType << "|"; 
+				success = sorter.sortAdd( row );
+			}
+			if( !success || !outputSorted( sorter, columnCount, rowOffset, rowLimit ) )
+			{
+				success = false;
+				error = "the sort could not write its runs";
 			}
 		}
-		cout << "\b \b" << endl;
-
-		//output specific data
-		//for each row
-		for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+		else if( rowLimit >= 0 )
 		{
-			bool printResult = false;
-			cout << "-- ";
-			//for each col
-			for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+			//read on one thread so the scan stops at the last row displayed
+			long position = 0;
+			while( position < rowOffset + rowLimit && scan.scanNextSelected( row ) )
 			{
-				//for each col check that the subset is to be called
-				if( currIndexIsSubset( attrSubsets, jIndex ) )
+				if( position++ >= rowOffset )
 				{
-					if( wCond.operatorValue == "=" )
-					{
-						
-						//if we are not comparing floats, then do not convert to double
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble == wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == "!=" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble != wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					if( wCond.operatorValue == "<" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble < wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == "<=" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble <= wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == ">" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble > wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					else if( wCond.operatorValue == ">=" )
-					{
-						if( !wCond.floatValue ) 
-						{
-							if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-							{
-								printResult = true;
-							}
-						}
-						else if( wCond.floatValue )
-						{
-							tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-							if( tempDouble >= wCond.comparisonValueFloat )
-							{
-								printResult = true;
-							}
-						}
-					}
-					if( printResult )
-					{
-						string content = twoDArr[ iIndex ][ jIndex ];
-						if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-						{
-							content.erase( 0, content.find( "'" ) + 1 );
-							content.erase( content.find_last_of( "'" ), content.length()-1 );
-						}
-						cout << content << "|";
-					}	
+					outputRow( row );
 				}
-
-				
 			}
-			if( printResult )
-			{
-				cout << "\b \b";
-				cout << endl;
-			}
-			else
+		}
+		else if( !parallelScan.scanSelect( scan, currentWorkingDirectory + filePath ) )
+		{
+			while( scan.scanNextSelected( row ) )
 			{
-				cout << "\b \b\b\b";	
+				outputRow( row );
 			}
 		}
 	}
+	if( !success )
+	{
+		cout << "-- !Failed to query table " << tableName << " because " << error << "." << endl;
+	}
+	scan.scanClose();
 }
 
 /**
- *@brief tableInsert
+ * @brief tableExplain method
  *
- *@details inserts a new record into an existing table
+ * @details displays how a select reads the table, the access path chosen
+ *          and the ones it was chosen over, without reading the rows
  *
- *@par Algorithm goes to correct file path where table info is, parses record, 
- *            and adds new record to the file and outputs succession to terminal
+ * @pre assumes table specified is in the current directory
  *
- *@param [in] string currentWorkingDirectory
- * 
- *@param [in] string currentDatabase
+ * @par Algorithm the where condition is planned as tableSelect plans it.
+ *      The columns, groups, order and limit of the select do not change
+ *      the access path and are not shown
  *
- *@param [in] string tblName
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string currentDatabase
+ *
+ * @param [in] string whereType
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Table::tableExplain( string currentWorkingDirectory, string currentDatabase, string whereType )
+{
+	TableScan scan;
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	string error;
+
+	if( !scan.scanOpen( filePath ) )
+	{
+		return;
+	}
+	if( !scan.scanSetWhere( whereType, error ) )
+	{
+		cout << "-- !Failed to explain the query of table " << tableName << " because " << error << "." << endl;
+		scan.scanClose();
+		return;
+	}
+	if( scan.accessPlan.candidates.empty() )
+	{
+		planAccessPath( filePath, scan.accessPlan );
+	}
+	outputAccessPlan( tableName, scan.accessPlan );
+	scan.scanClose();
+}
+
+/**
+ *@brief tableInsert
+ *
+ *@details inserts a new record into an existing table
+ *
+ *@par Algorithm goes to correct file path where table info is, parses record, 
+ *            and adds new record to the file and outputs succession to terminal
+ *
+ *@param [in] string currentWorkingDirectory
+ * 
+ *@param [in] string currentDatabase
+ *
+ *@param [in] string tblName
  *
  *@param [in] string input
  *
@@ -1042,12 +995,13 @@ void Table::tableSelect( string currentWorkingDirectory, string currentDatabase,
 */
 void Table::tableInsert( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode, bool beginTransaction )
 {
-	string contentStr = "\n";
+	vector< string > row;
+	TableWriter writer;
 	int commaCount;
-	string filePath = "/" + currentDatabase + "/" + tableName;
 	string temp;
 
-	if( beginTransaction && !tableLock( currentWorkingDirectory, currentDatabase ) )
+	//statements outside a transaction hold the lock while they run
+	if( !tableLock( currentWorkingDirectory, currentDatabase ) )
 	{
 		//output error if another process has control of the table
 		cout << "-- Error: Table " << tableName << " is locked!" << endl;
@@ -1064,25 +1018,43 @@ void Table::tableInsert( string currentWorkingDirectory, string currentDatabase,
 		//remove leading white space
 		removeLeadingWS( temp );
 
-		//concat temp to content str
-		contentStr = contentStr + temp + '\t';
+		//add temp to the row
+		row.push_back( temp );
 	}
 	
 	//remove leading WS from input
 	removeLeadingWS( input );
-	contentStr = contentStr + input;
+	row.push_back( input );
 
-	if( beginTransaction && tableLock( currentWorkingDirectory, currentDatabase ) )
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	if( beginTransaction )
 	{
-		tableTempName = tableName + "_temp";
-		filePath = "/" + currentDatabase + "/" + tableTempName;
+		//the row reaches the table when the transaction commits
+		writeAheadLog.walInsert( filePath, row );
+	}
+	else
+	{
+		bool success = writer.writerAppend( filePath ) && writer.writeRow( row );
+		writer.writerClose();
+		if( !success )
+		{
+			tableUnlock( currentWorkingDirectory, currentDatabase );
+			errorCode = true;
+			cout << "-- !Failed to insert into table " << tableName << "." << endl;
+			return;
+		}
 	}
 
-	ofstream fout;
-	fout.open( ( currentWorkingDirectory + filePath ).c_str(), ofstream::out | ofstream::app );
-	fout << contentStr;
-
-	fout.close();
+	TableStatistics *statistics = statisticsCatalog.statisticsToChange( filePath, beginTransaction );
+	if( statistics != NULL )
+	{
+		statisticsAddRow( *statistics, row );
+		statisticsCatalog.statisticsChanged( filePath );
+	}
+	if( !beginTransaction )
+	{
+		tableUnlock( currentWorkingDirectory, currentDatabase );
+	}
 
 	cout << "-- 1 new record inserted." << endl;
 }
@@ -1094,6 +1066,9 @@ void Table::tableInsert( string currentWorkingDirectory, string currentDatabase,
  *
  *@details updates the table based on all records that match the given condition  
  *
+ *@par Algorithm streams the table through a TableScan and updates every
+ *            matching row through the scan cursor
+ *
  *@param [in] string currentWorkingDirectory
  *
  *@param [in] string currentDatabase
@@ -1105,223 +1080,96 @@ void Table::tableInsert( string currentWorkingDirectory, string currentDatabase,
 */
 void Table::tableUpdate( string currentWorkingDirectory, string currentDatabase, string whereType, string setType, bool beginTransaction )
 {
-	vector< Attribute > attributes;
+	TableScan scan;
 	SetCondition sCond;
-	WhereCondition wCond;
-	string filePath = "/" + currentDatabase + "/" + tableTempName;
-	string temp;
+	vector< string > row;
+	string error;
+	bool rowMatches = false;
 	int recordsModified = 0;
-	int contentLineCount = 0;
-	double tempDouble;
 
-
-	//check if table is locked before updating
-	if( beginTransaction && !tableLock( currentWorkingDirectory, currentDatabase ) )
+	//check if table is locked before updating, statements outside a
+	//transaction hold the lock while they run
+	if( !tableLock( currentWorkingDirectory, currentDatabase ) )
 	{
 		//output error if another process has control of the table
 		cout << "-- Error: Table " << tableName << " is locked!" << endl;
 		return;
 	}
 
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-
-	//get attributes
-		//get until end of line
-	//check type of query
-	getline( fin, temp);
-
-	//get attribute data
-	while( !temp.empty() )
+	//changes of a transaction go to the log, others rewrite the table
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	bool opened = scan.scanOpen( filePath );
+	if( opened && beginTransaction )
 	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes.push_back( tempAttribute );
+		scan.scanLogChanges();
 	}
-
-	//get where and set conditions
-	getWhereCondition( wCond, whereType, attributes);
-	getSetCondition( sCond, setType, attributes );
-
-	//get size of file content
-	while( !fin.eof() )
+	else if( !opened || !scan.scanRewrite( filePath ) )
 	{
-		getline( fin, temp );
-		contentLineCount++;
+		if( !beginTransaction )
+		{
+			tableUnlock( currentWorkingDirectory, currentDatabase );
+		}
+		return;
 	}
 
-	fin.close();
-
-	fin.open(( currentWorkingDirectory + filePath ).c_str() );
-	
-	//get attribute and store into temp 
-	getline( fin, temp );
-	string attributeData = temp;
-	
-	//create 2d array and store content data
-	string twoDArr[ contentLineCount ][ attributes.size() ];
-	int attributesSize = attributes.size();
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+	//get where and set conditions
+	if( !scan.scanSetWhere( whereType, error ) )
 	{
-		getline( fin, temp );
-		for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+		cout << "-- !Failed to update table " << tableName << " because " << error << "." << endl;
+		scan.scanCancel();
+		if( !beginTransaction )
 		{
-			twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
+			tableUnlock( currentWorkingDirectory, currentDatabase );
 		}
+		return;
 	}
-	fin.close();
-
-
-	if( beginTransaction && tableLock( currentWorkingDirectory, currentDatabase ) )
+	getSetCondition( sCond, setType, scan.attributes );
+	TableStatistics *statistics = statisticsCatalog.statisticsToChange( filePath, beginTransaction );
+	TableStatistics statisticsBefore;
+	if( statistics != NULL )
 	{
-		tableTempName = tableName + "_temp";
-		filePath = "/" + currentDatabase + "/" + tableTempName;
+		statisticsBefore = *statistics;
 	}
 
-	ofstream fout( ( currentWorkingDirectory + filePath ).c_str() );
-	
-	fout << attributeData << endl;
-	
-	//output specific data
-	//for each row
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+	//replace the set value of matching rows
+	while( scan.scanNext( row, rowMatches ) )
 	{
-		bool printResult = false;
-		//for each col
-		for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+		if( rowMatches && sCond.attributeIndex >= 0 )
 		{
-			//for each col check that the set index is to be called
-			if( sCond.attributeIndex == jIndex )
+			recordsModified++;
+			if( statistics != NULL )
 			{
-				if( wCond.operatorValue == "=" )
-				{
-					//if we are not comparing floats, then do not convert to double
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble == wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				else if( wCond.operatorValue == "!=" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble != wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				if( wCond.operatorValue == "<" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble < wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				else if( wCond.operatorValue == "<=" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble <= wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				else if( wCond.operatorValue == ">" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble > wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				else if( wCond.operatorValue == ">=" )
-				{
-					if( !wCond.floatValue ) 
-					{
-						if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-						{
-							printResult = true;
-						}
-					}
-					else if( wCond.floatValue )
-					{
-						tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-						if( tempDouble >= wCond.comparisonValueFloat )
-						{
-							printResult = true;
-						}
-					}
-				}
-				if( printResult )
-				{
-					recordsModified++;
-					twoDArr[ iIndex ][ jIndex ] = sCond.newValue;
-				}	
+				statisticsReplaceValue( *statistics, sCond.attributeIndex, row[ sCond.attributeIndex ],
+										sCond.newValue );
 			}
+			row[ sCond.attributeIndex ] = sCond.newValue;
+			scan.scanUpdate( row );
+		}
+	}
 
-			fout << twoDArr[ iIndex ][ jIndex ];
-			if( jIndex != attributesSize - 1 )
-			{
-				fout << "\t";
-			}
+	//a table that could not be written keeps its rows and statistics
+	if( !scan.scanClose() )
+	{
+		if( statistics != NULL )
+		{
+			*statistics = statisticsBefore;
 		}
-		if( iIndex != contentLineCount- 1 )
+		if( !beginTransaction )
 		{
-			fout << endl;
+			tableUnlock( currentWorkingDirectory, currentDatabase );
 		}
+		cout << "-- !Failed to update table " << tableName << " because the changed table could not be written." << endl;
+		return;
+	}
+	if( statistics != NULL )
+	{
+		statisticsCatalog.statisticsChanged( filePath );
+	}
+	if( !beginTransaction )
+	{
+		tableUnlock( currentWorkingDirectory, currentDatabase );
 	}
 
-	fout.close();
 	cout << "-- " << recordsModified; 
 	if( recordsModified == 1 )
 	{
@@ -1333,225 +1181,109 @@ void Table::tableUpdate( string currentWorkingDirectory, string currentDatabase,
 	}
 }
 
-
+/**
+ *@brief tableDelete
+ *
+ *@details deletes all records that match the given condition
+ *
+ *@par Algorithm streams the table through a TableScan and deletes every
+ *            matching row through the scan cursor
+ *
+ *@param [in] string currentWorkingDirectory
+ *
+ *@param [in] string currentDatabase
+ *
+ *@param [in] string whereType
+ *
+ *@param [in] bool beginTransaction
+ *
+*/
 void Table::tableDelete( string currentWorkingDirectory, string currentDatabase, string whereType, bool beginTransaction )
 {
-	vector< Attribute > attributes;
-	vector< string > contentOutput;
-	SetCondition sCond;
-	WhereCondition wCond;
-	string filePath = "/" + currentDatabase + "/" + tableTempName;
-	string temp;
-	vector< int > recordsModified;
-	int contentLineCount = 0;
-	double tempDouble;
-	ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-
-	//check if table is locked before updating
-	if( beginTransaction && !tableLock( currentWorkingDirectory, currentDatabase ) )
+	TableScan scan;
+	vector< string > row;
+	string error;
+	bool rowMatches = false;
+	int recordsDeleted = 0;
+
+	//check if table is locked before updating, statements outside a
+	//transaction hold the lock while they run
+	if( !tableLock( currentWorkingDirectory, currentDatabase ) )
 	{
 		//output error if another process has control of the table
 		cout << "-- Error: Table " << tableName << " is locked!" << endl;
 		return;
 	}
 
-	//get attributes
-		//get until end of line
-	//check type of query
-	getline( fin, temp);
-
-	//get attribute data
-	while( !temp.empty() )
+	//changes of a transaction go to the log, others rewrite the table
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	bool opened = scan.scanOpen( filePath );
+	if( opened && beginTransaction )
 	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes.push_back( tempAttribute );
+		scan.scanLogChanges();
 	}
-
-	getWhereCondition( wCond, whereType, attributes);
-
-	//get size of file content
-	while( !fin.eof() )
+	else if( !opened || !scan.scanRewrite( filePath ) )
 	{
-		getline( fin, temp );
-		contentLineCount++;
+		if( !beginTransaction )
+		{
+			tableUnlock( currentWorkingDirectory, currentDatabase );
+		}
+		return;
 	}
-
-	fin.close();
-	//ifstream fin( ( currentWorkingDirectory + filePath ).c_str() );
-	fin.open(( currentWorkingDirectory + filePath ).c_str() );
-	//get attribute and store into temp 
-	getline( fin, temp );
-	string attributeData = temp;
-	//create 2d array
-	string twoDArr[ contentLineCount ][ attributes.size() ];
-	int attributesSize = attributes.size();
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
+	if( !scan.scanSetWhere( whereType, error ) )
 	{
-		getline( fin, temp );
-		for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
+		cout << "-- !Failed to delete from table " << tableName << " because " << error << "." << endl;
+		scan.scanCancel();
+		if( !beginTransaction )
 		{
-			twoDArr[ iIndex ][ jIndex ] = getUntilTab( temp );
+			tableUnlock( currentWorkingDirectory, currentDatabase );
 		}
+		return;
 	}
-	fin.close();
-
-
-	if( beginTransaction && tableLock( currentWorkingDirectory, currentDatabase ) )
+	TableStatistics *statistics = statisticsCatalog.statisticsToChange( filePath, beginTransaction );
+	TableStatistics statisticsBefore;
+	if( statistics != NULL )
 	{
-		tableTempName = tableName + "_temp";
-		filePath = "/" + currentDatabase + "/" + tableTempName;
-
+		statisticsBefore = *statistics;
 	}
 
-	ofstream fout( ( currentWorkingDirectory + filePath ).c_str() );
-	
-	fout << attributeData << endl;
-	//output specific data
-	//for each row
-	for( int iIndex = 0; iIndex < contentLineCount; iIndex++ )
-	{
-		bool printResult = true;
-		//check that index val does 
-		if( wCond.operatorValue == "=" )
-		{
-			
-			//if we are not comparing floats, then do not convert to double
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] == wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble == wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		else if( wCond.operatorValue == "!=" )
-		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] != wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble != wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		if( wCond.operatorValue == "<" )
-		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] < wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble < wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		else if( wCond.operatorValue == "<=" )
-		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] <= wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble <= wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
-		}
-		else if( wCond.operatorValue == ">" )
+	//remove every row that matches
+	while( scan.scanNext( row, rowMatches ) )
+	{
+		if( rowMatches )
 		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
+			recordsDeleted++;
+			if( statistics != NULL )
 			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble > wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
+				statisticsRemoveRow( *statistics, row );
 			}
+			scan.scanDelete();
 		}
-		else if( wCond.operatorValue == ">=" )
+	}
+
+	//a table that could not be written keeps its rows and statistics
+	if( !scan.scanClose() )
+	{
+		if( statistics != NULL )
 		{
-			if( !wCond.floatValue ) 
-			{
-				if( twoDArr[ iIndex ][ wCond.attributeIndex ] >= wCond.comparisonValue )
-				{
-					printResult = false;
-				}
-			}
-			else if( wCond.floatValue )
-			{
-				tempDouble = atof( twoDArr[ iIndex ][ wCond.attributeIndex ].c_str() );
-				if( tempDouble >= wCond.comparisonValueFloat )
-				{
-					printResult = false;
-				}
-			}
+			*statistics = statisticsBefore;
 		}
-
-		if( printResult == true )
+		if( !beginTransaction )
 		{
-			string content = "";
-			for( int jIndex = 0; jIndex < attributesSize; jIndex++ )
-			{
-				content = content + twoDArr[ iIndex ][ jIndex ];
-				if( jIndex != attributesSize - 1 )
-				{
-					content = content + '\t';
-				}
-			}
-			contentOutput.push_back( content );
+			tableUnlock( currentWorkingDirectory, currentDatabase );
 		}
+		cout << "-- !Failed to delete from table " << tableName << " because the changed table could not be written." << endl;
+		return;
 	}
-
-	int newContentSize = contentOutput.size();
-
-	for( int index = 0; index < newContentSize; index++ )
+	if( statistics != NULL )
 	{
-		fout << contentOutput[ index ];
-		if( index != newContentSize - 1 )
-		{
-			fout << endl;
-		}
+		statisticsCatalog.statisticsChanged( filePath );
+	}
+	if( !beginTransaction )
+	{
+		tableUnlock( currentWorkingDirectory, currentDatabase );
 	}
 
-	int recordsDeleted = contentLineCount - newContentSize;
 	cout << "-- " << recordsDeleted;
 	if( recordsDeleted == 1 )
 	{
@@ -1563,10 +1295,97 @@ void Table::tableDelete( string currentWorkingDirectory, string currentDatabase,
 	}
 }
 
+/**
+ * @brief tableAnalyze
+ *
+ * @details collects the statistics of the table
+ *
+ * @pre assumes table exists in current database
+ *
+ * @post the statistics file of the table holds its row count and the range,
+ *       null count, distinct count and histogram of every column
+ *
+ * @par Algorithm the table is locked while it is read, so no insert, update
+ *      or delete changes the statistics at the same time
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string currentDatabase
+ *
+ * @param [in] bool beginTransaction
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Table::tableAnalyze( string currentWorkingDirectory, string currentDatabase, bool beginTransaction )
+{
+	if( !tableLock( currentWorkingDirectory, currentDatabase ) )
+	{
+		cout << "-- Error: Table " << tableName << " is locked!" << endl;
+		return;
+	}
+
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	bool analyzed = statisticsCatalog.statisticsAnalyze( filePath, beginTransaction );
+	if( !beginTransaction )
+	{
+		tableUnlock( currentWorkingDirectory, currentDatabase );
+	}
+
+	if( analyzed )
+	{
+		cout << "-- Table " << tableName << " analyzed." << endl;
+	}
+	else
+	{
+		cout << "-- !Failed to analyze table " << tableName << "." << endl;
+	}
+}
+
+/**
+ * @brief tableShowStatistics
+ *
+ * @details outputs the statistics of the table, one line for the table and
+ *          one for each column
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string currentDatabase
+ *
+ * @return None
+ *
+ * @note None
+ */
+void Table::tableShowStatistics( string currentWorkingDirectory, string currentDatabase )
+{
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName;
+	TableStatistics *statistics = statisticsCatalog.statisticsOf( filePath );
+	if( statistics == NULL )
+	{
+		cout << "-- !Failed to show statistics of table " << tableName << " because it has not been analyzed." << endl;
+		return;
+	}
+
+	cout << "-- Table " << tableName << ": " << statistics->rowCount << " rows, ";
+	cout << statistics->modifiedRows << " changed since it was analyzed." << endl;
+	for( unsigned int index = 0; index < statistics->columns.size(); index++ )
+	{
+		const ColumnStatistics &column = statistics->columns[ index ];
+		cout << "-- " << column.columnName << ": " << column.nullCount << " nulls, about ";
+		cout << (long)( statisticsDistinct( column, statistics->rowCount ) + 0.5 ) << " distinct";
+		if( column.hasRange )
+		{
+			cout << ", from " << column.minValue << " to " << column.maxValue;
+		}
+		cout << ", " << column.histogram.size() << " histogram buckets." << endl;
+	}
+}
+
 int findAttrOccur( vector< Attribute > attributes, string attrName )
 {
 	int attrSize = attributes.size();
-	int attrIndex;
+	int attrIndex = -1;
 	for ( int index = 0; index < attrSize; index++ )
 	{
 		if( attributes[ index ].attributeName == attrName )
@@ -1594,33 +1413,39 @@ bool isAttrFloat( vector< Attribute > attributes, string attrName )
 }
 
 /**
-*@brief getWhereCondition method
-*
-*@details if there is a where condition in statement, parses that data
-*
-*@par Algorithm gets Where condition, and checks operatorValue from prev. function
-*			and stores the comparison which is converted into a floata and stored
-*
-*@param [in] WhereCondition &wCond
-*
-*@param [in] string whereType
-*
-*@param [in] vector <Attribute> attributes
-*
-*@note uses functions from setCondition 
-*/
-void getWhereCondition( WhereCondition &wCond, string whereType, vector< Attribute > attributes )
+ * @brief isNullValue
+ *
+ * @details tells whether a cell holds null, written as nothing by an outer
+ *          join, as null by alter table or as NULL by an insert
+ *
+ * @param [in] string &value
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool isNullValue( const string &value )
 {
-	wCond.attributeName = getNextWord( whereType );
-	wCond.attributeIndex = findAttrOccur( attributes, wCond.attributeName );
-	wCond.operatorValue = getNextWord( whereType );
-	wCond.comparisonValue = whereType;
+	return value.empty() || value == "null" || value == "NULL";
+}
 
-	if( isAttrFloat( attributes, wCond.attributeName ) )
-	{
-		wCond.floatValue = true;
-		wCond.comparisonValueFloat = atof( wCond.comparisonValue.c_str() );
-	}
+/**
+ * @brief isAttrInt
+ *
+ * @details checks whether a column holds ints
+ *
+ * @param [in] vector< Attribute > attributes
+ *
+ * @param [in] string attrName
+ *
+ * @return bool false if the column does not exist
+ *
+ * @note None
+ */
+bool isAttrInt( vector< Attribute > attributes, string attrName )
+{
+	int attrIndex = findAttrOccur( attributes, attrName );
+	return attrIndex >= 0 && caseInsCompare( attributes[ attrIndex ].attributeType, "int" );
 }
 
 /**
@@ -1648,65 +1473,19 @@ void getSetCondition( SetCondition &sCond, string setType, vector< Attribute > a
 	sCond.newValue = setType;
 }
 
-/**
-*@brief bool currIndexIsSubset Method
-*
-*@details checks if the the current Index mathces the index passed in 
-*
-*@param [in] vector < AttributeSubset > attrSubsets
-*
-*@param [in] int indexVal
-*
-*@return bool true if the same value
-*/
-bool currIndexIsSubset( vector< AttributeSubset > attrSubsets, int indexVal )
-{
-	int subsetSize = attrSubsets.size();
-	for( int index = 0; index < subsetSize; index++ )
-	{
-		if( attrSubsets[ index ].attributeIndex == indexVal )
-		{
-			return true;
-		}
-	}
-	return false;
-}
-
-/**
-*@brief indexExists method
-*
-*@details checks if the index value passed in exists 
-*
-*@param [in] int i (index value)
-*
-*@param [in] vector < int > indexCounter
-*
-*@return bool true if index passed in exists in the vector of indices
-*/
-bool indexExists( int i, vector< int > indexCounter )
-{
-	int size = indexCounter.size();
-	for ( int index = 0; index < size; index++ )
-	{
-		if( indexCounter[ index ] == i )
-		{
-			return true;
-		}
-	}
-	return false;
-}
-
 /**
  * @brief innerJoin
  *
- * @details uses index join algorithm
+ * @details uses the cheapest join algorithm
  *          
  * @pre table1 and table2 must exist
  *
  * @post output join
  *
  * @par Algorithm 
- *     use nested for loops to find similarities between two tables
+ *     the query planner picks the join method, usually the smaller table
+ *     is hashed on its join attribute and the other table is streamed past
+ *     it, see HashJoin
  * 
  * @exception None
  *
@@ -1723,184 +1502,26 @@ bool indexExists( int i, vector< int > indexCounter )
  */
 void Table::innerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr )
 {
-	vector < Attribute > attributes1;
-	vector < string * > table1Tuples;
-	vector < Attribute > attributes2;
-	vector < string * > table2Tuples;
-	string filePath = "/" + currentDatabase + "/";
-	string temp;
-
-
-	//open table 1 file and read contents and attributes
-	ifstream fin( (currentWorkingDirectory + filePath + table1Name ).c_str() );
-
-	//get table 1 attributes
-	getline( fin, temp );
-
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes1.push_back( tempAttribute );
-	}
-
-	//get tuples
-	int numTbl1Attr = attributes1.size();
-	//go till end of file
-	while( !fin.eof() )
-	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes1.size() ];
-		//get line
-		getline( fin, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl1Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table1Tuples.push_back( tuple );
-	}
-	fin.close();
-
-	//open table 3 file and read contents and attributes
-	ifstream fread( (currentWorkingDirectory + filePath + table2Name ).c_str() );
-
-	getline( fread, temp );
-
-	//get attributes for table 2
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes2.push_back( tempAttribute );
-	}
-
-	//get tuples
-	int numTbl2Attr = attributes2.size();
-	//go till end of file
-	while( !fread.eof() )
-	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes2.size() ];
-		//get line
-		getline( fread, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl2Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table2Tuples.push_back( tuple );
-	}
-	fread.close();
-
-	int tbl1Size = table1Tuples.size();
-	int tbl2Size = table2Tuples.size();
-	int tbl1AttrOccur = findAttrOccur( attributes1, table1Attr );
-	int tbl2AttrOccur = findAttrOccur( attributes2, table2Attr );
-
-	//output attributes
-	int attrSize1 = attributes1.size();
-	int attrSize2 = attributes2.size();
-
-	cout << "-- ";
-	for( int index = 0; index < attrSize1; index++ )
-	{
-		cout << attributes1[ index ].attributeName << " ";
-		cout << attributes1[ index ].attributeType << "|";
-	}
-
-
-	for( int index = 0; index < attrSize2; index++ )
-	{
-		cout << attributes2[ index ].attributeName << " ";
-		cout << attributes2[ index ].attributeType; 
-		if( index != attrSize2 - 1 )
-		{
-			cout << "|";
-		}
-	}
-	cout << endl;
-
-	for( int tuple1Count = 0; tuple1Count < tbl1Size; tuple1Count++ )
-	{
-		bool joinFound = false;
-		vector <int> tbl2JoinIndexes;
-
-		for( int tuple2Count = 0; tuple2Count < tbl2Size; tuple2Count++ )
-		{
-		
-			if( table1Tuples[ tuple1Count ][ tbl1AttrOccur ] == 
-				table2Tuples[ tuple2Count ][ tbl2AttrOccur ] )
-			{
-				joinFound = true;
-				tbl2JoinIndexes.push_back( tuple2Count );
-				//cout << "TUPLE count " << tuple2Count << endl;
-			}
-		}
-		if( joinFound )
-		{
-			int joinCount = tbl2JoinIndexes.size();
-			
-			for( int joins = 0; joins < joinCount; joins++ )
-			{
-				cout << "-- ";
-				for( int attr1 = 0; attr1 < numTbl1Attr; attr1++ )
-				{
-					string content = table1Tuples[ tuple1Count ][ attr1 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content << "|";
-				}
-
-				for( int attr2 = 0; attr2 < numTbl2Attr; attr2++ )
-				{
-					string content = table2Tuples[ tbl2JoinIndexes[ joins ] ][ attr2 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content; 
-					if( attr2 != numTbl2Attr - 1 )
-					{
-						cout << "|";
-					}
-				}
-				cout << endl;
-			}
-		}
-	}
-
-	for( int i = 0; i < numTbl1Attr; i++ )
-	{
-		delete [] table1Tuples[ i ];
-	}
-
-	for( int i = 0; i < numTbl2Attr; i++ )
-	{
-		delete [] table2Tuples[ i ];
-	}
+	HashJoin join;
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/";
 
+	join.joinTables( filePath + table1Name, table1Attr, filePath + table2Name, table2Attr, false );
 }
 
 /**
  * @brief outerJoin
  *
- * @details uses index join algorithm
+ * @details uses the cheapest join algorithm, rows of table1 without a match are
+ *          output with NULLs for the attributes of table2
  *          
  * @pre table1 and table2 must exist
  *
  * @post output join
  *
  * @par Algorithm 
- *     use nested for loops to find similarities between two tables
+ *     the query planner picks the join method, usually the smaller table
+ *     is hashed on its join attribute and the other table is streamed past
+ *     it, see HashJoin
  * 
  * @exception None
  *
@@ -1917,193 +1538,38 @@ void Table::innerJoin( string currentWorkingDirectory, string currentDatabase, s
  */
 void Table::outerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr )
 {
-	vector < Attribute > attributes1;
-	vector < string * > table1Tuples;
-	vector < Attribute > attributes2;
-	vector < string * > table2Tuples;
-	string filePath = "/" + currentDatabase + "/";
-	string temp;
-
-
-	//open table 1 file and read contents and attributes
-	ifstream fin( (currentWorkingDirectory + filePath + table1Name ).c_str() );
-
-	//get table 1 attributes
-	getline( fin, temp );
-
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes1.push_back( tempAttribute );
-	}
-
-	//get tuples
-	int numTbl1Attr = attributes1.size();
-	//go till end of file
-	while( !fin.eof() )
-	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes1.size() ];
-		//get line
-		getline( fin, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl1Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table1Tuples.push_back( tuple );
-	}
-	fin.close();
-
-	//open table 3 file and read contents and attributes
-	ifstream fread( (currentWorkingDirectory + filePath + table2Name ).c_str() );
-
-	getline( fread, temp );
-
-	//get attributes for table 2
-	while( !temp.empty() )
-	{
-		Attribute tempAttribute;
-		tempAttribute.attributeName = getNextWord( temp );
-		tempAttribute.attributeType = getUntilTab( temp );
-		attributes2.push_back( tempAttribute );
-	}
-
-	//get tuples
-	int numTbl2Attr = attributes2.size();
-	//go till end of file
-	while( !fread.eof() )
-	{
-		//declare string array of size number of attributes
-		string * tuple = new string [ attributes2.size() ];
-		//get line
-		getline( fread, temp );
-		//for each tuple, get each element 
-		for( int index = 0; index < numTbl2Attr; index++ )
-		{
-			tuple[ index ] = getUntilTab( temp );
-		}
-		//push tuple onto vector
-		table2Tuples.push_back( tuple );
-	}
-	fread.close();
-
-	int tbl1Size = table1Tuples.size();
-	int tbl2Size = table2Tuples.size();
-	int tbl1AttrOccur = findAttrOccur( attributes1, table1Attr );
-	int tbl2AttrOccur = findAttrOccur( attributes2, table2Attr );
-
-	//output attributes
-	int attrSize1 = attributes1.size();
-	int attrSize2 = attributes2.size();
-
-	cout << "-- ";
-	for( int index = 0; index < attrSize1; index++ )
-	{
-		cout << attributes1[ index ].attributeName << " ";
-		cout << attributes1[ index ].attributeType << "|";
-	}
-
-
-	for( int index = 0; index < attrSize2; index++ )
-	{
-		cout << attributes2[ index ].attributeName << " ";
-		cout << attributes2[ index ].attributeType; 
-		if( index != attrSize2 - 1 )
-		{
-			cout << "|";
-		}
-	}
-	cout << endl;
-
-	for( int tuple1Count = 0; tuple1Count < tbl1Size; tuple1Count++ )
-	{
-		bool joinFound = false;
-		vector <int> tbl2JoinIndexes;
-
-		for( int tuple2Count = 0; tuple2Count < tbl2Size; tuple2Count++ )
-		{
-		
-			if( table1Tuples[ tuple1Count ][ tbl1AttrOccur ] == 
-				table2Tuples[ tuple2Count ][ tbl2AttrOccur ] )
-			{
-				joinFound = true;
-				tbl2JoinIndexes.push_back( tuple2Count );
-				//cout << "TUPLE count " << tuple2Count << endl;
-			}
-		}
-		if( joinFound )
-		{
-			int joinCount = tbl2JoinIndexes.size();
-			
-			for( int joins = 0; joins < joinCount; joins++ )
-			{
-				cout << "-- ";
-				for( int attr1 = 0; attr1 < numTbl1Attr; attr1++ )
-				{
-					string content = table1Tuples[ tuple1Count ][ attr1 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content << "|";
-				}
+	HashJoin join;
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/";
 
-				for( int attr2 = 0; attr2 < numTbl2Attr; attr2++ )
-				{
-					string content = table2Tuples[ tbl2JoinIndexes[ joins ] ][ attr2 ];
-					if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-					{
-						content.erase( 0, content.find( "'" ) + 1 );
-						content.erase( content.find_last_of( "'" ), content.length()-1 );
-					}
-					cout << content; 
-					if( attr2 != numTbl2Attr - 1 )
-					{
-						cout << "|";
-					}
-				}
-				cout << endl;
-			}
-		}
-		else
-		{
-			cout << "-- ";
-			for( int attr1 = 0; attr1 < numTbl1Attr; attr1++ )
-			{
-				string content = table1Tuples[ tuple1Count ][ attr1 ];
-				if( content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
-				{
-					content.erase( 0, content.find( "'" ) + 1 );
-					content.erase( content.find_last_of( "'" ), content.length()-1 );
-				}
-				cout << content << "|";
-			}
-
-			for( int attr2 = 0; attr2 < numTbl2Attr; attr2++ )
-			{
-				if( attr2 != numTbl2Attr - 1 )
-				{
-					cout << "|";
-				}
-			}
-			cout << endl;
-		}
-	}
+	join.joinTables( filePath + table1Name, table1Attr, filePath + table2Name, table2Attr, true );
+}
 
-	for( int i = 0; i < numTbl1Attr; i++ )
-	{
-		delete [] table1Tuples[ i ];
-	}
+/**
+ * @brief joinExplain
+ *
+ * @details displays how a join of table1 and table2 would run, the method
+ *          chosen and the ones it was chosen over, without joining them
+ *
+ * @pre table1 and table2 must exist
+ *
+ * @param [in] currentworkingdirector 	provides string for which directory to get table from
+ 			   currentDatabase 			provides string for current database
+ 			   table1Name				provides the name for table1
+ 			   table2Name				provides the name for table2
+ 			   table1attr 				provides attribute name to be compared
+ 			   table2Attr 				provides attribute name to be compared
+ 			   outer					true for a left outer join
+ *
+ * @return void
+ *
+ * @note None
+ */
+void Table::joinExplain( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr, bool outer )
+{
+	HashJoin join;
+	string filePath = currentWorkingDirectory + "/" + currentDatabase + "/";
 
-	for( int i = 0; i < numTbl2Attr; i++ )
-	{
-		delete [] table2Tuples[ i ];
-	}
+	join.joinExplain( filePath + table1Name, table1Attr, filePath + table2Name, table2Attr, outer );
 }
 
 
@@ -2119,7 +1585,10 @@ void Table::outerJoin( string currentWorkingDirectory, string currentDatabase, s
  * @par Algorithm 
  *     if table belongs to us, then continue writing to modified file,
  *		 if file already exists, lock does not belong to us
- *		 if file doesnt exist, we can take the lock
+ *		 if file doesnt exist, we can take the lock. The lock file holds the
+ *		 process id of its owner and is created exclusively so two processes
+ *		 cannot both take it, and the committed changes in the log are applied
+ *		 before the table is read
  * 
  * @exception 
  *
@@ -2132,42 +1601,39 @@ void Table::outerJoin( string currentWorkingDirectory, string currentDatabase, s
 bool Table::tableLock( string currentWorkingDirectory, string currentDatabase )
 {
 	string filePath = "/" + currentDatabase + "/" + tableName;
-	//does a lock file already exist, if yes then...
-	if( fileExists( currentWorkingDirectory + filePath + "_temp" ) )
-	{
-		//check if this table owns the lock, if yes then...
-		if( tableIsLocked )
-		{
-			return true;
-		}
-		//another process owns the lock
-		else
-		{
-			return false;
-		}
-	}//the lock does not exist and we can create a temp file
-	else
+	//check if this table owns the lock, if yes then...
+	if( tableIsLocked && fileExists( currentWorkingDirectory + filePath + "_temp" ) )
 	{
-		//create table
-		ofstream fout( ( currentWorkingDirectory + "/" + currentDatabase + "/" + tableName + "_temp" ).c_str(), ofstream::out );
-		fout.close();
-		tableIsLocked = true;
 		return true;
 	}
+
+	//the lock does not exist and we can create a temp file, otherwise another
+	//process owns it, unless that process died and left the lock behind
+	if( !createLockFile( currentWorkingDirectory + filePath + "_temp" ) &&
+		!( tableBreakLock( currentWorkingDirectory, currentDatabase ) &&
+			createLockFile( currentWorkingDirectory + filePath + "_temp" ) ) )
+	{
+		return false;
+	}
+	tableIsLocked = true;
+
+	//a transaction that committed just before may not be applied yet
+	writeAheadLog.walCatchUp( currentWorkingDirectory + "/" + currentDatabase );
+	return true;
 }
 
 /**
  * @brief tableUnlock
  *
- * @details commits changes for that table
+ * @details releases the lock of the table
  *          
  * @pre table owns the lock and file exists
  *
- * @post 
+ * @post other processes can lock the table
  *
  * @par Algorithm 
- *     remove original table file, then rename modified file to original file name
- *		reset lock variables
+ *     committed changes are already in the log, so only the lock file is
+ *		removed and the lock variables reset
  * 
  * @exception 
  *
@@ -2180,17 +1646,104 @@ bool Table::tableLock( string currentWorkingDirectory, string currentDatabase )
 void Table::tableUnlock( string currentWorkingDirectory, string currentDatabase )
 {
 	string filePath = "/" + currentDatabase + "/" + tableName;
-	//remove original file tableName
-	system( ( "rm " + currentWorkingDirectory + filePath ).c_str() );
-
-	//rename temp file to tableName
-	system( ( "mv " + currentWorkingDirectory + filePath + "_temp" + " " +
-					currentWorkingDirectory + filePath ).c_str() );
+	unlink( ( currentWorkingDirectory + filePath + "_temp" ).c_str() );
 
 	tableTempName = tableName;
 	tableIsLocked = false;
 }
 
+/**
+ * @brief tableBreakLock
+ *
+ * @details releases a lock whose owner process no longer runs
+ *          
+ * @pre none
+ *
+ * @post the lock is gone if its owner died
+ *
+ * @par Algorithm 
+ *     the database directory is locked while the owner is checked, so two
+ *		processes cannot both break the lock and one of them remove the lock
+ *		the other one took next
+ * 
+ * @exception 
+ *
+ * @param [in] string currentWorkingDirectory
+ *
+ * @param [in] string currentDatabase
+ *
+ * @return bool true if an orphaned lock was removed
+ *
+ * @note None
+ */
+bool Table::tableBreakLock( string currentWorkingDirectory, string currentDatabase )
+{
+	string lockPath = currentWorkingDirectory + "/" + currentDatabase + "/" + tableName + "_temp";
+	int dirFd = open( ( currentWorkingDirectory + "/" + currentDatabase ).c_str(), O_RDONLY );
+	if( dirFd < 0 )
+	{
+		return false;
+	}
+	bool broken = false;
+	if( flock( dirFd, LOCK_EX ) == 0 && fileExists( lockPath ) && !lockOwnerAlive( lockPath ) )
+	{
+		broken = unlink( lockPath.c_str() ) == 0;
+	}
+	close( dirFd );
+	return broken;
+}
+
+/**
+ * @brief createLockFile
+ *
+ * @details creates a lock file holding the process id of this process
+ *
+ * @par Algorithm the id is written to a file of its own that is then linked
+ *      to the lock name, so the lock never exists without its owner and the
+ *      link fails if the lock is already taken
+ *
+ * @param [in] string lockPath
+ *
+ * @return bool true if this process took the lock
+ *
+ * @note None
+ */
+bool createLockFile( string lockPath )
+{
+	char processId[ 32 ];
+	snprintf( processId, sizeof( processId ), "%d", (int)getpid() );
+	string claimPath = lockPath + "_" + processId;
+
+	ofstream fout( claimPath.c_str(), ofstream::out | ofstream::trunc );
+	fout << processId;
+	fout.close();
+	bool locked = link( claimPath.c_str(), lockPath.c_str() ) == 0;
+	unlink( claimPath.c_str() );
+	return locked;
+}
+
+/**
+ * @brief lockOwnerAlive
+ *
+ * @details checks whether the process that created a lock still runs
+ *
+ * @param [in] string lockPath
+ *
+ * @return bool false if the owner died or the lock names no owner
+ *
+ * @note None
+ */
+bool lockOwnerAlive( string lockPath )
+{
+	int processId = 0;
+	ifstream fin( lockPath.c_str() );
+	if( !( fin >> processId ) || processId <= 0 )
+	{
+		return false;
+	}
+	return kill( processId, 0 ) == 0 || errno == EPERM;
+}
+
 /**
  * @brief fileExists
  *
@@ -36,10 +36,14 @@ struct WhereCondition{
 	int attributeIndex;
 	string operatorValue;
 	bool floatValue;
+	bool intValue;
 	double comparisonValueFloat;
 	string comparisonValue;
 };
 
+//cells that hold null, every operator that skips or orders nulls asks it
+bool isNullValue( const string &value );
+
 
 class Table{
 	public: 
@@ -53,20 +57,28 @@ class Table{
 
 		void tableCreate( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode );
 		void tableDrop( string currentWorkingDirectory, string dbName );
+		void tableCreateIndex( string currentWorkingDirectory, string currentDatabase, string indexName,
+								string attrName, bool &errorCode, bool beginTransaction );
 		
 		void tableAlter( string currentWorkingDirectory, string currentDatabase, string input, bool &errorCode );
 		
-		void tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType );
+		void tableSelect( string currentWorkingDirectory, string currentDatabase, string whereType, string queryType,
+							string groupType, string orderType, string limitType );
+		void tableExplain( string currentWorkingDirectory, string currentDatabase, string whereType );
 		
 		void tableInsert( string currentWorkingDirectory, string currentDatabase, string tblName, string input, bool &errorCode, bool beginTransaction );
 		void tableUpdate( string currentWorkingDirectory, string currentDatabase, string whereType, string setType, bool beginTransaction );
 		void tableDelete( string currentWorkingDirectory, string currentDatabase, string whereType, bool beginTransaction );
+		void tableAnalyze( string currentWorkingDirectory, string currentDatabase, bool beginTransaction );
+		void tableShowStatistics( string currentWorkingDirectory, string currentDatabase );
 		
 		void innerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr );
 		void outerJoin( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr );
+		void joinExplain( string currentWorkingDirectory, string currentDatabase, string table1Name, string table1Attr, string table2Name, string table2Attr, bool outer );
 
 		bool tableLock( string currentWorkingDirectory, string currentDatabase );
 		void tableUnlock( string currentWorkingDirectory, string currentDatabase );
+		bool tableBreakLock( string currentWorkingDirectory, string currentDatabase );
 };
 
 // Terminating precompiler directives  ////////////////////////////////////////
@@ -0,0 +1,1437 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file TableScan.cpp
+ *
+ * @brief Implementation file for TableScan class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the streaming scan operator. A scan reads the table
+ *          file one row at a time, filters it with the where condition and
+ *          projects it, so no statement has to hold the whole table in memory.
+ *          Both the text and the page table formats are read and written here
+ *
+ * @Note Requires TableScan.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <sys/stat.h>
+#include "TableScan.h"
+#include "PageFile.cpp"
+#include "MappedFile.cpp"
+#include "BTreeIndex.cpp"
+#include "WherePredicate.cpp"
+#include "TextTokenizer.cpp"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TABLESCAN_CPP
+#define TABLESCAN_CPP
+
+//helper functions implemented in Table.cpp
+void removeLeadingWS( string &input );
+int getCommaCount( string str );
+int findAttrOccur( vector< Attribute > attributes, string attrName );
+
+/**
+ * @brief parseAttributes
+ *
+ * @details parses the attribute line of a table file into attributes
+ *
+ * @pre attrLine is the first line of a table file
+ *
+ * @post attributes holds one entry per column
+ *
+ * @par Algorithm each column is "name type" separated by tabs, the name
+ *      ends at the first space of the column
+ *
+ * @param [in] string attrLine
+ *
+ * @param [out] vector< Attribute > &attributes
+ *
+ * @return None
+ *
+ * @note None
+ */
+void parseAttributes( string attrLine, vector< Attribute > &attributes )
+{
+	const char *start = attrLine.data();
+	const char *end = start + attrLine.size();
+
+	attributes.clear();
+	while( start < end )
+	{
+		const char *tab = findDelimiter( start, end );
+		const char *space = (const char *)memchr( start, ' ', tab - start );
+		Attribute tempAttribute;
+		if( space == NULL )
+		{
+			tempAttribute.attributeName.assign( start, tab - start );
+		}
+		else
+		{
+			tempAttribute.attributeName.assign( start, space - start );
+			tempAttribute.attributeType.assign( space + 1, tab - space - 1 );
+		}
+		attributes.push_back( tempAttribute );
+		start = tab + 1;
+	}
+}
+
+/**
+ * @brief splitRow
+ *
+ * @details splits a tab separated record into its cells
+ *
+ * @pre line is one record of a table file
+ *
+ * @post row holds exactly numCells values, missing cells are empty
+ *
+ * @par Algorithm the delimiter scanner walks the line once
+ *
+ * @param [in] string &line
+ *
+ * @param [in] int numCells
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void splitRow( const string &line, int numCells, vector< string > &row )
+{
+	splitRow( line.data(), line.data() + line.size(), numCells, row );
+}
+
+/**
+ * @brief joinRow
+ *
+ * @details joins cells back into a tab separated record
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return string
+ *
+ * @note None
+ */
+string joinRow( const vector< string > &row )
+{
+	string line;
+	int rowSize = row.size();
+	for( int index = 0; index < rowSize; index++ )
+	{
+		if( index != 0 )
+		{
+			line += '\t';
+		}
+		line += row[ index ];
+	}
+	return line;
+}
+
+/**
+ * @brief stripQuotes
+ *
+ * @details removes surrounding single quotes from a value for output
+ *
+ * @param [in] string content
+ *
+ * @return string
+ *
+ * @note None
+ */
+string stripQuotes( string content )
+{
+	if( content.size() >= 2 && content[ 0 ] == '\'' && content[ content.size() - 1 ] == '\'' )
+	{
+		return content.substr( 1, content.size() - 2 );
+	}
+	return content;
+}
+
+/**
+ * @brief outputRow
+ *
+ * @details outputs one result row as "-- a|b|c"
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void outputRow( const vector< string > &row )
+{
+	int rowSize = row.size();
+	cout << "-- ";
+	for( int index = 0; index < rowSize; index++ )
+	{
+		if( index != 0 )
+		{
+			cout << "|";
+		}
+		cout << stripQuotes( row[ index ] );
+	}
+	cout << endl;
+}
+
+/**
+ * @brief copyFile
+ *
+ * @details copies a file byte for byte
+ *
+ * @param [in] string sourcePath
+ *
+ * @param [in] string destinationPath
+ *
+ * @return bool false if either file could not be opened
+ *
+ * @note None
+ */
+bool copyFile( string sourcePath, string destinationPath )
+{
+	ifstream fin( sourcePath.c_str(), ios::binary );
+	ofstream fout( destinationPath.c_str(), ios::binary | ios::trunc );
+	if( !fin.is_open() || !fout.is_open() )
+	{
+		return false;
+	}
+	fout << fin.rdbuf();
+	return true;
+}
+
+/**
+ * @brief TableWriter default constructor
+ *
+ * @details a new writer is not attached to any table file
+ *
+ * @note None
+ */
+TableWriter::TableWriter()
+{
+	writerPageFormat = false;
+	appendOffset = 0;
+	countRows = -1;
+}
+
+/**
+ * @brief TableWriter default destructor
+ *
+ * @details closes the table file if it is still open
+ *
+ * @note None
+ */
+TableWriter::~TableWriter()
+{
+	writerClose();
+}
+
+/**
+ * @brief writerCreate
+ *
+ * @details creates a table file holding only its attribute line
+ *
+ * @pre none
+ *
+ * @post rows written next are appended to the new table, which is in the
+ *       schema catalog with no rows
+ *
+ * @param [in] string filePath
+ *
+ * @param [in] string attributeData
+ *
+ * @param [in] bool pageFormat true for the page format, false for text
+ *
+ * @return bool false if the file could not be created
+ *
+ * @note None
+ */
+bool TableWriter::writerCreate( string filePath, string attributeData, bool pageFormat )
+{
+	writerClose();
+	writerPageFormat = pageFormat;
+	countPath = filePath;
+	countRows = 0;
+	if( writerPageFormat )
+	{
+		return pageFile.pageFileCreate( filePath, attributeData );
+	}
+
+	fout.open( filePath.c_str(), ofstream::out | ofstream::trunc );
+	fout << attributeData;
+	schemaCatalog.catalogSchema( filePath, attributeData.data(), attributeData.size(), false );
+	return fout.is_open();
+}
+
+/**
+ * @brief writerAppend
+ *
+ * @details opens an existing table file to append rows to it
+ *
+ * @post the indexes of the table receive every row written, and scans of a
+ *       text table read it through the buffer pool until the writer closes.
+ *       A row count the catalog holds for the table follows the rows written
+ *
+ * @param [in] string filePath
+ *
+ * @return bool false if the file could not be opened
+ *
+ * @note None
+ */
+bool TableWriter::writerAppend( string filePath )
+{
+	writerClose();
+	writerPageFormat = PageFile::isPageFile( filePath );
+	countPath = filePath;
+	countRows = schemaCatalog.catalogRowCount( filePath );
+	if( writerPageFormat )
+	{
+		if( !pageFile.pageFileOpen( filePath ) )
+		{
+			return false;
+		}
+		vector< Attribute > attributes = schemaCatalog.catalogSchema( filePath, pageFile.attributeData.data(),
+																		pageFile.attributeData.size(), true ).attributes;
+		indexes.indexesOpen( filePath, &attributes );
+		return true;
+	}
+
+	struct stat fileStat;
+	appendOffset = stat( filePath.c_str(), &fileStat ) == 0 ? fileStat.st_size : 0;
+	fout.open( filePath.c_str(), ofstream::out | ofstream::app );
+	if( !fout.is_open() )
+	{
+		return false;
+	}
+	indexes.indexesOpen( filePath, NULL );
+	appendPath = filePath;
+	markAppending( appendPath, true );
+	return true;
+}
+
+/**
+ * @brief writeRow
+ *
+ * @details appends one row to the table
+ *
+ * @par Algorithm text rows are written as a new tab separated line, page rows
+ *      are stored in the last page with room
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool false if the row could not be written
+ *
+ * @note None
+ */
+bool TableWriter::writeRow( const vector< string > &row )
+{
+	long rid;
+	if( writerPageFormat )
+	{
+		if( !pageFile.insertRow( row, rid ) )
+		{
+			countRows = -1;
+			return false;
+		}
+	}
+	else
+	{
+		string rowLine = joinRow( row );
+		fout << endl << rowLine;
+		if( !fout.good() )
+		{
+			countRows = -1;
+			return false;
+		}
+		rid = appendOffset + 1;
+		appendOffset = rid + rowLine.size();
+	}
+	if( countRows >= 0 )
+	{
+		countRows++;
+	}
+
+	if( indexes.indexesActive() )
+	{
+		indexes.rowInserted( row, rid );
+	}
+	return true;
+}
+
+/**
+ * @brief writerClose
+ *
+ * @details closes the table file, then its indexes
+ *
+ * @par Algorithm when the rows of the table were known before the writer
+ *      opened it, the new count is recorded with the signature the file has
+ *      once it is closed
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableWriter::writerClose()
+{
+	bool success = true;
+	TableSignature signature;
+	if( fout.is_open() )
+	{
+		fout.close();
+		success = !fout.fail();
+	}
+	if( !appendPath.empty() )
+	{
+		markAppending( appendPath, false );
+		appendPath.clear();
+	}
+	pageFile.pageFileClose();
+	indexes.indexesClose( success );
+	if( !countPath.empty() && success && countRows >= 0 &&
+		tableSignatureOf( countPath, signature ) )
+	{
+		schemaCatalog.catalogSetRowCount( countPath, countRows, signature );
+	}
+	countPath.clear();
+	countRows = -1;
+}
+
+/**
+ * @brief TableScan default constructor
+ *
+ * @details a new scan has no file, no where condition and no projection
+ *
+ * @note None
+ */
+TableScan::TableScan()
+{
+	whereExists = false;
+	accessPlan.whereSelectivity = 1;
+	accessPlan.chosen = -1;
+	predicate = NULL;
+	pageFormat = false;
+	currentRid = -1;
+	delta = NULL;
+	insertCursor = 0;
+	logging = false;
+	indexScan = false;
+	indexCursor = 0;
+	maintainIndexes = false;
+	rewriting = false;
+	pendingStart = NULL;
+	pendingLength = 0;
+	pendingValid = false;
+	batchCount = 0;
+	batchCursor = 0;
+	mapCursor = 0;
+	rowsRead = 0;
+	rowsDeleted = 0;
+	signatureValid = false;
+	tableEnd = false;
+	tableChanged = false;
+}
+
+/**
+ * @brief TableScan default destructor
+ *
+ * @details closes the table file if it is still open
+ *
+ * @note None
+ */
+TableScan::~TableScan()
+{
+	scanClose();
+	delete predicate;
+}
+
+/**
+ * @brief scanOpen
+ *
+ * @details opens a table file and reads its attribute line
+ *
+ * @pre none
+ *
+ * @post scan is positioned on the first record, changes the open transaction
+ *       made to the table are laid over its rows
+ *
+ * @par Algorithm a text table is mapped into memory and its rows are split
+ *      straight from the mapping. A table this process is appending to, or
+ *      one that cannot be mapped, is read through the buffer pool. The
+ *      attributes come from the schema catalog, the attribute line is only
+ *      parsed when it is not the one the catalog holds
+ *
+ * @param [in] string filePath
+ *
+ * @return bool true if the file could be opened
+ *
+ * @note None
+ */
+bool TableScan::scanOpen( string filePath )
+{
+	scanPath = filePath;
+	currentRid = -1;
+	delta = writeAheadLog.walGetDelta( filePath );
+	insertCursor = 0;
+	indexScan = false;
+	indexRids.clear();
+	indexCursor = 0;
+	batchCount = 0;
+	batchCursor = 0;
+	rowsRead = 0;
+	rowsDeleted = 0;
+	tableEnd = false;
+	tableChanged = false;
+	signatureValid = tableSignatureOf( filePath, openSignature );
+	pageFormat = PageFile::isPageFile( filePath );
+	if( pageFormat )
+	{
+		if( !pageFile.pageFileOpen( filePath ) )
+		{
+			return false;
+		}
+		attributeData = pageFile.attributeData;
+	}
+	else if( mapping.mapOpen( filePath ) )
+	{
+		const char *data = mapping.mapData();
+		const char *newLine = (const char *)memchr( data, '\n', mapping.mapSize() );
+		mapCursor = newLine == NULL ? mapping.mapSize() : newLine - data;
+		const SchemaEntry &schema = schemaCatalog.catalogSchema( filePath, data, mapCursor, false );
+		attributeData = schema.attributeData;
+		attributes = schema.attributes;
+		mapCursor = newLine == NULL ? mapCursor : mapCursor + 1;
+		return true;
+	}
+	else
+	{
+		if( !reader.readerOpen( filePath ) )
+		{
+			return false;
+		}
+		reader.readLine( attributeData );
+	}
+
+	attributes = schemaCatalog.catalogSchema( filePath, attributeData.data(), attributeData.size(),
+												pageFormat ).attributes;
+	return true;
+}
+
+/**
+ * @brief scanRewrite
+ *
+ * @details lets scanUpdate and scanDelete change the rows of the scan, with
+ *          the result stored at outputPath
+ *
+ * @pre scanOpen was called and no row has been read yet
+ *
+ * @post scanClose installs the changed table at outputPath
+ *
+ * @par Algorithm page tables are changed in place, after copying the source
+ *      to outputPath if they differ, and their indexes follow every change.
+ *      Text tables stream every row that is kept into a scratch file that
+ *      replaces outputPath on close, their indexes are rebuilt after it
+ *
+ * @param [in] string outputPath
+ *
+ * @return bool false if the output could not be created
+ *
+ * @note None
+ */
+bool TableScan::scanRewrite( string outputPath )
+{
+	tableChanged = true;
+	if( pageFormat )
+	{
+		if( outputPath != scanPath )
+		{
+			pageFile.pageFileClose();
+			if( !copyFile( scanPath, outputPath ) || !pageFile.pageFileOpen( outputPath ) )
+			{
+				return false;
+			}
+			scanPath = outputPath;
+		}
+		maintainIndexes = indexes.indexesOpen( scanPath, &attributes );
+		return true;
+	}
+
+	rewritePath = outputPath;
+	rewriteOut.open( ( rewritePath + SCAN_SUFFIX ).c_str(), ofstream::out | ofstream::trunc );
+	rewriteOut << attributeData;
+	rewriting = rewriteOut.is_open();
+	return rewriting;
+}
+
+/**
+ * @brief scanLogChanges
+ *
+ * @details sends the changes of scanUpdate and scanDelete to the write ahead
+ *          log of the open transaction instead of the table file
+ *
+ * @pre scanOpen was called
+ *
+ * @post the table file is not changed by the scan
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::scanLogChanges()
+{
+	logging = true;
+}
+
+/**
+ * @brief scanSetDelta
+ *
+ * @details lays the given changes over the rows of the table
+ *
+ * @pre scanOpen was called and no row has been read yet
+ *
+ * @param [in] TableDelta *tableDelta changes to apply, NULL for none
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::scanSetDelta( TableDelta *tableDelta )
+{
+	delta = tableDelta;
+}
+
+/**
+ * @brief scanClose
+ *
+ * @details closes the table file, then its indexes
+ *
+ * @post a rewritten text table replaces the table unless writing it failed,
+ *       then the scratch file is removed and the table is left as it was
+ *
+ * @return bool false if the rewritten table could not be written
+ *
+ * @note None
+ */
+bool TableScan::scanClose()
+{
+	string countPath = scanPath;
+	bool written = true;
+	if( rewriting )
+	{
+		string scratchPath = rewritePath + SCAN_SUFFIX;
+		flushPending();
+		rewriteOut.close();
+		reader.readerClose();
+		mapping.mapClose();
+		rewriting = false;
+		written = rewriteOut.good() && rename( scratchPath.c_str(), rewritePath.c_str() ) == 0;
+		if( written )
+		{
+			refreshTableIndexes( rewritePath );
+			countPath = rewritePath;
+		}
+		else
+		{
+			remove( scratchPath.c_str() );
+			tableEnd = false;
+		}
+	}
+	reader.readerClose();
+	mapping.mapClose();
+	pageFile.pageFileClose();
+	indexes.indexesClose( true );
+	maintainIndexes = false;
+
+	//a scan that read the whole table counted its rows, a table it changed
+	//has the count from after the changes
+	TableSignature signature = openSignature;
+	if( tableEnd && ( delta == NULL || !tableChanged ) &&
+		( tableChanged ? tableSignatureOf( countPath, signature ) : signatureValid ) )
+	{
+		schemaCatalog.catalogSetRowCount( countPath, rowsRead - rowsDeleted, signature );
+	}
+	tableEnd = false;
+	return written;
+}
+
+/**
+ * @brief scanCancel
+ *
+ * @details closes the scan without replacing the table by its rewrite
+ *
+ * @pre no row was changed through the scan
+ *
+ * @post the table file and its indexes are as they were
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::scanCancel()
+{
+	if( rewriting )
+	{
+		rewriteOut.close();
+		remove( ( rewritePath + SCAN_SUFFIX ).c_str() );
+		rewriting = false;
+	}
+	tableChanged = false;
+	scanClose();
+}
+
+/**
+ * @brief flushPending
+ *
+ * @details writes the row read last to the rewrite output unless it was deleted
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::flushPending()
+{
+	if( pendingValid )
+	{
+		rewriteOut << endl;
+		rewriteOut.write( pendingStart, pendingLength );
+		pendingValid = false;
+	}
+}
+
+/**
+ * @brief scanSetWhere
+ *
+ * @details parses the where condition the scan filters with and compiles
+ *          it into a predicate for the column type
+ *
+ * @pre scanOpen was called so attributes are known
+ *
+ * @post rows are matched against whereType, an empty condition matches all.
+ *       When an index covers the condition only the rows it finds are read.
+ *       A condition with a syntax error matches no row
+ *
+ * @param [in] string whereType
+ *
+ * @param [out] string &error why the condition did not compile
+ *
+ * @return bool false on a syntax error, the statement is not run
+ *
+ * @note None
+ */
+bool TableScan::scanSetWhere( string whereType, string &error )
+{
+	removeLeadingWS( whereType );
+	whereExists = !whereType.empty();
+	delete predicate;
+	predicate = NULL;
+	accessPlan.whereSelectivity = 1;
+	accessPlan.conjuncts.clear();
+	accessPlan.candidates.clear();
+	accessPlan.candidateIndexes.clear();
+	accessPlan.chosen = -1;
+	if( whereExists )
+	{
+		predicate = compileWhere( whereType, attributes, conjuncts, error );
+		if( predicate == NULL )
+		{
+			predicate = new FalsePredicate;
+			return false;
+		}
+		accessPlan.whereSelectivity = predicate->selectivity();
+		accessPlan.conjuncts = conjuncts;
+		indexScan = useIndex();
+		if( indexScan )
+		{
+			mapping.mapAdvise( MAP_RANDOM );
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief useIndex
+ *
+ * @details looks up the rows of the where condition in an index when that
+ *          is cheaper than reading the whole table
+ *
+ * @pre scanSetWhere parsed the condition and no row has been read yet
+ *
+ * @post accessPlan holds the comparisons an index covers and the one
+ *       chosen, indexRids holds the row ids the index found in file order
+ *
+ * @par Algorithm each comparison that every matching row satisfies and an
+ *      index covers is costed by planAccessPath against a full scan. Rows
+ *      still pass the whole where condition when they are read. A table the
+ *      open transaction changed or a text table that is rewritten is read
+ *      in full
+ *
+ * @return bool false if the scan has to read the whole table
+ *
+ * @note None
+ */
+bool TableScan::useIndex()
+{
+	if( conjuncts.empty() || delta != NULL || rewriting ||
+		!indexes.indexesOpen( scanPath, &attributes ) )
+	{
+		return false;
+	}
+	for( unsigned int index = 0; index < conjuncts.size(); index++ )
+	{
+		const WhereCondition &wCond = conjuncts[ index ];
+		const string &op = wCond.operatorValue;
+		BTreeIndex *attrIndex = wCond.attributeIndex < 0 ? NULL : indexes.indexOn( wCond.attributeIndex );
+		string key;
+		if( attrIndex != NULL && attrIndex->keyType == indexKeyTypeOf( wCond ) &&
+			( op == "=" || op == "<" || op == "<=" || op == ">" || op == ">=" ) &&
+			attrIndex->indexKey( wCond.comparisonValue, key ) )
+		{
+			accessPlan.candidates.push_back( wCond );
+			accessPlan.candidateIndexes.push_back( attrIndex->indexName );
+		}
+	}
+	if( accessPlan.candidates.empty() )
+	{
+		return false;
+	}
+	planAccessPath( scanPath, accessPlan );
+	return accessPlan.chosen >= 0 && indexCondition( accessPlan.candidates[ accessPlan.chosen ] );
+}
+
+/**
+ * @brief indexCondition
+ *
+ * @details looks up the rows of one comparison in an index
+ *
+ * @par Algorithm =, <, <=, > and >= map to a range of keys. A key cut to
+ *      its prefix only widens the range
+ *
+ * @param [in] WhereCondition &wCond
+ *
+ * @return bool false if no index covers the comparison
+ *
+ * @note None
+ */
+bool TableScan::indexCondition( const WhereCondition &wCond )
+{
+	const string &op = wCond.operatorValue;
+	if( wCond.attributeIndex < 0 ||
+		( op != "=" && op != "<" && op != "<=" && op != ">" && op != ">=" ) )
+	{
+		return false;
+	}
+	BTreeIndex *index = indexes.indexOn( wCond.attributeIndex );
+	string key;
+	if( index == NULL || index->keyType != indexKeyTypeOf( wCond ) ||
+		!index->indexKey( wCond.comparisonValue, key ) )
+	{
+		return false;
+	}
+
+	bool cut = index->keyType == INDEX_TEXT_KEYS && wCond.comparisonValue.size() >= INDEX_MAX_KEY;
+	if( op == "=" )
+	{
+		index->indexRange( &key, true, &key, true, indexRids );
+	}
+	else if( op == "<" || op == "<=" )
+	{
+		index->indexRange( NULL, false, &key, op == "<=" || cut, indexRids );
+	}
+	else
+	{
+		index->indexRange( &key, op == ">=" || cut, NULL, false, indexRids );
+	}
+	sort( indexRids.begin(), indexRids.end() );
+	indexCursor = 0;
+	return true;
+}
+
+/**
+ * @brief scanIndexOn
+ *
+ * @details finds the index on a column of the table
+ *
+ * @pre scanOpen was called
+ *
+ * @param [in] int attributeIndex
+ *
+ * @return BTreeIndex* NULL if the column has no index
+ *
+ * @note None
+ */
+BTreeIndex *TableScan::scanIndexOn( int attributeIndex )
+{
+	if( !indexes.indexesOpen( scanPath, &attributes ) )
+	{
+		return NULL;
+	}
+	return indexes.indexOn( attributeIndex );
+}
+
+/**
+ * @brief scanLookup
+ *
+ * @details restarts the scan on the rows an index finds for one value
+ *
+ * @pre scanOpen was called, the scan has no where condition
+ *
+ * @post scanNext returns the rows found in file order and then ends, until
+ *       the next lookup
+ *
+ * @par Algorithm the index may find rows whose value only has the same key,
+ *      a float written another way or text cut to the same prefix, so the
+ *      caller compares the values again
+ *
+ * @param [in] int attributeIndex column looked up
+ *
+ * @param [in] string &value
+ *
+ * @return bool false if the column has no index, the value has no key or
+ *         the open transaction changed the table, the scan is unchanged
+ *
+ * @note None
+ */
+bool TableScan::scanLookup( int attributeIndex, const string &value )
+{
+	BTreeIndex *index = delta != NULL || rewriting ? NULL : scanIndexOn( attributeIndex );
+	string key;
+	if( index == NULL || !index->indexKey( value, key ) )
+	{
+		return false;
+	}
+	if( !indexScan )
+	{
+		mapping.mapAdvise( MAP_RANDOM );
+	}
+	indexRids.clear();
+	index->indexRange( &key, true, &key, true, indexRids );
+	sort( indexRids.begin(), indexRids.end() );
+	indexCursor = 0;
+	indexScan = true;
+	return true;
+}
+
+/**
+ * @brief scanSetProjection
+ *
+ * @details parses the select list into the columns the scan returns
+ *
+ * @pre scanOpen was called so attributes are known
+ *
+ * @post projection holds the index of every selected column
+ *
+ * @par Algorithm * selects every column, otherwise columns are comma separated
+ *      and unknown column names are skipped
+ *
+ * @param [in] string queryType
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::scanSetProjection( string queryType )
+{
+	projection.clear();
+	removeLeadingWS( queryType );
+	if( queryType == "*" )
+	{
+		int attributesSize = attributes.size();
+		for( int index = 0; index < attributesSize; index++ )
+		{
+			projection.push_back( index );
+		}
+		return;
+	}
+
+	int commaCount = getCommaCount( queryType );
+	for( int index = 0; index < commaCount + 1; index++ )
+	{
+		string temp = queryType.substr( 0, queryType.find( "," ) );
+		queryType.erase( 0, queryType.find( "," ) + 1 );
+		removeLeadingWS( temp );
+
+		int attrIndex = findAttrOccur( attributes, temp );
+		if( attrIndex >= 0 )
+		{
+			projection.push_back( attrIndex );
+		}
+	}
+}
+
+/**
+ * @brief scanNext
+ *
+ * @details reads the next record of the table
+ *
+ * @pre scanOpen was called
+ *
+ * @post row holds every column of the record
+ *
+ * @param [out] vector< string > &row
+ *
+ * @param [out] bool &rowMatches true if the row satisfies the where condition
+ *
+ * @return bool false once the end of the table is reached
+ *
+ * @note None
+ */
+bool TableScan::scanNext( vector< string > &row, bool &rowMatches )
+{
+	if( !nextRow( row ) )
+	{
+		return false;
+	}
+	rowMatches = rowMatchesWhere( row );
+	return true;
+}
+
+/**
+ * @brief nextRow
+ *
+ * @details reads the next record of the table as the open transaction
+ *          sees it
+ *
+ * @post currentRid identifies the row
+ *
+ * @par Algorithm the table file is read exactly once, rows the open
+ *      transaction changed are replaced or skipped and the rows it inserted
+ *      follow the last row of the file
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false once the end of the table is reached
+ *
+ * @note None
+ */
+bool TableScan::nextRow( vector< string > &row )
+{
+	while( nextTableRow( row ) )
+	{
+		if( !indexScan )
+		{
+			rowsRead++;
+		}
+		if( delta != NULL )
+		{
+			if( delta->deletedRows.count( currentRid ) )
+			{
+				continue;
+			}
+			map< long, vector< string > >::iterator updated = delta->updatedRows.find( currentRid );
+			if( updated != delta->updatedRows.end() )
+			{
+				row = updated->second;
+			}
+		}
+		return true;
+	}
+	tableEnd = !indexScan;
+
+	while( delta != NULL && insertCursor < delta->insertedRows.size() )
+	{
+		unsigned int index = insertCursor++;
+		if( delta->insertedLive[ index ] )
+		{
+			row = delta->insertedRows[ index ];
+			currentRid = -( (long)index + 1 );
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief nextTableRow
+ *
+ * @details reads the next row stored in the table file
+ *
+ * @post currentRid identifies the row
+ *
+ * @par Algorithm blank lines of a text table are skipped and do not count
+ *      as rows. An index scan reads only the rows the index found
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false at the end of the file
+ *
+ * @note None
+ */
+bool TableScan::nextTableRow( vector< string > &row )
+{
+	if( indexScan )
+	{
+		while( indexCursor < indexRids.size() )
+		{
+			currentRid = indexRids[ indexCursor++ ];
+			if( pageFormat )
+			{
+				if( pageFile.readRow( currentRid, row ) )
+				{
+					if( maintainIndexes )
+					{
+						currentRow = row;
+					}
+					return true;
+				}
+			}
+			else if( mapping.mapIsOpen() )
+			{
+				if( (size_t)currentRid < mapping.mapSize() && mapping.mapData()[ currentRid ] != '\n' )
+				{
+					const char *rowEnd = mapping.mapData() + mapping.mapSize();
+					splitRow( mapping.mapData() + currentRid, rowEnd, attributes.size(), row );
+					return true;
+				}
+			}
+			else if( reader.readerSeek( currentRid ) && reader.readLine( line ) && !line.empty() )
+			{
+				splitRow( line, attributes.size(), row );
+				return true;
+			}
+		}
+		return false;
+	}
+
+	if( pageFormat )
+	{
+		while( pageFile.scanNextRow( row, currentRid ) )
+		{
+			//rows an update moved further down the file were already seen
+			if( !movedRows.empty() && movedRows.count( currentRid ) )
+			{
+				continue;
+			}
+			if( maintainIndexes )
+			{
+				currentRow = row;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	if( rewriting )
+	{
+		flushPending();
+	}
+	if( mapping.mapIsOpen() )
+	{
+		return nextMappedRow( row );
+	}
+	off_t lineStart = reader.readerTell();
+	while( reader.readLine( line ) )
+	{
+		if( line.empty() )
+		{
+			lineStart = reader.readerTell();
+			continue;
+		}
+		currentRid = lineStart;
+		splitRow( line, attributes.size(), row );
+		if( rewriting )
+		{
+			pendingLine.swap( line );
+			pendingStart = pendingLine.data();
+			pendingLength = pendingLine.size();
+			pendingValid = true;
+		}
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief nextMappedRow
+ *
+ * @details splits the next text row of the mapped table file
+ *
+ * @par Algorithm blank lines are skipped. The cells are copied out of the
+ *      mapping into the strings of the row, the line itself is never copied.
+ *      A rewriting scan keeps where the line lies in the mapping to write it
+ *      out unchanged
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false at the end of the file
+ *
+ * @note None
+ */
+bool TableScan::nextMappedRow( vector< string > &row )
+{
+	const char *data = mapping.mapData();
+	const char *end = data + mapping.mapSize();
+
+	while( data + mapCursor < end )
+	{
+		const char *rowStart = data + mapCursor;
+		if( *rowStart == '\n' )
+		{
+			mapCursor++;
+			continue;
+		}
+		currentRid = mapCursor;
+		const char *next = splitRow( rowStart, end, attributes.size(), row );
+		mapCursor = next - data;
+		if( rewriting )
+		{
+			const char *rowEnd = next[ -1 ] == '\n' ? next - 1 : next;
+			pendingStart = rowStart;
+			pendingLength = rowEnd - rowStart;
+			pendingValid = true;
+		}
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief rowMatchesWhere
+ *
+ * @details checks a row against the where condition of the scan
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool true if there is no condition or the row satisfies it
+ *
+ * @note None
+ */
+bool TableScan::rowMatchesWhere( const vector< string > &row ) const
+{
+	return predicate == NULL || predicate->rowMatches( row );
+}
+
+/**
+ * @brief filterBatch
+ *
+ * @details checks a batch of rows against the where condition of the scan
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count rows of the batch in use
+ *
+ * @param [in/out] uint64_t *selection the bits of rows that do not satisfy
+ *                 the condition are cleared
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::filterBatch( const vector< vector< string > > &rows, unsigned int count,
+							uint64_t *selection ) const
+{
+	if( predicate != NULL )
+	{
+		predicate->filterBatch( rows, count, selection );
+	}
+}
+
+/**
+ * @brief scanUpdate
+ *
+ * @details replaces the row returned last by scanNext
+ *
+ * @pre scanRewrite or scanLogChanges was called
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::scanUpdate( const vector< string > &row )
+{
+	if( logging )
+	{
+		writeAheadLog.walUpdate( scanPath, currentRid, row );
+		return;
+	}
+	tableChanged = true;
+	if( pageFormat )
+	{
+		long rid = currentRid;
+		if( pageFile.updateRow( rid, row ) )
+		{
+			if( rid != currentRid )
+			{
+				movedRows.insert( rid );
+			}
+			if( maintainIndexes )
+			{
+				indexes.rowUpdated( currentRow, currentRid, row, rid );
+			}
+		}
+		return;
+	}
+	pendingLine = joinRow( row );
+	pendingStart = pendingLine.data();
+	pendingLength = pendingLine.size();
+}
+
+/**
+ * @brief scanDelete
+ *
+ * @details deletes the row returned last by scanNext
+ *
+ * @pre scanRewrite or scanLogChanges was called
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::scanDelete()
+{
+	if( logging )
+	{
+		writeAheadLog.walDelete( scanPath, currentRid );
+		return;
+	}
+	tableChanged = true;
+	rowsDeleted++;
+	if( pageFormat )
+	{
+		if( pageFile.deleteRow( currentRid ) && maintainIndexes )
+		{
+			indexes.rowDeleted( currentRow, currentRid );
+		}
+		return;
+	}
+	pendingValid = false;
+}
+
+/**
+ * @brief scanRowId
+ *
+ * @details returns the row id of the row returned last by scanNext
+ *
+ * @return long page and slot, the offset of a text row, or a negative id
+ *         for a row the open transaction inserted
+ *
+ * @note None
+ */
+long TableScan::scanRowId()
+{
+	return currentRid;
+}
+
+/**
+ * @brief scanPartitionable
+ *
+ * @details checks whether the rows of the scan can be read straight from
+ *          the table file in any order
+ *
+ * @return bool false if the scan reads through an index, overlays changes
+ *         of the open transaction or rewrites the table
+ *
+ * @note None
+ */
+bool TableScan::scanPartitionable()
+{
+	return !indexScan && delta == NULL && !rewriting && !logging && !maintainIndexes;
+}
+
+/**
+ * @brief scanNextSelected
+ *
+ * @details returns the next record that satisfies the where condition
+ *
+ * @pre scanOpen and scanSetProjection were called
+ *
+ * @post row holds the projected columns of the record, scanRowId does not
+ *       follow the rows returned since they are read a batch ahead
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return bool false once the end of the table is reached
+ *
+ * @note None
+ */
+bool TableScan::scanNextSelected( vector< string > &row )
+{
+	do
+	{
+		while( batchCursor < batchCount )
+		{
+			unsigned int rowIndex = batchCursor++;
+			if( rowSelected( &batchSelection[ 0 ], rowIndex ) )
+			{
+				const vector< string > &fullRow = batchRows[ rowIndex ];
+				int projectionSize = projection.size();
+				row.resize( projectionSize );
+				for( int index = 0; index < projectionSize; index++ )
+				{
+					row[ index ] = fullRow[ projection[ index ] ];
+				}
+				return true;
+			}
+		}
+	} while( nextBatch() );
+	return false;
+}
+
+/**
+ * @brief nextBatch
+ *
+ * @details reads the next FILTER_BATCH_ROWS records and filters them
+ *          against the where condition together
+ *
+ * @post batchSelection marks the rows that satisfy the condition
+ *
+ * @return bool false once the end of the table is reached
+ *
+ * @note None
+ */
+bool TableScan::nextBatch()
+{
+	if( batchRows.size() < FILTER_BATCH_ROWS )
+	{
+		batchRows.resize( FILTER_BATCH_ROWS );
+	}
+	batchCount = 0;
+	batchCursor = 0;
+	while( batchCount < FILTER_BATCH_ROWS && nextRow( batchRows[ batchCount ] ) )
+	{
+		batchCount++;
+	}
+	if( batchCount == 0 )
+	{
+		return false;
+	}
+	selectAll( batchSelection, batchCount );
+	filterBatch( batchRows, batchCount, &batchSelection[ 0 ] );
+	return true;
+}
+
+/**
+ * @brief outputHeader
+ *
+ * @details outputs the projected attributes as "-- a int|b float"
+ *
+ * @return None
+ *
+ * @note None
+ */
+void TableScan::outputHeader()
+{
+	int projectionSize = projection.size();
+	cout << "-- ";
+	for( int index = 0; index < projectionSize; index++ )
+	{
+		if( index != 0 )
+		{
+			cout << "|";
+		}
+		cout << attributes[ projection[ index ] ].attributeName << " ";
+		cout << attributes[ projection[ index ] ].attributeType;
+	}
+	cout << endl;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
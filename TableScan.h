@@ -0,0 +1,176 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file TableScan.h
+ *
+ * @brief Definition file for TableScan class
+ *
+ * @details Specifies all member methods of the TableScan class, the streaming
+ *          operator shared by select, update and delete
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include "Table.h"
+#include "PageFile.h"
+#include "SchemaCatalog.h"
+#include "MappedFile.h"
+#include "WriteAheadLog.h"
+#include "BTreeIndex.h"
+#include "WherePredicate.h"
+#include "FilterKernels.h"
+#include "TextTokenizer.h"
+#include "QueryPlanner.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TABLESCAN_H
+#define TABLESCAN_H
+
+//suffix of the scratch file a rewriting scan streams into before it is renamed
+const string SCAN_SUFFIX = "_scan_temp";
+
+class TableWriter{
+	public:
+		TableWriter();
+		~TableWriter();
+
+		bool writerCreate( string filePath, string attributeData, bool pageFormat );
+		bool writerAppend( string filePath );
+		bool writeRow( const vector< string > &row );
+		void writerClose();
+
+	private:
+		bool writerPageFormat;
+		PageFile pageFile;
+		ofstream fout;
+
+		//indexes of the table rows are appended to, text rows are found by
+		//the offset they start at
+		TableIndexes indexes;
+		off_t appendOffset;
+
+		//text table appended to, scans read it through the buffer pool
+		//until it is closed
+		string appendPath;
+
+		//table the rows go to and its number of rows with them, -1 when
+		//the catalog did not know it
+		string countPath;
+		int64_t countRows;
+};
+
+class TableScan{
+	public:
+		vector< Attribute > attributes;
+		string attributeData;
+		vector< int > projection;
+		bool pageFormat;
+
+		//how the where condition is read, planned when an index covers it
+		AccessPlan accessPlan;
+
+		TableScan();
+		~TableScan();
+
+		bool scanOpen( string filePath );
+		bool scanRewrite( string outputPath );
+		void scanLogChanges();
+		void scanSetDelta( TableDelta *tableDelta );
+		bool scanClose();
+		void scanCancel();
+		bool scanSetWhere( string whereType, string &error );
+		void scanSetProjection( string queryType );
+		BTreeIndex *scanIndexOn( int attributeIndex );
+		bool scanLookup( int attributeIndex, const string &value );
+		bool scanNext( vector< string > &row, bool &rowMatches );
+		bool scanNextSelected( vector< string > &row );
+		void scanUpdate( const vector< string > &row );
+		void scanDelete();
+		long scanRowId();
+		bool scanPartitionable();
+		bool rowMatchesWhere( const vector< string > &row ) const;
+		void filterBatch( const vector< vector< string > > &rows, unsigned int count,
+							uint64_t *selection ) const;
+		void outputHeader();
+
+	private:
+		string scanPath;
+		PoolReader reader;
+		string line;
+
+		//text tables are read straight from a mapping of the file when it
+		//is not being appended to, mapCursor is the offset of the next line
+		MappedFile mapping;
+		size_t mapCursor;
+		bool whereExists;
+		//the where condition compiled for the column types, NULL without
+		//one, and the comparisons of it every matching row satisfies
+		RowPredicate *predicate;
+		vector< WhereCondition > conjuncts;
+
+		//rows scanNextSelected read ahead and filtered together, the ones
+		//still selected are handed out from batchCursor on
+		vector< vector< string > > batchRows;
+		vector< uint64_t > batchSelection;
+		unsigned int batchCount;
+		unsigned int batchCursor;
+
+		//row id of the row read last, page and slot or the offset of the line
+		//of a text table
+		long currentRid;
+
+		//indexes of the table, the rows an index lookup found and the row
+		//read last when its indexes have to follow the changes to it
+		TableIndexes indexes;
+		bool indexScan;
+		vector< long > indexRids;
+		unsigned int indexCursor;
+		bool maintainIndexes;
+		vector< string > currentRow;
+
+		//page format cursor
+		PageFile pageFile;
+		set< long > movedRows;
+
+		//uncommitted changes laid over the table, and whether changes go to the log
+		TableDelta *delta;
+		unsigned int insertCursor;
+		bool logging;
+
+		//text format rewrite, the row read last is written when the scan moves on,
+		//from the mapping or from pendingLine
+		bool rewriting;
+		string rewritePath;
+		ofstream rewriteOut;
+		string pendingLine;
+		const char *pendingStart;
+		size_t pendingLength;
+		bool pendingValid;
+
+		//rows of the table file read and deleted, the signature it had when
+		//it was opened and whether the scan read all of it or changed it,
+		//so the row count of the catalog can follow
+		int64_t rowsRead;
+		int64_t rowsDeleted;
+		TableSignature openSignature;
+		bool signatureValid;
+		bool tableEnd;
+		bool tableChanged;
+
+		void flushPending();
+		bool nextRow( vector< string > &row );
+		bool nextTableRow( vector< string > &row );
+		bool nextMappedRow( vector< string > &row );
+		bool nextBatch();
+		bool useIndex();
+		bool indexCondition( const WhereCondition &wCond );
+};
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,1133 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file TableStatistics.cpp
+ *
+ * @brief Implementation file for StatisticsCatalog class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements table and column statistics. ANALYZE reads a table
+ *          once and records its row count and, for every column, the
+ *          smallest and largest value, the number of nulls, a HyperLogLog
+ *          sketch of the distinct values and an equi-depth histogram built
+ *          from a sample of the rows. Insert, update and delete then keep the
+ *          statistics up to date without reading the table again. The
+ *          statistics of a table are stored next to it in .<table>.stats,
+ *          which is written after a number of changed rows rather than by
+ *          every statement
+ *
+ * @Note Requires TableStatistics.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "TableStatistics.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TABLESTATISTICS_CPP
+#define TABLESTATISTICS_CPP
+
+//helper functions implemented in ExternalSort.cpp, BTreeIndex.cpp and Table.cpp
+int compareCells( const string &first, const string &second, SortValue valueType );
+bool tableSignatureOf( string tablePath, TableSignature &signature );
+bool caseInsCompare( const string &s1, const string &s2 );
+bool createLockFile( string lockPath );
+
+//helper functions implemented in WriteAheadLog.cpp
+void appendUint32( string &buffer, uint32_t value );
+void appendUint64( string &buffer, uint64_t value );
+void appendString( string &buffer, const string &value );
+bool takeUint32( const char *data, size_t length, size_t &position, uint32_t &value );
+bool takeUint64( const char *data, size_t length, size_t &position, uint64_t &value );
+bool takeString( const char *data, size_t length, size_t &position, string &value );
+uint32_t walChecksum( const char *data, size_t length );
+bool writeAll( int fileDesc, const string &buffer );
+
+StatisticsCatalog statisticsCatalog;
+
+/**
+ * @brief statisticsFilePath
+ *
+ * @details returns the file the statistics of a table are stored in
+ *
+ * @param [in] string &tablePath
+ *
+ * @param [in] string &suffix
+ *
+ * @return string the path .<table><suffix> next to the table
+ *
+ * @note None
+ */
+string statisticsFilePath( const string &tablePath, const string &suffix )
+{
+	size_t slash = tablePath.rfind( '/' );
+	string directory = tablePath.substr( 0, slash + 1 );
+	string tableName = tablePath.substr( slash + 1 );
+	return directory + "." + tableName + suffix;
+}
+
+/**
+ * @brief statisticsValueHash
+ *
+ * @details hashes a value of a column for its distinct count
+ *
+ * @par Algorithm numbers are hashed by value so 1 and 1.0 count once. The
+ *      string hash is finished with the splitmix64 mixer, since HyperLogLog
+ *      needs every bit of the hash to be random
+ *
+ * @param [in] string &value
+ *
+ * @param [in] SortValue valueType
+ *
+ * @return uint64_t
+ *
+ * @note None
+ */
+uint64_t statisticsValueHash( const string &value, SortValue valueType )
+{
+	hash< string > hashValue;
+	uint64_t mixed;
+	if( valueType == SORT_INTEGER )
+	{
+		long long number = strtoll( value.c_str(), NULL, 10 );
+		mixed = hashValue( string( (const char *)&number, sizeof( number ) ) );
+	}
+	else if( valueType == SORT_FLOAT )
+	{
+		double number = strtod( value.c_str(), NULL ) + 0.0;
+		mixed = hashValue( string( (const char *)&number, sizeof( number ) ) );
+	}
+	else
+	{
+		mixed = hashValue( value );
+	}
+	mixed = ( mixed ^ ( mixed >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+	mixed = ( mixed ^ ( mixed >> 27 ) ) * 0x94d049bb133111ebULL;
+	return mixed ^ ( mixed >> 31 );
+}
+
+/**
+ * @brief findHistogramBucket
+ *
+ * @details finds the bucket of a histogram a value falls in
+ *
+ * @par Algorithm binary search for the first bucket whose upper bound is not
+ *      below the value
+ *
+ * @param [in] ColumnStatistics &column
+ *
+ * @param [in] string &value
+ *
+ * @return unsigned int the number of buckets if the value is above them all
+ *
+ * @note None
+ */
+unsigned int findHistogramBucket( const ColumnStatistics &column, const string &value )
+{
+	unsigned int low = 0;
+	unsigned int high = column.histogram.size();
+	while( low < high )
+	{
+		unsigned int middle = ( low + high ) / 2;
+		if( compareCells( column.histogram[ middle ].upperBound, value, column.valueType ) < 0 )
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/**
+ * @brief addColumnValue
+ *
+ * @details adds one value to the statistics of a column
+ *
+ * @par Algorithm the register the top bits of the hash select keeps the
+ *      largest rank seen, the position of the first set bit in the rest of
+ *      the hash. A value above the histogram raises its last bound
+ *
+ * @param [in/out] ColumnStatistics &column
+ *
+ * @param [in] string &value
+ *
+ * @return None
+ *
+ * @note None
+ */
+void addColumnValue( ColumnStatistics &column, const string &value )
+{
+	if( isNullValue( value ) )
+	{
+		column.nullCount++;
+		return;
+	}
+
+	if( !column.hasRange )
+	{
+		column.minValue = column.maxValue = value;
+		column.hasRange = true;
+	}
+	else if( compareCells( value, column.minValue, column.valueType ) < 0 )
+	{
+		column.minValue = value;
+	}
+	else if( compareCells( value, column.maxValue, column.valueType ) > 0 )
+	{
+		column.maxValue = value;
+	}
+
+	uint64_t hashed = statisticsValueHash( value, column.valueType );
+	unsigned int registerIndex = hashed >> ( 64 - STATISTICS_REGISTER_BITS );
+	uint64_t rest = hashed << STATISTICS_REGISTER_BITS;
+	unsigned char rank = rest == 0 ? 64 - STATISTICS_REGISTER_BITS + 1 : __builtin_clzll( rest ) + 1;
+	if( (unsigned char)column.registers[ registerIndex ] < rank )
+	{
+		column.registers[ registerIndex ] = rank;
+	}
+
+	if( !column.histogram.empty() )
+	{
+		unsigned int bucket = findHistogramBucket( column, value );
+		if( bucket == column.histogram.size() )
+		{
+			bucket--;
+			column.histogram[ bucket ].upperBound = value;
+		}
+		column.histogram[ bucket ].rowCount++;
+	}
+}
+
+/**
+ * @brief removeColumnValue
+ *
+ * @details removes one value from the statistics of a column
+ *
+ * @par Algorithm the null count and the histogram bucket of the value are
+ *      lowered. The range and the sketch cannot forget a value, so they stay
+ *      as they were until the next ANALYZE
+ *
+ * @param [in/out] ColumnStatistics &column
+ *
+ * @param [in] string &value
+ *
+ * @return None
+ *
+ * @note None
+ */
+void removeColumnValue( ColumnStatistics &column, const string &value )
+{
+	if( isNullValue( value ) )
+	{
+		column.nullCount = max( column.nullCount - 1, (int64_t)0 );
+		return;
+	}
+	unsigned int bucket = findHistogramBucket( column, value );
+	if( bucket < column.histogram.size() && column.histogram[ bucket ].rowCount > 0 )
+	{
+		column.histogram[ bucket ].rowCount--;
+	}
+}
+
+/**
+ * @brief emptyColumnStatistics
+ *
+ * @details returns the statistics of a column without any values
+ *
+ * @param [in] Attribute &attribute
+ *
+ * @return ColumnStatistics
+ *
+ * @note None
+ */
+ColumnStatistics emptyColumnStatistics( const Attribute &attribute )
+{
+	ColumnStatistics column;
+	column.columnName = attribute.attributeName;
+	column.valueType = SORT_TEXT;
+	if( caseInsCompare( attribute.attributeType, "int" ) )
+	{
+		column.valueType = SORT_INTEGER;
+	}
+	else if( caseInsCompare( attribute.attributeType, "float" ) )
+	{
+		column.valueType = SORT_FLOAT;
+	}
+	column.nullCount = 0;
+	column.hasRange = false;
+	column.registers.assign( STATISTICS_REGISTERS, '\0' );
+	return column;
+}
+
+/**
+ * @brief applyStatisticsChange
+ *
+ * @details applies an inserted, deleted or updated row to the statistics of
+ *          its table
+ *
+ * @param [in/out] TableStatistics &statistics
+ *
+ * @param [in] StatisticsChange &change
+ *
+ * @return None
+ *
+ * @note None
+ */
+void applyStatisticsChange( TableStatistics &statistics, const StatisticsChange &change )
+{
+	if( change.columnIndex >= 0 )
+	{
+		if( change.columnIndex < (int)statistics.columns.size() )
+		{
+			removeColumnValue( statistics.columns[ change.columnIndex ], change.oldValues[ 0 ] );
+			addColumnValue( statistics.columns[ change.columnIndex ], change.newValues[ 0 ] );
+		}
+	}
+	else if( change.oldValues.empty() )
+	{
+		for( unsigned int index = 0; index < statistics.columns.size(); index++ )
+		{
+			addColumnValue( statistics.columns[ index ],
+							index < change.newValues.size() ? change.newValues[ index ] : "null" );
+		}
+		statistics.rowCount++;
+	}
+	else
+	{
+		for( unsigned int index = 0; index < statistics.columns.size(); index++ )
+		{
+			removeColumnValue( statistics.columns[ index ],
+								index < change.oldValues.size() ? change.oldValues[ index ] : "null" );
+		}
+		statistics.rowCount = max( statistics.rowCount - 1, (int64_t)0 );
+	}
+	statistics.modifiedRows++;
+}
+
+/**
+ * @brief recordStatisticsChange
+ *
+ * @details applies a row change to the statistics and keeps it until the
+ *          statistics are written
+ *
+ * @param [in/out] TableStatistics &statistics
+ *
+ * @param [in] StatisticsChange &change
+ *
+ * @return None
+ *
+ * @note None
+ */
+void recordStatisticsChange( TableStatistics &statistics, const StatisticsChange &change )
+{
+	applyStatisticsChange( statistics, change );
+	statistics.unsavedChanges.push_back( change );
+	statistics.unsavedRows++;
+}
+
+/**
+ * @brief statisticsAddRow
+ *
+ * @details adds an inserted row to the statistics of its table
+ *
+ * @param [in/out] TableStatistics &statistics
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void statisticsAddRow( TableStatistics &statistics, const vector< string > &row )
+{
+	StatisticsChange change;
+	change.columnIndex = -1;
+	change.newValues = row;
+	recordStatisticsChange( statistics, change );
+}
+
+/**
+ * @brief statisticsRemoveRow
+ *
+ * @details removes a deleted row from the statistics of its table
+ *
+ * @param [in/out] TableStatistics &statistics
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void statisticsRemoveRow( TableStatistics &statistics, const vector< string > &row )
+{
+	StatisticsChange change;
+	change.columnIndex = -1;
+	change.oldValues = row;
+	recordStatisticsChange( statistics, change );
+}
+
+/**
+ * @brief statisticsReplaceValue
+ *
+ * @details replaces the value of one column of an updated row in the
+ *          statistics of its table
+ *
+ * @param [in/out] TableStatistics &statistics
+ *
+ * @param [in] int columnIndex
+ *
+ * @param [in] string &oldValue
+ *
+ * @param [in] string &newValue
+ *
+ * @return None
+ *
+ * @note None
+ */
+void statisticsReplaceValue( TableStatistics &statistics, int columnIndex, const string &oldValue,
+								const string &newValue )
+{
+	if( columnIndex < 0 || columnIndex >= (int)statistics.columns.size() )
+	{
+		return;
+	}
+	StatisticsChange change;
+	change.columnIndex = columnIndex;
+	change.oldValues.assign( 1, oldValue );
+	change.newValues.assign( 1, newValue );
+	recordStatisticsChange( statistics, change );
+}
+
+/**
+ * @brief statisticsAddColumns
+ *
+ * @details adds the columns ALTER TABLE appended to a table, which are null
+ *          in every row
+ *
+ * @param [in/out] TableStatistics &statistics
+ *
+ * @param [in] vector< Attribute > &attributes all columns of the table
+ *
+ * @return None
+ *
+ * @note None
+ */
+void statisticsAddColumns( TableStatistics &statistics, const vector< Attribute > &attributes )
+{
+	for( unsigned int index = statistics.columns.size(); index < attributes.size(); index++ )
+	{
+		statistics.columns.push_back( emptyColumnStatistics( attributes[ index ] ) );
+		statistics.columns.back().nullCount = statistics.rowCount;
+	}
+}
+
+/**
+ * @brief statisticsDistinct
+ *
+ * @details estimates the number of distinct values of a column
+ *
+ * @par Algorithm the HyperLogLog estimate, the harmonic mean of 2 to the
+ *      power of each register scaled by the number of registers. While many
+ *      registers are still empty linear counting is more accurate and is
+ *      used instead. The estimate is at most the number of values
+ *
+ * @param [in] ColumnStatistics &column
+ *
+ * @param [in] int64_t rowCount of the table
+ *
+ * @return double
+ *
+ * @note None
+ */
+double statisticsDistinct( const ColumnStatistics &column, int64_t rowCount )
+{
+	double registerCount = STATISTICS_REGISTERS;
+	double sum = 0;
+	unsigned int emptyRegisters = 0;
+	for( unsigned int index = 0; index < column.registers.size(); index++ )
+	{
+		unsigned char rank = column.registers[ index ];
+		sum += ldexp( 1.0, -(int)rank );
+		emptyRegisters += rank == 0;
+	}
+
+	double estimate = 0.7213 / ( 1 + 1.079 / registerCount ) * registerCount * registerCount / sum;
+	if( estimate <= 2.5 * registerCount && emptyRegisters > 0 )
+	{
+		estimate = registerCount * log( registerCount / emptyRegisters );
+	}
+	double values = max( rowCount - column.nullCount, (int64_t)0 );
+	return min( estimate, values );
+}
+
+/**
+ * @brief buildHistogram
+ *
+ * @details builds the equi-depth histogram of a column from a sample
+ *
+ * @par Algorithm the sampled values are sorted and cut into buckets of the
+ *      same number of values. A bucket is widened over the copies of its
+ *      upper bound, so a value is in one bucket only. The counts are scaled
+ *      from the sample to all values of the column
+ *
+ * @param [in/out] ColumnStatistics &column
+ *
+ * @param [in] vector< string > &values the values of the sample, not null
+ *
+ * @param [in] int64_t valueCount the values of the column, not null
+ *
+ * @return None
+ *
+ * @note None
+ */
+void buildHistogram( ColumnStatistics &column, vector< string > &values, int64_t valueCount )
+{
+	SortValue valueType = column.valueType;
+	column.histogram.clear();
+	if( values.empty() )
+	{
+		return;
+	}
+	sort( values.begin(), values.end(), [ valueType ]( const string &first, const string &second )
+		{
+			return compareCells( first, second, valueType ) < 0;
+		} );
+
+	size_t bucketCount = min( (size_t)HISTOGRAM_BUCKETS, values.size() );
+	size_t start = 0;
+	int64_t scaledBefore = 0;
+	for( size_t bucket = 0; bucket < bucketCount && start < values.size(); bucket++ )
+	{
+		size_t end = max( ( bucket + 1 ) * values.size() / bucketCount, start + 1 ) - 1;
+		while( end + 1 < values.size() && compareCells( values[ end + 1 ], values[ end ], valueType ) == 0 )
+		{
+			end++;
+		}
+
+		//the counts are scaled by their running total so they add up
+		int64_t scaled = (int64_t)( (double)( end + 1 ) * valueCount / values.size() + 0.5 );
+		HistogramBucket entry;
+		entry.upperBound = values[ end ];
+		entry.rowCount = scaled - scaledBefore;
+		column.histogram.push_back( entry );
+		scaledBefore = scaled;
+		start = end + 1;
+	}
+}
+
+/**
+ * @brief encodeStatistics
+ *
+ * @details writes the statistics of a table to a buffer
+ *
+ * @par Algorithm a header, then one record framed as the log frames its
+ *      records, so a file cut off by a crash is detected
+ *
+ * @param [in] TableStatistics &statistics
+ *
+ * @param [out] string &buffer
+ *
+ * @return None
+ *
+ * @note None
+ */
+void encodeStatistics( const TableStatistics &statistics, string &buffer )
+{
+	string payload;
+	appendUint64( payload, (uint64_t)statistics.rowCount );
+	appendUint64( payload, (uint64_t)statistics.modifiedRows );
+	appendUint32( payload, statistics.columns.size() );
+	for( unsigned int index = 0; index < statistics.columns.size(); index++ )
+	{
+		const ColumnStatistics &column = statistics.columns[ index ];
+		appendString( payload, column.columnName );
+		payload += (char)column.valueType;
+		appendUint64( payload, (uint64_t)column.nullCount );
+		payload += (char)column.hasRange;
+		appendString( payload, column.minValue );
+		appendString( payload, column.maxValue );
+		appendString( payload, column.registers );
+		appendUint32( payload, column.histogram.size() );
+		for( unsigned int bucket = 0; bucket < column.histogram.size(); bucket++ )
+		{
+			appendString( payload, column.histogram[ bucket ].upperBound );
+			appendUint64( payload, (uint64_t)column.histogram[ bucket ].rowCount );
+		}
+	}
+
+	buffer.assign( STATISTICS_MAGIC, 4 );
+	appendUint32( buffer, STATISTICS_VERSION );
+	appendUint32( buffer, payload.size() );
+	appendUint32( buffer, walChecksum( payload.data(), payload.size() ) );
+	buffer.append( payload );
+}
+
+/**
+ * @brief decodeStatistics
+ *
+ * @details reads the statistics of a table from the contents of its file
+ *
+ * @param [in] string &data
+ *
+ * @param [out] TableStatistics &statistics
+ *
+ * @return bool false if the file is incomplete or damaged
+ *
+ * @note None
+ */
+bool decodeStatistics( const string &data, TableStatistics &statistics )
+{
+	uint32_t version;
+	uint32_t length;
+	uint32_t checksum;
+	size_t position = 4;
+	if( data.size() < (size_t)STATISTICS_HEADER_SIZE || memcmp( data.data(), STATISTICS_MAGIC, 4 ) != 0 ||
+		!takeUint32( data.data(), data.size(), position, version ) || version != STATISTICS_VERSION ||
+		!takeUint32( data.data(), data.size(), position, length ) ||
+		!takeUint32( data.data(), data.size(), position, checksum ) ||
+		data.size() - position != length || walChecksum( data.data() + position, length ) != checksum )
+	{
+		return false;
+	}
+
+	const char *payload = data.data() + position;
+	size_t offset = 0;
+	uint64_t value;
+	uint32_t columnCount;
+	if( !takeUint64( payload, length, offset, value ) )
+	{
+		return false;
+	}
+	statistics.rowCount = (int64_t)value;
+	if( !takeUint64( payload, length, offset, value ) )
+	{
+		return false;
+	}
+	statistics.modifiedRows = (int64_t)value;
+	statistics.unsavedRows = 0;
+	statistics.unsavedChanges.clear();
+	statistics.replaceFile = false;
+	if( !takeUint32( payload, length, offset, columnCount ) || columnCount > length )
+	{
+		return false;
+	}
+
+	statistics.columns.resize( columnCount );
+	for( unsigned int index = 0; index < columnCount; index++ )
+	{
+		ColumnStatistics &column = statistics.columns[ index ];
+		uint32_t bucketCount;
+		if( !takeString( payload, length, offset, column.columnName ) || offset >= length )
+		{
+			return false;
+		}
+		column.valueType = (SortValue)payload[ offset++ ];
+		if( !takeUint64( payload, length, offset, value ) || offset >= length )
+		{
+			return false;
+		}
+		column.nullCount = (int64_t)value;
+		column.hasRange = payload[ offset++ ] != 0;
+		if( !takeString( payload, length, offset, column.minValue ) ||
+			!takeString( payload, length, offset, column.maxValue ) ||
+			!takeString( payload, length, offset, column.registers ) ||
+			column.registers.size() != STATISTICS_REGISTERS ||
+			!takeUint32( payload, length, offset, bucketCount ) || bucketCount > length )
+		{
+			return false;
+		}
+		column.histogram.resize( bucketCount );
+		for( unsigned int bucket = 0; bucket < bucketCount; bucket++ )
+		{
+			if( !takeString( payload, length, offset, column.histogram[ bucket ].upperBound ) ||
+				!takeUint64( payload, length, offset, value ) )
+			{
+				return false;
+			}
+			column.histogram[ bucket ].rowCount = (int64_t)value;
+		}
+	}
+	return offset == length;
+}
+
+/**
+ * @brief StatisticsCatalog default constructor
+ *
+ * @details creates a catalog that has not read any statistics
+ *
+ * @note None
+ */
+StatisticsCatalog::StatisticsCatalog()
+{
+}
+
+/**
+ * @brief StatisticsCatalog default destructor
+ *
+ * @details writes the statistics that changed to their files
+ *
+ * @note None
+ */
+StatisticsCatalog::~StatisticsCatalog()
+{
+	statisticsFlush();
+}
+
+/**
+ * @brief statisticsOf
+ *
+ * @details returns the statistics of a table
+ *
+ * @par Algorithm the statistics read before are returned while the file
+ *      still has the signature it was read or written with, see
+ *      refreshStatistics
+ *
+ * @param [in] string &tablePath
+ *
+ * @return TableStatistics* NULL if the table has no statistics, valid until
+ *         the statistics of the table are dropped
+ *
+ * @note None
+ */
+TableStatistics *StatisticsCatalog::statisticsOf( const string &tablePath )
+{
+	return refreshStatistics( tablePath );
+}
+
+/**
+ * @brief statisticsToChange
+ *
+ * @details returns the statistics an insert, update or delete changes
+ *
+ * @par Algorithm inside a transaction the changes go to a copy of the
+ *      statistics that replaces them when the transaction commits, so the
+ *      statistics file never holds rows of a transaction that aborts
+ *
+ * @param [in] string &tablePath
+ *
+ * @param [in] bool beginTransaction
+ *
+ * @return TableStatistics* NULL if the table has no statistics
+ *
+ * @note None
+ */
+TableStatistics *StatisticsCatalog::statisticsToChange( const string &tablePath, bool beginTransaction )
+{
+	map< string, TableStatistics >::iterator found = transactionTables.find( tablePath );
+	if( found != transactionTables.end() )
+	{
+		return &found->second;
+	}
+	TableStatistics *statistics = statisticsOf( tablePath );
+	if( !beginTransaction || statistics == NULL )
+	{
+		return statistics;
+	}
+	return &( transactionTables[ tablePath ] = *statistics );
+}
+
+/**
+ * @brief statisticsCreate
+ *
+ * @details writes the statistics of a table that was just created
+ *
+ * @param [in] string &tablePath
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @return bool false if the statistics file cannot be written
+ *
+ * @note None
+ */
+bool StatisticsCatalog::statisticsCreate( const string &tablePath, const vector< Attribute > &attributes )
+{
+	TableStatistics &statistics = tables[ tablePath ];
+	statistics.rowCount = 0;
+	statistics.modifiedRows = 0;
+	statistics.unsavedRows = 0;
+	statistics.unsavedChanges.clear();
+	statistics.replaceFile = true;
+	statistics.columns.clear();
+	statisticsAddColumns( statistics, attributes );
+	return statisticsSave( tablePath );
+}
+
+/**
+ * @brief statisticsAnalyze
+ *
+ * @details reads a table and replaces its statistics
+ *
+ * @par Algorithm the range, null count and sketch of every column take in
+ *      every row. The histograms are built from a reservoir sample of the
+ *      rows, each row replacing a random one of the sample with falling
+ *      chance, so memory does not grow with the table. The random numbers
+ *      start from the same seed every time, so the same table gives the same
+ *      histograms
+ *
+ * @param [in] string &tablePath
+ *
+ * @param [in] bool beginTransaction the scan sees the rows of the open
+ *        transaction, so the statistics wait for it to commit
+ *
+ * @return bool false if the table cannot be read or the statistics written
+ *
+ * @note None
+ */
+bool StatisticsCatalog::statisticsAnalyze( const string &tablePath, bool beginTransaction )
+{
+	TableScan scan;
+	vector< string > row;
+	vector< vector< string > > sample;
+	bool rowMatches = false;
+	uint64_t random = 0x9e3779b97f4a7c15ULL;
+
+	if( !scan.scanOpen( tablePath ) )
+	{
+		return false;
+	}
+
+	TableStatistics statistics;
+	statistics.rowCount = 0;
+	statistics.modifiedRows = 0;
+	statistics.unsavedRows = 0;
+	statistics.replaceFile = true;
+	statisticsAddColumns( statistics, scan.attributes );
+	while( scan.scanNext( row, rowMatches ) )
+	{
+		for( unsigned int index = 0; index < statistics.columns.size(); index++ )
+		{
+			addColumnValue( statistics.columns[ index ], index < row.size() ? row[ index ] : "null" );
+		}
+		statistics.rowCount++;
+
+		if( sample.size() < STATISTICS_SAMPLE_ROWS )
+		{
+			sample.push_back( row );
+			continue;
+		}
+		random ^= random << 13;
+		random ^= random >> 7;
+		random ^= random << 17;
+		uint64_t slot = random % (uint64_t)statistics.rowCount;
+		if( slot < STATISTICS_SAMPLE_ROWS )
+		{
+			sample[ slot ].swap( row );
+		}
+	}
+	scan.scanClose();
+
+	for( unsigned int index = 0; index < statistics.columns.size(); index++ )
+	{
+		ColumnStatistics &column = statistics.columns[ index ];
+		vector< string > values;
+		for( unsigned int sampled = 0; sampled < sample.size(); sampled++ )
+		{
+			if( index < sample[ sampled ].size() && !isNullValue( sample[ sampled ][ index ] ) )
+			{
+				values.push_back( sample[ sampled ][ index ] );
+			}
+		}
+		buildHistogram( column, values, statistics.rowCount - column.nullCount );
+	}
+
+	if( beginTransaction )
+	{
+		statistics.unsavedRows = 1;
+		transactionTables[ tablePath ] = statistics;
+		return true;
+	}
+	transactionTables.erase( tablePath );
+	tables[ tablePath ] = statistics;
+	return statisticsSave( tablePath );
+}
+
+/**
+ * @brief statisticsSave
+ *
+ * @details writes the statistics of a table to its file
+ *
+ * @pre the statistics were returned by statisticsOf or statisticsCreate,
+ *      the table is locked
+ *
+ * @par Algorithm changes are first applied to the file as another process
+ *      may have left it, see refreshStatistics. The statistics are written
+ *      to a scratch file that then replaces the file, so a reader never sees
+ *      half of them
+ *
+ * @param [in] string &tablePath
+ *
+ * @return bool false if the file cannot be written
+ *
+ * @note None
+ */
+bool StatisticsCatalog::statisticsSave( const string &tablePath )
+{
+	map< string, TableStatistics >::iterator found = tables.find( tablePath );
+	if( found == tables.end() || ( !found->second.replaceFile && refreshStatistics( tablePath ) == NULL ) )
+	{
+		return false;
+	}
+
+	string buffer;
+	string newPath = statisticsFilePath( tablePath, STATISTICS_NEW_SUFFIX );
+	string statisticsPath = statisticsFilePath( tablePath, STATISTICS_SUFFIX );
+	encodeStatistics( found->second, buffer );
+	int fileDesc = open( newPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	bool success = writeAll( fileDesc, buffer );
+	close( fileDesc );
+	if( !success || rename( newPath.c_str(), statisticsPath.c_str() ) != 0 ||
+		!tableSignatureOf( statisticsPath, found->second.fileSignature ) )
+	{
+		unlink( newPath.c_str() );
+		tables.erase( found );
+		return false;
+	}
+	found->second.unsavedRows = 0;
+	found->second.unsavedChanges.clear();
+	found->second.replaceFile = false;
+	return true;
+}
+
+/**
+ * @brief statisticsChanged
+ *
+ * @details notes that insert, update or delete changed the statistics of a
+ *          table
+ *
+ * @pre the statistics were returned by statisticsToChange
+ *
+ * @par Algorithm writing the file takes longer than a single row insert, so
+ *      the statistics are written once enough rows changed and when the
+ *      process ends. Changes lost in a crash only make the statistics less
+ *      accurate until the next ANALYZE. Changes of the open transaction wait
+ *      for statisticsCommit
+ *
+ * @param [in] string &tablePath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void StatisticsCatalog::statisticsChanged( const string &tablePath )
+{
+	map< string, TableStatistics >::iterator found = tables.find( tablePath );
+	if( transactionTables.count( tablePath ) == 0 && found != tables.end() &&
+		found->second.unsavedRows >= STATISTICS_SAVE_ROWS )
+	{
+		statisticsSave( tablePath );
+	}
+}
+
+/**
+ * @brief statisticsCommit
+ *
+ * @details writes the statistics the committed transaction changed
+ *
+ * @pre the changes of the transaction are in the log
+ *
+ * @return None
+ *
+ * @note None
+ */
+void StatisticsCatalog::statisticsCommit()
+{
+	for( map< string, TableStatistics >::iterator table = transactionTables.begin();
+		table != transactionTables.end(); table++ )
+	{
+		if( table->second.unsavedRows > 0 )
+		{
+			tables[ table->first ] = table->second;
+			statisticsSave( table->first );
+		}
+	}
+	transactionTables.clear();
+}
+
+/**
+ * @brief statisticsAbort
+ *
+ * @details forgets the statistics the aborted transaction changed
+ *
+ * @return None
+ *
+ * @note None
+ */
+void StatisticsCatalog::statisticsAbort()
+{
+	transactionTables.clear();
+}
+
+/**
+ * @brief statisticsDrop
+ *
+ * @details removes the statistics of a dropped table
+ *
+ * @param [in] string &tablePath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void StatisticsCatalog::statisticsDrop( const string &tablePath )
+{
+	tables.erase( tablePath );
+	transactionTables.erase( tablePath );
+	unlink( statisticsFilePath( tablePath, STATISTICS_SUFFIX ).c_str() );
+}
+
+/**
+ * @brief statisticsFlush
+ *
+ * @details writes the statistics that changed since they were last written
+ *
+ * @par Algorithm statistics of a table that no longer exists, such as one
+ *      whose database was dropped, are left out. Every table is locked
+ *      while its statistics are written, unless this process already holds
+ *      the lock. The changes of a table another process has locked are left
+ *      out too, so they cannot overwrite its statistics, until the next
+ *      ANALYZE
+ *
+ * @return None
+ *
+ * @note None
+ */
+void StatisticsCatalog::statisticsFlush()
+{
+	TableSignature signature;
+	vector< string > changedTables;
+	for( map< string, TableStatistics >::iterator table = tables.begin(); table != tables.end(); table++ )
+	{
+		if( table->second.unsavedRows > 0 && tableSignatureOf( table->first, signature ) )
+		{
+			changedTables.push_back( table->first );
+		}
+	}
+	for( unsigned int index = 0; index < changedTables.size(); index++ )
+	{
+		string lockPath = changedTables[ index ] + "_temp";
+		if( createLockFile( lockPath ) )
+		{
+			statisticsSave( changedTables[ index ] );
+			unlink( lockPath.c_str() );
+			continue;
+		}
+
+		//a transaction this process left open holds the lock
+		int owner = 0;
+		ifstream fin( lockPath.c_str() );
+		if( fin >> owner && owner == (int)getpid() )
+		{
+			statisticsSave( changedTables[ index ] );
+		}
+	}
+}
+
+/**
+ * @brief refreshStatistics
+ *
+ * @details returns the statistics of a table as they are in its file
+ *
+ * @par Algorithm the statistics read before are returned while the file
+ *      still has the signature it was read or written with. Otherwise
+ *      another process wrote it, the file is read again and the changes of
+ *      this process not yet written are applied once more, so neither
+ *      process loses the rows of the other
+ *
+ * @param [in] string &tablePath
+ *
+ * @return TableStatistics* NULL if the table has no statistics
+ *
+ * @note None
+ */
+TableStatistics *StatisticsCatalog::refreshStatistics( const string &tablePath )
+{
+	TableSignature signature;
+	map< string, TableStatistics >::iterator found = tables.find( tablePath );
+	if( !tableSignatureOf( statisticsFilePath( tablePath, STATISTICS_SUFFIX ), signature ) )
+	{
+		tables.erase( tablePath );
+		return NULL;
+	}
+	if( found != tables.end() && memcmp( &found->second.fileSignature, &signature, sizeof( signature ) ) == 0 )
+	{
+		return &found->second;
+	}
+
+	TableStatistics statistics;
+	if( !loadStatistics( tablePath, statistics ) )
+	{
+		tables.erase( tablePath );
+		return NULL;
+	}
+	if( found != tables.end() )
+	{
+		for( unsigned int index = 0; index < found->second.unsavedChanges.size(); index++ )
+		{
+			applyStatisticsChange( statistics, found->second.unsavedChanges[ index ] );
+		}
+		statistics.unsavedChanges.swap( found->second.unsavedChanges );
+		statistics.unsavedRows = found->second.unsavedRows;
+	}
+	statistics.fileSignature = signature;
+	TableStatistics &stored = tables[ tablePath ];
+	stored = statistics;
+	return &stored;
+}
+
+/**
+ * @brief loadStatistics
+ *
+ * @details reads the statistics file of a table
+ *
+ * @param [in] string &tablePath
+ *
+ * @param [out] TableStatistics &statistics
+ *
+ * @return bool false if there is no file or it is damaged
+ *
+ * @note None
+ */
+bool StatisticsCatalog::loadStatistics( const string &tablePath, TableStatistics &statistics )
+{
+	struct stat buffer;
+	string data;
+	int fileDesc = open( statisticsFilePath( tablePath, STATISTICS_SUFFIX ).c_str(), O_RDONLY );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	if( fstat( fileDesc, &buffer ) == 0 && buffer.st_size > 0 )
+	{
+		data.resize( buffer.st_size );
+		if( pread( fileDesc, &data[ 0 ], data.size(), 0 ) != (ssize_t)data.size() )
+		{
+			data.clear();
+		}
+	}
+	close( fileDesc );
+	return decodeStatistics( data, statistics );
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,122 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file TableStatistics.h
+ *
+ * @brief Definition file for StatisticsCatalog class
+ *
+ * @details Specifies the statistics kept for every table, its row count and
+ *          the range, null count, distinct count and histogram of each
+ *          column, and the StatisticsCatalog class that reads and writes them
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <stdint.h>
+#include "Table.h"
+#include "BTreeIndex.h"
+#include "ExternalSort.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TABLESTATISTICS_H
+#define TABLESTATISTICS_H
+
+//statistics file kept next to every table, .<table>.stats, and the file it
+//is written to before it replaces the statistics
+const string STATISTICS_SUFFIX = ".stats";
+const string STATISTICS_NEW_SUFFIX = ".stats_new";
+const char STATISTICS_MAGIC[] = "TSTA";
+const uint32_t STATISTICS_VERSION = 1;
+const int STATISTICS_HEADER_SIZE = 8;
+
+//HyperLogLog registers of a column, addressed by the top bits of the hash
+//of a value
+const int STATISTICS_REGISTER_BITS = 10;
+const unsigned int STATISTICS_REGISTERS = 1 << STATISTICS_REGISTER_BITS;
+
+//changed rows of a table kept in memory before its statistics are written
+const int64_t STATISTICS_SAVE_ROWS = 1000;
+
+//buckets of an equi-depth histogram and rows of the sample it is built from
+const unsigned int HISTOGRAM_BUCKETS = 32;
+const unsigned int STATISTICS_SAMPLE_ROWS = 30000;
+
+//one bucket of a histogram, the rows whose value is above the bound of the
+//bucket before and at most upperBound
+struct HistogramBucket{
+	string upperBound;
+	int64_t rowCount;
+};
+
+//statistics of one column. The range holds only when hasRange is set, a
+//deleted value leaves the range and the distinct count as they were
+struct ColumnStatistics{
+	string columnName;
+	SortValue valueType;
+	int64_t nullCount;
+	bool hasRange;
+	string minValue;
+	string maxValue;
+	string registers;
+	vector< HistogramBucket > histogram;
+};
+
+//a row change not yet written to the statistics file. An insert has no old
+//values, a delete no new values and an update one of each for columnIndex
+struct StatisticsChange{
+	int columnIndex;
+	vector< string > oldValues;
+	vector< string > newValues;
+};
+
+//statistics of one table and the rows inserted, updated or deleted since
+//ANALYZE last read it and since the statistics were last written, the
+//signature is that of the statistics file. The changes not yet written are
+//kept to be applied again when another process wrote the file meanwhile,
+//unless ANALYZE replaced the statistics as a whole
+struct TableStatistics{
+	int64_t rowCount;
+	int64_t modifiedRows;
+	int64_t unsavedRows;
+	vector< ColumnStatistics > columns;
+	TableSignature fileSignature;
+	vector< StatisticsChange > unsavedChanges;
+	bool replaceFile;
+};
+
+class StatisticsCatalog{
+	public:
+		StatisticsCatalog();
+		~StatisticsCatalog();
+
+		TableStatistics *statisticsOf( const string &tablePath );
+		TableStatistics *statisticsToChange( const string &tablePath, bool beginTransaction );
+		bool statisticsCreate( const string &tablePath, const vector< Attribute > &attributes );
+		bool statisticsAnalyze( const string &tablePath, bool beginTransaction );
+		bool statisticsSave( const string &tablePath );
+		void statisticsChanged( const string &tablePath );
+		void statisticsCommit();
+		void statisticsAbort();
+		void statisticsDrop( const string &tablePath );
+		void statisticsFlush();
+
+	private:
+		//statistics read or written by this process, by table file
+		map< string, TableStatistics > tables;
+		//statistics changed by the open transaction, written when it commits
+		map< string, TableStatistics > transactionTables;
+
+		bool loadStatistics( const string &tablePath, TableStatistics &statistics );
+		TableStatistics *refreshStatistics( const string &tablePath );
+};
+
+//the statistics of the process
+extern StatisticsCatalog statisticsCatalog;
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,298 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file TextTokenizer.cpp
+ *
+ * @brief Implementation file for the text table tokenizer
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the delimiter scanner of the text table format. A row
+ *          is split in one pass over its bytes, comparing 32 of them with
+ *          both a tab and a newline per instruction with AVX2, or 16 with
+ *          SSE2, on the instruction set FilterKernels.cpp detected. The
+ *          positions found come back as a bitmask, one bit per byte
+ *
+ * @Note Requires TextTokenizer.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <stdint.h>
+#include "TextTokenizer.h"
+
+#ifdef FILTER_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TEXTTOKENIZER_CPP
+#define TEXTTOKENIZER_CPP
+
+/**
+ * @brief delimiterMaskScalar
+ *
+ * @details marks the tabs and newlines of a block one byte at a time
+ *
+ * @param [in] const char *block
+ *
+ * @param [in] size_t length at most TOKENIZER_BLOCK_BYTES
+ *
+ * @return uint64_t bit n set if byte n is a delimiter
+ *
+ * @note None
+ */
+uint64_t delimiterMaskScalar( const char *block, size_t length )
+{
+	uint64_t mask = 0;
+	for( size_t index = 0; index < length; index++ )
+	{
+		if( block[ index ] == '\t' || block[ index ] == '\n' )
+		{
+			mask |= (uint64_t)1 << index;
+		}
+	}
+	return mask;
+}
+
+#ifdef FILTER_X86
+
+//a block of each delimiter, loaded whole instead of broadcast on every call
+const char TAB_BYTES[ 32 ] = {
+	'\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t',
+	'\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t' };
+const char NEWLINE_BYTES[ 32 ] = {
+	'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n',
+	'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n' };
+
+/**
+ * @brief delimiterMaskSse
+ *
+ * @details marks the tabs and newlines of a block 16 bytes at a time
+ *
+ * @param [in] const char *block TOKENIZER_BLOCK_BYTES long
+ *
+ * @return uint64_t bit n set if byte n is a delimiter
+ *
+ * @note None
+ */
+__attribute__(( target( "sse2" ) ))
+uint64_t delimiterMaskSse( const char *block )
+{
+	const __m128i tabs = _mm_loadu_si128( (const __m128i *)TAB_BYTES );
+	const __m128i newLines = _mm_loadu_si128( (const __m128i *)NEWLINE_BYTES );
+	uint64_t mask = 0;
+	for( unsigned int offset = 0; offset < TOKENIZER_BLOCK_BYTES; offset += 16 )
+	{
+		__m128i bytes = _mm_loadu_si128( (const __m128i *)( block + offset ) );
+		uint64_t found = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( bytes, tabs ),
+														  _mm_cmpeq_epi8( bytes, newLines ) ) );
+		mask |= found << offset;
+	}
+	return mask;
+}
+
+/**
+ * @brief delimiterMaskAvx
+ *
+ * @details marks the tabs and newlines of a block 32 bytes at a time, the
+ *          upper halves of the registers are cleared before returning to
+ *          code built without AVX, which would otherwise stall on them
+ *
+ * @param [in] const char *block TOKENIZER_BLOCK_BYTES long
+ *
+ * @return uint64_t bit n set if byte n is a delimiter
+ *
+ * @note None
+ */
+__attribute__(( target( "avx2" ) ))
+uint64_t delimiterMaskAvx( const char *block )
+{
+	const __m256i tabs = _mm256_loadu_si256( (const __m256i *)TAB_BYTES );
+	const __m256i newLines = _mm256_loadu_si256( (const __m256i *)NEWLINE_BYTES );
+	__m256i low = _mm256_loadu_si256( (const __m256i *)block );
+	__m256i high = _mm256_loadu_si256( (const __m256i *)( block + 32 ) );
+	uint64_t lowMask = (uint32_t)_mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( low, tabs ),
+																		 _mm256_cmpeq_epi8( low, newLines ) ) );
+	uint64_t highMask = (uint32_t)_mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( high, tabs ),
+																		  _mm256_cmpeq_epi8( high, newLines ) ) );
+	_mm256_zeroupper();
+	return lowMask | highMask << 32;
+}
+
+#endif
+
+/**
+ * @brief delimiterMask
+ *
+ * @details marks the tabs and newlines of a block with the widest
+ *          instruction set of the CPU
+ *
+ * @param [in] const char *block
+ *
+ * @param [in] size_t length at most TOKENIZER_BLOCK_BYTES, a shorter block
+ *             at the end of a buffer is copied into a block of zeros first,
+ *             so no byte past the buffer is read
+ *
+ * @return uint64_t bit n set if byte n is a delimiter
+ *
+ * @note None
+ */
+uint64_t delimiterMask( const char *block, size_t length )
+{
+#ifdef FILTER_X86
+	char padded[ TOKENIZER_BLOCK_BYTES ];
+	if( length < TOKENIZER_BLOCK_BYTES )
+	{
+		memset( padded, 0, sizeof( padded ) );
+		memcpy( padded, block, length );
+		block = padded;
+	}
+	if( cpuInstructions == FILTER_AVX2 )
+	{
+		return delimiterMaskAvx( block );
+	}
+	return delimiterMaskSse( block );
+#else
+	return delimiterMaskScalar( block, length );
+#endif
+}
+
+/**
+ * @brief findDelimiter
+ *
+ * @details finds the first tab or newline of a buffer
+ *
+ * @param [in] const char *start
+ *
+ * @param [in] const char *end
+ *
+ * @return const char * the delimiter, or end if there is none
+ *
+ * @note None
+ */
+const char *findDelimiter( const char *start, const char *end )
+{
+	while( start < end )
+	{
+		size_t length = end - start < (ptrdiff_t)TOKENIZER_BLOCK_BYTES ? end - start : TOKENIZER_BLOCK_BYTES;
+		uint64_t mask = delimiterMask( start, length );
+		if( mask != 0 )
+		{
+			return start + __builtin_ctzll( mask );
+		}
+		start += length;
+	}
+	return end;
+}
+
+/**
+ * @brief splitRow
+ *
+ * @details splits the row starting at start into its cells, copied from the
+ *          buffer straight into the strings the row already holds
+ *
+ * @pre start is the first byte of a row
+ *
+ * @post row holds exactly numCells values, missing cells are empty and the
+ *       last cell holds the rest of the row, tabs included
+ *
+ * @par Algorithm the row is read a block at a time, each block is turned
+ *      into a mask of its delimiters and every set bit ends a cell, so a
+ *      block of short cells costs one comparison. A block without any
+ *      delimiter is part of a long cell, that cell and the rest of the
+ *      row are searched with memchr. Tabs in the last cell are passed over, a newline
+ *      ends the row
+ *
+ * @param [in] const char *start
+ *
+ * @param [in] const char *end end of the buffer, a row may end there
+ *             without a newline
+ *
+ * @param [in] int numCells
+ *
+ * @param [out] vector< string > &row
+ *
+ * @return const char * the first byte after the newline of the row
+ *
+ * @note None
+ */
+const char *splitRow( const char *start, const char *end, int numCells, vector< string > &row )
+{
+	const char *cellStart = start;
+	const char *rowEnd = end;
+	const char *next = end;
+	const char *lineEnd = NULL;
+	bool wideRow = false;
+	int index = 0;
+
+	row.resize( numCells );
+	string *cells = numCells == 0 ? NULL : &row[ 0 ];
+	const char *block = start;
+	while( block < end && next == end )
+	{
+		size_t length = 0;
+		uint64_t mask = 0;
+		if( !wideRow )
+		{
+			length = end - block < (ptrdiff_t)TOKENIZER_BLOCK_BYTES ? end - block : TOKENIZER_BLOCK_BYTES;
+			mask = delimiterMask( block, length );
+		}
+		if( mask == 0 )
+		{
+			//a long cell, memchr runs to its end faster than block masks and
+			//is used for the rest of the row
+			wideRow = true;
+			block += length;
+			if( lineEnd == NULL )
+			{
+				lineEnd = (const char *)memchr( block, '\n', end - block );
+				lineEnd = lineEnd == NULL ? end : lineEnd;
+			}
+			const char *tab = NULL;
+			if( index < numCells - 1 )
+			{
+				tab = (const char *)memchr( block, '\t', lineEnd - block );
+			}
+			if( tab == NULL )
+			{
+				rowEnd = lineEnd;
+				next = lineEnd == end ? end : lineEnd + 1;
+				break;
+			}
+			cells[ index++ ].assign( cellStart, tab - cellStart );
+			cellStart = block = tab + 1;
+			continue;
+		}
+		while( mask != 0 )
+		{
+			const char *delimiter = block + __builtin_ctzll( mask );
+			mask &= mask - 1;
+			if( *delimiter == '\n' )
+			{
+				rowEnd = delimiter;
+				next = delimiter + 1;
+				break;
+			}
+			if( index < numCells - 1 )
+			{
+				cells[ index++ ].assign( cellStart, delimiter - cellStart );
+				cellStart = delimiter + 1;
+			}
+		}
+		block += length;
+	}
+
+	for( ; index < numCells; index++ )
+	{
+		cells[ index ].assign( cellStart, rowEnd - cellStart );
+		cellStart = rowEnd;
+	}
+	return next;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,35 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file TextTokenizer.h
+ *
+ * @brief Definition file for the text table tokenizer
+ *
+ * @details Specifies the scanner that finds the tabs and newlines of a
+ *          buffer of text table rows and splits the rows it holds into
+ *          cells without copying each line out first
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+#include "FilterKernels.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef TEXTTOKENIZER_H
+#define TEXTTOKENIZER_H
+
+//bytes the scanner looks at together, one bit of a delimiter mask each
+const size_t TOKENIZER_BLOCK_BYTES = 64;
+
+uint64_t delimiterMask( const char *block, size_t length );
+const char *findDelimiter( const char *start, const char *end );
+const char *splitRow( const char *start, const char *end, int numCells, vector< string > &row );
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
@@ -0,0 +1,25 @@
+--CS457 transaction statistics
+
+--Statistics change only when the transaction that changed the table commits
+
+CREATE DATABASE Counted;
+USE Counted;
+
+create table Items (id int, name varchar(10));
+insert into Items values(1, 'one');
+insert into Items values(2, 'two');
+ANALYZE Items;
+.STATISTICS Items
+
+begin transaction;
+insert into Items values(3, 'three');
+update Items set name = 'uno' where id = 1;
+delete from Items where id = 2;
+.STATISTICS Items
+ANALYZE Items;
+.STATISTICS Items
+commit;
+.STATISTICS Items
+
+DROP DATABASE Counted;
+.EXIT
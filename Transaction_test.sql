@@ -0,0 +1,33 @@
+--CS457 transaction overlay
+
+--Rows changed in an open transaction must print the same before and after commit
+
+CREATE DATABASE Overlay;
+USE Overlay;
+
+create table Pages (id int, price float, note varchar(10)) STORAGE PAGE;
+create table Lines (id int, price float, note varchar(10));
+
+insert into Pages values(1, 1.0, 'first');
+insert into Pages values(2, 2.5, NULL);
+insert into Lines values(1, 1.0, 'first');
+insert into Lines values(2, 2.5, NULL);
+
+begin transaction;
+insert into Pages values(3, 3.50, NULL);
+insert into Pages values(007, 1e2, '');
+update Pages set price = 4.0 where id = 1;
+delete from Pages where id = 2;
+insert into Lines values(3, 3.50, NULL);
+insert into Lines values(007, 1e2, '');
+update Lines set price = 4.0 where id = 1;
+delete from Lines where id = 2;
+select * from Pages;
+select * from Lines;
+commit;
+
+select * from Pages;
+select * from Lines;
+
+DROP DATABASE Overlay;
+.EXIT
@@ -0,0 +1,1408 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file WherePredicate.cpp
+ *
+ * @brief Implementation file for the RowPredicate classes
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the compiled where condition. The operator and the
+ *          column type are resolved once, into one of the ColumnPredicate
+ *          instantiations, and the comparison value is parsed once. Float
+ *          columns compare as doubles and int columns as 64 bit integers,
+ *          every other column compares its text, the same way indexes order
+ *          their keys. Compound clauses are parsed by recursive descent, NOT
+ *          binding tighter than AND and AND tighter than OR, and the terms of
+ *          every AND and OR are ordered by their estimated cost and
+ *          selectivity. A batch of rows is filtered into a selection bitmap
+ *          one term at a time, float and int comparisons run through the
+ *          vector kernels of FilterKernels.cpp
+ *
+ * @Note Requires WherePredicate.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <stdint.h>
+#include "WherePredicate.h"
+#include "FilterKernels.cpp"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef WHEREPREDICATE_CPP
+#define WHEREPREDICATE_CPP
+
+//helper functions implemented in Table.cpp
+int findAttrOccur( vector< Attribute > attributes, string attrName );
+bool isAttrFloat( vector< Attribute > attributes, string attrName );
+bool isAttrInt( vector< Attribute > attributes, string attrName );
+bool caseInsCompare( const string &s1, const string &s2 );
+
+//float columns, the cell is parsed as it is compared
+template<>
+struct CellValue< double >{
+	static const double compareCost;
+
+	static double parse( const string &cell )
+	{
+		return strtod( cell.c_str(), NULL );
+	}
+};
+
+const double CellValue< double >::compareCost = FLOAT_COMPARE_COST;
+
+//int columns, compared as numbers like their sort order and index keys
+template<>
+struct CellValue< long long >{
+	static const double compareCost;
+
+	static long long parse( const string &cell )
+	{
+		return strtoll( cell.c_str(), NULL, 10 );
+	}
+};
+
+const double CellValue< long long >::compareCost = INT_COMPARE_COST;
+
+//text columns, the cell is compared as it is stored
+template<>
+struct CellValue< string >{
+	static const double compareCost;
+
+	static const string &parse( const string &cell )
+	{
+		return cell;
+	}
+};
+
+const double CellValue< string >::compareCost = TEXT_COMPARE_COST;
+
+//the test of one operator, chosen when the predicate is compiled
+template< CompareOp op >
+struct Comparison;
+
+template<>
+struct Comparison< COMPARE_EQUAL >{
+	template< typename ValueType >
+	static bool apply( const ValueType &cell, const ValueType &constant )
+	{
+		return cell == constant;
+	}
+};
+
+template<>
+struct Comparison< COMPARE_NOT_EQUAL >{
+	template< typename ValueType >
+	static bool apply( const ValueType &cell, const ValueType &constant )
+	{
+		return cell != constant;
+	}
+};
+
+template<>
+struct Comparison< COMPARE_LESS >{
+	template< typename ValueType >
+	static bool apply( const ValueType &cell, const ValueType &constant )
+	{
+		return cell < constant;
+	}
+};
+
+template<>
+struct Comparison< COMPARE_LESS_EQUAL >{
+	template< typename ValueType >
+	static bool apply( const ValueType &cell, const ValueType &constant )
+	{
+		return cell <= constant;
+	}
+};
+
+template<>
+struct Comparison< COMPARE_GREATER >{
+	template< typename ValueType >
+	static bool apply( const ValueType &cell, const ValueType &constant )
+	{
+		return cell > constant;
+	}
+};
+
+template<>
+struct Comparison< COMPARE_GREATER_EQUAL >{
+	template< typename ValueType >
+	static bool apply( const ValueType &cell, const ValueType &constant )
+	{
+		return cell >= constant;
+	}
+};
+
+/**
+ * @brief RowPredicate default destructor
+ *
+ * @details predicates are deleted through the base class
+ *
+ * @note None
+ */
+RowPredicate::~RowPredicate()
+{
+}
+
+/**
+ * @brief filterBatch
+ *
+ * @details tests the selected rows of a batch one at a time, for predicates
+ *          without a batch kernel
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count rows of the batch in use
+ *
+ * @param [in/out] uint64_t *selection one bit per row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void RowPredicate::filterBatch( const vector< vector< string > > &rows, unsigned int count,
+								uint64_t *selection ) const
+{
+	for( unsigned int word = 0; word < selectionWords( count ); word++ )
+	{
+		uint64_t bits = selection[ word ];
+		while( bits != 0 )
+		{
+			unsigned int bit = __builtin_ctzll( bits );
+			if( !rowMatches( rows[ word * SELECTION_WORD_BITS + bit ] ) )
+			{
+				selection[ word ] &= ~( (uint64_t)1 << bit );
+			}
+			bits &= bits - 1;
+		}
+	}
+}
+
+/**
+ * @brief filterColumn
+ *
+ * @details filters a batch on a float column, the selected cells are parsed
+ *          into a buffer the vector kernel compares in one pass
+ *
+ * @param [in] double constant
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] int attributeIndex
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+template< CompareOp op >
+void filterColumn( double constant, const vector< vector< string > > &rows, unsigned int count,
+					int attributeIndex, uint64_t *selection )
+{
+	//one buffer per thread, parallel scans filter batches concurrently
+	static thread_local vector< double > values;
+	values.assign( count, 0 );
+	for( unsigned int word = 0; word < selectionWords( count ); word++ )
+	{
+		uint64_t bits = selection[ word ];
+		while( bits != 0 )
+		{
+			unsigned int rowIndex = word * SELECTION_WORD_BITS + __builtin_ctzll( bits );
+			values[ rowIndex ] = CellValue< double >::parse( rows[ rowIndex ][ attributeIndex ] );
+			bits &= bits - 1;
+		}
+	}
+	filterDoubles( op, &values[ 0 ], count, constant, selection );
+}
+
+/**
+ * @brief filterColumn
+ *
+ * @details filters a batch on an int column, the selected cells are parsed
+ *          into a buffer the vector kernel compares in one pass
+ *
+ * @param [in] long long constant
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] int attributeIndex
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+template< CompareOp op >
+void filterColumn( long long constant, const vector< vector< string > > &rows, unsigned int count,
+					int attributeIndex, uint64_t *selection )
+{
+	//one buffer per thread, parallel scans filter batches concurrently
+	static thread_local vector< long long > values;
+	values.assign( count, 0 );
+	for( unsigned int word = 0; word < selectionWords( count ); word++ )
+	{
+		uint64_t bits = selection[ word ];
+		while( bits != 0 )
+		{
+			unsigned int rowIndex = word * SELECTION_WORD_BITS + __builtin_ctzll( bits );
+			values[ rowIndex ] = CellValue< long long >::parse( rows[ rowIndex ][ attributeIndex ] );
+			bits &= bits - 1;
+		}
+	}
+	filterIntegers( op, &values[ 0 ], count, constant, selection );
+}
+
+/**
+ * @brief filterColumn
+ *
+ * @details filters a batch on a text column
+ *
+ * @param [in] string &constant
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in] int attributeIndex
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+template< CompareOp op >
+void filterColumn( const string &constant, const vector< vector< string > > &rows,
+					unsigned int count, int attributeIndex, uint64_t *selection )
+{
+	for( unsigned int word = 0; word < selectionWords( count ); word++ )
+	{
+		uint64_t bits = selection[ word ];
+		while( bits != 0 )
+		{
+			unsigned int bit = __builtin_ctzll( bits );
+			const string &cell = rows[ word * SELECTION_WORD_BITS + bit ][ attributeIndex ];
+			if( !Comparison< op >::apply( cell, constant ) )
+			{
+				selection[ word ] &= ~( (uint64_t)1 << bit );
+			}
+			bits &= bits - 1;
+		}
+	}
+}
+
+/**
+ * @brief ColumnPredicate constructor
+ *
+ * @details parses the comparison value for the column type
+ *
+ * @param [in] int attrIndex column the condition tests
+ *
+ * @param [in] string &comparisonValue
+ *
+ * @note None
+ */
+template< typename ValueType, CompareOp op >
+ColumnPredicate< ValueType, op >::ColumnPredicate( int attrIndex, const string &comparisonValue )
+{
+	attributeIndex = attrIndex;
+	constant = CellValue< ValueType >::parse( comparisonValue );
+}
+
+/**
+ * @brief rowMatches
+ *
+ * @details compares the column of a row with the constant
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool
+ *
+ * @note None
+ */
+template< typename ValueType, CompareOp op >
+bool ColumnPredicate< ValueType, op >::rowMatches( const vector< string > &row ) const
+{
+	return Comparison< op >::apply( CellValue< ValueType >::parse( row[ attributeIndex ] ), constant );
+}
+
+/**
+ * @brief filterBatch
+ *
+ * @details compares the column of every selected row with the constant
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+template< typename ValueType, CompareOp op >
+void ColumnPredicate< ValueType, op >::filterBatch( const vector< vector< string > > &rows,
+													unsigned int count, uint64_t *selection ) const
+{
+	filterColumn< op >( constant, rows, count, attributeIndex, selection );
+}
+
+/**
+ * @brief selectivity
+ *
+ * @details estimates the share of rows the comparison matches
+ *
+ * @return double
+ *
+ * @note None
+ */
+template< typename ValueType, CompareOp op >
+double ColumnPredicate< ValueType, op >::selectivity() const
+{
+	if( op == COMPARE_EQUAL )
+	{
+		return EQUAL_SELECTIVITY;
+	}
+	else if( op == COMPARE_NOT_EQUAL )
+	{
+		return 1 - EQUAL_SELECTIVITY;
+	}
+	return RANGE_SELECTIVITY;
+}
+
+/**
+ * @brief cost
+ *
+ * @details estimates the cost of testing one row
+ *
+ * @return double
+ *
+ * @note None
+ */
+template< typename ValueType, CompareOp op >
+double ColumnPredicate< ValueType, op >::cost() const
+{
+	return CellValue< ValueType >::compareCost;
+}
+
+/**
+ * @brief rowMatches
+ *
+ * @details a condition that cannot be met matches no row
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool false
+ *
+ * @note None
+ */
+bool FalsePredicate::rowMatches( const vector< string > &row ) const
+{
+	return false;
+}
+
+/**
+ * @brief selectivity
+ *
+ * @details a condition that cannot be met matches no row
+ *
+ * @return double 0
+ *
+ * @note None
+ */
+double FalsePredicate::selectivity() const
+{
+	return 0;
+}
+
+/**
+ * @brief cost
+ *
+ * @details a condition that cannot be met looks at no cell
+ *
+ * @return double 0
+ *
+ * @note None
+ */
+double FalsePredicate::cost() const
+{
+	return 0;
+}
+
+/**
+ * @brief andRank
+ *
+ * @details orders the terms of an AND, lowest rank first
+ *
+ * @par Algorithm a term is worth testing early when it is cheap and likely
+ *      to fail, so the rank is its cost per row it rules out
+ *
+ * @param [in] RowPredicate *termA
+ *
+ * @param [in] RowPredicate *termB
+ *
+ * @return bool true if termA goes first
+ *
+ * @note None
+ */
+bool andRank( const RowPredicate *termA, const RowPredicate *termB )
+{
+	return termA->cost() * ( 1 - termB->selectivity() ) < termB->cost() * ( 1 - termA->selectivity() );
+}
+
+/**
+ * @brief orRank
+ *
+ * @details orders the terms of an OR, lowest rank first
+ *
+ * @par Algorithm a term is worth testing early when it is cheap and likely
+ *      to match, so the rank is its cost per row it lets through
+ *
+ * @param [in] RowPredicate *termA
+ *
+ * @param [in] RowPredicate *termB
+ *
+ * @return bool true if termA goes first
+ *
+ * @note None
+ */
+bool orRank( const RowPredicate *termA, const RowPredicate *termB )
+{
+	return termA->cost() * termB->selectivity() < termB->cost() * termA->selectivity();
+}
+
+/**
+ * @brief AndPredicate constructor
+ *
+ * @details takes the terms and orders them by rank
+ *
+ * @param [in] vector< RowPredicate * > &predicates the AND owns them
+ *
+ * @note None
+ */
+AndPredicate::AndPredicate( const vector< RowPredicate * > &predicates )
+{
+	terms = predicates;
+	stable_sort( terms.begin(), terms.end(), andRank );
+}
+
+/**
+ * @brief AndPredicate default destructor
+ *
+ * @details deletes the terms
+ *
+ * @note None
+ */
+AndPredicate::~AndPredicate()
+{
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		delete terms[ index ];
+	}
+}
+
+/**
+ * @brief rowMatches
+ *
+ * @details tests the terms in order until one fails
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool true if every term matches
+ *
+ * @note None
+ */
+bool AndPredicate::rowMatches( const vector< string > &row ) const
+{
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		if( !terms[ index ]->rowMatches( row ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief filterBatch
+ *
+ * @details each term filters the rows the earlier terms left selected
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+void AndPredicate::filterBatch( const vector< vector< string > > &rows, unsigned int count,
+								uint64_t *selection ) const
+{
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		terms[ index ]->filterBatch( rows, count, selection );
+		if( !anySelected( selection, count ) )
+		{
+			return;
+		}
+	}
+}
+
+/**
+ * @brief selectivity
+ *
+ * @details the terms are taken as independent
+ *
+ * @return double
+ *
+ * @note None
+ */
+double AndPredicate::selectivity() const
+{
+	double matching = 1;
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		matching *= terms[ index ]->selectivity();
+	}
+	return matching;
+}
+
+/**
+ * @brief cost
+ *
+ * @details a term is only tested on the rows every earlier term matched
+ *
+ * @return double
+ *
+ * @note None
+ */
+double AndPredicate::cost() const
+{
+	double total = 0;
+	double reached = 1;
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		total += reached * terms[ index ]->cost();
+		reached *= terms[ index ]->selectivity();
+	}
+	return total;
+}
+
+/**
+ * @brief OrPredicate constructor
+ *
+ * @details takes the terms and orders them by rank
+ *
+ * @param [in] vector< RowPredicate * > &predicates the OR owns them
+ *
+ * @note None
+ */
+OrPredicate::OrPredicate( const vector< RowPredicate * > &predicates )
+{
+	terms = predicates;
+	stable_sort( terms.begin(), terms.end(), orRank );
+}
+
+/**
+ * @brief OrPredicate default destructor
+ *
+ * @details deletes the terms
+ *
+ * @note None
+ */
+OrPredicate::~OrPredicate()
+{
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		delete terms[ index ];
+	}
+}
+
+/**
+ * @brief rowMatches
+ *
+ * @details tests the terms in order until one matches
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool true if any term matches
+ *
+ * @note None
+ */
+bool OrPredicate::rowMatches( const vector< string > &row ) const
+{
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		if( terms[ index ]->rowMatches( row ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief filterBatch
+ *
+ * @details each term tests the selected rows no earlier term matched
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+void OrPredicate::filterBatch( const vector< vector< string > > &rows, unsigned int count,
+								uint64_t *selection ) const
+{
+	unsigned int words = selectionWords( count );
+	vector< uint64_t > matched( words, 0 );
+	vector< uint64_t > untested( words );
+
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		for( unsigned int word = 0; word < words; word++ )
+		{
+			untested[ word ] = selection[ word ] & ~matched[ word ];
+		}
+		if( !anySelected( &untested[ 0 ], count ) )
+		{
+			break;
+		}
+		terms[ index ]->filterBatch( rows, count, &untested[ 0 ] );
+		for( unsigned int word = 0; word < words; word++ )
+		{
+			matched[ word ] |= untested[ word ];
+		}
+	}
+	for( unsigned int word = 0; word < words; word++ )
+	{
+		selection[ word ] = matched[ word ];
+	}
+}
+
+/**
+ * @brief selectivity
+ *
+ * @details the terms are taken as independent
+ *
+ * @return double
+ *
+ * @note None
+ */
+double OrPredicate::selectivity() const
+{
+	double failing = 1;
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		failing *= 1 - terms[ index ]->selectivity();
+	}
+	return 1 - failing;
+}
+
+/**
+ * @brief cost
+ *
+ * @details a term is only tested on the rows no earlier term matched
+ *
+ * @return double
+ *
+ * @note None
+ */
+double OrPredicate::cost() const
+{
+	double total = 0;
+	double reached = 1;
+	for( unsigned int index = 0; index < terms.size(); index++ )
+	{
+		total += reached * terms[ index ]->cost();
+		reached *= 1 - terms[ index ]->selectivity();
+	}
+	return total;
+}
+
+/**
+ * @brief NotPredicate constructor
+ *
+ * @details takes the negated term
+ *
+ * @param [in] RowPredicate *predicate the NOT owns it
+ *
+ * @note None
+ */
+NotPredicate::NotPredicate( RowPredicate *predicate )
+{
+	term = predicate;
+}
+
+/**
+ * @brief NotPredicate default destructor
+ *
+ * @details deletes the term
+ *
+ * @note None
+ */
+NotPredicate::~NotPredicate()
+{
+	delete term;
+}
+
+/**
+ * @brief rowMatches
+ *
+ * @details negates the term
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool NotPredicate::rowMatches( const vector< string > &row ) const
+{
+	return !term->rowMatches( row );
+}
+
+/**
+ * @brief filterBatch
+ *
+ * @details keeps the selected rows the term does not match
+ *
+ * @param [in] vector< vector< string > > &rows
+ *
+ * @param [in] unsigned int count
+ *
+ * @param [in/out] uint64_t *selection
+ *
+ * @return None
+ *
+ * @note None
+ */
+void NotPredicate::filterBatch( const vector< vector< string > > &rows, unsigned int count,
+								uint64_t *selection ) const
+{
+	unsigned int words = selectionWords( count );
+	vector< uint64_t > matched( selection, selection + words );
+
+	term->filterBatch( rows, count, &matched[ 0 ] );
+	for( unsigned int word = 0; word < words; word++ )
+	{
+		selection[ word ] &= ~matched[ word ];
+	}
+}
+
+/**
+ * @brief selectivity
+ *
+ * @details the rows the term does not match
+ *
+ * @return double
+ *
+ * @note None
+ */
+double NotPredicate::selectivity() const
+{
+	return 1 - term->selectivity();
+}
+
+/**
+ * @brief cost
+ *
+ * @details the cost of the term
+ *
+ * @return double
+ *
+ * @note None
+ */
+double NotPredicate::cost() const
+{
+	return term->cost();
+}
+
+/**
+ * @brief WhereParser constructor
+ *
+ * @details splits a where clause into tokens
+ *
+ * @param [in] string &whereType
+ *
+ * @param [in] vector< Attribute > &attributes columns of the table
+ *
+ * @note None
+ */
+WhereParser::WhereParser( const string &whereType, const vector< Attribute > &attributes )
+	: clause( whereType ), tableAttributes( attributes )
+{
+	position = 0;
+	tokenize( whereType );
+}
+
+/**
+ * @brief tokenize
+ *
+ * @details splits a where clause into words, operators, parentheses and
+ *          quoted values
+ *
+ * @par Algorithm a quoted value keeps its quotes, as cells store them, and
+ *      may hold spaces, parentheses and keywords
+ *
+ * @param [in] string &whereType
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WhereParser::tokenize( const string &whereType )
+{
+	const string operatorChars = "=!<>";
+	const string wordEnds = " \t\r\n()'=!<>";
+	size_t index = 0;
+	size_t length = whereType.size();
+
+	while( index < length )
+	{
+		WhereToken token;
+		char current = whereType[ index ];
+		size_t end = index + 1;
+		token.quoted = false;
+		if( isspace( (unsigned char)current ) )
+		{
+			index++;
+			continue;
+		}
+		if( current == '\'' )
+		{
+			end = whereType.find( '\'', index + 1 );
+			end = end == string::npos ? length : end + 1;
+			token.quoted = true;
+		}
+		else if( operatorChars.find( current ) != string::npos )
+		{
+			while( end < length && operatorChars.find( whereType[ end ] ) != string::npos )
+			{
+				end++;
+			}
+		}
+		else if( current != '(' && current != ')' )
+		{
+			while( end < length && wordEnds.find( whereType[ end ] ) == string::npos )
+			{
+				end++;
+			}
+		}
+		token.text = whereType.substr( index, end - index );
+		token.start = index;
+		tokens.push_back( token );
+		index = end;
+	}
+}
+
+/**
+ * @brief atKeyword
+ *
+ * @details checks whether the next token is a keyword, in any case
+ *
+ * @param [in] const char *keyword
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool WhereParser::atKeyword( const char *keyword )
+{
+	return position < tokens.size() && !tokens[ position ].quoted &&
+			caseInsCompare( tokens[ position ].text, keyword );
+}
+
+/**
+ * @brief atSymbol
+ *
+ * @details checks whether the next token is a parenthesis or an operator
+ *
+ * @param [in] const char *symbol
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool WhereParser::atSymbol( const char *symbol )
+{
+	return position < tokens.size() && !tokens[ position ].quoted &&
+			tokens[ position ].text == symbol;
+}
+
+/**
+ * @brief atComparisonValue
+ *
+ * @details checks whether the next token can be a column or a value
+ *
+ * @return bool false at the end, a parenthesis or an operator
+ *
+ * @note None
+ */
+bool WhereParser::atComparisonValue()
+{
+	return position < tokens.size() && !atSymbol( "(" ) && !atSymbol( ")" ) &&
+			( tokens[ position ].quoted || compareOpOf( tokens[ position ].text ) == COMPARE_INVALID );
+}
+
+/**
+ * @brief plainComparison
+ *
+ * @details checks whether the clause is one "attr op value" comparison as
+ *          the old grammar read it, with the value running to the end
+ *
+ * @par Algorithm the value may hold several words but no parenthesis,
+ *      operator, AND, OR or NOT outside quotes, those make the clause a
+ *      boolean expression
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool WhereParser::plainComparison()
+{
+	bool plain = tokens.size() >= 3 && atComparisonValue() && !atKeyword( "not" ) &&
+					!tokens[ 1 ].quoted && compareOpOf( tokens[ 1 ].text ) != COMPARE_INVALID;
+	for( position = 2; plain && position < tokens.size(); position++ )
+	{
+		plain = atComparisonValue() && !atKeyword( "and" ) && !atKeyword( "or" ) && !atKeyword( "not" );
+	}
+	position = 0;
+	return plain;
+}
+
+/**
+ * @brief parsePlainComparison
+ *
+ * @details compiles a clause plainComparison accepted
+ *
+ * @pre plainComparison returned true
+ *
+ * @post conjuncts holds the comparison
+ *
+ * @par Algorithm the column and operator are the first two tokens, so no
+ *      space is needed between them. The value is the clause from the third
+ *      token to its end, spaces inside it kept
+ *
+ * @param [out] vector< WhereCondition > &conjuncts
+ *
+ * @return RowPredicate * never NULL
+ *
+ * @note None
+ */
+RowPredicate *WhereParser::parsePlainComparison( vector< WhereCondition > &conjuncts )
+{
+	WhereCondition comparison;
+	size_t valueEnd = clause.find_last_not_of( " \t\r\n" ) + 1;
+	comparison.attributeName = tokens[ 0 ].text;
+	comparison.operatorValue = tokens[ 1 ].text;
+	comparison.comparisonValue = clause.substr( tokens[ 2 ].start, valueEnd - tokens[ 2 ].start );
+	position = tokens.size();
+	RowPredicate *predicate = compileComparison( comparison );
+	conjuncts.assign( 1, comparison );
+	return predicate;
+}
+
+/**
+ * @brief syntaxError
+ *
+ * @details describes where parseClause stopped
+ *
+ * @pre parseClause returned NULL
+ *
+ * @return string
+ *
+ * @note None
+ */
+string WhereParser::syntaxError()
+{
+	if( position >= tokens.size() )
+	{
+		return "the where clause ends too early";
+	}
+	return "the where clause has a syntax error near " + tokens[ position ].text;
+}
+
+/**
+ * @brief parseClause
+ *
+ * @details parses the whole where clause
+ *
+ * @post conjuncts holds the comparisons the clause requires of every row,
+ *       the ones an index lookup may use
+ *
+ * @param [out] vector< WhereCondition > &conjuncts
+ *
+ * @return RowPredicate * NULL on a syntax error
+ *
+ * @note None
+ */
+RowPredicate *WhereParser::parseClause( vector< WhereCondition > &conjuncts )
+{
+	conjuncts.clear();
+	RowPredicate *predicate = parseOr( &conjuncts );
+	if( predicate != NULL && position < tokens.size() )
+	{
+		delete predicate;
+		predicate = NULL;
+	}
+	return predicate;
+}
+
+/**
+ * @brief parseOr
+ *
+ * @details parses terms joined by OR
+ *
+ * @param [out] vector< WhereCondition > *conjuncts required comparisons,
+ *              NULL when they are not collected
+ *
+ * @return RowPredicate * NULL on a syntax error
+ *
+ * @note None
+ */
+RowPredicate *WhereParser::parseOr( vector< WhereCondition > *conjuncts )
+{
+	vector< RowPredicate * > terms;
+	RowPredicate *term = parseAnd( conjuncts );
+	while( term != NULL )
+	{
+		terms.push_back( term );
+		if( !atKeyword( "or" ) )
+		{
+			break;
+		}
+		position++;
+		term = parseAnd( NULL );
+	}
+
+	if( term == NULL )
+	{
+		for( unsigned int index = 0; index < terms.size(); index++ )
+		{
+			delete terms[ index ];
+		}
+		return NULL;
+	}
+	if( terms.size() == 1 )
+	{
+		return terms[ 0 ];
+	}
+	//no single comparison is required of every row
+	if( conjuncts != NULL )
+	{
+		conjuncts->clear();
+	}
+	return new OrPredicate( terms );
+}
+
+/**
+ * @brief parseAnd
+ *
+ * @details parses terms joined by AND
+ *
+ * @param [out] vector< WhereCondition > *conjuncts required comparisons,
+ *              NULL when they are not collected
+ *
+ * @return RowPredicate * NULL on a syntax error
+ *
+ * @note None
+ */
+RowPredicate *WhereParser::parseAnd( vector< WhereCondition > *conjuncts )
+{
+	vector< RowPredicate * > terms;
+	RowPredicate *term = parseNot( conjuncts );
+	while( term != NULL )
+	{
+		terms.push_back( term );
+		if( !atKeyword( "and" ) )
+		{
+			break;
+		}
+		position++;
+		term = parseNot( conjuncts );
+	}
+
+	if( term == NULL )
+	{
+		for( unsigned int index = 0; index < terms.size(); index++ )
+		{
+			delete terms[ index ];
+		}
+		return NULL;
+	}
+	if( terms.size() == 1 )
+	{
+		return terms[ 0 ];
+	}
+	return new AndPredicate( terms );
+}
+
+/**
+ * @brief parseNot
+ *
+ * @details parses a comparison, a parenthesized clause or NOT and a term
+ *
+ * @param [out] vector< WhereCondition > *conjuncts receives a plain
+ *              comparison, NULL when they are not collected
+ *
+ * @return RowPredicate * NULL on a syntax error
+ *
+ * @note None
+ */
+RowPredicate *WhereParser::parseNot( vector< WhereCondition > *conjuncts )
+{
+	if( atKeyword( "not" ) )
+	{
+		position++;
+		RowPredicate *term = parseNot( NULL );
+		return term == NULL ? NULL : new NotPredicate( term );
+	}
+	if( atSymbol( "(" ) )
+	{
+		position++;
+		RowPredicate *term = parseOr( NULL );
+		if( term == NULL || !atSymbol( ")" ) )
+		{
+			delete term;
+			return NULL;
+		}
+		position++;
+		return term;
+	}
+
+	WhereCondition comparison;
+	RowPredicate *term = parseComparison( comparison );
+	if( term != NULL && conjuncts != NULL )
+	{
+		conjuncts->push_back( comparison );
+	}
+	return term;
+}
+
+/**
+ * @brief parseComparison
+ *
+ * @details parses "attr op value" and compiles it
+ *
+ * @param [out] WhereCondition &comparison
+ *
+ * @return RowPredicate * NULL on a syntax error
+ *
+ * @note None
+ */
+RowPredicate *WhereParser::parseComparison( WhereCondition &comparison )
+{
+	if( !atComparisonValue() )
+	{
+		return NULL;
+	}
+	comparison.attributeName = tokens[ position++ ].text;
+	if( position >= tokens.size() || compareOpOf( tokens[ position ].text ) == COMPARE_INVALID )
+	{
+		return NULL;
+	}
+	comparison.operatorValue = tokens[ position++ ].text;
+	if( !atComparisonValue() )
+	{
+		return NULL;
+	}
+	comparison.comparisonValue = tokens[ position++ ].text;
+	return compileComparison( comparison );
+}
+
+/**
+ * @brief compileComparison
+ *
+ * @details looks up the column of a parsed comparison and compiles it
+ *
+ * @param [in/out] WhereCondition &comparison
+ *
+ * @return RowPredicate * never NULL
+ *
+ * @note None
+ */
+RowPredicate *WhereParser::compileComparison( WhereCondition &comparison )
+{
+	comparison.attributeIndex = findAttrOccur( tableAttributes, comparison.attributeName );
+	comparison.floatValue = isAttrFloat( tableAttributes, comparison.attributeName );
+	comparison.intValue = isAttrInt( tableAttributes, comparison.attributeName );
+	comparison.comparisonValueFloat = atof( comparison.comparisonValue.c_str() );
+	return compilePredicate( comparison );
+}
+
+/**
+ * @brief compareOpOf
+ *
+ * @details maps the operator text of a where condition to its operator
+ *
+ * @param [in] string &operatorValue
+ *
+ * @return CompareOp COMPARE_INVALID if it is not an operator
+ *
+ * @note None
+ */
+CompareOp compareOpOf( const string &operatorValue )
+{
+	if( operatorValue == "=" )
+	{
+		return COMPARE_EQUAL;
+	}
+	else if( operatorValue == "!=" )
+	{
+		return COMPARE_NOT_EQUAL;
+	}
+	else if( operatorValue == "<" )
+	{
+		return COMPARE_LESS;
+	}
+	else if( operatorValue == "<=" )
+	{
+		return COMPARE_LESS_EQUAL;
+	}
+	else if( operatorValue == ">" )
+	{
+		return COMPARE_GREATER;
+	}
+	else if( operatorValue == ">=" )
+	{
+		return COMPARE_GREATER_EQUAL;
+	}
+	return COMPARE_INVALID;
+}
+
+/**
+ * @brief columnPredicateFor
+ *
+ * @details builds the predicate of one operator for the column type
+ *
+ * @param [in] WhereCondition &wCond
+ *
+ * @return RowPredicate *
+ *
+ * @note None
+ */
+template< CompareOp op >
+RowPredicate *columnPredicateFor( const WhereCondition &wCond )
+{
+	if( wCond.floatValue )
+	{
+		return new ColumnPredicate< double, op >( wCond.attributeIndex, wCond.comparisonValue );
+	}
+	if( wCond.intValue )
+	{
+		return new ColumnPredicate< long long, op >( wCond.attributeIndex, wCond.comparisonValue );
+	}
+	return new ColumnPredicate< string, op >( wCond.attributeIndex, wCond.comparisonValue );
+}
+
+/**
+ * @brief compilePredicate
+ *
+ * @details compiles a parsed where condition into a predicate
+ *
+ * @pre wCond was parsed by WhereParser
+ *
+ * @post the caller owns the predicate and deletes it
+ *
+ * @param [in] WhereCondition &wCond
+ *
+ * @return RowPredicate * never NULL, a condition that cannot be met
+ *         compiles to a FalsePredicate
+ *
+ * @note None
+ */
+RowPredicate *compilePredicate( const WhereCondition &wCond )
+{
+	if( wCond.attributeIndex < 0 )
+	{
+		return new FalsePredicate;
+	}
+	switch( compareOpOf( wCond.operatorValue ) )
+	{
+		case COMPARE_EQUAL:
+			return columnPredicateFor< COMPARE_EQUAL >( wCond );
+		case COMPARE_NOT_EQUAL:
+			return columnPredicateFor< COMPARE_NOT_EQUAL >( wCond );
+		case COMPARE_LESS:
+			return columnPredicateFor< COMPARE_LESS >( wCond );
+		case COMPARE_LESS_EQUAL:
+			return columnPredicateFor< COMPARE_LESS_EQUAL >( wCond );
+		case COMPARE_GREATER:
+			return columnPredicateFor< COMPARE_GREATER >( wCond );
+		case COMPARE_GREATER_EQUAL:
+			return columnPredicateFor< COMPARE_GREATER_EQUAL >( wCond );
+		default:
+			return new FalsePredicate;
+	}
+}
+
+/**
+ * @brief compileWhere
+ *
+ * @details compiles a where clause into a predicate
+ *
+ * @pre whereType is the text after "where", not empty
+ *
+ * @post conjuncts holds the comparisons every matching row satisfies, the
+ *       caller owns the predicate and deletes it
+ *
+ * @par Algorithm a clause the old grammar reads in full, one comparison
+ *      whose value runs to the end, keeps the whole value. Anything else
+ *      has to parse as a boolean expression, a clause that does not is an
+ *      error and never falls back to its first comparison
+ *
+ * @param [in] string whereType
+ *
+ * @param [in] vector< Attribute > &attributes
+ *
+ * @param [out] vector< WhereCondition > &conjuncts
+ *
+ * @param [out] string &error why the clause did not compile
+ *
+ * @return RowPredicate * NULL on a syntax error
+ *
+ * @note None
+ */
+RowPredicate *compileWhere( string whereType, const vector< Attribute > &attributes,
+							vector< WhereCondition > &conjuncts, string &error )
+{
+	WhereParser parser( whereType, attributes );
+	if( parser.plainComparison() )
+	{
+		return parser.parsePlainComparison( conjuncts );
+	}
+
+	RowPredicate *predicate = parser.parseClause( conjuncts );
+	if( predicate == NULL )
+	{
+		conjuncts.clear();
+		error = parser.syntaxError();
+	}
+	return predicate;
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
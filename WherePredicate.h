@@ -0,0 +1,184 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file WherePredicate.h
+ *
+ * @brief Definition file for the RowPredicate classes
+ *
+ * @details Specifies the predicates a where condition is compiled into once
+ *          per statement, so a row is tested without looking at the
+ *          operator or the column type again. Conditions combined with AND,
+ *          OR and NOT compile into a tree of predicates
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "Table.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef WHEREPREDICATE_H
+#define WHEREPREDICATE_H
+
+//comparison operators of a where condition
+enum CompareOp{
+	COMPARE_EQUAL,
+	COMPARE_NOT_EQUAL,
+	COMPARE_LESS,
+	COMPARE_LESS_EQUAL,
+	COMPARE_GREATER,
+	COMPARE_GREATER_EQUAL,
+	COMPARE_INVALID
+};
+
+//estimated share of rows a comparison matches, without statistics
+const double EQUAL_SELECTIVITY = 0.1;
+const double RANGE_SELECTIVITY = 1.0 / 3;
+
+//estimated cost of testing one cell, parsing a number costs more than
+//comparing text and parsing a float more than parsing an int
+const double TEXT_COMPARE_COST = 1.0;
+const double INT_COMPARE_COST = 1.5;
+const double FLOAT_COMPARE_COST = 2.0;
+
+//a compiled where condition, it keeps no state between rows so one
+//predicate may be tested from several threads at once
+class RowPredicate{
+	public:
+		virtual ~RowPredicate();
+
+		virtual bool rowMatches( const vector< string > &row ) const = 0;
+
+		//clears the selection bit of every row of a batch that does not match
+		virtual void filterBatch( const vector< vector< string > > &rows, unsigned int count,
+									uint64_t *selection ) const;
+
+		//share of rows expected to match and expected cost of one test
+		virtual double selectivity() const = 0;
+		virtual double cost() const = 0;
+};
+
+//how a cell of a column is read before it is compared, specialized for the
+//column types in WherePredicate.cpp
+template< typename ValueType >
+struct CellValue;
+
+//one column compared with a constant parsed when the predicate is built
+template< typename ValueType, CompareOp op >
+class ColumnPredicate : public RowPredicate{
+	public:
+		ColumnPredicate( int attrIndex, const string &comparisonValue );
+
+		bool rowMatches( const vector< string > &row ) const;
+		void filterBatch( const vector< vector< string > > &rows, unsigned int count,
+							uint64_t *selection ) const;
+		double selectivity() const;
+		double cost() const;
+
+	private:
+		int attributeIndex;
+		ValueType constant;
+};
+
+//a condition on an unknown column or with an unknown operator
+class FalsePredicate : public RowPredicate{
+	public:
+		bool rowMatches( const vector< string > &row ) const;
+		double selectivity() const;
+		double cost() const;
+};
+
+//terms that must all match, tested cheapest and most selective first and
+//only until one fails
+class AndPredicate : public RowPredicate{
+	public:
+		AndPredicate( const vector< RowPredicate * > &predicates );
+		~AndPredicate();
+
+		bool rowMatches( const vector< string > &row ) const;
+		void filterBatch( const vector< vector< string > > &rows, unsigned int count,
+							uint64_t *selection ) const;
+		double selectivity() const;
+		double cost() const;
+
+	private:
+		vector< RowPredicate * > terms;
+};
+
+//terms of which one must match, tested cheapest and most likely first and
+//only until one matches
+class OrPredicate : public RowPredicate{
+	public:
+		OrPredicate( const vector< RowPredicate * > &predicates );
+		~OrPredicate();
+
+		bool rowMatches( const vector< string > &row ) const;
+		void filterBatch( const vector< vector< string > > &rows, unsigned int count,
+							uint64_t *selection ) const;
+		double selectivity() const;
+		double cost() const;
+
+	private:
+		vector< RowPredicate * > terms;
+};
+
+class NotPredicate : public RowPredicate{
+	public:
+		NotPredicate( RowPredicate *predicate );
+		~NotPredicate();
+
+		bool rowMatches( const vector< string > &row ) const;
+		void filterBatch( const vector< vector< string > > &rows, unsigned int count,
+							uint64_t *selection ) const;
+		double selectivity() const;
+		double cost() const;
+
+	private:
+		RowPredicate *term;
+};
+
+//token of a where clause
+struct WhereToken{
+	string text;
+	bool quoted;
+	size_t start;
+};
+
+//recursive descent parser of compound where clauses
+class WhereParser{
+	public:
+		WhereParser( const string &whereType, const vector< Attribute > &attributes );
+
+		RowPredicate *parseClause( vector< WhereCondition > &conjuncts );
+		bool plainComparison();
+		RowPredicate *parsePlainComparison( vector< WhereCondition > &conjuncts );
+		string syntaxError();
+
+	private:
+		string clause;
+		vector< WhereToken > tokens;
+		unsigned int position;
+		const vector< Attribute > &tableAttributes;
+
+		void tokenize( const string &whereType );
+		bool atKeyword( const char *keyword );
+		bool atSymbol( const char *symbol );
+		bool atComparisonValue();
+		RowPredicate *parseOr( vector< WhereCondition > *conjuncts );
+		RowPredicate *parseAnd( vector< WhereCondition > *conjuncts );
+		RowPredicate *parseNot( vector< WhereCondition > *conjuncts );
+		RowPredicate *parseComparison( WhereCondition &comparison );
+		RowPredicate *compileComparison( WhereCondition &comparison );
+};
+
+CompareOp compareOpOf( const string &operatorValue );
+RowPredicate *compilePredicate( const WhereCondition &wCond );
+RowPredicate *compileWhere( string whereType, const vector< Attribute > &attributes,
+							vector< WhereCondition > &conjuncts, string &error );
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
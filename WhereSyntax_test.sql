@@ -0,0 +1,33 @@
+--CS457 where clause syntax errors
+
+--A where clause that does not parse fails the statement and changes no row
+
+CREATE DATABASE WhereSyntax;
+USE WhereSyntax;
+
+create table T (a int, b varchar(10));
+insert into T values(1, 'x');
+insert into T values(2, 'x');
+insert into T values(3, 'y');
+
+delete from T where a != 1 and (b = 'x';
+delete from T where a != 1 and;
+update T set b = 'z' where a = 1 or;
+update T set b = 'z' where (a = 1)) or b = 'x';
+select * from T where a = 1 b = 'x';
+select * from T where not;
+select count(*) from T where b = 'x' and (;
+explain select * from T where a >;
+select * from T;
+
+begin transaction;
+delete from T where (a = 1 or b = 'y';
+commit;
+select * from T;
+
+delete from T where a != 1 and (b = 'x');
+select * from T;
+select * from T where b = Joe Smith;
+
+DROP DATABASE WhereSyntax;
+.EXIT
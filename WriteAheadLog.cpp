@@ -0,0 +1,1367 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file WriteAheadLog.cpp
+ *
+ * @brief Implementation file for WriteAheadLog class
+ *
+ * @author Carli Decapito, Sanya Gupta, Eugene Nelson
+ *
+ * @details Implements the write ahead log. The changes of a transaction stay
+ *          in memory, laid over the scans of the process, until commit
+ *          appends them to the log of the database and syncs it. A background
+ *          thread then applies the committed changes to the table files, and
+ *          every process catches up with the log before it touches a table
+ *
+ * @Note Requires WriteAheadLog.h
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <thread>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "WriteAheadLog.h"
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef WRITEAHEADLOG_CPP
+#define WRITEAHEADLOG_CPP
+
+WriteAheadLog writeAheadLog;
+
+//helper function implemented in Table.cpp
+bool fileExists( string filename );
+
+/**
+ * @brief appendUint32
+ *
+ * @details appends a 32 bit value to a log buffer
+ *
+ * @param [out] string &buffer
+ *
+ * @param [in] uint32_t value
+ *
+ * @return None
+ *
+ * @note None
+ */
+void appendUint32( string &buffer, uint32_t value )
+{
+	buffer.append( (const char *)&value, sizeof( value ) );
+}
+
+/**
+ * @brief appendUint64
+ *
+ * @details appends a 64 bit value to a log buffer
+ *
+ * @param [out] string &buffer
+ *
+ * @param [in] uint64_t value
+ *
+ * @return None
+ *
+ * @note None
+ */
+void appendUint64( string &buffer, uint64_t value )
+{
+	buffer.append( (const char *)&value, sizeof( value ) );
+}
+
+/**
+ * @brief appendString
+ *
+ * @details appends a length prefixed string to a log buffer
+ *
+ * @param [out] string &buffer
+ *
+ * @param [in] string &value
+ *
+ * @return None
+ *
+ * @note None
+ */
+void appendString( string &buffer, const string &value )
+{
+	appendUint32( buffer, value.size() );
+	buffer.append( value );
+}
+
+/**
+ * @brief takeUint32
+ *
+ * @details reads a 32 bit value of a record payload
+ *
+ * @param [in] const char *data
+ *
+ * @param [in] size_t length
+ *
+ * @param [in/out] size_t &position moved past the value
+ *
+ * @param [out] uint32_t &value
+ *
+ * @return bool false if the payload is too short
+ *
+ * @note None
+ */
+bool takeUint32( const char *data, size_t length, size_t &position, uint32_t &value )
+{
+	if( length - position < sizeof( value ) )
+	{
+		return false;
+	}
+	memcpy( &value, data + position, sizeof( value ) );
+	position += sizeof( value );
+	return true;
+}
+
+/**
+ * @brief takeUint64
+ *
+ * @details reads a 64 bit value of a record payload
+ *
+ * @param [in] const char *data
+ *
+ * @param [in] size_t length
+ *
+ * @param [in/out] size_t &position moved past the value
+ *
+ * @param [out] uint64_t &value
+ *
+ * @return bool false if the payload is too short
+ *
+ * @note None
+ */
+bool takeUint64( const char *data, size_t length, size_t &position, uint64_t &value )
+{
+	if( length - position < sizeof( value ) )
+	{
+		return false;
+	}
+	memcpy( &value, data + position, sizeof( value ) );
+	position += sizeof( value );
+	return true;
+}
+
+/**
+ * @brief takeString
+ *
+ * @details reads a length prefixed string of a record payload
+ *
+ * @param [in] const char *data
+ *
+ * @param [in] size_t length
+ *
+ * @param [in/out] size_t &position moved past the string
+ *
+ * @param [out] string &value
+ *
+ * @return bool false if the payload is too short
+ *
+ * @note None
+ */
+bool takeString( const char *data, size_t length, size_t &position, string &value )
+{
+	uint32_t size;
+	if( !takeUint32( data, length, position, size ) || length - position < size )
+	{
+		return false;
+	}
+	value.assign( data + position, size );
+	position += size;
+	return true;
+}
+
+/**
+ * @brief walChecksum
+ *
+ * @details computes the FNV-1a hash of a record payload
+ *
+ * @param [in] const char *data
+ *
+ * @param [in] size_t length
+ *
+ * @return uint32_t
+ *
+ * @note None
+ */
+uint32_t walChecksum( const char *data, size_t length )
+{
+	uint32_t hash = 2166136261u;
+	for( size_t index = 0; index < length; index++ )
+	{
+		hash ^= (unsigned char)data[ index ];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @brief encodeRecord
+ *
+ * @details appends one record to a log buffer
+ *
+ * @par Algorithm a record is its payload length, the checksum of the
+ *      payload and the payload, so a record cut off by a crash is detected
+ *
+ * @param [in] WalRecord &record
+ *
+ * @param [out] string &buffer
+ *
+ * @return None
+ *
+ * @note None
+ */
+void encodeRecord( const WalRecord &record, string &buffer )
+{
+	string payload;
+	payload += record.recordType;
+	appendUint64( payload, record.txnId );
+	appendString( payload, record.tableName );
+	appendUint64( payload, (uint64_t)record.rid );
+	appendUint32( payload, record.pageNo );
+	appendUint32( payload, record.row.size() );
+	for( unsigned int index = 0; index < record.row.size(); index++ )
+	{
+		appendString( payload, record.row[ index ] );
+	}
+
+	appendUint32( buffer, payload.size() );
+	appendUint32( buffer, walChecksum( payload.data(), payload.size() ) );
+	buffer.append( payload );
+}
+
+/**
+ * @brief decodeRecord
+ *
+ * @details reads one record of the log
+ *
+ * @param [in] const char *data
+ *
+ * @param [in] size_t available bytes left in the log
+ *
+ * @param [out] WalRecord &record
+ *
+ * @param [out] size_t &used bytes the record takes up
+ *
+ * @return bool false if the record is incomplete or damaged
+ *
+ * @note None
+ */
+bool decodeRecord( const char *data, size_t available, WalRecord &record, size_t &used )
+{
+	uint32_t length;
+	uint32_t checksum;
+	size_t position = 0;
+	if( !takeUint32( data, available, position, length ) ||
+		!takeUint32( data, available, position, checksum ) ||
+		available - position < length ||
+		walChecksum( data + position, length ) != checksum )
+	{
+		return false;
+	}
+
+	const char *payload = data + position;
+	size_t offset = 1;
+	uint64_t rid;
+	uint32_t cellCount;
+	if( length < 1 ||
+		!takeUint64( payload, length, offset, record.txnId ) ||
+		!takeString( payload, length, offset, record.tableName ) ||
+		!takeUint64( payload, length, offset, rid ) ||
+		!takeUint32( payload, length, offset, record.pageNo ) ||
+		!takeUint32( payload, length, offset, cellCount ) ||
+		cellCount > length )
+	{
+		return false;
+	}
+	record.recordType = payload[ 0 ];
+	record.rid = (long)rid;
+	record.row.resize( cellCount );
+	for( unsigned int index = 0; index < cellCount; index++ )
+	{
+		if( !takeString( payload, length, offset, record.row[ index ] ) )
+		{
+			return false;
+		}
+	}
+	used = position + length;
+	return true;
+}
+
+/**
+ * @brief applyRecordToDelta
+ *
+ * @details adds one row change to the changes of a table
+ *
+ * @par Algorithm negative row ids address the rows the transaction inserted
+ *      itself, so changing them edits the insert
+ *
+ * @param [in/out] TableDelta &delta
+ *
+ * @param [in] char recordType WAL_INSERT, WAL_UPDATE or WAL_DELETE
+ *
+ * @param [in] long rid
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void applyRecordToDelta( TableDelta &delta, char recordType, long rid, const vector< string > &row )
+{
+	if( recordType == WAL_INSERT )
+	{
+		delta.insertedRows.push_back( row );
+		delta.insertedLive.push_back( true );
+		return;
+	}
+
+	if( rid < 0 )
+	{
+		unsigned int index = -rid - 1;
+		if( index < delta.insertedRows.size() )
+		{
+			if( recordType == WAL_UPDATE )
+			{
+				delta.insertedRows[ index ] = row;
+			}
+			else
+			{
+				delta.insertedLive[ index ] = false;
+			}
+		}
+		return;
+	}
+
+	if( recordType == WAL_UPDATE )
+	{
+		delta.updatedRows[ rid ] = row;
+	}
+	else
+	{
+		delta.updatedRows.erase( rid );
+		delta.deletedRows.insert( rid );
+	}
+}
+
+/**
+ * @brief writeAll
+ *
+ * @details appends a buffer to the end of a file
+ *
+ * @param [in] int fileDesc
+ *
+ * @param [in] string &buffer
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool writeAll( int fileDesc, const string &buffer )
+{
+	size_t written = 0;
+	lseek( fileDesc, 0, SEEK_END );
+	while( written < buffer.size() )
+	{
+		ssize_t result = write( fileDesc, buffer.data() + written, buffer.size() - written );
+		if( result <= 0 )
+		{
+			return false;
+		}
+		written += result;
+	}
+	return true;
+}
+
+/**
+ * @brief syncPath
+ *
+ * @details waits until a file or directory is on disk
+ *
+ * @param [in] string path
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool syncPath( string path )
+{
+	int fileDesc = open( path.c_str(), O_RDONLY );
+	if( fileDesc < 0 )
+	{
+		return false;
+	}
+	bool success = fsync( fileDesc ) == 0;
+	close( fileDesc );
+	return success;
+}
+
+/**
+ * @brief writeLogHeader
+ *
+ * @details writes the header of a log and syncs it
+ *
+ * @param [in] int logFd
+ *
+ * @param [in] uint64_t generation changes whenever the log is emptied
+ *
+ * @param [in] uint64_t checkpoint offset replay starts from
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool writeLogHeader( int logFd, uint64_t generation, uint64_t checkpoint )
+{
+	string header( WAL_MAGIC, 4 );
+	appendUint32( header, WAL_VERSION );
+	appendUint64( header, generation );
+	appendUint64( header, checkpoint );
+	return pwrite( logFd, header.data(), header.size(), 0 ) == WAL_HEADER_SIZE &&
+			fdatasync( logFd ) == 0;
+}
+
+/**
+ * @brief readLogHeader
+ *
+ * @details checks the header of a log and returns its generation and
+ *          checkpoint
+ *
+ * @param [in] int logFd
+ *
+ * @param [out] uint64_t &generation
+ *
+ * @param [out] uint64_t &checkpoint
+ *
+ * @return bool false if the file is not a log
+ *
+ * @note None
+ */
+bool readLogHeader( int logFd, uint64_t &generation, uint64_t &checkpoint )
+{
+	char header[ WAL_HEADER_SIZE ];
+	uint32_t version;
+	if( pread( logFd, header, WAL_HEADER_SIZE, 0 ) != WAL_HEADER_SIZE ||
+		memcmp( header + WAL_HEADER_MAGIC, WAL_MAGIC, 4 ) != 0 )
+	{
+		return false;
+	}
+	memcpy( &version, header + WAL_HEADER_VERSION, sizeof( version ) );
+	memcpy( &generation, header + WAL_HEADER_GENERATION, sizeof( generation ) );
+	memcpy( &checkpoint, header + WAL_HEADER_CHECKPOINT, sizeof( checkpoint ) );
+	return version == WAL_VERSION && checkpoint >= (uint64_t)WAL_HEADER_SIZE;
+}
+
+/**
+ * @brief openLog
+ *
+ * @details opens the log of a database and locks it against other processes
+ *
+ * @post a new log holds its header, the lock is released by closing the file
+ *
+ * @param [in] string databasePath
+ *
+ * @param [in] bool create true to create a missing log
+ *
+ * @return int file descriptor, -1 if there is no log
+ *
+ * @note None
+ */
+int openLog( string databasePath, bool create )
+{
+	string logPath = databasePath + "/" + WAL_FILE;
+	int logFd = open( logPath.c_str(), O_RDWR | ( create ? O_CREAT : 0 ), 0644 );
+	if( logFd < 0 )
+	{
+		return -1;
+	}
+	if( flock( logFd, LOCK_EX ) != 0 )
+	{
+		close( logFd );
+		return -1;
+	}
+
+	if( lseek( logFd, 0, SEEK_END ) < WAL_HEADER_SIZE )
+	{
+		//a new log, or one whose creator died before writing the header
+		if( ftruncate( logFd, 0 ) != 0 ||
+			!writeLogHeader( logFd, (uint64_t)time( NULL ) * 1000003u + getpid(), WAL_HEADER_SIZE ) )
+		{
+			close( logFd );
+			return -1;
+		}
+	}
+	return logFd;
+}
+
+/**
+ * @brief WriteAheadLog default constructor
+ *
+ * @details no transaction is open and no log has been read
+ *
+ * @note None
+ */
+WriteAheadLog::WriteAheadLog()
+{
+}
+
+/**
+ * @brief WriteAheadLog default destructor
+ *
+ * @details waits for the background apply to finish
+ *
+ * @note None
+ */
+WriteAheadLog::~WriteAheadLog()
+{
+	waitForApplier();
+}
+
+/**
+ * @brief walGetDelta
+ *
+ * @details returns the uncommitted changes of the open transaction to a table
+ *
+ * @param [in] string tablePath
+ *
+ * @return TableDelta* NULL if the transaction did not change the table
+ *
+ * @note None
+ */
+TableDelta *WriteAheadLog::walGetDelta( string tablePath )
+{
+	map< string, TableDelta >::iterator found = pendingDeltas.find( tablePath );
+	if( found == pendingDeltas.end() )
+	{
+		return NULL;
+	}
+	return &found->second;
+}
+
+/**
+ * @brief walInsert
+ *
+ * @details records a row the open transaction inserts
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::walInsert( string tablePath, const vector< string > &row )
+{
+	logChange( tablePath, WAL_INSERT, 0, row );
+}
+
+/**
+ * @brief walUpdate
+ *
+ * @details records the new version of a row the open transaction updates
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] long rid
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::walUpdate( string tablePath, long rid, const vector< string > &row )
+{
+	logChange( tablePath, WAL_UPDATE, rid, row );
+}
+
+/**
+ * @brief walDelete
+ *
+ * @details records a row the open transaction deletes
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] long rid
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::walDelete( string tablePath, long rid )
+{
+	logChange( tablePath, WAL_DELETE, rid, vector< string >() );
+}
+
+/**
+ * @brief walCommit
+ *
+ * @details makes the changes of the open transaction durable
+ *
+ * @pre the transaction holds the lock of every table it changed
+ *
+ * @post the changes are in the log of each database and on disk, they are
+ *       applied to the table files in the background
+ *
+ * @par Algorithm the records of a database and its commit record are
+ *      appended in one write and synced once, so commit costs the size of
+ *      the change. The offset of the first record identifies the transaction
+ *
+ * @return bool false if a log could not be written
+ *
+ * @note None
+ */
+bool WriteAheadLog::walCommit()
+{
+	bool success = true;
+	vector< string > committed;
+
+	waitForApplier();
+	map< string, vector< WalRecord > >::iterator database;
+	for( database = pendingRecords.begin(); database != pendingRecords.end(); ++database )
+	{
+		vector< WalRecord > &records = database->second;
+		int logFd = openLog( database->first, true );
+		if( logFd < 0 )
+		{
+			success = false;
+			continue;
+		}
+
+		//cuts off a record torn by a crash so the new records can be read
+		int redone;
+		int discarded;
+		replayLog( logFd, database->first, redone, discarded );
+
+		off_t start = lseek( logFd, 0, SEEK_END );
+		string buffer;
+		for( unsigned int index = 0; index < records.size(); index++ )
+		{
+			records[ index ].txnId = start;
+			encodeRecord( records[ index ], buffer );
+		}
+		WalRecord commit;
+		commit.recordType = WAL_COMMIT;
+		commit.txnId = start;
+		commit.rid = 0;
+		commit.pageNo = 0;
+		encodeRecord( commit, buffer );
+
+		if( writeAll( logFd, buffer ) && fdatasync( logFd ) == 0 )
+		{
+			committed.push_back( database->first );
+		}
+		else
+		{
+			if( ftruncate( logFd, start ) != 0 )
+			{
+				cout << "-- !Failed to truncate the log of " << database->first << "." << endl;
+			}
+			success = false;
+		}
+		close( logFd );
+	}
+
+	pendingRecords.clear();
+	pendingDeltas.clear();
+	if( !committed.empty() )
+	{
+		applier = thread( &WriteAheadLog::applyLogs, this, committed );
+	}
+	return success;
+}
+
+/**
+ * @brief walAbort
+ *
+ * @details discards the changes of the open transaction
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::walAbort()
+{
+	pendingRecords.clear();
+	pendingDeltas.clear();
+}
+
+/**
+ * @brief walCatchUp
+ *
+ * @details applies every committed change of a database that is not in its
+ *          table files yet
+ *
+ * @pre none
+ *
+ * @post the table files of the database hold every committed transaction
+ *
+ * @param [in] string databasePath empty to only wait for the background apply
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::walCatchUp( string databasePath )
+{
+	waitForApplier();
+	if( !databasePath.empty() )
+	{
+		applyLog( databasePath );
+	}
+}
+
+/**
+ * @brief walRecover
+ *
+ * @details brings the tables of a database to a consistent state after a
+ *          crash
+ *
+ * @pre no transaction of this process is open
+ *
+ * @post every committed transaction is applied, the log holds no damaged
+ *       records and a checkpoint is taken
+ *
+ * @par Algorithm analysis reads the log from the last checkpoint and sorts
+ *      transactions into committed and applied, committed only, and those
+ *      without a commit record. Redo applies the committed ones that are not
+ *      applied yet. Changes reach the log only at commit and the tables only
+ *      after that, so undo has nothing to roll back in the tables, the
+ *      records of unfinished transactions are dropped and staging files no
+ *      commit reached are removed
+ *
+ * @param [in] string databasePath
+ *
+ * @param [out] int &redone transactions applied by the recovery
+ *
+ * @param [out] int &discarded transactions without a commit record
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::walRecover( string databasePath, int &redone, int &discarded )
+{
+	redone = 0;
+	discarded = 0;
+	waitForApplier();
+	if( !fileExists( databasePath + "/" + WAL_FILE ) )
+	{
+		return;
+	}
+	int logFd = openLog( databasePath, false );
+	if( logFd < 0 )
+	{
+		return;
+	}
+
+	cursors.erase( databasePath );
+	replayLog( logFd, databasePath, redone, discarded );
+	checkpointLog( logFd, databasePath, true );
+
+	//staging files left by an apply that never reached its staged mark
+	DIR *dirp = opendir( databasePath.c_str() );
+	struct dirent *dp;
+	while( dirp != NULL && ( dp = readdir( dirp ) ) != NULL )
+	{
+		string fileName = dp->d_name;
+		if( fileName.size() > APPLY_SUFFIX.size() &&
+			fileName.compare( fileName.size() - APPLY_SUFFIX.size(), APPLY_SUFFIX.size(), APPLY_SUFFIX ) == 0 )
+		{
+			unlink( ( databasePath + "/" + fileName ).c_str() );
+		}
+	}
+	if( dirp != NULL )
+	{
+		closedir( dirp );
+	}
+	close( logFd );
+}
+
+/**
+ * @brief logChange
+ *
+ * @details adds a row change to the open transaction
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] char recordType
+ *
+ * @param [in] long rid
+ *
+ * @param [in] vector< string > &row
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::logChange( string tablePath, char recordType, long rid, const vector< string > &row )
+{
+	applyRecordToDelta( pendingDeltas[ tablePath ], recordType, rid, row );
+
+	size_t slash = tablePath.rfind( '/' );
+	WalRecord record;
+	record.recordType = recordType;
+	record.txnId = 0;
+	record.tableName = tablePath.substr( slash + 1 );
+	record.rid = rid;
+	record.row = row;
+	record.pageNo = 0;
+	pendingRecords[ tablePath.substr( 0, slash ) ].push_back( record );
+}
+
+/**
+ * @brief applyLogs
+ *
+ * @details applies the logs of several databases, run by the background thread
+ *
+ * @param [in] vector< string > databasePaths
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::applyLogs( vector< string > databasePaths )
+{
+	for( unsigned int index = 0; index < databasePaths.size(); index++ )
+	{
+		applyLog( databasePaths[ index ] );
+	}
+}
+
+/**
+ * @brief applyLog
+ *
+ * @details applies the committed changes of a database log
+ *
+ * @par Algorithm the log is only opened when it grew past the point this
+ *      process has applied, which keeps the check before every statement cheap
+ *
+ * @param [in] string databasePath
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::applyLog( string databasePath )
+{
+	struct stat buffer;
+	WalCursor &cursor = cursors[ databasePath ];
+	if( stat( ( databasePath + "/" + WAL_FILE ).c_str(), &buffer ) != 0 )
+	{
+		cursor.generation = 0;
+		return;
+	}
+	if( cursor.generation != 0 && cursor.inode == buffer.st_ino && cursor.offset == buffer.st_size )
+	{
+		return;
+	}
+
+	int logFd = openLog( databasePath, false );
+	if( logFd >= 0 )
+	{
+		int redone;
+		int discarded;
+		replayLog( logFd, databasePath, redone, discarded );
+		close( logFd );
+	}
+}
+
+/**
+ * @brief replayLog
+ *
+ * @details reads the log past the point this process has applied and applies
+ *          every committed transaction that is not applied yet
+ *
+ * @pre the log is open and locked
+ *
+ * @post the cursor of the database is past every applied transaction
+ *
+ * @par Algorithm records are grouped by transaction. A record that is cut
+ *      off or damaged can only be the end of a write a crash interrupted, so
+ *      the log is truncated there. Transactions are applied in commit order
+ *      and the first one that fails stops the replay, later transactions may
+ *      depend on it
+ *
+ * @param [in] int logFd
+ *
+ * @param [in] string databasePath
+ *
+ * @param [out] int &redone transactions applied
+ *
+ * @param [out] int &discarded transactions without a commit record
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::replayLog( int logFd, string databasePath, int &redone, int &discarded )
+{
+	WalCursor &cursor = cursors[ databasePath ];
+	uint64_t generation;
+	uint64_t checkpoint;
+	struct stat buffer;
+	redone = 0;
+	discarded = 0;
+	if( !readLogHeader( logFd, generation, checkpoint ) || fstat( logFd, &buffer ) != 0 )
+	{
+		return;
+	}
+	//a process that has not read this log yet starts at the checkpoint
+	if( generation != cursor.generation || cursor.inode != buffer.st_ino || cursor.offset > buffer.st_size )
+	{
+		cursor.generation = generation;
+		cursor.inode = buffer.st_ino;
+		cursor.offset = checkpoint;
+	}
+
+	string data( buffer.st_size - cursor.offset, '\0' );
+	if( data.empty() ||
+		pread( logFd, &data[ 0 ], data.size(), cursor.offset ) != (ssize_t)data.size() )
+	{
+		return;
+	}
+
+	vector< uint64_t > order;
+	map< uint64_t, vector< WalRecord > > transactions;
+	set< uint64_t > committed;
+	set< uint64_t > applied;
+	set< uint64_t > changed;
+	size_t position = 0;
+	WalRecord record;
+	while( position < data.size() )
+	{
+		size_t used;
+		if( !decodeRecord( data.data() + position, data.size() - position, record, used ) )
+		{
+			if( ftruncate( logFd, cursor.offset + position ) != 0 )
+			{
+				return;
+			}
+			break;
+		}
+		position += used;
+
+		if( record.recordType == WAL_COMMIT )
+		{
+			committed.insert( record.txnId );
+		}
+		else if( record.recordType == WAL_APPLIED )
+		{
+			applied.insert( record.txnId );
+		}
+		else
+		{
+			if( transactions.find( record.txnId ) == transactions.end() )
+			{
+				order.push_back( record.txnId );
+			}
+			transactions[ record.txnId ].push_back( record );
+			if( record.recordType == WAL_INSERT || record.recordType == WAL_UPDATE ||
+				record.recordType == WAL_DELETE )
+			{
+				changed.insert( record.txnId );
+			}
+		}
+	}
+
+	for( unsigned int index = 0; index < order.size(); index++ )
+	{
+		uint64_t txnId = order[ index ];
+		if( !committed.count( txnId ) )
+		{
+			discarded += changed.count( txnId );
+		}
+		else if( !applied.count( txnId ) )
+		{
+			if( !applyTransaction( logFd, databasePath, txnId, transactions[ txnId ] ) )
+			{
+				cursor.offset = txnId;
+				checkpointLog( logFd, databasePath, false );
+				return;
+			}
+			redone++;
+		}
+	}
+	cursor.offset = lseek( logFd, 0, SEEK_END );
+	checkpointLog( logFd, databasePath, false );
+}
+
+/**
+ * @brief checkpointLog
+ *
+ * @details moves the checkpoint of a log up to the first transaction that is
+ *          not applied, so replay never reads further back than that
+ *
+ * @pre the log is open and locked, replayLog ran
+ *
+ * @post once every transaction is applied the log is emptied and its
+ *       generation changed, which tells other processes to start over
+ *
+ * @par Algorithm a checkpoint is only taken when the log grew
+ *      WAL_CHECKPOINT_BYTES past the last one, so startup replays at most
+ *      that much log plus the transactions that are still to be applied
+ *
+ * @param [in] int logFd
+ *
+ * @param [in] string databasePath
+ *
+ * @param [in] bool force take a checkpoint however little log there is
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::checkpointLog( int logFd, string databasePath, bool force )
+{
+	WalCursor &cursor = cursors[ databasePath ];
+	uint64_t generation;
+	uint64_t checkpoint;
+	off_t logSize = lseek( logFd, 0, SEEK_END );
+	if( !readLogHeader( logFd, generation, checkpoint ) ||
+		( !force && cursor.offset - (off_t)checkpoint < WAL_CHECKPOINT_BYTES ) )
+	{
+		return;
+	}
+
+	if( cursor.offset == logSize )
+	{
+		if( logSize > WAL_HEADER_SIZE && ftruncate( logFd, WAL_HEADER_SIZE ) == 0 &&
+			writeLogHeader( logFd, generation + 1, WAL_HEADER_SIZE ) )
+		{
+			cursor.generation = generation + 1;
+			cursor.offset = WAL_HEADER_SIZE;
+		}
+	}
+	else if( cursor.offset > (off_t)checkpoint )
+	{
+		writeLogHeader( logFd, generation, cursor.offset );
+	}
+}
+
+/**
+ * @brief applyTransaction
+ *
+ * @details applies one committed transaction to its tables
+ *
+ * @pre the log is open and locked
+ *
+ * @post the transaction is marked applied in the log
+ *
+ * @par Algorithm a table whose new version was already staged by an earlier
+ *      attempt is only installed, every other table is rebuilt from the row
+ *      changes
+ *
+ * @param [in] int logFd
+ *
+ * @param [in] string databasePath
+ *
+ * @param [in] uint64_t txnId
+ *
+ * @param [in] vector< WalRecord > &records every record of the transaction
+ *
+ * @return bool false if a table could not be applied
+ *
+ * @note None
+ */
+bool WriteAheadLog::applyTransaction( int logFd, string databasePath, uint64_t txnId,
+										const vector< WalRecord > &records )
+{
+	vector< string > tableNames;
+	map< string, TableDelta > deltas;
+	map< string, map< uint32_t, string > > pageImages;
+	set< string > staged;
+
+	for( unsigned int index = 0; index < records.size(); index++ )
+	{
+		const WalRecord &record = records[ index ];
+		if( record.recordType == WAL_PAGE && !record.row.empty() )
+		{
+			pageImages[ record.tableName ][ record.pageNo ] = record.row[ 0 ];
+		}
+		else if( record.recordType == WAL_STAGED )
+		{
+			staged.insert( record.tableName );
+		}
+		else
+		{
+			if( deltas.find( record.tableName ) == deltas.end() )
+			{
+				tableNames.push_back( record.tableName );
+			}
+			applyRecordToDelta( deltas[ record.tableName ], record.recordType, record.rid, record.row );
+		}
+	}
+
+	for( unsigned int index = 0; index < tableNames.size(); index++ )
+	{
+		string tableName = tableNames[ index ];
+		string tablePath = databasePath + "/" + tableName;
+		bool success = true;
+
+		if( staged.count( tableName ) )
+		{
+			if( pageImages.count( tableName ) )
+			{
+				success = installPages( tablePath, pageImages[ tableName ] );
+			}
+			else if( fileExists( tablePath + APPLY_SUFFIX ) )
+			{
+				success = rename( ( tablePath + APPLY_SUFFIX ).c_str(), tablePath.c_str() ) == 0;
+			}
+		}
+		else if( fileExists( tablePath ) )
+		{
+			if( PageFile::isPageFile( tablePath ) )
+			{
+				success = applyPageTable( logFd, databasePath, txnId, tableName, deltas[ tableName ] );
+			}
+			else
+			{
+				success = applyTextTable( logFd, databasePath, txnId, tableName, deltas[ tableName ] );
+			}
+		}
+
+		if( !success )
+		{
+			return false;
+		}
+	}
+
+	syncPath( databasePath );
+	WalRecord done;
+	done.recordType = WAL_APPLIED;
+	done.txnId = txnId;
+	done.rid = 0;
+	done.pageNo = 0;
+	string buffer;
+	encodeRecord( done, buffer );
+	return writeAll( logFd, buffer ) && fdatasync( logFd ) == 0;
+}
+
+/**
+ * @brief applyTextTable
+ *
+ * @details applies the changes of a transaction to a text table
+ *
+ * @par Algorithm the table is rebuilt next to itself with the changes laid
+ *      over its rows, synced, marked staged in the log and renamed over the
+ *      table, so a crash leaves either version complete. The indexes of
+ *      the table are rebuilt after it
+ *
+ * @param [in] int logFd
+ *
+ * @param [in] string databasePath
+ *
+ * @param [in] uint64_t txnId
+ *
+ * @param [in] string tableName
+ *
+ * @param [in] TableDelta &delta
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool WriteAheadLog::applyTextTable( int logFd, string databasePath, uint64_t txnId,
+									string tableName, TableDelta &delta )
+{
+	string tablePath = databasePath + "/" + tableName;
+	string stagePath = tablePath + APPLY_SUFFIX;
+	TableScan scan;
+	TableWriter writer;
+	vector< string > row;
+	bool rowMatches;
+
+	if( !scan.scanOpen( tablePath ) || !writer.writerCreate( stagePath, scan.attributeData, false ) )
+	{
+		return false;
+	}
+	scan.scanSetDelta( &delta );
+	bool success = true;
+	while( scan.scanNext( row, rowMatches ) )
+	{
+		success = writer.writeRow( row ) && success;
+	}
+	writer.writerClose();
+	scan.scanClose();
+	if( !success || !syncPath( stagePath ) )
+	{
+		return false;
+	}
+
+	WalRecord record;
+	record.recordType = WAL_STAGED;
+	record.txnId = txnId;
+	record.tableName = tableName;
+	record.rid = 0;
+	record.pageNo = 0;
+	string buffer;
+	encodeRecord( record, buffer );
+	if( !writeAll( logFd, buffer ) || fdatasync( logFd ) != 0 ||
+		rename( stagePath.c_str(), tablePath.c_str() ) != 0 )
+	{
+		return false;
+	}
+	refreshTableIndexes( tablePath );
+	return true;
+}
+
+/**
+ * @brief applyPageTable
+ *
+ * @details applies the changes of a transaction to a page table
+ *
+ * @par Algorithm the changes are made to staged copies of the pages they
+ *      touch. The page images go to the log before they are written over
+ *      the table, so only the changed pages are written and a crash in
+ *      between is repaired by writing the images again. The indexes of the
+ *      table follow each row, an index a crash left behind is rebuilt
+ *
+ * @param [in] int logFd
+ *
+ * @param [in] string databasePath
+ *
+ * @param [in] uint64_t txnId
+ *
+ * @param [in] string tableName
+ *
+ * @param [in] TableDelta &delta
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool WriteAheadLog::applyPageTable( int logFd, string databasePath, uint64_t txnId,
+									string tableName, TableDelta &delta )
+{
+	string tablePath = databasePath + "/" + tableName;
+	map< uint32_t, string > pages;
+	PageFile pageFile;
+	TableIndexes indexes;
+	vector< Attribute > attributes;
+	vector< string > oldRow;
+	long rid;
+
+	if( !pageFile.pageFileOpen( tablePath ) )
+	{
+		return false;
+	}
+	attributes = schemaCatalog.catalogSchema( tablePath, pageFile.attributeData.data(),
+												pageFile.attributeData.size(), true ).attributes;
+	bool indexed = indexes.indexesOpen( tablePath, &attributes );
+	pageFile.pageFileStage( &pages );
+
+	//deletes first so updates and inserts can use the space they free,
+	//indexes are told the stored row before it changes
+	set< long >::iterator deleted;
+	for( deleted = delta.deletedRows.begin(); deleted != delta.deletedRows.end(); ++deleted )
+	{
+		if( indexed && pageFile.readRow( *deleted, oldRow ) )
+		{
+			indexes.rowDeleted( oldRow, *deleted );
+		}
+		pageFile.deleteRow( *deleted );
+	}
+	map< long, vector< string > >::iterator updated;
+	for( updated = delta.updatedRows.begin(); updated != delta.updatedRows.end(); ++updated )
+	{
+		rid = updated->first;
+		bool oldRead = indexed && pageFile.readRow( rid, oldRow );
+		if( pageFile.updateRow( rid, updated->second ) && oldRead )
+		{
+			indexes.rowUpdated( oldRow, updated->first, updated->second, rid );
+		}
+	}
+	for( unsigned int index = 0; index < delta.insertedRows.size(); index++ )
+	{
+		if( delta.insertedLive[ index ] && pageFile.insertRow( delta.insertedRows[ index ], rid ) && indexed )
+		{
+			indexes.rowInserted( delta.insertedRows[ index ], rid );
+		}
+	}
+	pageFile.pageFileStage( NULL );
+	pageFile.pageFileClose();
+
+	string buffer;
+	WalRecord record;
+	record.txnId = txnId;
+	record.tableName = tableName;
+	record.rid = 0;
+	map< uint32_t, string >::iterator page;
+	for( page = pages.begin(); page != pages.end(); ++page )
+	{
+		record.recordType = WAL_PAGE;
+		record.pageNo = page->first;
+		record.row.assign( 1, page->second );
+		encodeRecord( record, buffer );
+	}
+	record.recordType = WAL_STAGED;
+	record.pageNo = 0;
+	record.row.clear();
+	encodeRecord( record, buffer );
+	if( !writeAll( logFd, buffer ) || fdatasync( logFd ) != 0 )
+	{
+		return false;
+	}
+	bool installed = installPages( tablePath, pages );
+	indexes.indexesClose( installed );
+	return installed;
+}
+
+/**
+ * @brief installPages
+ *
+ * @details writes logged page images over a page table
+ *
+ * @param [in] string tablePath
+ *
+ * @param [in] map< uint32_t, string > &pages
+ *
+ * @return bool
+ *
+ * @note None
+ */
+bool WriteAheadLog::installPages( string tablePath, const map< uint32_t, string > &pages )
+{
+	PageFile pageFile;
+	if( !pageFile.pageFileOpen( tablePath ) )
+	{
+		return false;
+	}
+	bool success = pageFile.pageFileInstall( pages );
+	pageFile.pageFileClose();
+	return success;
+}
+
+/**
+ * @brief waitForApplier
+ *
+ * @details waits until the background apply of the last commit is done
+ *
+ * @return None
+ *
+ * @note None
+ */
+void WriteAheadLog::waitForApplier()
+{
+	if( applier.joinable() )
+	{
+		applier.join();
+	}
+}
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
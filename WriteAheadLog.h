@@ -0,0 +1,124 @@
+// Program Information ////////////////////////////////////////////////////////
+/**
+ * @file WriteAheadLog.h
+ *
+ * @brief Definition file for WriteAheadLog class
+ *
+ * @details Specifies all member methods of the WriteAheadLog class, the per
+ *          database log that transactional changes are committed to before
+ *          they reach the table files
+ *
+ * @Note None
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <thread>
+#include <stdint.h>
+#include <sys/types.h>
+
+using namespace std;
+
+// Precompiler directives /////////////////////////////////////////////////////
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+//log file kept in every database directory
+const string WAL_FILE = ".wal";
+const char WAL_MAGIC[] = "WLOG";
+const uint32_t WAL_VERSION = 1;
+
+//header layout, the checkpoint is the offset replay starts from
+const int WAL_HEADER_MAGIC = 0;
+const int WAL_HEADER_VERSION = 4;
+const int WAL_HEADER_GENERATION = 8;
+const int WAL_HEADER_CHECKPOINT = 16;
+const int WAL_HEADER_SIZE = 24;
+
+//a checkpoint is taken once this much log lies past the last one
+const off_t WAL_CHECKPOINT_BYTES = 1024 * 1024;
+
+//suffix of the file a text table is rebuilt into before it replaces the table
+const string APPLY_SUFFIX = "_apply_temp";
+
+//record types, row changes and the commit are written together at commit
+const char WAL_INSERT = 'I';
+const char WAL_UPDATE = 'U';
+const char WAL_DELETE = 'D';
+const char WAL_COMMIT = 'C';
+//page image of a page table, written before the page itself
+const char WAL_PAGE = 'P';
+//the new version of a table is staged and only has to be installed
+const char WAL_STAGED = 'S';
+//every table of the transaction was applied
+const char WAL_APPLIED = 'A';
+
+struct WalRecord{
+	char recordType;
+	uint64_t txnId;
+	string tableName;
+	long rid;
+	vector< string > row;
+	uint32_t pageNo;
+};
+
+//changes of one transaction to one table, rows inserted by the transaction
+//have the negative row ids -1, -2, ...
+struct TableDelta{
+	map< long, vector< string > > updatedRows;
+	set< long > deletedRows;
+	vector< vector< string > > insertedRows;
+	vector< bool > insertedLive;
+};
+
+//how far this process has applied the log of a database
+struct WalCursor{
+	uint64_t generation;
+	ino_t inode;
+	off_t offset;
+};
+
+class WriteAheadLog{
+	public:
+		WriteAheadLog();
+		~WriteAheadLog();
+
+		TableDelta *walGetDelta( string tablePath );
+		void walInsert( string tablePath, const vector< string > &row );
+		void walUpdate( string tablePath, long rid, const vector< string > &row );
+		void walDelete( string tablePath, long rid );
+		bool walCommit();
+		void walAbort();
+		void walCatchUp( string databasePath );
+		void walRecover( string databasePath, int &redone, int &discarded );
+
+	private:
+		//uncommitted changes of the open transaction
+		map< string, TableDelta > pendingDeltas;
+		map< string, vector< WalRecord > > pendingRecords;
+		map< string, WalCursor > cursors;
+		thread applier;
+
+		void logChange( string tablePath, char recordType, long rid, const vector< string > &row );
+		void applyLogs( vector< string > databasePaths );
+		void applyLog( string databasePath );
+		void replayLog( int logFd, string databasePath, int &redone, int &discarded );
+		void checkpointLog( int logFd, string databasePath, bool force );
+		bool applyTransaction( int logFd, string databasePath, uint64_t txnId,
+								const vector< WalRecord > &records );
+		bool applyTextTable( int logFd, string databasePath, uint64_t txnId,
+								string tableName, TableDelta &delta );
+		bool applyPageTable( int logFd, string databasePath, uint64_t txnId,
+								string tableName, TableDelta &delta );
+		bool installPages( string tablePath, const map< uint32_t, string > &pages );
+		void waitForApplier();
+};
+
+//the log of the transaction the process has open
+extern WriteAheadLog writeAheadLog;
+
+// Terminating precompiler directives  ////////////////////////////////////////
+#endif
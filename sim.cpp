@@ -25,10 +25,13 @@
 #include <cstdlib>
 #include <cstring>
 #include <cctype>
+#include <algorithm>
 #include <fstream>
 #include <stdlib.h>
 #include <unistd.h>
 #include "Database.cpp"
+#include "SqlParser.cpp"
+#include "CatalogCache.cpp"
 
 #include <stdio.h>
 
@@ -36,6 +39,7 @@ using namespace std;
 
 const string DATABASE_TYPE = "DATABASE";
 const string TABLE_TYPE = "TABLE";
+const string INDEX_TYPE = "INDEX";
 
 const string DROP = "DROP";
 const string CREATE = "CREATE";
@@ -46,6 +50,11 @@ const string INSERT = "INSERT";
 const string UPDATE = "UPDATE";
 const string DELETE = "DELETE";
 const string EXIT = ".EXIT";
+const string BUFFERPOOL = ".BUFFERPOOL";
+const string JOINMEMORY = ".JOINMEMORY";
+const string SORTMEMORY = ".SORTMEMORY";
+const string THREADS = ".THREADS";
+const string STATISTICS = ".STATISTICS";
 
 bool BEGINTRANSACTION = false;
 
@@ -64,50 +73,18 @@ bool stringValid( string str );
 //removes semicolon for easier parsing
 bool removeSemiColon( string &input );
 //starts specific action (aka create)
-bool startEvent( string input, vector< Database> &dbms, string currentWorkingDirectory, string &currentDatabase );
-//helper function to get next word for parsing
-string getNextWord( string &input );
-//helper function to check that db exists
-bool databaseExists( vector<Database> dbms, Database dbInput, int &dbReturn );
-//removes database from vector and deletes from disk
-void removeDatabase( vector< Database > &dbms, int index );
-//removes table from disk and vector
-void removeTable( vector< Database > &dbms, int dbReturn, int tblReturn );
+bool startEvent( string input, CatalogCache &catalogCache, string currentWorkingDirectory, string &currentDatabase );
 //outputs errors to user
 void handleError( int errorType, string commandError, string errorContainerName );
 //helper function, converts string to LC
 void convertToLC( string &input );
 //helper function, converts string to UC
 void convertToUC( string &input );
-//gets type of query, * or attribute type
-string getQueryType( string &input );
-//returns where condition
-string getWhereCondition( string &input );
-//returns set condition for update table
-string getSetCondition( string &input );
 //removes new line chars from strings for easier parsing
 void removeNewLine( string &input );
-//returns next word without deleting word from input string
-string returnNextWord( string input );
-//checks for inner join (a comma b/w table names)
-bool checkJoin( string & input, string &LHS );
-//checks for inner join
-bool checkInnerJoin( string & input, string &LHS  );
-//checks for left outer join
-bool checkOuterJoin( string & input, string &LHS  );
-//helper function, gets the table variable
-string getTableVariable( string &input );
-//helper function, gets LHS and stores RHS of = join into input
-string returnLHSJoinComparison( string &input );
-//helper parse function, gets LHS 
-string getOnCondition( string &input );
 
 void removeCarriageReturn( string &input );
 
-Database* getDatabase( vector< Database > &dbms, string databaseName );
-
-void getDatabaseStructure( vector<Database> &dbms, string databaseSystemDirectory );
-
 /**
  * @brief read_Directory method
  *
@@ -167,9 +144,18 @@ void startSimulation( string currentWorkingDirectory )
 	string input;
 	string temp;
 	string currentDatabase;
-	vector< Database > dbms;
+	CatalogCache catalogCache;
 
 	bool simulationEnd = false;
+
+	//list the catalog once, then bring every database to a consistent state
+	//before the first statement
+	catalogCache.cacheLoad( currentWorkingDirectory );
+	for( unsigned int index = 0; index < catalogCache.databases.size(); index++ )
+	{
+		catalogCache.databases[ index ].databaseRecover( currentWorkingDirectory );
+	}
+
 	do{
 		getline( cin, input );
 
@@ -195,9 +181,12 @@ void startSimulation( string currentWorkingDirectory )
 		//first checks that data is valid, if not valid will not check for semi colon
 		if(  !simulationEnd && stringValid( input ) ) 
 		{ 
-			getDatabaseStructure( dbms, currentWorkingDirectory );
+			//apply the databases and tables other processes created or dropped
+			catalogCache.cacheRefresh();
+			//apply transactions other processes committed
+			writeAheadLog.walCatchUp( currentDatabase.empty() ? "" : currentWorkingDirectory + "/" + currentDatabase );
 			//call helper function to check if modifying db or tbl
-			simulationEnd = startEvent( input, dbms, currentWorkingDirectory, currentDatabase );
+			simulationEnd = startEvent( input, catalogCache, currentWorkingDirectory, currentDatabase );
 		}
 	}while( simulationEnd == false );
 
@@ -283,10 +272,11 @@ bool removeSemiColon( string &input )
 	//if semi colon does not exist or is not at the end
 	if( semiExists == false )
 	{
-		//if input is exit then we are fine
+		//if input is exit or another dot command then we are fine
 		string temp = input;
 		convertToUC( temp );
-		if( temp == EXIT )
+		removeLeadingWS( temp );
+		if( temp == EXIT || ( !temp.empty() && temp[ 0 ] == '.' ) )
 		{
 			return true;
 		}
@@ -307,219 +297,125 @@ bool removeSemiColon( string &input )
  *
  * @details Initiates action to take: create, use, drop, select, alter
  *          
- * @pre input and dbms exists
+ * @pre input and catalogCache exists
  *
  * @post action is done
  *
  * @par Algorithm 
- *      stores data into DB class and into tables
+ *      parses the statement into a SqlStatement, then runs it on the
+ *      database and tables it names
  *      
  * @exception None
  *
  * @param [in] input provides string of input command
  *
- * @param [out] dbms provides system of database to add databases and tables
+ * @param [in/out] catalogCache provides system of database to add databases and tables
  *
  * @return None
  *
  * @note None
  */
-bool startEvent( string input, vector< Database> &dbms, string currentWorkingDirectory, string &currentDatabase )
+bool startEvent( string input, CatalogCache &catalogCache, string currentWorkingDirectory, string &currentDatabase )
 {
 	bool exitProgram = false;
 	bool errorExists = false;
 	bool attrError = false;
 
-	//bool tblExists;
-	int dbReturn;
 	int tblReturn;
 	int errorType;
-	string originalInput = input;
 	string errorContainerName;
+	SqlParser parser;
+	SqlStatement statement;
 
-	//get first action word & convert to uppercase
-	string temp = getNextWord( input );
-	convertToUC( temp );
-	string actionType = temp;
-
-	string containerType;
-
-	if( caseInsCompare( actionType, SELECT ) )
+	if( !parser.parseStatement( input, statement ) )
 	{
-		bool dbExists = true;
-		bool tblExists = true;
-
-		Database* dbTemp = getDatabase( dbms, currentDatabase );
-		if( dbTemp == NULL )
-		{
-			dbExists = false;
-		}
-
-		//get all words before from
-		string qType = getQueryType( input );
-
-		//get table name
-		string tName = getNextWord( input );
+		handleError( ERROR_INCORRECT_COMMAND, statement.action, input );
+		return false;
+	}
+	string actionType = statement.action;
+	Database* dbTemp = catalogCache.cacheGetDatabase( currentDatabase );
 
-		Table tblTemp;
-		tblTemp.tableName = tName;
-		Table* tblTempPtr = dbTemp->getTable( tblTemp.tableName );
-		if( tblTempPtr == NULL )
-		{
-			tblExists = false;
-		}
+	if( statement.type == STATEMENT_SELECT )
+	{
+		Table* tblTempPtr = dbTemp == NULL ? NULL : dbTemp->getTable( statement.tables[ 0 ].name );
 
-		//join parsing
-		if( returnNextWord( input ) != "where" && !returnNextWord( input ).empty() )
+		if( statement.joinType != JOIN_NONE )
 		{
-			string table1Var; 
-			string table2Var;
-			string table1Attr;
-			string table2Attr;
-			string joinCondition;
-			Table tblTemp2;
-
-			if( checkJoin( input, table1Var ) )
-			{
-				tblTemp2.tableName = getNextWord( input );
-				table2Var = getNextWord( input );
-
-				joinCondition = getWhereCondition( input );
-
-				string LHS = returnLHSJoinComparison( joinCondition );
-
-				string tempVar1 = getTableVariable( LHS );
-				string tempVar2 = getTableVariable( joinCondition );
-
-				if( tempVar1 == table1Var && tempVar2 == table2Var )
-				{
-					table1Attr = LHS;
-					table2Attr = joinCondition;
-				}
-				else
-				{
-					table1Attr = joinCondition;
-					table2Attr = LHS;
-				}
-				if( !dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn ) || 
-					!dbms[ dbReturn ].tableExists( tblTemp2.tableName, tblReturn ) )
-				{
-					errorExists = true;
-					errorType = ERROR_TBL_NOT_EXISTS;
-					errorContainerName = tblTemp.tableName + " and " + tblTemp2.tableName;	
-				}
-				else
-				{
-					tblTemp.innerJoin( currentWorkingDirectory, currentDatabase, tblTemp.tableName, table1Attr, tblTemp2.tableName , table2Attr );
-				}
-			}
-			else if( checkInnerJoin( input, table1Var ) )
-			{
-				tblTemp2.tableName = getNextWord( input );
-				table2Var = getNextWord( input );
-
-				joinCondition = getOnCondition( input );
-
-				string LHS = returnLHSJoinComparison( joinCondition );
-
-				string tempVar1 = getTableVariable( LHS );
-				string tempVar2 = getTableVariable( joinCondition );
+			Table* tblTemp2Ptr = dbTemp == NULL ? NULL : dbTemp->getTable( statement.tables[ 1 ].name );
 
-				if( tempVar1 == table1Var && tempVar2 == table2Var )
-				{
-					table1Attr = LHS;
-					table2Attr = joinCondition;
-				}
-				else
-				{
-					table1Attr = joinCondition;
-					table2Attr = LHS;
-				}
-				if( !dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn ) || 
-					!dbms[ dbReturn ].tableExists( tblTemp2.tableName, tblReturn ) )
-				{
-					errorExists = true;
-					errorType = ERROR_TBL_NOT_EXISTS;
-					errorContainerName = tblTemp.tableName + " and " + tblTemp2.tableName;	
-				}
-				else
-				{
-					tblTemp.innerJoin( currentWorkingDirectory, currentDatabase, tblTemp.tableName, table1Attr, tblTemp2.tableName , table2Attr );
-				}
-			}
-			else if( checkOuterJoin( input, table1Var ) )
+			//the column of each table is the one qualified by its alias
+			ColumnReference table1Attr = statement.joinLeft;
+			ColumnReference table2Attr = statement.joinRight;
+			if( table1Attr.qualifier != statement.tables[ 0 ].alias ||
+				table2Attr.qualifier != statement.tables[ 1 ].alias )
 			{
-				tblTemp2.tableName = getNextWord( input );
-				table2Var = getNextWord( input );
-
-				joinCondition = getOnCondition( input );
-
-				string LHS = returnLHSJoinComparison( joinCondition );
-
-				string tempVar1 = getTableVariable( LHS );
-				string tempVar2 = getTableVariable( joinCondition );
-
-				if( tempVar1 == table1Var && tempVar2 == table2Var )
-				{
-					table1Attr = LHS;
-					table2Attr = joinCondition;
-				}
-				else
-				{
-					table1Attr = joinCondition;
-					table2Attr = LHS;
-				}
-				if( !dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn ) || 
-					!dbms[ dbReturn ].tableExists( tblTemp2.tableName, tblReturn ) )
-				{
-					errorExists = true;
-					errorType = ERROR_TBL_NOT_EXISTS;
-					errorContainerName = tblTemp.tableName + " and " + tblTemp2.tableName;	
-				}
-				else
-				{
-					tblTemp.outerJoin( currentWorkingDirectory, currentDatabase, tblTemp.tableName, table1Attr, tblTemp2.tableName , table2Attr );
-				}
+				swap( table1Attr, table2Attr );
 			}
 
-		}
-		//normal query parsing and output
-		else
-		{
-			string cType = getWhereCondition( input );
-
-			if( !dbExists )
+			if( dbTemp == NULL )
 			{
 				errorExists = true;
 				errorType = ERROR_DB_NOT_EXISTS;
-				errorContainerName = currentDatabase;	
+				errorContainerName = currentDatabase;
 			}
-			else if( !tblExists )
+			else if( tblTempPtr == NULL || tblTemp2Ptr == NULL )
 			{
 				errorExists = true;
 				errorType = ERROR_TBL_NOT_EXISTS;
-				errorContainerName = tblTemp.tableName;		
+				errorContainerName = statement.tables[ 0 ].name + " and " + statement.tables[ 1 ].name;
+			}
+			else if( statement.explain )
+			{
+				tblTempPtr->joinExplain( currentWorkingDirectory, currentDatabase, tblTempPtr->tableName,
+											table1Attr.column, tblTemp2Ptr->tableName, table2Attr.column,
+											statement.joinType == JOIN_LEFT_OUTER );
+			}
+			else if( statement.joinType == JOIN_INNER )
+			{
+				tblTempPtr->innerJoin( currentWorkingDirectory, currentDatabase, tblTempPtr->tableName,
+										table1Attr.column, tblTemp2Ptr->tableName, table2Attr.column );
 			}
 			else
 			{
-				tblTempPtr->tableSelect( currentWorkingDirectory, currentDatabase, cType, qType );
-				//tblTemp.tableSelect( currentWorkingDirectory, currentDatabase, cType, qType );
+				tblTempPtr->outerJoin( currentWorkingDirectory, currentDatabase, tblTempPtr->tableName,
+										table1Attr.column, tblTemp2Ptr->tableName, table2Attr.column );
 			}
 		}
-
+		//normal query parsing and output
+		else if( dbTemp == NULL )
+		{
+			errorExists = true;
+			errorType = ERROR_DB_NOT_EXISTS;
+			errorContainerName = currentDatabase;	
+		}
+		else if( tblTempPtr == NULL )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_NOT_EXISTS;
+			errorContainerName = statement.tables[ 0 ].name;
+		}
+		else if( statement.explain )
+		{
+			tblTempPtr->tableExplain( currentWorkingDirectory, currentDatabase, statement.whereClause );
+		}
+		else
+		{
+			tblTempPtr->tableSelect( currentWorkingDirectory, currentDatabase, statement.whereClause,
+										statement.selectList, statement.groupClause, statement.orderClause,
+										statement.limitClause );
+		}
 	}
-	else if( caseInsCompare( actionType, USE) )
+	else if( statement.type == STATEMENT_USE )
 	{
-		
 		Database dbTemp;
-		dbTemp.databaseName = input;
-		bool dbExists = databaseExists( dbms, dbTemp, dbReturn );
+		dbTemp.databaseName = statement.name;
+		Database* dbFound = catalogCache.cacheGetDatabase( dbTemp.databaseName );
 		
 		//check if database exists
-		if( dbExists )
+		if( dbFound != NULL )
 		{
-			//if it does then set current database as string
-			currentDatabase = dbTemp.databaseName;
+			//if it does then set current database as the name it was created with
+			currentDatabase = dbFound->databaseName;
 			dbTemp.databaseUse();
 		}
 		else
@@ -530,365 +426,192 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 			errorType = ERROR_DB_NOT_EXISTS; 
 		}
 	}
-	else if( caseInsCompare( actionType, CREATE ) ) 
+	else if( statement.type == STATEMENT_CREATE_DATABASE )
 	{
-		//get string if we are modifying table or db
-		temp = getNextWord( input );
-		convertToUC( temp );
-		containerType = temp;
-
-		//databse create
-		if( containerType == DATABASE_TYPE )
-		{
-			Database dbTemp;
-			//call Create db function
-			dbTemp.databaseName = input;
-			//check that db does not exist already
-			bool dbExists = databaseExists( dbms, dbTemp, dbReturn );
-
-			if( dbExists )
-			{
-				//if it does then return error message
-				errorExists = true;
-				errorContainerName = dbTemp.databaseName;
-				errorType = ERROR_DB_EXISTS; 
-			}
-			else
-			{
-				//if it does not, return success message and push onto vector
-				dbms.push_back( dbTemp );
-
-				//create directory
-				dbTemp.databaseCreate();
-			}
-		}
-		//table create
-		else if( caseInsCompare( containerType, TABLE_TYPE ) )
+		Database dbTemp;
+		//call Create db function
+		dbTemp.databaseName = statement.name;
+		//check that db does not exist already
+		if( catalogCache.cacheGetDatabase( dbTemp.databaseName ) != NULL )
 		{
-			//call create tbl function
-			Database dbTemp;
-			dbTemp.databaseName = currentDatabase;
-			//get dbReturn of database
-			databaseExists( dbms, dbTemp, dbReturn );
-			
-			// make sure the input does not specify multiple tables 
-			size_t pos = input.find("(");
-			string temp = input.substr(0, pos);
-			removeLeadingWS( temp );
-
-			//get table name 
-			Table tblTemp;
-			tblTemp.tableTempName = tblTemp.tableName = getNextWord( temp );
-			tblTemp.tableIsLocked = false;
-
-			//check that table exists
-			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
-			{
-				//check that table attributes are not the same
-				tblTemp.tableCreate( currentWorkingDirectory, currentDatabase, tblTemp.tableName, input, attrError );
-				if( !attrError  )
-				{
-					//if it doesnt then push table onto database	
-					dbms[ dbReturn ].databaseTable.push_back( tblTemp );
-				}
-			}
-			else
-			{
-				//if it does than handle error
-			 	errorExists = true;
-			 	errorType = ERROR_TBL_EXISTS;
-			 	errorContainerName = tblTemp.tableName;	
-			}
+			//if it does then return error message
+			errorExists = true;
+			errorContainerName = dbTemp.databaseName;
+			errorType = ERROR_DB_EXISTS; 
 		}
 		else
 		{
-			errorExists = true;
-			errorType = ERROR_INCORRECT_COMMAND;
-			errorContainerName = originalInput;	
-		}
+			//if it does not, return success message and add to the catalog
+			catalogCache.cacheAddDatabase( dbTemp.databaseName );
 
+			//create directory
+			dbTemp.databaseCreate();
+		}
 	}
-	else if( actionType.compare( DROP ) == 0 )
+	else if( statement.type == STATEMENT_CREATE_TABLE )
 	{
-		temp = getNextWord( input );
-		convertToUC( temp );
-		containerType = temp;
+		//get table name 
+		Table tblTemp;
+		tblTemp.tableTempName = tblTemp.tableName = statement.name;
+		tblTemp.tableIsLocked = false;
 
-		if( containerType == DATABASE_TYPE )
+		if( dbTemp == NULL )
 		{
-			//create temp db to be dropped
-			Database dbTemp;
-			dbTemp.databaseName = input;
-
-			//check if database exists
-			if( databaseExists( dbms, dbTemp, dbReturn ) != true )
-			{
-				//if it does not then return error message
-				errorExists = true;
-				errorContainerName = dbTemp.databaseName;
-				errorType = ERROR_DB_NOT_EXISTS; 
-			}
-			else
-			{
-				//if it does, return success message and remove from dbReturn element
-				removeDatabase( dbms, dbReturn );
-
-				//remove directory
-				dbTemp.databaseDrop(currentWorkingDirectory);
-			}
-
-
+			errorExists = true;
+			errorType = ERROR_DB_NOT_EXISTS;
+			errorContainerName = currentDatabase;
 		}
-		else if( containerType == TABLE_TYPE )
+		//check that table exists
+		else if( !( dbTemp->tableExists( tblTemp.tableName, tblReturn ) ) )
 		{
-			//call drop tbl function
-			Database dbTemp;
-			dbTemp.databaseName = currentDatabase;
-			databaseExists( dbms, dbTemp, dbReturn );
-
-			Table tblTemp;
-			tblTemp.tableName = getNextWord( input );
-
-			//check if table exists
-			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
-			{
-				//if it doesnt exist then return error
-				errorExists = true;
-				errorType = ERROR_TBL_NOT_EXISTS;
-				errorContainerName = tblTemp.tableName;
-			}
-			else
+			//check that table attributes are not the same
+			tblTemp.tableCreate( currentWorkingDirectory, currentDatabase, tblTemp.tableName,
+									statement.definition, attrError );
+			if( !attrError  )
 			{
-				//table exists and remove from database
-				removeTable( dbms, dbReturn, tblReturn );
-
-				//remove table/file
-				tblTemp.tableDrop(currentWorkingDirectory, currentDatabase );
+				//if it doesnt then add table to database	
+				dbTemp->addTable( tblTemp );
 			}
 		}
 		else
 		{
+			//if it does than handle error
 			errorExists = true;
-			errorType = ERROR_INCORRECT_COMMAND;
-			errorContainerName = originalInput;	
-		}
-	}
-	else if( actionType.compare( ALTER ) == 0 ) 
-	{
-		containerType = getNextWord( input );
-		if( containerType == TABLE_TYPE )
-		{
-			//call alter tbl function
-			Database dbTemp;
-			dbTemp.databaseName = currentDatabase;
-			databaseExists( dbms, dbTemp, dbReturn );
-
-			Table tblTemp;
-			tblTemp.tableName = getNextWord( input );
-
-			//check if table exists
-			if( !(dbms[ dbReturn ].tableExists( tblTemp.tableName, tblReturn )) )
-			{
-				//if it doesnt exist then return error
-				errorExists = true;
-				errorType = ERROR_TBL_NOT_EXISTS;
-				errorContainerName = tblTemp.tableName;
-			}
-			else
-			{
-				//remove table/file
-				tblTemp.tableAlter( currentWorkingDirectory, currentDatabase, input, attrError );	
-			}
+			errorType = ERROR_TBL_EXISTS;
+			errorContainerName = tblTemp.tableName;	
 		}
 	}
-	else if( actionType.compare( INSERT ) == 0 )
+	//index create, name ON table( attribute )
+	else if( statement.type == STATEMENT_CREATE_INDEX )
 	{
-		temp = getNextWord( input );
-		//check that temp is into
-		if( temp != "into" )
-		{
-			errorExists = true;
-			errorType = ERROR_INCORRECT_COMMAND;
-			errorContainerName = originalInput;	
-		}
-
-		//check that current db exists
-		bool dbExists = true;
-		bool tblExists = true;
+		Table* tblTempPtr = dbTemp == NULL ? NULL : dbTemp->getTable( statement.indexTable );
 
-		Database *dbTemp = getDatabase( dbms, currentDatabase );
 		if( dbTemp == NULL )
-		{
-			//db does not exist
-			dbExists = false;
-		}
-
-		string tableName = getNextWord( input );
-
-		Table *tblTemp = dbTemp->getTable( tableName );
-
-		if( tblTemp == NULL )
-		{
-			//table doesent exist
-			tblExists = false;
-		}
-
-		if( !dbExists )
 		{
 			errorExists = true;
 			errorType = ERROR_DB_NOT_EXISTS;
 			errorContainerName = currentDatabase;
 		}
-		else if( !tblExists )
+		else if( tblTempPtr == NULL )
 		{
-			//if it doesnt exist then return error
 			errorExists = true;
 			errorType = ERROR_TBL_NOT_EXISTS;
-			errorContainerName = tableName;
+			errorContainerName = statement.indexTable;
 		}
 		else
 		{
-			//table exists and we can modify it
-			//return only stuff between parentheses
-			input.erase( 0, input.find( "(" ) + 1 );
-			input.erase( input.find_last_of( ")" ), input.length()-1 );
-
-			tblTemp->tableInsert( currentWorkingDirectory, currentDatabase, tblTemp->tableName, input, attrError, BEGINTRANSACTION );
-		}	
+			tblTempPtr->tableCreateIndex( currentWorkingDirectory, currentDatabase, statement.name,
+											statement.indexColumn, attrError, BEGINTRANSACTION );
+		}
 	}
-	else if( actionType.compare( UPDATE ) == 0 )
+	else if( statement.type == STATEMENT_DROP_DATABASE )
 	{
-		//get index of curr DB
-		bool dbExists = true;
-		bool tblExists = true;
+		//create temp db to be dropped
+		Database dbTemp;
+		dbTemp.databaseName = statement.name;
 
-		Database *dbTemp = getDatabase( dbms, currentDatabase );
-		if( dbTemp == NULL )
+		//check if database exists
+		Database* dbFound = catalogCache.cacheGetDatabase( dbTemp.databaseName );
+		if( dbFound == NULL )
 		{
-			//db does not exist
-			dbExists = false;
+			//if it does not then return error message
+			errorExists = true;
+			errorContainerName = dbTemp.databaseName;
+			errorType = ERROR_DB_NOT_EXISTS; 
 		}
-
-		string tableName = getNextWord( input );
-
-		Table *tblTemp = dbTemp->getTable( tableName );
-
-		if( tblTemp == NULL )
+		else
 		{
-			//table doesent exist
-			tblExists = false;
-		}
-
-		/*
-		Database dbTemp;
-		dbTemp.databaseName = currentDatabase;
-		databaseExists( dbms, dbTemp, dbReturn );
+			//if it does, return success message and remove from the catalog
+			dbTemp.databaseName = dbFound->databaseName;
+			catalogCache.cacheDropDatabase( dbTemp.databaseName );
 
-		//get table name
+			//remove directory
+			dbTemp.databaseDrop(currentWorkingDirectory);
+		}
+	}
+	else if( statement.type == STATEMENT_DROP_TABLE )
+	{
 		Table tblTemp;
-		tblTemp.tableName = getNextWord( input );
-		
-		*/
-		//get where condition
-		string wCond = getWhereCondition( input );
+		tblTemp.tableName = statement.name;
 
-		//get set condition
-		string sCond = getSetCondition( input );
-	
 		//check if table exists
-		if( !dbExists )
-		{
-			errorExists = true;
-			errorType = ERROR_DB_NOT_EXISTS;
-			errorContainerName = currentDatabase;
-		}
-		else if( !tblExists )
+		if( dbTemp == NULL || !( dbTemp->tableExists( tblTemp.tableName, tblReturn ) ) )
 		{
 			//if it doesnt exist then return error
 			errorExists = true;
 			errorType = ERROR_TBL_NOT_EXISTS;
-			errorContainerName = tableName;
+			errorContainerName = tblTemp.tableName;
 		}
 		else
 		{
-			//update values
-			tblTemp->tableUpdate( currentWorkingDirectory, currentDatabase, wCond, sCond, BEGINTRANSACTION );
+			//table exists and remove from database
+			dbTemp->dropTable( tblTemp.tableName );
+
+			//remove table/file
+			tblTemp.tableDrop(currentWorkingDirectory, currentDatabase );
 		}
 	}
-	else if( actionType.compare( DELETE ) == 0 )
+	else if( statement.type == STATEMENT_ALTER_TABLE )
 	{
+		Table tblTemp;
+		tblTemp.tableName = statement.name;
 
-		bool dbExists = true;
-		bool tblExists = true;
-
-		Database* dbTemp = getDatabase( dbms, currentDatabase );
-		if( dbTemp == NULL )
+		//check if table exists
+		if( dbTemp == NULL || !( dbTemp->tableExists( tblTemp.tableName, tblReturn ) ) )
 		{
-			dbExists = false;
+			//if it doesnt exist then return error
+			errorExists = true;
+			errorType = ERROR_TBL_NOT_EXISTS;
+			errorContainerName = tblTemp.tableName;
 		}
-
-		/*
-		//get index of curr DB
-		Database dbTemp;
-		dbTemp.databaseName = currentDatabase;
-		databaseExists( dbms, dbTemp, dbReturn );
-		*/
-
-		string temp = getQueryType( input );
-		//get table name
-		Table tblTemp;
-		tblTemp.tableName = getNextWord( input );
-
-		Table* tblTempPtr = dbTemp->getTable( tblTemp.tableName );
-		if( tblTempPtr == NULL )
+		else
 		{
-			tblExists = false;
+			tblTemp.tableAlter( currentWorkingDirectory, currentDatabase, statement.definition, attrError );
 		}
+	}
+	else if( statement.type == STATEMENT_INSERT || statement.type == STATEMENT_UPDATE ||
+				statement.type == STATEMENT_DELETE )
+	{
+		Table *tblTemp = dbTemp == NULL ? NULL : dbTemp->getTable( statement.name );
 
-		//get where condition
-		string wCond = getWhereCondition( input );
-	
-		//check if table exists
-		if( !dbExists )
+		if( dbTemp == NULL )
 		{
 			errorExists = true;
 			errorType = ERROR_DB_NOT_EXISTS;
 			errorContainerName = currentDatabase;
 		}
-		else if( !tblExists )
+		else if( tblTemp == NULL )
 		{
 			//if it doesnt exist then return error
 			errorExists = true;
 			errorType = ERROR_TBL_NOT_EXISTS;
-			errorContainerName = tblTemp.tableName;
+			errorContainerName = statement.name;
+		}
+		else if( statement.type == STATEMENT_INSERT )
+		{
+			tblTemp->tableInsert( currentWorkingDirectory, currentDatabase, tblTemp->tableName,
+									statement.valueList, attrError, BEGINTRANSACTION );
+		}
+		else if( statement.type == STATEMENT_UPDATE )
+		{
+			tblTemp->tableUpdate( currentWorkingDirectory, currentDatabase, statement.whereClause,
+									statement.setClause, BEGINTRANSACTION );
 		}
 		else
 		{
-			//update values
-			tblTempPtr->tableDelete( currentWorkingDirectory, currentDatabase, wCond, BEGINTRANSACTION );
+			tblTemp->tableDelete( currentWorkingDirectory, currentDatabase, statement.whereClause,
+									BEGINTRANSACTION );
 		}
 	}
-	else if( actionType.compare( EXIT ) == 0 )
-	{
-		exitProgram = true;
-	}
-	else if( caseInsCompare( actionType, "begin" ) && caseInsCompare( getNextWord( input ), "transaction" ) )
+	else if( statement.type == STATEMENT_BEGIN )
 	{
 		//will lock table on next call
 		BEGINTRANSACTION = true;
 		cout << "-- Transaction starts. " << endl;
 	}
-	else if( caseInsCompare( actionType, "commit" ) )
+	else if( statement.type == STATEMENT_COMMIT )
 	{
-		bool dbExists = true;
-
-		Database* dbTemp = getDatabase( dbms, currentDatabase );
-		if( dbTemp == NULL )
-		{
-			dbExists = false;
-		}
-
-		if( dbExists )
+		if( dbTemp != NULL )
 		{
 			if( dbTemp->commitTransaction( currentWorkingDirectory ) )
 			{
@@ -901,221 +624,140 @@ bool startEvent( string input, vector< Database> &dbms, string currentWorkingDir
 			BEGINTRANSACTION = false;
 		}
 	}
-	else
+	//analyze one table, or every table of the database when none is named
+	else if( statement.type == STATEMENT_ANALYZE )
 	{
-		errorExists = true;
-		errorType = ERROR_INCORRECT_COMMAND;
-		errorContainerName = originalInput;
+		Table* tblTempPtr = dbTemp == NULL ? NULL : dbTemp->getTable( statement.name );
+
+		if( dbTemp == NULL )
+		{
+			errorExists = true;
+			errorType = ERROR_DB_NOT_EXISTS;
+			errorContainerName = currentDatabase;
+		}
+		else if( statement.name.empty() )
+		{
+			for( unsigned int index = 0; index < dbTemp->databaseTable.size(); index++ )
+			{
+				dbTemp->databaseTable[ index ].tableAnalyze( currentWorkingDirectory, currentDatabase,
+																BEGINTRANSACTION );
+			}
+		}
+		else if( tblTempPtr == NULL )
+		{
+			errorExists = true;
+			errorType = ERROR_TBL_NOT_EXISTS;
+			errorContainerName = statement.name;
+		}
+		else
+		{
+			tblTempPtr->tableAnalyze( currentWorkingDirectory, currentDatabase, BEGINTRANSACTION );
+		}
 	}
-	if( errorExists )
+	else if( actionType.compare( EXIT ) == 0 )
 	{
-		handleError( errorType, actionType, errorContainerName );
+		exitProgram = true;
 	}
-
-	return exitProgram;
-}
-
-
-/**
- * @brief 
- *
- * @details 
- *          
- * @pre 
- *
- * @post 
- *
- * @par Algorithm 
- *     
- * 
- * @exception 
- *
- * @param [in] 
- *
- * @return 
- *
- * @note None
- */
-Database* getDatabase( vector< Database > &dbms, string databaseName )
-{
-	for( uint i = 0; i < dbms.size(); i++ )
+	else if( actionType.compare( BUFFERPOOL ) == 0 )
 	{
-		if( dbms[ i ].databaseName == databaseName )
+		//optional new budget in megabytes, then the pool counters
+		string budget = statement.argument;
+		if( !budget.empty() )
 		{
-			return &dbms[ i ];
+			long megabytes = atol( budget.c_str() );
+			if( megabytes > 0 )
+			{
+				bufferPool.poolSetBudget( megabytes * 1024 * 1024 );
+			}
+			else
+			{
+				cout << "-- !Failed to set buffer pool size, " << budget << " is not a size in MB." << endl;
+			}
 		}
+		bufferPool.outputStatistics();
 	}
-	return NULL;
-}
-
-/**
- * @brief databaseExists
- *
- * @details checks whether dbInput exists in dbms
- *          
- * @pre dbms exists and dbInput exists
- *
- * @post returns true if dbExists, false otherwise
- *
- * @par Algorithm 
- *      loop through dbms return true if match is found
- *      
- * @exception None
- *
- * @param [in] dbms provides vector of dbs
- *
- * @param [in] dbInput provides db to be created
- *
- * @return bool
- *
- * @note None
- */
-bool databaseExists( vector<Database> dbms, Database dbInput, int &dbReturn )
-{
-	int size = dbms.size();
-	for( dbReturn = 0; dbReturn < size; dbReturn++ )
+	else if( actionType.compare( JOINMEMORY ) == 0 )
 	{
-		if( caseInsCompare( dbInput.databaseName, dbms[ dbReturn ].databaseName ) )
+		//optional new join budget in megabytes, then the budget in use
+		string budget = statement.argument;
+		if( !budget.empty() )
 		{
-			return true;
+			double megabytes = atof( budget.c_str() );
+			if( megabytes > 0 )
+			{
+				joinMemoryBytes = max( (long)( megabytes * 1024 * 1024 ), MIN_JOIN_BYTES );
+			}
+			else
+			{
+				cout << "-- !Failed to set join memory, " << budget << " is not a size in MB." << endl;
+			}
 		}
+		cout << "-- Join memory: " << joinMemoryBytes / 1024 << "KB." << endl;
 	}
-	return false;
-}
-
-/*
-* @brief getDatabaseStructure
-*
-* @details
-*
-* @pre
-*
-* @post
-*
-* @par
-*
-* @param [in/out]
-*
-* @param [in]
-*
-* @return
-*/
-void getDatabaseStructure( vector<Database> &dbms, string databaseSystemDirectory )
-{
-	// Check if the database system directory exists
-    struct stat buffer;
-	if( !( stat( databaseSystemDirectory.c_str(), &buffer ) == 0 ) )
-		// if not, create it.
-		system( ( "mkdir " + databaseSystemDirectory ).c_str() );
-
-	// Retrieve all of the information about existing directories
-	vector< string > directoryItems;
-
-	if( read_directory( databaseSystemDirectory, directoryItems ) )
+	else if( actionType.compare( SORTMEMORY ) == 0 )
 	{
-		for( unsigned int i = 0; i < directoryItems.size(); i++ )
+		//optional new sort budget in megabytes, then the budget in use
+		string budget = statement.argument;
+		if( !budget.empty() )
 		{
-			if(directoryItems[i] == "." || directoryItems[i] == "..")
+			double megabytes = atof( budget.c_str() );
+			if( megabytes > 0 )
 			{
-				directoryItems.erase(directoryItems.begin() + i);
-				i--;
+				sortMemoryBytes = max( (long)( megabytes * 1024 * 1024 ), MIN_SORT_BYTES );
 			}
 			else
 			{
-				Database* tempDatabase = getDatabase( dbms, directoryItems[i] );
-
-				// Need to add database to system
-				if( tempDatabase == NULL )
-				{
-					tempDatabase = new Database();
-					tempDatabase->databaseName = directoryItems[i];
-
-					dbms.push_back( *tempDatabase );
-					tempDatabase = &dbms[ dbms.size() - 1 ];
-				}
-
-				vector< string > tableItems;
-
-				if( read_directory( databaseSystemDirectory + "/" + tempDatabase->databaseName, tableItems ) )
-				{
-					for( unsigned int j = 0; j < tableItems.size(); j++ )
-					{
-						// ignore items that are current directory, previous directory, or temp files.
-						if(tableItems[j] == "." || tableItems[j] == ".." || (tableItems[j].find("_temp") != string::npos))
-						{
-							tableItems.erase(tableItems.begin() + j);
-							j--;
-						}
-						else
-						{
-							Table* tempTable = tempDatabase->getTable( tableItems[j] );
-
-							// Check if table is already in database
-							if ( tempTable == NULL )
-							{
-								tempTable = new Table();
-								tempTable->tableName = tableItems[j];
-
-								tempDatabase->databaseTable.push_back( *tempTable );
-							}
-						}
-					}
-				}
+				cout << "-- !Failed to set sort memory, " << budget << " is not a size in MB." << endl;
 			}
 		}
+		cout << "-- Sort memory: " << sortMemoryBytes / 1024 << "KB." << endl;
+	}
+	else if( actionType.compare( THREADS ) == 0 )
+	{
+		//optional new number of worker threads, then the number in use
+		string threads = statement.argument;
+		if( !threads.empty() )
+		{
+			int threadCount = atoi( threads.c_str() );
+			if( threadCount > 0 )
+			{
+				workerPool.poolSetThreads( threadCount );
+			}
+			else
+			{
+				cout << "-- !Failed to set worker threads, " << threads << " is not a number of threads." << endl;
+			}
+		}
+		cout << "-- Worker threads: " << workerPool.poolGetThreads() << "." << endl;
+	}
+	else if( actionType.compare( STATISTICS ) == 0 )
+	{
+		//statistics of the table named after the command
+		Table* tblTempPtr = dbTemp == NULL ? NULL : dbTemp->getTable( statement.argument );
+		if( tblTempPtr == NULL )
+		{
+			cout << "-- !Failed to show statistics of table " << statement.argument;
+			cout << " because it does not exist." << endl;
+		}
+		else
+		{
+			tblTempPtr->tableShowStatistics( currentWorkingDirectory, currentDatabase );
+		}
+	}
+	else
+	{
+		errorExists = true;
+		errorType = ERROR_INCORRECT_COMMAND;
+		errorContainerName = input;
+	}
+	if( errorExists )
+	{
+		handleError( errorType, actionType, errorContainerName );
 	}
-}
-
 
-/**
- * @brief 
- *
- * @details 
- *          
- * @pre 
- *
- * @post 
- *
- * @par Algorithm 
- *     
- * 
- * @exception 
- *
- * @param [in] 
- *
- * @return 
- *
- * @note None
- */
-void removeDatabase( vector< Database > &dbms, int index )
-{
-	dbms.erase( dbms.begin() + index );
+	return exitProgram;
 }
 
-/**
- * @brief 
- *
- * @details 
- *          
- * @pre 
- *
- * @post 
- *
- * @par Algorithm 
- *     
- * 
- * @exception 
- *
- * @param [in] 
- *
- * @return 
- *
- * @note None
- */
-void removeTable( vector< Database > &dbms, int dbReturn, int tblReturn )
-{
-	dbms[ dbReturn ].databaseTable.erase( dbms[ dbReturn ].databaseTable.begin() + tblReturn );
-}
 
 /**
  * @brief handleError
@@ -1229,136 +871,6 @@ void convertToUC( string &input )
 	}
 }
 
-/**
-*@brief string getQueryType method
-*
-*@details basically chesks for "from" statment and stores the table
-*
-*@param [in] string &input
-*
-*@return string (aka the record name) or space
-*/
-string getQueryType( string &input )
-{
-	bool fromOccurs = false;
-	int fromOccurance = 0;
-	int inputSize = input.size();
-
-	for( int index = 0; index < inputSize; index++ )
-	{
-		//check that i is f or F
-		if( ( input[ index ] == 'f' || input[ index ] == 'F' ) &&
-			( input[ index + 1 ] == 'r' || input[ index + 1 ] == 'R' ) && 
-			( input[ index + 2 ] == 'o' || input[ index + 2 ] == 'O' ) &&
-			( input[ index + 3 ] == 'm' || input[ index + 3] == 'M' ))
-		{
-			fromOccurs = true;
-			fromOccurance = index;
-		}
-	}
-
-	if( fromOccurs )
-	{
-		string queryType;
-		//take first word of input and set as action word
-		queryType = input.substr( 0, fromOccurance - 1);
-		//erase word from original str to further parse
-		input.erase( 0, fromOccurance + 5 );
-
-		return queryType;
-	}
-	else
-	{
-		return "";
-	}
-	
-}
-
-/**
-*@brief string getWhereCondition method
-*
-*@details checks for where in string, and if true stores the condition
-*
-*@param [in] string &input
-*
-*@return string
-*/
-string getWhereCondition( string &input )
-{
-	bool whereOccurs = false;
-	int whereOccurance = 0;
-	int inputSize = input.size();
-
-	for( int index = 0; index < inputSize; index++ )
-	{
-		//check that i is f or F
-		if( ( input[ index ] == 'w' || input[ index ] == 'W' ) &&
-			( input[ index + 1 ] == 'h' || input[ index + 1 ] == 'H' ) && 
-			( input[ index + 2 ] == 'e' || input[ index + 2 ] == 'E' ) &&
-			( input[ index + 3 ] == 'r' || input[ index + 3 ] == 'R' ) && 
-			( input[ index + 4 ] == 'e' || input[ index + 4 ] == 'E' ))
-		{
-			whereOccurs = true;
-			whereOccurance = index;
-		}
-	}
-
-	if( whereOccurs )
-	{
-		string condType;
-		//take first word of input and set as action word
-		condType = input.substr( whereOccurance + 6, input.size() - 1 );
-		//erase word from original str to further parse
-		input.erase( whereOccurance, input.size() - 1 );
-		return condType;
-	}
-	else
-	{
-		return "";
-	}
-}
-
-/**
-*@brief string getSetCondition method
-*
-*@details returns the attribute that is being reset
-*
-*@param [in] string &input
-*
-*@return string (the set value)
-*/
-string getSetCondition( string &input )
-{
-	bool setOccurs = false;
-	int setOccurance = 0;
-	int inputSize = input.size();
-
-	for( int index = 0; index < inputSize; index++ )
-	{
-		//check that i is f or F
-		if( ( input[ index ] == 's' || input[ index ] == 'S' ) &&
-			( input[ index + 1 ] == 'e' || input[ index + 1 ] == 'E' ) && 
-			( input[ index + 2 ] == 't' || input[ index + 2 ] == 'T' ) )
-		{
-			setOccurs = true;
-			setOccurance = index;
-		}
-	}
-
-	if( setOccurs )
-	{
-		string setType;
-		//take first word of input and set as action word
-		setType = input.substr( setOccurance + 4, input.find("\n") - 1);
-		//erase word from original str to further parse
-		input.erase( setOccurance, input.size() - 1);
-		return setType;
-	}
-	else
-	{
-		return "";
-	}
-}
 
 /**
 *@brief void removeNewLine method
@@ -1382,281 +894,6 @@ void removeNewLine( string &input )
 }
 
 
-/**
- * @brief returnNextWord
- *
- * @details returns next word without deleting anything from input string
- *          
- * @pre input is not empty
- *
- * @post first word is returned
- *
- * @par Algorithm 
- *      get string until first space appears
- * 
- * @exception None
- *
- * @param [in] string input provides input string to parse
- *
- * @return string
- *
- * @note None
- */
-string returnNextWord( string input )
-{
-	//doesnt actually remove WS, just modifies local input string
-	removeLeadingWS( input );
-
-	//takes first word and returns it
-	string nextWord = input.substr( 0, input.find(" ") );
-	return nextWord;
-}
-
-/**
- * @brief checkJoin
- *
- * @details checks for inner join without using inner join keyword
- *          
- * @pre nothing
- *
- * @post returns true if default join
- *
- * @par Algorithm 
- *      parse through the string and find , and return LHS and RHS
- * 
- * @exception None
- *
- * @param [in] string &input
- *
- * @return bool
- *
- * @note None
- */
-bool checkJoin( string & input, string &LHS )
-{
-	//check input for comma
-	size_t found = input.find( ',' );
-	if( found != input.npos )
-	{
-		LHS = input.substr(0, found );
-		removeLeadingWS( LHS );
-
-		input.erase( 0, found + 1 );
-		removeLeadingWS( input );
-		return true;
-	}
-	return false;
-}
-
-
-/**
- * @brief checkInnerJoin
- *
- * @details checks that query is inner join
- *          
- * @pre 
- *
- * @post 
- *
- * @par Algorithm 
- *      parse through the string and look for occurance of inner join and return lhs and rhs
- * 
- * @exception None
- *
- * @param [in] string &input
- *
- * @return bool, true if inner join, false otherwise
- *
- * @note None
- */
-bool checkInnerJoin( string & input, string &LHS  )
-{
-	bool innerOccurs = false;
-	int found = 0;
-	int inputSize = input.size();
-
-	for( int index = 0; index < inputSize; index++ )
-	{
-		//check that i is f or F  
-		if( ( input[ index ] == 'i' || input[ index ] == 'I' ) &&
-			( input[ index + 1 ] == 'n' || input[ index + 1 ] == 'N' ) && 
-			( input[ index + 2 ] == 'n' || input[ index + 2 ] == 'N' ) &&
-			( input[ index + 3 ] == 'e' || input[ index + 3] == 'E' ) && 
-			( input[ index + 4 ] == 'r' || input[ index + 4] == 'R' ) &&
-			  input[ index + 5 ] == ' ' &&
-			( input[ index + 6 ] == 'j' || input[ index + 6 ] == 'J' ) && 
-			( input[ index + 7 ] == 'o' || input[ index + 7 ] == 'O' ) &&
-			( input[ index + 8 ] == 'i' || input[ index + 8 ] == 'I' ) && 
-			( input[ index + 9 ] == 'n' || input[ index + 9 ] == 'N' ))
-		{
-			innerOccurs = true;
-			found = index;
-		}
-	}
-
-	if( innerOccurs )
-	{
-		LHS = input.substr( 0, found );
-		removeLeadingWS( LHS );
-
-		input.erase( 0, found + 10 );
-		removeLeadingWS( input );
-		return true;
-	}
-	return false;
-}
-
-/**
- * @brief checkouterjoin
- *
- * @details checks if string contains outer join
- *          
- * @pre none
- *
- * @post return true if outer join
- *
- * @par Algorithm 
- *     
- * 
- * @exception None
- *
- * @param [in] input provides input string to be returned
- *			   LHS returns tables in outer join
- *
- * @return 
- *
- * @note None
- */
-bool checkOuterJoin( string & input, string &LHS  )
-{
-	bool outerOccurs = false;
-	int found = 0;
-	int inputSize = input.size();
-
-	for( int index = 0; index < inputSize; index++ )
-	{
-		//check that i is f or F  
-		if( ( input[ index ] == 'l' || input[ index ] == 'L' ) &&
-			( input[ index + 1 ] == 'e' || input[ index + 1 ] == 'E' ) && 
-			( input[ index + 2 ] == 'f' || input[ index + 2 ] == 'F' ) &&
-			( input[ index + 3 ] == 't' || input[ index + 3 ] == 'T' ) && 
-
-			  input[ index + 4 ] == ' ' &&
-
-			( input[ index + 5 ] == 'o' || input[ index + 5 ] == 'O' ) &&
-			( input[ index + 6 ] == 'u' || input[ index + 6 ] == 'U' ) && 
-			( input[ index + 7 ] == 't' || input[ index + 7 ] == 'T' ) &&
-			( input[ index + 8 ] == 'e' || input[ index + 8 ] == 'E' ) && 
-			( input[ index + 9 ] == 'r' || input[ index + 9 ] == 'R' ) &&
-
-			  input[ index + 10 ] == ' ' && 
-
-			( input[ index + 11 ] == 'j' || input[ index + 11 ] == 'J' ) &&
-			( input[ index + 12 ] == 'o' || input[ index + 12 ] == 'O' ) && 
-			( input[ index + 13 ] == 'i' || input[ index + 13 ] == 'I' ) &&
-			( input[ index + 14 ] == 'n' || input[ index + 14 ] == 'N' ))
-		{
-			outerOccurs = true;
-			found = index;
-		}
-	}
-
-	if( outerOccurs )
-	{
-		LHS = input.substr( 0, found );
-		removeLeadingWS( LHS );
-
-		input.erase( 0, found + 15 );
-		removeLeadingWS( input );
-		return true;
-	}
-	return false;
-}
-
-
-/**
- * @brief getTableVariable
- *
- * @details returns valriable of table
- *          
- * @pre 
- *
- * @post 
- *
- * @par Algorithm 
- *     parse string
- * 
- * @exception None
- *
- * @param [in] 
- *
- * @return 
- *
- * @note None
- */
-string getTableVariable( string &input )
-{
-	string tblVar;
-	size_t found = input.find( '.' );
-	if( found != input.npos )
-	{
-		tblVar = input.substr( 0, found );
-		removeLeadingWS( tblVar );
-
-		input.erase( 0, found + 1 );
-		removeLeadingWS( input );
-	}
-
-	return tblVar;
-}
-
-
-string returnLHSJoinComparison( string &input )
-{
-	string LHS;
-	size_t found = input.find( '=' );
-	if ( found != input.npos )
-	{
-		LHS = input.substr( 0, found );
-		removeLeadingWS( LHS );
-
-		input.erase( 0, found + 1 );
-		removeLeadingWS( input );
-	}
-	return LHS;
-}
-
-
-string getOnCondition( string &input )
-{
-	bool onOccurs = false;
-	int found = 0;
-	int inputSize = input.size();
-	string LHS;
-
-	for( int index = 0; index < inputSize; index++ )
-	{
-		//check that i is f or F  
-		if( ( input[ index ] == 'o' || input[ index ] == 'O' ) &&
-			( input[ index + 1 ] == 'n' || input[ index + 1 ] == 'N' ) )
-		{
-			onOccurs = true;
-			found = index;
-		}
-	}
-
-	if( onOccurs )
-	{
-		LHS = input.substr( found + 2, input.size() - 1 );
-		removeLeadingWS( LHS );
-
-		input.erase( found, input.size() - 1 );
-		removeLeadingWS( input );
-	}
-	return LHS;
-}
-
-
 void removeCarriageReturn( string &input )
 {
 	int strLen = input.length();